@@ -8,6 +8,10 @@ let isConfigured = false;
 let availableLines = [];
 let currentStopId = null;
 let refreshInterval = null;
+let eventSource = null;
+let liveConfig = null;
+let liveDepartures = null;
+let renderInterval = null;
 
 // =====================
 // Debounce Utility
@@ -31,6 +35,7 @@ function setupStopSearch() {
     
     const debouncedSearch = debounce(async (query) => {
         if (query.length < 2) {
+            latestStopQuery = '';
             hideStopResults();
             return;
         }
@@ -88,13 +93,34 @@ function updateHighlight(items) {
     });
 }
 
+// Suche und Linien laufen auf dem Gerät im Hintergrund: 202 (bzw. 503 bei voller
+// Warteschlange) heisst "noch nicht fertig", dieselbe URL wird dann erneut abgefragt.
+// `isCurrent` beendet das Nachfragen, sobald die Anfrage überholt ist (null).
+async function fetchLookup(url, isCurrent = () => true) {
+    for (let attempt = 0; attempt < 60; attempt++) {
+        if (!isCurrent()) return null;
+        const res = await fetch(url);
+        // 202 = läuft noch, 503 mit Retry-After = Warteschlange voll
+        const retry = res.status === 202 || (res.status === 503 && res.headers.has('Retry-After'));
+        if (!retry) return res;
+        await new Promise(resolve => setTimeout(resolve, 300));
+    }
+    throw new Error('Timeout');
+}
+
+let latestStopQuery = '';
+
 async function searchStops(query) {
+    latestStopQuery = query;
     const resultsDiv = document.getElementById('stop-results');
     resultsDiv.innerHTML = '<div class="dropdown-item loading">Suche...</div>';
     resultsDiv.style.display = 'block';
     
     try {
-        const res = await fetch(`/api/stops/search?q=${encodeURIComponent(query)}`);
+        // Inzwischen weitergetippt: Ergebnis der neueren Suche abwarten
+        const isCurrent = () => query === latestStopQuery;
+        const res = await fetchLookup(`/api/stops/search?q=${encodeURIComponent(query)}`, isCurrent);
+        if (!res || !isCurrent()) return;
         const data = await res.json();
         
         if (data.error) {
@@ -171,7 +197,7 @@ async function loadLinesForStop(stopId) {
     l2Select.style.display = 'none';
     
     try {
-        const res = await fetch(`/api/lines?stopId=${encodeURIComponent(stopId)}`);
+        const res = await fetchLookup(`/api/lines?stopId=${encodeURIComponent(stopId)}`);
         const data = await res.json();
         
         if (data.error) {
@@ -394,9 +420,9 @@ async function loadLiveDepartures() {
     try {
         // Hole die aktuelle Config
         const statusRes = await fetch('/api/status');
-        const config = await statusRes.json();
+        liveConfig = await statusRes.json();
         
-        if (!config.station || !config.station.id) {
+        if (!liveConfig.station || !liveConfig.station.id) {
             contentDiv.innerHTML = '<div class="no-data">Keine Haltestelle konfiguriert</div>';
             return;
         }
@@ -412,39 +438,7 @@ async function loadLiveDepartures() {
             return;
         }
         
-        const departures = depsData.departures || [];
-        
-        if (departures.length === 0) {
-            contentDiv.innerHTML = '<div class="no-data">Keine Abfahrten gefunden</div>';
-            return;
-        }
-        
-        // Filtere die konfigurierten Linien
-        const line1 = config.line1;
-        const line2 = config.line2;
-        
-        let html = `<div class="station-header"><h3>${config.station.name}</h3></div>`;
-        
-        // Zeige konfigurierte Linien prominent
-        if (line1 && line1.name) {
-            const departures1 = departures.filter(d => d.line === line1.name && d.direction === line1.dir).slice(0, 2);
-            html += renderLineBlock('Linie 1', line1, departures1);
-        }
-        
-        if (line2 && line2.name) {
-            const departures2 = departures.filter(d => d.line === line2.name && d.direction === line2.dir).slice(0, 2);
-            html += renderLineBlock('Linie 2', line2, departures2);
-        }
-        
-        contentDiv.innerHTML = html;
-        
-        // Update Zeit anzeigen
-        const now = new Date();
-        const timeStr = now.toLocaleTimeString('de-CH');
-        const updateInfo = document.createElement('div');
-        updateInfo.className = 'update-time';
-        updateInfo.textContent = `Aktualisiert: ${timeStr}`;
-        contentDiv.appendChild(updateInfo);
+        renderLiveDepartures(depsData);
         
     } catch (e) {
         console.error('Error loading live departures:', e);
@@ -452,6 +446,47 @@ async function loadLiveDepartures() {
     }
 }
 
+function renderLiveDepartures(depsData) {
+    const contentDiv = document.getElementById('live-departures-content');
+    const config = liveConfig;
+    if (!config) return;
+    liveDepartures = depsData;
+    
+    const departures = depsData.departures || [];
+    
+    if (departures.length === 0) {
+        contentDiv.innerHTML = '<div class="no-data">Keine Abfahrten gefunden</div>';
+        return;
+    }
+    
+    // Filtere die konfigurierten Linien
+    const line1 = config.line1;
+    const line2 = config.line2;
+    
+    let html = `<div class="station-header"><h3>${config.station.name}</h3></div>`;
+    
+    // Zeige konfigurierte Linien prominent
+    if (line1 && line1.name) {
+        const departures1 = departures.filter(d => d.line === line1.name && d.direction === line1.dir).slice(0, 2);
+        html += renderLineBlock('Linie 1', line1, departures1);
+    }
+    
+    if (line2 && line2.name) {
+        const departures2 = departures.filter(d => d.line === line2.name && d.direction === line2.dir).slice(0, 2);
+        html += renderLineBlock('Linie 2', line2, departures2);
+    }
+    
+    contentDiv.innerHTML = html;
+    
+    // Update Zeit anzeigen
+    const now = new Date();
+    const timeStr = now.toLocaleTimeString('de-CH');
+    const updateInfo = document.createElement('div');
+    updateInfo.className = 'update-time';
+    updateInfo.textContent = `Aktualisiert: ${timeStr}`;
+    contentDiv.appendChild(updateInfo);
+}
+
 function renderLineBlock(title, lineConfig, departures) {
     const icon = getVehicleIcon(getLineType(lineConfig.name, lineConfig.dir));
     let html = `
@@ -465,8 +500,10 @@ function renderLineBlock(title, lineConfig, departures) {
     
     if (departures.length > 0) {
         html += '<div class="departure-list">';
+        // Minuten aus dem Abfahrtszeitpunkt, damit die Antwort vom Panel cachebar bleibt
+        const nowSeconds = Date.now() / 1000;
         departures.forEach(dep => {
-            const minutes = dep.minutes || 0;
+            const minutes = Math.max(0, Math.floor((dep.timestamp - nowSeconds) / 60));
             const timeText = minutes === 0 ? 'Jetzt' : `${minutes}'`;
             html += `<div class="departure-item"><strong>${timeText}</strong></div>`;
         });
@@ -495,11 +532,39 @@ function startLiveDeparturesRefresh() {
     // Initial load
     loadLiveDepartures();
     
-    // Refresh alle 30 Sekunden
     if (refreshInterval) {
         clearInterval(refreshInterval);
+        refreshInterval = null;
+    }
+    
+    // Push vom Panel; ohne EventSource (oder wenn das Panel ablehnt) alle 30 Sekunden pollen
+    if (!window.EventSource) {
+        refreshInterval = setInterval(loadLiveDepartures, 30000);
+        return;
+    }
+    if (eventSource) {
+        eventSource.close();
     }
-    refreshInterval = setInterval(loadLiveDepartures, 30000);
+    eventSource = new EventSource('/api/events');
+    
+    // Zwischen zwei Pushes nur die Minuten neu berechnen
+    if (!renderInterval) {
+        renderInterval = setInterval(() => {
+            if (liveDepartures) renderLiveDepartures(liveDepartures);
+        }, 30000);
+    }
+    
+    eventSource.addEventListener('departures', (e) => {
+        const depsData = JSON.parse(e.data);
+        if (depsData.stop !== 0) return;
+        renderLiveDepartures(depsData);
+    });
+    
+    eventSource.addEventListener('error', () => {
+        if (eventSource.readyState === EventSource.CLOSED && !refreshInterval) {
+            refreshInterval = setInterval(loadLiveDepartures, 30000);
+        }
+    });
 }
 
 function refreshDepartures() {
@@ -720,7 +785,7 @@ async function saveConfig() {
     };
     
     // Bestätigung mit verbessertem Dialog
-    if (!showConfirmDialog('Konfiguration speichern und Gerät neu starten?')) {
+    if (!showConfirmDialog('Konfiguration speichern?')) {
         return;
     }
     
@@ -736,24 +801,23 @@ async function saveConfig() {
         });
         
         const result = await res.json();
-        showToast(result.message, 'success');
-        
-        // Zeige Countdown
-        let countdown = 5;
-        const interval = setInterval(() => {
-            btn.innerHTML = `Neustart in ${countdown}s...`;
-            countdown--;
-            if (countdown < 0) {
-                clearInterval(interval);
-                btn.innerHTML = 'Neustart läuft...';
-            }
-        }, 1000);
-        
+        if (!res.ok) {
+            showToast(result.message || 'Fehler beim Speichern!', 'error');
+        } else if (result.reconnect) {
+            // Neue WLAN-Zugangsdaten: das Gerät verbindet sich neu, die Seite kann kurz wegfallen
+            showToast('Gespeichert. WLAN wird neu verbunden...', 'success');
+        } else {
+            showToast('Gespeichert und übernommen', 'success');
+        }
+        // Kein Neustart mehr: Stationsname und Linienfilter der Live-Anzeige neu laden,
+        // sonst zeichnen die folgenden Pushes noch mit der alten Config
+        if (res.ok) loadLiveDepartures();
     } catch (e) {
         showToast('Fehler beim Speichern!', 'error');
-        btn.disabled = false;
-        btn.textContent = 'Speichern & Neustart';
     }
+    
+    btn.disabled = false;
+    btn.textContent = 'Speichern';
 }
 
 async function factoryReset() {
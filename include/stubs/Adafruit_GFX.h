@@ -0,0 +1,41 @@
+// Stub header for Adafruit GFX - nur für clangd IntelliSense
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+class String;
+
+// Dummy GFX base class for syntax checking
+class Adafruit_GFX {
+public:
+    Adafruit_GFX(int16_t w, int16_t h);
+    virtual ~Adafruit_GFX() {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+    virtual void fillScreen(uint16_t color);
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+
+    void setFont(const void* f);
+    void setTextColor(uint16_t c);
+    void setCursor(int16_t x, int16_t y);
+    void setRotation(uint8_t r);
+    void getTextBounds(const String& str, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h);
+    void getTextBounds(const char* str, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h);
+
+    size_t print(const char* str);
+    size_t print(const String& str);
+    size_t println(const char* str);
+    size_t println(const String& str);
+    size_t println();
+
+    int16_t width() const;
+    int16_t height() const;
+
+protected:
+    int16_t WIDTH;
+    int16_t HEIGHT;
+};
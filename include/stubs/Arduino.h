@@ -67,6 +67,10 @@ void delay(uint32_t ms);
 uint32_t millis();
 uint32_t micros();
 
+// PSRAM (esp32-hal-psram.h)
+bool psramFound();
+void* ps_malloc(size_t size);
+
 // String class (minimal)
 class String {
 public:
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <stdint.h>
+#include "Adafruit_GFX.h"
 
 // Forward declarations
 class GxEPD2_EPD;
@@ -17,26 +18,23 @@ public:
 
 // Template class for display
 template<class T, int page_height>
-class GxEPD2_BW {
+class GxEPD2_BW : public Adafruit_GFX {
 public:
-    GxEPD2_BW(T display) {}
+    GxEPD2_BW(T display) : Adafruit_GFX(T::WIDTH, T::HEIGHT) {}
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
 
     void init(uint32_t serial_diag_bitrate = 0, bool initial = true, uint16_t reset_duration = 2, bool pulldown_rst_mode = false);
-    void setRotation(uint8_t r);
-    void setFont(const void* f);
-    void setTextColor(uint16_t c);
     void setFullWindow();
+    void setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
     bool nextPage();
     void firstPage();
     void fillScreen(uint16_t color);
-    void setCursor(int16_t x, int16_t y);
-    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
 
-    size_t print(const char* str);
+    using Adafruit_GFX::print;
+    using Adafruit_GFX::println;
     size_t print(int num);
-    size_t println(const char* str);
     size_t println(int num);
-    size_t println();
 
     void hibernate();
 };
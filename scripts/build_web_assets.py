@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""
+Bereitet die Web-Oberfläche für das LittleFS-Image vor.
+
+- Komprimiert jede Datei aus data/ mit gzip (-9, ohne Zeitstempel -> reproduzierbar)
+- Hängt an Verweise in index.html einen Content-Hash an (app.js?v=1a2b3c4d),
+  damit app.js und style.css im Browser als "immutable" gecacht werden dürfen
+- Schreibt das Manifest assets.idx ("<pfad> <hash> <gz-bytes> <roh-bytes>" pro Zeile),
+  das StaticAssets beim Start liest
+- Mit -DWEB_ASSETS_EMBEDDED zusätzlich web_assets_embedded.h: dieselben gzip-Daten als
+  const Arrays, die direkt aus dem Flash ausgeliefert werden (kein LittleFS nötig)
+
+Als PlatformIO pre-Script läuft es vor jedem Build/buildfs/uploadfs und schreibt nach
+$PROJECT_DATA_DIR (.pio/webfs) bzw. .pio/webgen (Header, im Include-Pfad).
+Standalone: python3 scripts/build_web_assets.py [quelle] [ziel] [header-verzeichnis]
+"""
+import gzip
+import hashlib
+import os
+import re
+import shutil
+import sys
+
+MANIFEST = "assets.idx"
+HEADER = "web_assets_embedded.h"
+HASH_LEN = 8
+
+# Nur diese Referenzen in HTML werden versioniert (lokale Pfade ohne Query/Schema)
+REFERENCE = re.compile(r'(href|src)="([A-Za-z0-9_./-]+)"')
+
+
+def content_hash(data):
+    return hashlib.sha256(data).hexdigest()[:HASH_LEN]
+
+
+def version_references(html, hashes):
+    def replace(match):
+        name = match.group(2).lstrip("./")
+        if name not in hashes:
+            return match.group(0)
+        return '%s="%s?v=%s"' % (match.group(1), match.group(2), hashes[name])
+    return REFERENCE.sub(replace, html.decode("utf-8")).encode("utf-8")
+
+
+def c_bytes(data):
+    rows = []
+    for i in range(0, len(data), 16):
+        rows.append("    " + ",".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(rows)
+
+
+def write_header(header_dir, assets):
+    os.makedirs(header_dir, exist_ok=True)
+    out = ["// Generiert von scripts/build_web_assets.py - nicht bearbeiten",
+           "#ifndef WEB_ASSETS_EMBEDDED_H",
+           "#define WEB_ASSETS_EMBEDDED_H",
+           "",
+           "#include <stdint.h>",
+           "#include <stddef.h>",
+           ""]
+    for index, (name, digest, packed) in enumerate(assets):
+        out.append("static const uint8_t WEB_ASSET_%d[] = {  // %s" % (index, name))
+        out.append(c_bytes(packed))
+        out.append("};")
+        out.append("")
+    out.append("struct EmbeddedWebAsset {")
+    out.append("    const char* path;")
+    out.append("    const char* hash;")
+    out.append("    const uint8_t* data;")
+    out.append("    size_t size;")
+    out.append("};")
+    out.append("")
+    out.append("static const EmbeddedWebAsset EMBEDDED_WEB_ASSETS[] = {")
+    for index, (name, digest, packed) in enumerate(assets):
+        out.append('    { "/%s", "%s", WEB_ASSET_%d, %d },' % (name, digest, index, len(packed)))
+    out.append("};")
+    out.append("")
+    out.append("#endif // WEB_ASSETS_EMBEDDED_H")
+
+    path = os.path.join(header_dir, HEADER)
+    content = "\n".join(out) + "\n"
+    # Nur bei Änderung schreiben, sonst kompiliert PlatformIO jedes Mal neu
+    if os.path.exists(path):
+        with open(path) as f:
+            if f.read() == content:
+                return
+    with open(path, "w") as f:
+        f.write(content)
+
+
+def build(source_dir, target_dir, header_dir=None):
+    files = sorted(f for f in os.listdir(source_dir)
+                   if os.path.isfile(os.path.join(source_dir, f)) and not f.startswith("."))
+
+    contents = {}
+    for name in files:
+        with open(os.path.join(source_dir, name), "rb") as f:
+            contents[name] = f.read()
+
+    # Erst alle anderen Dateien hashen, dann die HTML-Seiten mit den Versionen umschreiben
+    hashes = {name: content_hash(data) for name, data in contents.items() if not name.endswith(".html")}
+    for name in files:
+        if name.endswith(".html"):
+            contents[name] = version_references(contents[name], hashes)
+            hashes[name] = content_hash(contents[name])
+
+    if os.path.isdir(target_dir):
+        shutil.rmtree(target_dir)
+    os.makedirs(target_dir)
+
+    lines = []
+    embedded = []
+    total_raw = 0
+    total_gz = 0
+    for name in files:
+        packed = gzip.compress(contents[name], compresslevel=9, mtime=0)
+        with open(os.path.join(target_dir, name + ".gz"), "wb") as f:
+            f.write(packed)
+        lines.append("/%s %s %d %d" % (name, hashes[name], len(packed), len(contents[name])))
+        embedded.append((name, hashes[name], packed))
+        total_raw += len(contents[name])
+        total_gz += len(packed)
+        print("  %-12s %6d -> %6d bytes  (%s)" % (name, len(contents[name]), len(packed), hashes[name]))
+
+    with open(os.path.join(target_dir, MANIFEST), "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+    if header_dir:
+        write_header(header_dir, embedded)
+
+    print("Web assets: %d files, %d -> %d bytes" % (len(files), total_raw, total_gz))
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    source = sys.argv[1] if len(sys.argv) > 1 else os.path.join(root, "data")
+    target = sys.argv[2] if len(sys.argv) > 2 else os.path.join(root, ".pio", "webfs")
+    header = sys.argv[3] if len(sys.argv) > 3 else None
+    build(source, target, header)
+
+
+if __name__ == "__main__":
+    main()
+else:
+    # PlatformIO extra_script
+    Import("env")  # noqa: F821
+    header_dir = None
+    if "WEB_ASSETS_EMBEDDED" in env.subst("$BUILD_FLAGS"):  # noqa: F821
+        header_dir = os.path.join(env.subst("$PROJECT_WORKSPACE_DIR"), "webgen")  # noqa: F821
+        env.Append(CPPPATH=[header_dir])  # noqa: F821
+    build(os.path.join(env.subst("$PROJECT_DIR"), "data"), env.subst("$PROJECT_DATA_DIR"), header_dir)  # noqa: F821
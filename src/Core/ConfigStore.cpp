@@ -1,8 +1,38 @@
 #include "ConfigStore.h"
 #include "../Logger/Logger.h"
 #include <mbedtls/base64.h>
+#include <nvs.h>
 
-ConfigStore::ConfigStore() : _macKey(0) {}
+namespace {
+
+const uint32_t DEFAULT_POLL_MIN_S = 20;
+const uint32_t DEFAULT_POLL_MAX_S = 300;
+
+// Keys: st_name/st_id (Hauptstation), st2_name/st2_id, st3_name/st3_id, ...
+String stopKey(size_t index, const char* field) {
+    String suffix = (index == 0) ? "" : String(index + 1);
+    return "st" + suffix + "_" + field;
+}
+
+} // namespace
+
+ConfigSnapshot::ConfigSnapshot() : generation(0) {
+    poll.minSeconds = DEFAULT_POLL_MIN_S;
+    poll.maxSeconds = DEFAULT_POLL_MAX_S;
+}
+
+ConfigStore::ConfigStore()
+    : _snapshot(std::make_shared<ConfigSnapshot>()),
+      _mutex(NULL),
+      _updateDepth(0),
+      _updateCancelled(false),
+      _nvsReads(0),
+      _nvsWrites(0),
+      _nvsCommits(0),
+      _listenerCount(0),
+      _macKey(0) {
+    _mutex = xSemaphoreCreateRecursiveMutex();
+}
 
 void ConfigStore::begin() {
     Logger::info("CONFIG", "Initializing ConfigStore...");
@@ -12,111 +42,332 @@ void ConfigStore::begin() {
     
     migratePassword();
     
-    StationConfig station = getStation();
-    if (station.id.length() == 0) {
+    xSemaphoreTakeRecursive(_mutex, portMAX_DELAY);
+    load();
+    xSemaphoreGiveRecursive(_mutex);
+    
+    if (getStation().id.length() == 0) {
         Logger::info("CONFIG", "No station configured, setting defaults (Arlesheim, Im Lee)...");
+        beginUpdate();
         setStation("Arlesheim, Im Lee", "8588764");
         setLine1("10", "Flüh, Bahnhof");
         setLine2("10", "Dornach Bahnhof");
+        commitUpdate();
+    }
+}
+
+// Snapshot & Schreibblöcke
+ConfigSnapshotPtr ConfigStore::getSnapshot() const {
+    return std::atomic_load(&_snapshot);
+}
+
+String ConfigStore::readString(const char* key, const String& fallback) {
+    _nvsReads++;
+    return preferences.getString(key, fallback);
+}
+
+uint32_t ConfigStore::load() {
+    std::shared_ptr<ConfigSnapshot> next = std::make_shared<ConfigSnapshot>();
+    uint32_t readsBefore = _nvsReads;
+    
+    next->ssid = readString("ssid", "");
+    next->password = readString("password", "");
+    _nvsReads++;
+    if (next->password.length() > 0 && preferences.getBool("pw_obf", false)) {
+        next->password = deobfuscate(next->password);
+    }
+    next->apiKey = readString("apikey", "");
+    for (size_t i = 0; i < MAX_STOPS; i++) {
+        next->stops[i].name = readString(stopKey(i, "name").c_str(), "");
+        next->stops[i].id = readString(stopKey(i, "id").c_str(), "");
+    }
+    next->line1.name = readString("l1_name", "");
+    next->line1.direction = readString("l1_dir", "");
+    next->line2.name = readString("l2_name", "");
+    next->line2.direction = readString("l2_dir", "");
+    _nvsReads += 2;
+    next->poll.minSeconds = preferences.getUInt("poll_min", DEFAULT_POLL_MIN_S);
+    next->poll.maxSeconds = preferences.getUInt("poll_max", DEFAULT_POLL_MAX_S);
+    next->webPassword = readString("web_pw", "");
+    
+    uint32_t changed = publish(next);
+    Logger::printf("CONFIG", "Loaded %u keys from NVS (generation %u)", _nvsReads - readsBefore, next->generation);
+    return changed;
+}
+
+uint32_t ConfigStore::publish(std::shared_ptr<ConfigSnapshot> next) {
+    ConfigSnapshotPtr current = getSnapshot();
+    next->generation = current->generation + 1;
+    std::atomic_store(&_snapshot, ConfigSnapshotPtr(next));
+    return changes(*current, *next);
+}
+
+uint32_t ConfigStore::changes(const ConfigSnapshot& before, const ConfigSnapshot& after) {
+    uint32_t mask = 0;
+    if (before.ssid != after.ssid || before.password != after.password) mask |= CONFIG_CHANGE_WIFI;
+    if (before.apiKey != after.apiKey) mask |= CONFIG_CHANGE_API_KEY;
+    if (before.stops[0].name != after.stops[0].name || before.stops[0].id != after.stops[0].id) {
+        mask |= CONFIG_CHANGE_STATION;
+    }
+    for (size_t i = 1; i < MAX_STOPS; i++) {
+        if (before.stops[i].name != after.stops[i].name || before.stops[i].id != after.stops[i].id) {
+            mask |= CONFIG_CHANGE_STOPS;
+        }
+    }
+    if (before.line1.name != after.line1.name || before.line1.direction != after.line1.direction ||
+        before.line2.name != after.line2.name || before.line2.direction != after.line2.direction) {
+        mask |= CONFIG_CHANGE_LINES;
+    }
+    if (before.poll.minSeconds != after.poll.minSeconds || before.poll.maxSeconds != after.poll.maxSeconds) {
+        mask |= CONFIG_CHANGE_POLL;
+    }
+    if (before.webPassword != after.webPassword) mask |= CONFIG_CHANGE_WEB_PASSWORD;
+    return mask;
+}
+
+bool ConfigStore::subscribe(uint32_t mask, ConfigListener listener) {
+    if (_listenerCount >= MAX_LISTENERS || !listener) return false;
+    _listeners[_listenerCount].mask = mask;
+    _listeners[_listenerCount].callback = listener;
+    _listenerCount++;
+    return true;
+}
+
+void ConfigStore::notify(uint32_t changes) {
+    if (changes == 0) return;
+    ConfigSnapshotPtr config = getSnapshot();
+    for (size_t i = 0; i < _listenerCount; i++) {
+        uint32_t relevant = changes & _listeners[i].mask;
+        if (relevant) _listeners[i].callback(*config, relevant);
+    }
+}
+
+void ConfigStore::beginUpdate() {
+    xSemaphoreTakeRecursive(_mutex, portMAX_DELAY);
+    if (_updateDepth++ == 0) {
+        _draft = std::make_shared<ConfigSnapshot>(*getSnapshot());
+        _updateCancelled = false;
     }
 }
 
+bool ConfigStore::commitUpdate() {
+    if (_updateDepth == 0) return false;
+    if (--_updateDepth > 0) {
+        xSemaphoreGiveRecursive(_mutex);
+        return !_updateCancelled;
+    }
+    
+    std::shared_ptr<ConfigSnapshot> next = _draft;
+    _draft.reset();
+    
+    bool ok = !_updateCancelled;
+    uint32_t changed = 0;
+    if (ok) {
+        int written = persist(*getSnapshot(), *next);
+        if (written < 0) {
+            ok = false;
+        } else if (written > 0) {
+            changed = publish(next);
+            Logger::printf("CONFIG", "Committed %d keys (generation %u)", written, next->generation);
+        }
+    }
+    _updateCancelled = false;
+    
+    xSemaphoreGiveRecursive(_mutex);
+    notify(changed);
+    return ok;
+}
+
+void ConfigStore::cancelUpdate() {
+    if (_updateDepth == 0) return;
+    _updateCancelled = true;
+    commitUpdate();
+}
+
+int ConfigStore::persist(const ConfigSnapshot& current, const ConfigSnapshot& next) {
+    nvs_handle_t handle;
+    if (nvs_open(NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        Logger::error("CONFIG", "NVS open failed, settings not saved");
+        return -1;
+    }
+    
+    esp_err_t err = ESP_OK;
+    int written = 0;
+    auto putString = [&](const char* key, const String& before, const String& after) {
+        if (err != ESP_OK || before == after) return;
+        err = nvs_set_str(handle, key, after.c_str());
+        written++;
+    };
+    auto putUInt = [&](const char* key, uint32_t before, uint32_t after) {
+        if (err != ESP_OK || before == after) return;
+        err = nvs_set_u32(handle, key, after);
+        written++;
+    };
+    
+    // Passwort immer verschleiert und zusammen mit der SSID
+    if (current.ssid != next.ssid || current.password != next.password) {
+        putString("ssid", "", next.ssid);
+        putString("password", "", obfuscate(next.password));
+        if (err == ESP_OK) {
+            err = nvs_set_u8(handle, "pw_obf", 1);
+            written++;
+        }
+    }
+    putString("apikey", current.apiKey, next.apiKey);
+    for (size_t i = 0; i < MAX_STOPS; i++) {
+        putString(stopKey(i, "name").c_str(), current.stops[i].name, next.stops[i].name);
+        putString(stopKey(i, "id").c_str(), current.stops[i].id, next.stops[i].id);
+    }
+    putString("l1_name", current.line1.name, next.line1.name);
+    putString("l1_dir", current.line1.direction, next.line1.direction);
+    putString("l2_name", current.line2.name, next.line2.name);
+    putString("l2_dir", current.line2.direction, next.line2.direction);
+    putUInt("poll_min", current.poll.minSeconds, next.poll.minSeconds);
+    putUInt("poll_max", current.poll.maxSeconds, next.poll.maxSeconds);
+    putString("web_pw", current.webPassword, next.webPassword);
+    
+    // Ein Commit für alle Keys des Blocks
+    if (err == ESP_OK && written > 0) {
+        err = nvs_commit(handle);
+        _nvsCommits++;
+    }
+    nvs_close(handle);
+    
+    if (err != ESP_OK) {
+        Logger::printf("CONFIG", "NVS write failed (%d), settings not saved", (int)err);
+        return -1;
+    }
+    _nvsWrites += written;
+    return written;
+}
+
+ConfigStoreStats ConfigStore::getStats() const {
+    ConfigStoreStats stats;
+    stats.generation = getGeneration();
+    stats.nvsReads = _nvsReads;
+    stats.nvsWrites = _nvsWrites;
+    stats.nvsCommits = _nvsCommits;
+    return stats;
+}
+
 // Wifi
 void ConfigStore::setWifiCredentials(const String& ssid, const String& password) {
-    preferences.putString("ssid", ssid);
-    preferences.putString("password", obfuscate(password));
-    preferences.putBool("pw_obf", true);
+    beginUpdate();
+    _draft->ssid = ssid;
+    _draft->password = password;
+    commitUpdate();
     Logger::info("CONFIG", "Wifi credentials saved");
 }
 
 String ConfigStore::getWifiSSID() {
-    return preferences.getString("ssid", "");
+    return getSnapshot()->ssid;
 }
 
 String ConfigStore::getWifiPassword() {
-    String stored = preferences.getString("password", "");
-    if (stored.length() == 0) return stored;
-    
-    if (preferences.getBool("pw_obf", false)) {
-        return deobfuscate(stored);
-    }
-    return stored;
+    return getSnapshot()->password;
 }
 
 bool ConfigStore::hasWifiConfig() {
-    String ssid = getWifiSSID();
-    return ssid.length() > 0;
+    return getSnapshot()->ssid.length() > 0;
 }
 
 // Transport API
 void ConfigStore::setApiKey(const String& apiKey) {
-    preferences.putString("apikey", apiKey);
+    beginUpdate();
+    _draft->apiKey = apiKey;
+    commitUpdate();
     Logger::info("CONFIG", "API Key saved");
 }
 
 String ConfigStore::getApiKey() {
-    return preferences.getString("apikey", "");
+    return getSnapshot()->apiKey;
 }
 
 // Station
 void ConfigStore::setStation(const String& name, const String& id) {
-    preferences.putString("st_name", name);
-    preferences.putString("st_id", id);
-    Logger::info("CONFIG", ("Station saved: " + name).c_str());
+    setStop(0, name, id);
 }
 
 StationConfig ConfigStore::getStation() {
-    StationConfig config;
-    config.name = preferences.getString("st_name", "");
-    config.id = preferences.getString("st_id", "");
-    return config;
+    return getStop(0);
+}
+
+void ConfigStore::setStop(size_t index, const String& name, const String& id) {
+    if (index >= MAX_STOPS) return;
+    beginUpdate();
+    _draft->stops[index].name = name;
+    _draft->stops[index].id = id;
+    commitUpdate();
+    Logger::info("CONFIG", ("Station saved: " + name).c_str());
+}
+
+StationConfig ConfigStore::getStop(size_t index) {
+    if (index >= MAX_STOPS) return StationConfig();
+    return getSnapshot()->stops[index];
 }
 
 // Lines
 void ConfigStore::setLine1(const String& name, const String& direction) {
-    preferences.putString("l1_name", name);
-    preferences.putString("l1_dir", direction);
+    beginUpdate();
+    _draft->line1.name = name;
+    _draft->line1.direction = direction;
+    commitUpdate();
     Logger::info("CONFIG", "Line 1 saved");
 }
 
 LineConfig ConfigStore::getLine1() {
-    LineConfig config;
-    config.name = preferences.getString("l1_name", "");
-    config.direction = preferences.getString("l1_dir", "");
-    return config;
+    return getSnapshot()->line1;
 }
 
 void ConfigStore::setLine2(const String& name, const String& direction) {
-    preferences.putString("l2_name", name);
-    preferences.putString("l2_dir", direction);
+    beginUpdate();
+    _draft->line2.name = name;
+    _draft->line2.direction = direction;
+    commitUpdate();
     Logger::info("CONFIG", "Line 2 saved");
 }
 
 LineConfig ConfigStore::getLine2() {
-    LineConfig config;
-    config.name = preferences.getString("l2_name", "");
-    config.direction = preferences.getString("l2_dir", "");
-    return config;
+    return getSnapshot()->line2;
+}
+
+// Polling
+void ConfigStore::setPollInterval(uint32_t minSeconds, uint32_t maxSeconds) {
+    beginUpdate();
+    _draft->poll.minSeconds = minSeconds;
+    _draft->poll.maxSeconds = maxSeconds;
+    commitUpdate();
+    Logger::info("CONFIG", "Poll interval saved");
+}
+
+PollConfig ConfigStore::getPollInterval() {
+    return getSnapshot()->poll;
 }
 
 // Web Password
 void ConfigStore::setWebPassword(const String& password) {
-    preferences.putString("web_pw", password);
+    beginUpdate();
+    _draft->webPassword = password;
+    commitUpdate();
     Logger::info("CONFIG", "Web password saved");
 }
 
 String ConfigStore::getWebPassword() {
-    return preferences.getString("web_pw", "");
+    return getSnapshot()->webPassword;
 }
 
 bool ConfigStore::hasWebPassword() {
-    return getWebPassword().length() > 0;
+    return getSnapshot()->webPassword.length() > 0;
 }
 
 // Reset
 void ConfigStore::resetToFactory() {
     Logger::info("CONFIG", "Factory Reset...");
+    xSemaphoreTakeRecursive(_mutex, portMAX_DELAY);
     preferences.clear();
+    uint32_t changed = load();
+    xSemaphoreGiveRecursive(_mutex);
+    notify(changed);
 }
 
 String ConfigStore::obfuscate(const String& input) {
@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 #include <Preferences.h>
+#include <functional>
+#include <memory>
 
 struct StationConfig {
     String name;
@@ -14,12 +16,92 @@ struct LineConfig {
     String direction;
 };
 
+// Grenzen für das adaptive Poll-Intervall (Sekunden)
+struct PollConfig {
+    uint32_t minSeconds;
+    uint32_t maxSeconds;
+};
+
+/**
+ * Unveränderlicher Stand aller Einstellungen im RAM.
+ * Wird nach jedem Commit ersetzt, nie verändert: Leser halten ihn per
+ * shared_ptr ohne Lock. Gleiche `generation` = gleicher Inhalt.
+ */
+struct ConfigSnapshot {
+    static const size_t MAX_STOPS = 3;
+
+    uint32_t generation;        // Steigt mit jedem Commit, 0 = noch nicht geladen
+
+    String ssid;
+    String password;            // Klartext (im NVS verschleiert)
+    String apiKey;
+    StationConfig stops[MAX_STOPS];
+    LineConfig line1;
+    LineConfig line2;
+    PollConfig poll;
+    String webPassword;
+
+    ConfigSnapshot();
+};
+
+typedef std::shared_ptr<const ConfigSnapshot> ConfigSnapshotPtr;
+
+// Welche Einstellungen sich mit einem Commit geändert haben (Bitmaske)
+enum ConfigChange : uint32_t {
+    CONFIG_CHANGE_WIFI         = 1 << 0,    // SSID oder Passwort
+    CONFIG_CHANGE_API_KEY      = 1 << 1,
+    CONFIG_CHANGE_STATION      = 1 << 2,    // Hauptstation (Name oder ID)
+    CONFIG_CHANGE_STOPS        = 1 << 3,    // Zusätzliche Haltestellen
+    CONFIG_CHANGE_LINES        = 1 << 4,    // Line1/Line2
+    CONFIG_CHANGE_POLL         = 1 << 5,
+    CONFIG_CHANGE_WEB_PASSWORD = 1 << 6
+};
+
+// Wird nach einem Commit im Task des Schreibenden aufgerufen (z.B. Webserver):
+// nur Flags setzen oder den eigenen Task wecken, nicht blockieren
+typedef std::function<void(const ConfigSnapshot& config, uint32_t changes)> ConfigListener;
+
+struct ConfigStoreStats {
+    uint32_t generation;
+    uint32_t nvsReads;          // Gelesene Keys seit Boot (nur begin() und Factory Reset)
+    uint32_t nvsWrites;         // Geschriebene Keys seit Boot
+    uint32_t nvsCommits;        // nvs_commit() seit Boot
+};
+
 class ConfigStore {
 public:
+    // Haltestelle 0 ist die Hauptstation (Display), weitere für Multi-Stop-Dashboards
+    static const size_t MAX_STOPS = ConfigSnapshot::MAX_STOPS;
+    static const size_t MAX_LISTENERS = 4;
+    
     ConfigStore();
     
+    // Liest alle Keys einmal aus dem NVS, danach kommen alle Getter aus dem RAM
     void begin();
     
+    // Aktueller Stand, lock-frei. Konsumenten vergleichen `generation` und laden
+    // nur nach, wenn sie sich geändert hat.
+    ConfigSnapshotPtr getSnapshot() const;
+    uint32_t getGeneration() const { return getSnapshot()->generation; }
+    
+    // Mehrere Setter als ein NVS-Commit und eine neue Generation:
+    // beginUpdate(), Setter, commitUpdate(). Verschachtelbar, committed wird beim
+    // äussersten commitUpdate(). cancelUpdate() verwirft alle Änderungen des Blocks.
+    // Setter ausserhalb eines Blocks committen einzeln.
+    // Unveränderte Werte werden nicht geschrieben; ohne Änderung bleibt die Generation.
+    void beginUpdate();
+    bool commitUpdate();
+    void cancelUpdate();
+    
+    ConfigStoreStats getStats() const;
+    
+    // Meldet Commits, die eine der Einstellungen in `mask` ändern. Nur im Setup
+    // aufrufen, maximal MAX_LISTENERS. false = kein Platz mehr
+    bool subscribe(uint32_t mask, ConfigListener listener);
+    
+    // Unterschiede zweier Stände als ConfigChange-Maske
+    static uint32_t changes(const ConfigSnapshot& before, const ConfigSnapshot& after);
+    
     // Wifi
     void setWifiCredentials(const String& ssid, const String& password);
     String getWifiSSID();
@@ -34,12 +116,20 @@ public:
     void setStation(const String& name, const String& id);
     StationConfig getStation();
     
+    // Zusätzliche Haltestellen (index 0 = setStation/getStation, leere ID = nicht belegt)
+    void setStop(size_t index, const String& name, const String& id);
+    StationConfig getStop(size_t index);
+    
     void setLine1(const String& name, const String& direction);
     LineConfig getLine1();
     
     void setLine2(const String& name, const String& direction);
     LineConfig getLine2();
     
+    // Polling
+    void setPollInterval(uint32_t minSeconds, uint32_t maxSeconds);
+    PollConfig getPollInterval();
+    
     // Web Password
     void setWebPassword(const String& password);
     String getWebPassword();
@@ -52,6 +142,40 @@ private:
     Preferences preferences;
     const char* NAMESPACE = "crowpanel";
 
+    // Veröffentlichter Stand, nur über std::atomic_load/atomic_store zugreifen
+    ConfigSnapshotPtr _snapshot;
+    
+    // Schreibender Block (unter _mutex, rekursiv für verschachtelte Setter)
+    SemaphoreHandle_t _mutex;
+    std::shared_ptr<ConfigSnapshot> _draft;
+    uint8_t _updateDepth;
+    bool _updateCancelled;
+    
+    uint32_t _nvsReads;
+    uint32_t _nvsWrites;
+    uint32_t _nvsCommits;
+    
+    struct Listener {
+        uint32_t mask;
+        ConfigListener callback;
+    };
+    Listener _listeners[MAX_LISTENERS];
+    size_t _listenerCount;
+
+    // Liest alle Keys und veröffentlicht sie als neue Generation, Rückgabe: Änderungen
+    uint32_t load();
+    
+    // Tauscht den Stand aus (unter _mutex), Rückgabe: Änderungen gegenüber dem alten
+    uint32_t publish(std::shared_ptr<ConfigSnapshot> next);
+    
+    // Ruft die betroffenen Listener auf (ohne _mutex)
+    void notify(uint32_t changes);
+    String readString(const char* key, const String& fallback);
+    
+    // Schreibt die Unterschiede von `next` gegenüber `current` in einem Commit.
+    // Rückgabe: Anzahl geschriebener Keys, -1 bei Fehler (RAM-Stand bleibt dann der alte)
+    int persist(const ConfigSnapshot& current, const ConfigSnapshot& next);
+
     // XOR-basierte Verschleierung (kein echtes Krypto — Stepping Stone bis NVS Encryption)
     String obfuscate(const String& input);
     String deobfuscate(const String& input);
@@ -59,5 +183,24 @@ private:
     uint64_t _macKey;
 };
 
-#endif // CONFIG_STORE_H
+// Schreibblock für Funktionen mit mehreren Ausstiegen (z.B. Validierungsfehler):
+// ohne commit() werden die Änderungen beim Verlassen des Scopes verworfen
+class ConfigUpdate {
+public:
+    explicit ConfigUpdate(ConfigStore* store) : _store(store), _open(true) { _store->beginUpdate(); }
+    ~ConfigUpdate() { if (_open) _store->cancelUpdate(); }
 
+    bool commit() {
+        _open = false;
+        return _store->commitUpdate();
+    }
+
+private:
+    ConfigStore* _store;
+    bool _open;
+
+    ConfigUpdate(const ConfigUpdate&);
+    ConfigUpdate& operator=(const ConfigUpdate&);
+};
+
+#endif // CONFIG_STORE_H
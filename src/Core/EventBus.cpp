@@ -0,0 +1,41 @@
+#include "EventBus.h"
+#include <atomic>
+
+namespace {
+
+struct Subscriber {
+    QueueHandle_t queue;
+    bool lossy;
+};
+
+Subscriber subscribers[EventBus::MAX_SUBSCRIBERS];
+
+// Eintrag wird vor dem Hochzählen geschrieben: publish() sieht nur fertige Einträge
+std::atomic<size_t> subscriberCount(0);
+
+portMUX_TYPE subscribeLock = portMUX_INITIALIZER_UNLOCKED;
+
+} // namespace
+
+bool EventBus::subscribe(QueueHandle_t queue, bool lossy) {
+    if (!queue) return false;
+
+    bool added = false;
+    portENTER_CRITICAL(&subscribeLock);
+    size_t count = subscriberCount.load(std::memory_order_relaxed);
+    if (count < MAX_SUBSCRIBERS) {
+        subscribers[count].queue = queue;
+        subscribers[count].lossy = lossy;
+        subscriberCount.store(count + 1, std::memory_order_release);
+        added = true;
+    }
+    portEXIT_CRITICAL(&subscribeLock);
+    return added;
+}
+
+void EventBus::publish(SystemEvent event, TickType_t wait) {
+    size_t count = subscriberCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; i++) {
+        xQueueSend(subscribers[i].queue, &event, subscribers[i].lossy ? 0 : wait);
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <Arduino.h>
+#include "SystemEvents.h"
+
+/**
+ * Verteilt System-Events an alle abonnierten Queues (Display, Web-Push, ...).
+ * Produzenten kennen damit weder den DisplayManager noch die Web-Oberfläche.
+ *
+ * Verlustfreie Abonnenten (Display) bekommen jedes Event, notfalls wartet
+ * publish() bis `wait`. Verlustbehaftete Abonnenten lesen nur "es hat sich
+ * etwas geändert" und den aktuellen Zustand selbst nach: ist ihre Queue voll,
+ * wird das Event verworfen statt den Produzenten aufzuhalten.
+ */
+class EventBus {
+public:
+    static const size_t MAX_SUBSCRIBERS = 4;
+
+    // Im Setup aufrufen. false wenn bereits MAX_SUBSCRIBERS Queues eingetragen sind.
+    static bool subscribe(QueueHandle_t queue, bool lossy = false);
+
+    // Aus beliebigen Tasks aufrufbar (nicht aus ISRs)
+    static void publish(SystemEvent event, TickType_t wait = 0);
+};
+
+#endif // EVENT_BUS_H
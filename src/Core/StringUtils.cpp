@@ -1,55 +1,99 @@
 #include "StringUtils.h"
+#include <string.h>
 
-String StringUtils::toASCII(const String& input) {
-    String output = "";
-    
-    for (unsigned int i = 0; i < input.length(); i++) {
-        unsigned char c = input[i];
-        
-        // Prüfe ob es ein UTF-8 Multi-Byte Zeichen ist
-        if (c >= 0xC0 && c <= 0xDF && i + 1 < input.length()) {
-            // 2-Byte UTF-8 Zeichen
-            unsigned char c2 = input[i + 1];
-            
-            // Deutsche Umlaute (UTF-8)
-            if (c == 0xC3) {
-                switch (c2) {
-                    case 0xA4: output += "ae"; break; // ä
-                    case 0x84: output += "Ae"; break; // Ä
-                    case 0xB6: output += "oe"; break; // ö
-                    case 0x96: output += "Oe"; break; // Ö
-                    case 0xBC: output += "ue"; break; // ü
-                    case 0x9C: output += "Ue"; break; // Ü
-                    case 0x9F: output += "ss"; break; // ß
-                    case 0xA9: output += "e";  break; // é
-                    case 0x89: output += "E";  break; // É
-                    case 0xA8: output += "e";  break; // è
-                    case 0x88: output += "E";  break; // È
-                    case 0xAA: output += "e";  break; // ê
-                    case 0x8A: output += "E";  break; // Ê
-                    case 0xA0: output += "a";  break; // à
-                    case 0x80: output += "A";  break; // À
-                    default: 
-                        // Unbekanntes Zeichen, nehme Original
-                        output += (char)c;
-                        output += (char)c2;
-                        break;
-                }
-                i++; // Skip next byte
-            } else {
-                // Anderes 2-Byte Zeichen, behalte Original
-                output += (char)c;
-            }
-        } else if (c >= 0x20 && c < 0x7F) {
-            // Normales ASCII Zeichen (32-126)
-            output += (char)c;
-        } else if (c == 0x0A || c == 0x0D) {
-            // Newline / Carriage Return
-            output += (char)c;
+namespace {
+
+const uint32_t TABLE_FIRST = 0x00A0;
+const uint32_t TABLE_LAST = 0x017F;
+const uint32_t PUNCT_FIRST = 0x2010;
+const uint32_t PUNCT_LAST = 0x201F;
+
+// Ersatztext pro Codepoint U+00A0..U+017F (max. 3 Zeichen, "" = weglassen).
+// Die deutschen Umlaute werden ausgeschrieben, sonst fällt das diakritische Zeichen weg.
+constexpr char TRANSLIT[TABLE_LAST - TABLE_FIRST + 1][4] = {
+    // Latin-1 Supplement
+    " ", "!", "c", "L", "", "Y", "|", "S", "\"", "(c)", "a", "\"", "-", "", "(R)", "-",  // U+00A0: NBSP ¡ ¢ £ ¤ ¥ ¦ § ¨ © ª « ¬ SHY ® ¯
+    "o", "+-", "2", "3", "'", "u", "P", ".", ",", "1", "o", "\"", "1/4", "1/2", "3/4", "?",  // U+00B0: ° ± ² ³ ´ µ ¶ · ¸ ¹ º » ¼ ½ ¾ ¿
+    "A", "A", "A", "A", "Ae", "A", "AE", "C", "E", "E", "E", "E", "I", "I", "I", "I",  // U+00C0: À Á Â Ã Ä Å Æ Ç È É Ê Ë Ì Í Î Ï
+    "D", "N", "O", "O", "O", "O", "Oe", "x", "O", "U", "U", "U", "Ue", "Y", "Th", "ss",  // U+00D0: Ð Ñ Ò Ó Ô Õ Ö × Ø Ù Ú Û Ü Ý Þ ß
+    "a", "a", "a", "a", "ae", "a", "ae", "c", "e", "e", "e", "e", "i", "i", "i", "i",  // U+00E0: à á â ã ä å æ ç è é ê ë ì í î ï
+    "d", "n", "o", "o", "o", "o", "oe", ":", "o", "u", "u", "u", "ue", "y", "th", "y",  // U+00F0: ð ñ ò ó ô õ ö ÷ ø ù ú û ü ý þ ÿ
+    // Latin Extended-A
+    "A", "a", "A", "a", "A", "a", "C", "c", "C", "c", "C", "c", "C", "c", "D", "d",  // U+0100: Ā ā Ă ă Ą ą Ć ć Ĉ ĉ Ċ ċ Č č Ď ď
+    "D", "d", "E", "e", "E", "e", "E", "e", "E", "e", "E", "e", "G", "g", "G", "g",  // U+0110: Đ đ Ē ē Ĕ ĕ Ė ė Ę ę Ě ě Ĝ ĝ Ğ ğ
+    "G", "g", "G", "g", "H", "h", "H", "h", "I", "i", "I", "i", "I", "i", "I", "i",  // U+0120: Ġ ġ Ģ ģ Ĥ ĥ Ħ ħ Ĩ ĩ Ī ī Ĭ ĭ Į į
+    "I", "i", "IJ", "ij", "J", "j", "K", "k", "k", "L", "l", "L", "l", "L", "l", "L",  // U+0130: İ ı Ĳ ĳ Ĵ ĵ Ķ ķ ĸ Ĺ ĺ Ļ ļ Ľ ľ Ŀ
+    "l", "L", "l", "N", "n", "N", "n", "N", "n", "n", "N", "n", "O", "o", "O", "o",  // U+0140: ŀ Ł ł Ń ń Ņ ņ Ň ň ŉ Ŋ ŋ Ō ō Ŏ ŏ
+    "O", "o", "OE", "oe", "R", "r", "R", "r", "R", "r", "S", "s", "S", "s", "S", "s",  // U+0150: Ő ő Œ œ Ŕ ŕ Ŗ ŗ Ř ř Ś ś Ŝ ŝ Ş ş
+    "S", "s", "T", "t", "T", "t", "T", "t", "U", "u", "U", "u", "U", "u", "U", "u",  // U+0160: Š š Ţ ţ Ť ť Ŧ ŧ Ũ ũ Ū ū Ŭ ŭ Ů ů
+    "U", "u", "U", "u", "W", "w", "Y", "y", "Y", "Z", "z", "Z", "z", "Z", "z", "s",  // U+0170: Ű ű Ų ų Ŵ ŵ Ŷ ŷ Ÿ Ź ź Ż ż Ž ž ſ
+};
+
+// Typografische Striche und Anführungszeichen U+2010..U+201F
+constexpr char PUNCTUATION[PUNCT_LAST - PUNCT_FIRST + 1][2] = {
+    "-", "-", "-", "-", "-", "-", "|", "_",        // ‐ ‑ ‒ – — ― ‖ ‗
+    "'", "'", "'", "'", "\"", "\"", "\"", "\"",    // ‘ ’ ‚ ‛ “ ” „ ‟
+};
+
+const char* replacement(uint32_t codepoint) {
+    if (codepoint >= TABLE_FIRST && codepoint <= TABLE_LAST) return TRANSLIT[codepoint - TABLE_FIRST];
+    if (codepoint >= PUNCT_FIRST && codepoint <= PUNCT_LAST) return PUNCTUATION[codepoint - PUNCT_FIRST];
+    if (codepoint == 0x2026) return "...";  // …
+    return "";
+}
+
+} // namespace
+
+size_t StringUtils::toASCII(const char* input, char* out, size_t capacity) {
+    if (!out || capacity == 0) return 0;
+
+    const size_t limit = capacity - 1;
+    const uint8_t* p = (const uint8_t*)(input ? input : "");
+    size_t len = 0;
+
+    while (*p && len < limit) {
+        uint8_t c = *p++;
+
+        if (c < 0x80) {
+            // Druckbares ASCII (32-126) sowie Newline / Carriage Return
+            if ((c >= 0x20 && c < 0x7F) || c == '\n' || c == '\r') out[len++] = (char)c;
+            continue;
+        }
+
+        // Länge der UTF-8 Sequenz aus dem Startbyte
+        uint32_t codepoint;
+        size_t follow;
+        if ((c & 0xE0) == 0xC0) { codepoint = c & 0x1F; follow = 1; }
+        else if ((c & 0xF0) == 0xE0) { codepoint = c & 0x0F; follow = 2; }
+        else if ((c & 0xF8) == 0xF0) { codepoint = c & 0x07; follow = 3; }
+        else continue;  // Folgebyte ohne Startbyte: ignorieren
+
+        size_t i = 0;
+        for (; i < follow && (p[i] & 0xC0) == 0x80; i++) {
+            codepoint = (codepoint << 6) | (p[i] & 0x3F);
+        }
+        p += i;
+        if (i < follow) continue;  // Abgebrochene Sequenz
+
+        for (const char* r = replacement(codepoint); *r && len < limit; r++) {
+            out[len++] = *r;
         }
-        // Alle anderen Zeichen werden ignoriert
     }
-    
+
+    out[len] = '\0';
+    return len;
+}
+
+String StringUtils::toASCII(const String& input) {
+    // Ersatztexte sind höchstens 1.5x so lang wie die UTF-8 Sequenz (2 Bytes -> 3 Zeichen)
+    size_t capacity = input.length() + input.length() / 2 + 1;
+    char stackBuffer[96];
+    char* buffer = (capacity <= sizeof(stackBuffer)) ? stackBuffer : new char[capacity];
+
+    toASCII(input.c_str(), buffer, capacity);
+    String output(buffer);
+
+    if (buffer != stackBuffer) delete[] buffer;
     return output;
 }
 
@@ -67,3 +111,20 @@ String StringUtils::getStationNameOnly(const String& fullName) {
     // Kein Komma gefunden, gib den ganzen Namen zurück
     return fullName;
 }
+
+size_t StringUtils::split(const String& line, char separator, String* fields, size_t count) {
+    const char* start = line.c_str();
+    size_t n = 0;
+    while (n < count) {
+        const char* end = strchr(start, separator);
+        if (!end) {
+            fields[n++] = String(start);
+            break;
+        }
+        String field;
+        field.concat(start, end - start);
+        fields[n++] = field;
+        start = end + 1;
+    }
+    return n;
+}
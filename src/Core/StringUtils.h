@@ -5,13 +5,24 @@
 
 class StringUtils {
 public:
-    // Konvertiert deutsche Umlaute zu ASCII-Äquivalenten
-    // ä -> ae, ö -> oe, ü -> ue, ß -> ss, etc.
+    // Transliteriert UTF-8 nach ASCII für die Display-Fonts (nur 0x20..0x7E).
+    // Tabellengesteuert für Latin-1 Supplement und Latin Extended-A
+    // (ä -> ae, ß -> ss, é -> e, č -> c, ł -> l, ...), typografische
+    // Anführungszeichen/Striche werden zu ' " -. Unbekannte Zeichen fallen weg.
+    //
+    // Ein Durchlauf direkt in `out` (inkl. '\0', wird ggf. gekürzt).
+    // Rückgabe: Länge ohne '\0'. Die Ausgabe ist höchstens 1.5x so lang wie die Eingabe.
+    static size_t toASCII(const char* input, char* out, size_t capacity);
+
     static String toASCII(const String& input);
     
     // Extrahiert nur den Stationsnamen (Teil nach dem Komma)
     // "Zürich, Bucheggplatz" -> "Bucheggplatz"
     static String getStationNameOnly(const String& fullName);
+
+    // Zerlegt eine Zeile an `separator` in höchstens `count` Felder
+    // ("a\tb\tc" -> "a", "b", "c"). Rückgabe: Anzahl gefundener Felder.
+    static size_t split(const String& line, char separator, String* fields, size_t count);
 };
 
 #endif // STRING_UTILS_H
@@ -26,7 +26,11 @@ enum SystemEvent {
     EVENT_INTERNET_OK,
 
     // Time
-    EVENT_TIME_SYNCED
+    EVENT_TIME_SYNCED,
+    EVENT_MINUTE_TICK,    // Minutenwechsel, vom Display-Task selbst ausgelöst (Countdown)
+    
+    // Config
+    EVENT_CONFIG_CHANGED  // Hauptstation geändert (nur an das Display, aus dem ConfigStore-Listener)
 };
 
 #endif // SYSTEM_EVENTS_H
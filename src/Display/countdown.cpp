@@ -0,0 +1,62 @@
+#include "countdown.h"
+
+namespace {
+
+// Zeiten vor 2020 bedeuten: Uhr noch nicht per NTP synchronisiert
+const time_t MIN_VALID_TIME = 1577836800;
+
+} // namespace
+
+bool Countdown::clockValid(time_t now) {
+    return now >= MIN_VALID_TIME;
+}
+
+bool Countdown::departed(const Departure& dep, time_t now) {
+    return dep.getEffectiveTime() < now;
+}
+
+int Countdown::minutesUntil(time_t departure, time_t now) {
+    // Ganze Minuten seit 1970: Schweizer Zeitzonen sind volle Stunden, die
+    // Minutengrenzen sind damit dieselben wie auf der angezeigten Uhr
+    long minutes = (long)(departure / 60) - (long)(now / 60);
+    return minutes > 0 ? (int)minutes : 0;
+}
+
+size_t Countdown::visible(const DepartureList& list, time_t now, const Departure** rows, size_t capacity) {
+    bool timeValid = clockValid(now);
+    size_t count = 0;
+    for (const Departure& dep : list) {
+        if (count >= capacity) break;
+        if (timeValid && departed(dep, now)) continue;
+        rows[count++] = &dep;
+    }
+    return count;
+}
+
+size_t Countdown::departedAhead(const DepartureList& list, time_t now) {
+    if (!clockValid(now)) return 0;
+    size_t count = 0;
+    for (const Departure& dep : list) {
+        if (!departed(dep, now)) break;
+        count++;
+    }
+    return count;
+}
+
+uint32_t Countdown::msUntilTick(time_t now) {
+    return (uint32_t)(60 - now % 60) * 1000 + TICK_MARGIN_MS;
+}
+
+TickAction Countdown::onTick(const DepartureList& list, time_t now, size_t rows, bool offline) {
+    if (!clockValid(now)) return TICK_NONE;
+    if (offline) return TICK_RENDER;
+
+    size_t gone = 0;
+    for (const Departure& dep : list) {
+        if (departed(dep, now)) gone++;
+    }
+    // Nichts abgefahren: ein Poll brächte keine zusätzlichen Zeilen
+    if (gone == 0) return TICK_RENDER;
+    // Keine Reserve mehr: der nächste abfahrende Kurs hinterliesse eine Lücke
+    return list.size() - gone <= rows ? TICK_REFETCH : TICK_RENDER;
+}
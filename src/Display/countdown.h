@@ -0,0 +1,55 @@
+#ifndef COUNTDOWN_H
+#define COUNTDOWN_H
+
+#include <Arduino.h>
+#include <time.h>
+#include "../Transport/TransportTypes.h"
+
+// Was der minütliche Tick des Displays tun soll
+enum TickAction : uint8_t {
+    TICK_NONE,      // Keine gültige Uhrzeit: Zeilen zeigen die Abfahrtszeit, nichts zählt
+    TICK_RENDER,    // Lokal neu berechnen (Minuten, abgefahrene Zeilen), kein Request
+    TICK_REFETCH    // Lokal neu berechnen und Poll anfordern: Reserve zum Nachrücken aufgebraucht
+};
+
+/**
+ * Countdown der Abfahrten aus dem zuletzt empfangenen Snapshot.
+ *
+ * Die Minuten werden auf Minutengrenzen der Uhr gerechnet (Abfahrt 12:05:40
+ * um 12:03:10 = 2'), damit alle Zeilen zusammen mit der Uhrzeit im Header
+ * umspringen und ein Tick pro Minute genügt. Abgefahrene Kurse werden
+ * übersprungen, spätere aus der tieferen Liste rücken nach.
+ *
+ * Reine Logik ohne RTOS/Display: die Uhrzeit wird übergeben.
+ */
+class Countdown {
+public:
+    // Tick kurz nach dem Minutenwechsel, damit time() sicher schon umgesprungen ist
+    static const uint32_t TICK_MARGIN_MS = 500;
+
+    // Uhr per NTP synchronisiert, erst dann wird heruntergezählt
+    static bool clockValid(time_t now);
+
+    // Abfahrt (inkl. Prognose) liegt vor `now`
+    static bool departed(const Departure& dep, time_t now);
+
+    // Minuten bis zur Abfahrt auf Minutengrenzen, nie negativ
+    static int minutesUntil(time_t departure, time_t now);
+
+    // Die ersten `capacity` noch nicht abgefahrenen Abfahrten. Ohne gültige
+    // Uhrzeit wird nichts aussortiert. Rückgabe: Anzahl in `rows`
+    static size_t visible(const DepartureList& list, time_t now, const Departure** rows, size_t capacity);
+
+    // Anzahl abgefahrener Kurse vor der ersten angezeigten Zeile
+    static size_t departedAhead(const DepartureList& list, time_t now);
+
+    // Wartezeit bis zum nächsten Tick (ms)
+    static uint32_t msUntilTick(time_t now);
+
+    // Entscheidung beim Tick für eine Liste mit `rows` Zeilen auf dem Display.
+    // Nachladen nur, wenn Kurse abgefahren sind und keine Reserve mehr
+    // nachrücken kann. Offline (Cache) lädt nie nach, das regelt der Poll-Backoff.
+    static TickAction onTick(const DepartureList& list, time_t now, size_t rows, bool offline);
+};
+
+#endif // COUNTDOWN_H
@@ -0,0 +1,74 @@
+#include "dirty_regions.h"
+
+// Layout des Dashboards (400x300), siehe DisplayManager::drawDashboard()
+const DisplayRect DirtyRegions::LAYOUT[REGION_COUNT] = {
+    {   0,   0, 232,  40 },   // REGION_TITLE: Stationsname
+    { 232,   0, 136,  40 },   // REGION_CLOCK: Uhrzeit
+    { 368,   0,  32,  40 },   // REGION_WIFI: Signalstärke
+    {   0,  50, 336,  55 },   // REGION_ROW_0: Linie, Zielort
+    { 336,  50,  64,  55 },   // REGION_TIME_0: Minuten (rechtsbündig, max. 3 Zeichen)
+    {   0, 105, 336,  55 },   // REGION_ROW_1
+    { 336, 105,  64,  55 },   // REGION_TIME_1
+    {   0, 160, 336,  55 },   // REGION_ROW_2
+    { 336, 160,  64,  55 },   // REGION_TIME_2
+    {   0, 215, 336,  55 },   // REGION_ROW_3
+    { 336, 215,  64,  55 },   // REGION_TIME_3
+    {   0, 270, 400,  30 },   // REGION_FOOTER
+};
+
+static_assert(REGION_COUNT <= 16, "Dirty mask is 16 bit");
+
+DirtyRegions::DirtyRegions() : _dirtyMask(0), _valid(false) {
+    memset(_shown, 0, sizeof(_shown));
+    memset(_pending, 0, sizeof(_pending));
+}
+
+void DirtyRegions::invalidate() {
+    _valid = false;
+    _dirtyMask = (1U << REGION_COUNT) - 1;
+}
+
+void DirtyRegions::set(DashboardRegion region, uint32_t signature) {
+    _pending[region] = signature;
+    if (!_valid || _shown[region] != signature) {
+        _dirtyMask |= 1U << region;
+    } else {
+        _dirtyMask &= ~(1U << region);
+    }
+}
+
+size_t DirtyRegions::windows(DisplayRect* out, size_t capacity) const {
+    size_t count = 0;
+    for (uint8_t i = 0; i < REGION_COUNT; i++) {
+        if (!(_dirtyMask & (1U << i))) continue;
+        const DisplayRect& rect = LAYOUT[i];
+
+        // An das vorherige Fenster anhängen, wenn die Vereinigung wieder ein Rechteck ist
+        if (count > 0 && merge(out[count - 1], rect)) {
+            // Zeile + Minuten ergeben wieder die volle Breite: ggf. mit der Zeile darüber vereinen
+            if (count > 1 && merge(out[count - 2], out[count - 1])) count--;
+            continue;
+        }
+        if (count == capacity) break;
+        out[count++] = rect;
+    }
+    return count;
+}
+
+bool DirtyRegions::merge(DisplayRect& into, const DisplayRect& rect) {
+    if (into.y == rect.y && into.h == rect.h && into.x + into.w == rect.x) {
+        into.w += rect.w;
+        return true;
+    }
+    if (into.x == rect.x && into.w == rect.w && into.y + into.h == rect.y) {
+        into.h += rect.h;
+        return true;
+    }
+    return false;
+}
+
+void DirtyRegions::commit() {
+    memcpy(_shown, _pending, sizeof(_shown));
+    _dirtyMask = 0;
+    _valid = true;
+}
@@ -0,0 +1,68 @@
+#ifndef DIRTY_REGIONS_H
+#define DIRTY_REGIONS_H
+
+#include <Arduino.h>
+
+// Bereiche des Dashboards, die einzeln per Partial Refresh aktualisiert werden
+enum DashboardRegion : uint8_t {
+    REGION_TITLE,
+    REGION_CLOCK,
+    REGION_WIFI,
+    REGION_ROW_0,       // Linie und Zielort
+    REGION_TIME_0,      // Minuten: ändert sich beim Countdown allein
+    REGION_ROW_1,
+    REGION_TIME_1,
+    REGION_ROW_2,
+    REGION_TIME_2,
+    REGION_ROW_3,
+    REGION_TIME_3,
+    REGION_FOOTER,
+    REGION_COUNT
+};
+
+// Rechteck in Display-Koordinaten (x und w Vielfache von 8 für GxEPD2 Partial Windows)
+struct DisplayRect {
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+};
+
+/**
+ * Merkt sich pro Bereich eine Signatur des zuletzt angezeigten Inhalts.
+ * Ein Bereich ist "dirty", wenn sich seine Signatur seit dem letzten
+ * commit() geändert hat. Nebeneinanderliegende dirty Bereiche werden zu
+ * möglichst wenigen Partial Windows zusammengefasst.
+ */
+class DirtyRegions {
+public:
+    static const DisplayRect LAYOUT[REGION_COUNT];
+
+    DirtyRegions();
+
+    // Alles neu zeichnen (z.B. nach Full Refresh oder Screen-Wechsel)
+    void invalidate();
+
+    // Neue Signatur für einen Bereich setzen
+    void set(DashboardRegion region, uint32_t signature);
+
+    bool isDirty(DashboardRegion region) const { return (_dirtyMask & (1U << region)) != 0; }
+    bool any() const { return _dirtyMask != 0; }
+
+    // Zusammengefasste dirty Rechtecke, Rückgabe: Anzahl (max. `capacity`)
+    size_t windows(DisplayRect* out, size_t capacity) const;
+
+    // Aktuelle Signaturen gelten jetzt als angezeigt
+    void commit();
+
+private:
+    uint32_t _shown[REGION_COUNT];
+    uint32_t _pending[REGION_COUNT];
+    uint16_t _dirtyMask;
+    bool _valid;
+
+    // Hängt `rect` an `into` an, wenn die Vereinigung wieder ein Rechteck ist
+    static bool merge(DisplayRect& into, const DisplayRect& rect);
+};
+
+#endif // DIRTY_REGIONS_H
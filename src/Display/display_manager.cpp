@@ -7,9 +7,14 @@
 #include <Fonts/FreeSans9pt7b.h>
 #include <Fonts/FreeSansBold9pt7b.h>
 
-DisplayManager::DisplayManager(GxEPD2_BW<GxEPD2_420_GYE042A87, GxEPD2_420_GYE042A87::HEIGHT>* disp)
-    : display(disp), initialized(false), updateCounter(0), taskHandle(NULL), eventQueue(NULL), currentState(STATE_BOOT) {
+DisplayManager::DisplayManager(DisplayPanel* disp)
+    : display(disp), initialized(false), updateCounter(0), taskHandle(NULL), eventQueue(NULL), currentState(STATE_BOOT),
+      frameBuffer(GxEPD2_420_GYE042A87::WIDTH, GxEPD2_420_GYE042A87::HEIGHT), gfx(disp),
+      shownState(STATE_BOOT), frameShown(false), shownFrameHash(0), panelRamValid(false), partialsSinceFull(0), lastFullRefresh(0),
+      renderTimeValid(false), renderNow(0), renderWifi(false), renderRssi(0) {
     stationName = "Station";
+    memset(&refreshStats, 0, sizeof(refreshStats));
+    memset(&renderTime, 0, sizeof(renderTime));
 }
 
 void DisplayManager::begin(QueueHandle_t queue) {
@@ -39,9 +44,14 @@ void DisplayManager::taskCode(void* pvParameters) {
     instance->update(EVENT_INIT);
 
     for(;;) {
-        if (xQueueReceive(instance->eventQueue, &event, portMAX_DELAY) == pdTRUE) {
+        // Auf dem Dashboard spätestens zum Minutenwechsel aufwachen: Countdown lokal weiterzählen
+        long tickMs = instance->msUntilTick();
+        TickType_t timeout = tickMs < 0 ? portMAX_DELAY : pdMS_TO_TICKS(tickMs);
+        if (xQueueReceive(instance->eventQueue, &event, timeout) == pdTRUE) {
             Logger::printf("TASK_DISPLAY", "Display event received: %d", event);
             instance->update(event);
+        } else {
+            instance->onMinuteTick();
         }
     }
 }
@@ -57,6 +67,15 @@ bool DisplayManager::init() {
     display->setRotation(0);
     display->setTextColor(GxEPD_BLACK);
 
+    // UI wird offscreen gezeichnet; ohne Puffer direkt in den GxEPD2 Seitenpuffer (immer Full Refresh)
+    if (frameBuffer.begin()) {
+        gfx = &frameBuffer;
+        gfx->setTextColor(GxEPD_BLACK);
+        Logger::info("DISPLAY", "Framebuffer allocated");
+    } else {
+        Logger::error("DISPLAY", "Framebuffer allocation failed, drawing directly");
+    }
+
     initialized = true;
     Logger::info("DISPLAY", "Initialization successful!");
 
@@ -68,6 +87,7 @@ void DisplayManager::hibernate() {
 
     display->hibernate();
     digitalWrite(EPD_PWR_PIN, LOW);
+    panelRamValid = false; // Stromlos: nächstes Update muss ein Full Refresh sein
     Logger::info("DISPLAY", "Hibernating...");
 }
 
@@ -79,16 +99,16 @@ void DisplayManager::wakeup() {
     Logger::info("DISPLAY", "Waking up...");
 }
 
-void DisplayManager::setDepartures(const std::vector<Departure>& departures) {
-    this->currentDepartures = departures;
+void DisplayManager::setDepartures(DepartureSnapshotPtr snapshot) {
+    this->currentSnapshot = snapshot;
 }
 
 void DisplayManager::setStationName(String name) {
-    this->stationName = name;
+    this->stationName = StringUtils::toASCII(name);
 }
 
 void DisplayManager::setErrorMessage(String msg) {
-    this->errorMessage = msg;
+    this->errorMessage = StringUtils::toASCII(msg);
     this->currentState = STATE_ERROR;
 }
 
@@ -96,6 +116,14 @@ void DisplayManager::setDataProvider(DataProvider provider) {
     this->dataProvider = provider;
 }
 
+void DisplayManager::setStationNameProvider(StationNameProvider provider) {
+    this->stationNameProvider = provider;
+}
+
+void DisplayManager::setRefetchRequest(RefetchRequest request) {
+    this->refetchRequest = request;
+}
+
 void DisplayManager::update(SystemEvent event) {
     if (!initialized) {
         Logger::error("DISPLAY", "Not initialized!");
@@ -105,7 +133,22 @@ void DisplayManager::update(SystemEvent event) {
     // Handle Data Update
     if (event == EVENT_DATA_AVAILABLE && dataProvider) {
         Logger::info("DISPLAY", "Fetching new data from provider...");
-        currentDepartures = dataProvider();
+        DepartureSnapshotPtr snapshot = dataProvider();
+        // Angezeigt werden die ersten VISIBLE_ROWS nicht abgefahrenen Kurse
+        size_t shownRows = snapshot ? Countdown::departedAhead(snapshot->stop(0), time(NULL)) + VISIBLE_ROWS : 0;
+        if (snapshot && currentSnapshot && currentState == STATE_DASHBOARD &&
+            snapshot->offline == currentSnapshot->offline &&
+            (snapshot->generation == currentSnapshot->generation ||
+             (snapshot->generation == currentSnapshot->generation + 1 &&
+              !snapshot->changes[0].affects(shownRows)))) {
+            // Gleiche Daten oder Änderungen nur ausserhalb der angezeigten Zeilen
+            // (andere Haltestelle, spätere Abfahrten): kein E-Paper Refresh nötig.
+            // Wechsel zwischen live und offline ändert den Footer, dort nie überspringen.
+            currentSnapshot = snapshot;
+            Logger::info("DISPLAY", "No visible change, skipping refresh");
+            return;
+        }
+        currentSnapshot = snapshot;
         currentState = STATE_DASHBOARD; // Switch to dashboard if we get data
     }
 
@@ -121,36 +164,164 @@ void DisplayManager::update(SystemEvent event) {
             }
             break;
         case EVENT_WIFI_LOST:
+            // Mit Abfahrten bleibt das Dashboard stehen (Footer zeigt "Offline"),
+            // das TransportModule rechnet danach aus dem Offline-Cache weiter
+            if (currentState == STATE_DASHBOARD && hasDepartures()) break;
             currentState = STATE_ERROR;
             errorMessage = "WLAN Verbindung verloren!";
             break;
+        case EVENT_CONFIG_CHANGED:
+            // Neue Hauptstation ohne Neustart: Name übernehmen, die Liste hat das
+            // TransportModule schon geleert, der Poll für die neue Station läuft
+            if (stationNameProvider) setStationName(stationNameProvider());
+            if (dataProvider) currentSnapshot = dataProvider();
+            break;
         case EVENT_INIT:
-            currentState = STATE_BOOT;
+            // Offline-Cache schon geladen: direkt das Dashboard statt des Boot-Screens
+            currentSnapshot = dataProvider ? dataProvider() : DepartureSnapshotPtr();
+            currentState = hasDepartures() ? STATE_DASHBOARD : STATE_BOOT;
             break;
         default:
             // Bleibe im aktuellen State
             break;
     }
 
+    captureRenderState();
+
+    bool buffered = frameBuffer.valid();
+    uint32_t frameHash = 0;
+    if (buffered) {
+        // UI einmal offscreen zeichnen; gleiches Bild wie auf dem Panel = nichts zu tun
+        drawUI(event);
+        frameHash = frameBuffer.hash(frameBuffer.bounds());
+        if (frameShown && frameHash == shownFrameHash) {
+            refreshStats.skipped++;
+            Logger::printf("DISPLAY", "Frame unchanged (Event: %d), skipping refresh", event);
+            return;
+        }
+    }
+
+    // Partial Refresh nur innerhalb des Dashboards und solange das Controller-RAM das Bild noch kennt
+    bool partial = buffered && currentState == STATE_DASHBOARD && shownState == STATE_DASHBOARD &&
+                   panelRamValid && !fullRefreshDue();
+    if (buffered && currentState == STATE_DASHBOARD) {
+        updateRegions();
+    }
+
     wakeup();
 
-    Logger::printf("DISPLAY", "Updating (Event: %d, State: %d)...", event, currentState);
+    Logger::printf("DISPLAY", "Updating (Event: %d, State: %d, %s)...", event, currentState,
+                   partial ? "partial" : "full");
 
-    display->setFullWindow();
-    display->firstPage();
-    do {
-        drawUI(event);
-    } while (display->nextPage());
+    unsigned long start = millis();
+    if (partial) {
+        refreshPartial();
+    } else {
+        refreshFull(event);
+    }
+    refreshStats.lastRefreshMs = millis() - start;
+    regions.commit();
+    shownState = currentState;
+    frameShown = buffered;
+    shownFrameHash = frameHash;
 
     updateCounter++;
 
-    Logger::info("DISPLAY", "Update complete!");
+    Logger::printf("DISPLAY", "Update complete (%d ms, %d bytes, %d windows)",
+                   refreshStats.lastRefreshMs, refreshStats.lastBytes, refreshStats.lastWindows);
+    
+    if (refreshStats.firstDeparturesMs == 0 && currentState == STATE_DASHBOARD && hasDepartures()) {
+        refreshStats.firstDeparturesMs = millis();
+        Logger::printf("DISPLAY", "First departures on screen %lu ms after boot (%s)",
+                       (unsigned long)refreshStats.firstDeparturesMs,
+                       currentSnapshot->offline ? "offline cache" : "live");
+    }
 
-    hibernate();
+    if (currentState == STATE_DASHBOARD) {
+        // Controller in Deep Sleep (RAM bleibt erhalten), Panel bleibt versorgt
+        // damit das nächste Update ein Partial Refresh sein kann
+        display->hibernate();
+    } else {
+        hibernate();
+    }
+}
+
+void DisplayManager::captureRenderState() {
+    // Nicht auf NTP warten (getLocalTime() blockiert sonst bis zu 5 s pro Update)
+    renderTimeValid = getLocalTime(&renderTime, 0);
+    time(&renderNow);
+    renderWifi = (WiFi.status() == WL_CONNECTED);
+    renderRssi = renderWifi ? WiFi.RSSI() : 0;
+}
+
+void DisplayManager::updateRegions() {
+    // Signatur = Hash der Pixel des Bereichs im Framebuffer
+    for (uint8_t region = 0; region < REGION_COUNT; region++) {
+        regions.set((DashboardRegion)region, frameBuffer.hash(DirtyRegions::LAYOUT[region]));
+    }
+}
+
+bool DisplayManager::fullRefreshDue() const {
+    return partialsSinceFull >= FULL_REFRESH_EVERY ||
+           (millis() - lastFullRefresh) >= FULL_REFRESH_INTERVAL_MS;
+}
+
+void DisplayManager::refreshFull(SystemEvent event) {
+    display->setFullWindow();
+    if (frameBuffer.valid()) {
+        blitPages(frameBuffer.bounds());
+    } else {
+        // Ohne Framebuffer wird pro Seite neu gezeichnet, GxEPD2 schneidet zu
+        display->firstPage();
+        do {
+            drawUI(event);
+        } while (display->nextPage());
+    }
+
+    regions.invalidate();
+    panelRamValid = true;
+    partialsSinceFull = 0;
+    lastFullRefresh = millis();
+    refreshStats.fullRefreshes++;
+    refreshStats.lastWindows = 0;
+    refreshStats.lastBytes = (uint32_t)display->width() * display->height() / 8;
+}
+
+void DisplayManager::refreshPartial() {
+    DisplayRect windows[REGION_COUNT];
+    size_t count = regions.windows(windows, REGION_COUNT);
+
+    uint32_t bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        const DisplayRect& rect = windows[i];
+        // Nur das Fenster aus dem Framebuffer übertragen
+        display->setPartialWindow(rect.x, rect.y, rect.w, rect.h);
+        blitPages(rect);
+        bytes += (uint32_t)rect.w * rect.h / 8;
+    }
+
+    partialsSinceFull++;
+    refreshStats.partialRefreshes++;
+    refreshStats.lastWindows = count;
+    refreshStats.lastBytes = bytes;
+}
+
+void DisplayManager::blitPages(const DisplayRect& rect) {
+    // GxEPD2 teilt das Fenster ab rect.y in Seiten zu DISPLAY_PAGE_HEIGHT Zeilen.
+    // Pro Seite nur deren Zeilen übertragen, der Rest würde verworfen.
+    uint16_t pageY = rect.y;
+    display->firstPage();
+    do {
+        uint16_t end = rect.y + rect.h;
+        uint16_t rows = (end - pageY < DISPLAY_PAGE_HEIGHT) ? end - pageY : DISPLAY_PAGE_HEIGHT;
+        DisplayRect page = { rect.x, pageY, rect.w, rows };
+        frameBuffer.blit(*display, page);
+        pageY += rows;
+    } while (display->nextPage());
 }
 
 void DisplayManager::drawUI(SystemEvent event) {
-    display->fillScreen(GxEPD_WHITE);
+    gfx->fillScreen(GxEPD_WHITE);
 
     switch(currentState) {
         case STATE_BOOT:
@@ -175,122 +346,163 @@ void DisplayManager::drawUI(SystemEvent event) {
 }
 
 void DisplayManager::drawBootScreen() {
-    display->setFont(&FreeMonoBold12pt7b);
+    gfx->setFont(&FreeMonoBold12pt7b);
     
     int16_t tbx, tby; uint16_t tbw, tbh;
     String title = "CROWPANEL OEV";
-    display->getTextBounds(title, 0, 0, &tbx, &tby, &tbw, &tbh);
-    display->setCursor((400 - tbw) / 2, 140);
-    display->println(title);
+    gfx->getTextBounds(title, 0, 0, &tbx, &tby, &tbw, &tbh);
+    gfx->setCursor((400 - tbw) / 2, 140);
+    gfx->println(title);
 
-    display->setFont(&FreeSans9pt7b);
+    gfx->setFont(&FreeSans9pt7b);
     String sub = "v1.0 - Starting...";
-    display->getTextBounds(sub, 0, 0, &tbx, &tby, &tbw, &tbh);
-    display->setCursor((400 - tbw) / 2, 170);
-    display->println(sub);
+    gfx->getTextBounds(sub, 0, 0, &tbx, &tby, &tbw, &tbh);
+    gfx->setCursor((400 - tbw) / 2, 170);
+    gfx->println(sub);
 }
 
 void DisplayManager::drawSetupScreen() {
     drawHeader("SETUP ERFORDERLICH", "WiFi");
 
-    display->setFont(&FreeSans9pt7b);
-    display->setCursor(10, 80);
-    display->println("1. Verbinde mit WLAN:");
+    gfx->setFont(&FreeSans9pt7b);
+    gfx->setCursor(10, 80);
+    gfx->println("1. Verbinde mit WLAN:");
     
-    display->setFont(&FreeSansBold9pt7b);
-    display->setCursor(30, 110);
-    display->println("CrowPanel-Setup");
+    gfx->setFont(&FreeSansBold9pt7b);
+    gfx->setCursor(30, 110);
+    gfx->println("CrowPanel-Setup");
     
-    display->setFont(&FreeSans9pt7b);
-    display->setCursor(10, 150);
-    display->println("2. Oeffne im Browser:");
+    gfx->setFont(&FreeSans9pt7b);
+    gfx->setCursor(10, 150);
+    gfx->println("2. Oeffne im Browser:");
     
-    display->setFont(&FreeSansBold9pt7b);
-    display->setCursor(30, 180);
-    display->println("http://192.168.4.1");
+    gfx->setFont(&FreeSansBold9pt7b);
+    gfx->setCursor(30, 180);
+    gfx->println("http://192.168.4.1");
     
-    display->setFont(&FreeSans9pt7b);
-    display->setCursor(10, 240);
-    display->println("Folge den Anweisungen auf dem");
-    display->setCursor(10, 260);
-    display->println("Bildschirm zur Konfiguration.");
+    gfx->setFont(&FreeSans9pt7b);
+    gfx->setCursor(10, 240);
+    gfx->println("Folge den Anweisungen auf dem");
+    gfx->setCursor(10, 260);
+    gfx->println("Bildschirm zur Konfiguration.");
 }
 
 void DisplayManager::drawErrorScreen() {
-    display->drawRect(10, 10, 380, 280, GxEPD_BLACK);
+    gfx->drawRect(10, 10, 380, 280, GxEPD_BLACK);
     
-    display->setFont(&FreeMonoBold12pt7b);
+    gfx->setFont(&FreeMonoBold12pt7b);
     String title = "FEHLER";
     int16_t tbx, tby; uint16_t tbw, tbh;
-    display->getTextBounds(title, 0, 0, &tbx, &tby, &tbw, &tbh);
-    display->setCursor((400 - tbw) / 2, 60);
-    display->print(title);
+    gfx->getTextBounds(title, 0, 0, &tbx, &tby, &tbw, &tbh);
+    gfx->setCursor((400 - tbw) / 2, 60);
+    gfx->print(title);
 
-    display->setFont(&FreeSans9pt7b);
-    
-    // Konvertiere Fehlermeldung
-    String errorASCII = StringUtils::toASCII(errorMessage);
+    gfx->setFont(&FreeSans9pt7b);
     
     // Split message if too long (simple approach)
-    display->setCursor(30, 120);
-    display->println(errorASCII);
+    gfx->setCursor(30, 120);
+    gfx->println(errorMessage);
     
-    display->setCursor(30, 200);
-    display->println("Versuche Neustart...");
+    gfx->setCursor(30, 200);
+    gfx->println("Versuche Neustart...");
 }
 
 void DisplayManager::drawDashboard(SystemEvent event) {
     // Header
-    struct tm timeinfo;
     char timeStr[6] = "00:00";
-    if(getLocalTime(&timeinfo)){
-        strftime(timeStr, 6, "%H:%M", &timeinfo);
+    if (renderTimeValid) {
+        strftime(timeStr, 6, "%H:%M", &renderTime);
     }
     
     drawHeader(stationName, String(timeStr));
 
-    // Departures
+    // Departures: abgefahrene Kurse fallen weg, spätere aus der Reserve rücken nach
     int y = 50; // Start Y position
-    if (currentDepartures.empty()) {
-        display->setFont(&FreeSans9pt7b);
-        display->setCursor(10, 100);
-        display->println("Keine Abfahrten verfuegbar...");
+    static const DepartureList NO_DEPARTURES;
+    const DepartureList& currentDepartures = currentSnapshot ? currentSnapshot->stop(0) : NO_DEPARTURES;
+    const Departure* rows[VISIBLE_ROWS];
+    size_t rowCount = Countdown::visible(currentDepartures, renderNow, rows, VISIBLE_ROWS);
+    if (rowCount == 0) {
+        gfx->setFont(&FreeSans9pt7b);
+        gfx->setCursor(10, 100);
+        gfx->println("Keine Abfahrten verfuegbar...");
     } else {
-        for (const auto& dep : currentDepartures) {
-            if (y > 240) break; // Don't draw outside
-            drawDepartureRow(y, dep);
+        for (size_t row = 0; row < rowCount; row++) {
+            drawDepartureRow(y, *rows[row], currentDepartures.directionASCII(*rows[row]));
             y += 55;
         }
     }
 
     // Footer
-    String status;
-    if (event == EVENT_WIFI_LOST) {
-        status = "Offline / Verbindungsfehler";
-    } else {
-        char updateTimeStr[10];
-        strftime(updateTimeStr, 10, "%H:%M:%S", &timeinfo);
-        status = "Aktualisiert: " + String(updateTimeStr);
+    drawFooter(footerStatus(event));
+}
+
+String DisplayManager::footerStatus(SystemEvent event) const {
+    bool offline = currentSnapshot && currentSnapshot->offline;
+    if (event == EVENT_WIFI_LOST && !offline) {
+        return "Offline / Verbindungsfehler";
     }
-    
-    drawFooter(status);
+    // Zeitpunkt der Daten, nicht des Zeichnens: ein Redraw ohne neue Daten ergibt dasselbe Bild
+    if (!currentSnapshot || currentSnapshot->fetchedAt == 0) {
+        return "Warte auf Daten...";
+    }
+    struct tm fetched;
+    localtime_r(&currentSnapshot->fetchedAt, &fetched);
+    if (offline) {
+        // Veraltet-Markierung: Zeiten aus dem Fahrplan, ohne Verspätungen
+        char stand[16];
+        strftime(stand, sizeof(stand), "%d.%m. %H:%M", &fetched);
+        return "OFFLINE - Fahrplan, Stand " + String(stand);
+    }
+    char updateTimeStr[10];
+    strftime(updateTimeStr, 10, "%H:%M:%S", &fetched);
+    return "Aktualisiert: " + String(updateTimeStr);
+}
+
+bool DisplayManager::hasDepartures() const {
+    return currentSnapshot && !currentSnapshot->stop(0).empty();
+}
+
+long DisplayManager::msUntilTick() const {
+    // Nur das Dashboard zeigt Uhrzeit und Minuten; ohne NTP gibt es nichts zu zählen
+    if (currentState != STATE_DASHBOARD) return -1;
+    time_t now = time(NULL);
+    if (!Countdown::clockValid(now)) return -1;
+    return Countdown::msUntilTick(now);
+}
+
+void DisplayManager::onMinuteTick() {
+    static const DepartureList NO_DEPARTURES;
+    const DepartureList& departures = currentSnapshot ? currentSnapshot->stop(0) : NO_DEPARTURES;
+    bool offline = currentSnapshot && currentSnapshot->offline;
+
+    TickAction action = Countdown::onTick(departures, time(NULL), VISIBLE_ROWS, offline);
+    if (action == TICK_NONE) return;
+    if (action == TICK_REFETCH && refetchRequest) {
+        // Poll läuft im TransportTask, die neuen Daten kommen per EVENT_DATA_AVAILABLE
+        Logger::info("DISPLAY", "Countdown ran out of departures, requesting poll");
+        refetchRequest();
+    }
+    // Aus dem vorhandenen Snapshot neu zeichnen, der Frame-Hash bzw. die
+    // Dirty Regions begrenzen das Update auf Uhrzeit und geänderte Minuten
+    update(EVENT_MINUTE_TICK);
 }
 
 void DisplayManager::drawInfoScreen() {
     drawHeader("INFO / KONFIG", "");
 
-    display->setFont(&FreeSans9pt7b);
-    display->setCursor(10, 80);
-    display->println("Um das Geraet zu konfigurieren,");
-    display->println("oeffne im Browser:");
+    gfx->setFont(&FreeSans9pt7b);
+    gfx->setCursor(10, 80);
+    gfx->println("Um das Geraet zu konfigurieren,");
+    gfx->println("oeffne im Browser:");
 
-    display->setFont(&FreeSansBold9pt7b);
-    display->setCursor(30, 130);
-    display->println("http://crowpanel.local/");
+    gfx->setFont(&FreeSansBold9pt7b);
+    gfx->setCursor(30, 130);
+    gfx->println("http://crowpanel.local/");
     
-    display->setFont(&FreeSans9pt7b);
-    display->setCursor(10, 180);
-    display->println("Oder scanne den QR-Code:");
+    gfx->setFont(&FreeSans9pt7b);
+    gfx->setCursor(10, 180);
+    gfx->println("Oder scanne den QR-Code:");
 
     // Platzhalter für QR Code Box (100x100)
     int qrX = 150;
@@ -298,12 +510,12 @@ void DisplayManager::drawInfoScreen() {
     int qrSize = 80;
     
     // Rahmen
-    display->drawRect(qrX, qrY, qrSize, qrSize, GxEPD_BLACK);
+    gfx->drawRect(qrX, qrY, qrSize, qrSize, GxEPD_BLACK);
     // Dummy Muster (Checkerboard)
     for(int i=0; i<qrSize; i+=10) {
         for(int j=0; j<qrSize; j+=10) {
             if ((i+j)%20 == 0) {
-                 display->fillRect(qrX+i, qrY+j, 10, 10, GxEPD_BLACK);
+                 gfx->fillRect(qrX+i, qrY+j, 10, 10, GxEPD_BLACK);
             }
         }
     }
@@ -314,19 +526,16 @@ void DisplayManager::drawInfoScreen() {
 // --- Helpers ---
 
 void DisplayManager::drawHeader(String title, String rightText) {
-    // Konvertiere Umlaute zu ASCII
-    String titleASCII = StringUtils::toASCII(title);
-    String rightTextASCII = StringUtils::toASCII(rightText);
-    
+    // Texte sind bereits ASCII (Stationsname in setStationName transliteriert)
     // Left: Title
-    display->setFont(&FreeMonoBold12pt7b);
-    display->setCursor(5, 30);
-    display->print(titleASCII.substring(0, 15)); // Basic truncate
+    gfx->setFont(&FreeMonoBold12pt7b);
+    gfx->setCursor(5, 30);
+    gfx->print(title.substring(0, 15)); // Basic truncate
 
     // Calculate Right Text Size
-    display->setFont(&FreeSansBold9pt7b);
+    gfx->setFont(&FreeSansBold9pt7b);
     int16_t tbx, tby; uint16_t tbw, tbh;
-    display->getTextBounds(rightTextASCII, 0, 0, &tbx, &tby, &tbw, &tbh);
+    gfx->getTextBounds(rightText, 0, 0, &tbx, &tby, &tbw, &tbh);
     
     int wifiWidth = 24;
     int gap = 10;
@@ -336,86 +545,84 @@ void DisplayManager::drawHeader(String title, String rightText) {
     int rightTextX = 400 - margin - tbw;
     
     // Wifi Icon logic
-    if (currentState == STATE_DASHBOARD && WiFi.status() == WL_CONNECTED) {
+    if (currentState == STATE_DASHBOARD && renderWifi) {
         // Icon ganz rechts
         int iconX = 400 - margin - wifiWidth; 
         int iconY = 30; // Baseline
-        drawWifiSignal(iconX, iconY, WiFi.RSSI());
+        drawWifiSignal(iconX, iconY, renderRssi);
         
         // Text links daneben
         rightTextX = iconX - gap - tbw;
     }
 
     // Right: Text (Time)
-    display->setCursor(rightTextX, 30);
-    display->print(rightTextASCII);
+    gfx->setCursor(rightTextX, 30);
+    gfx->print(rightText);
 
     // Thick Line
-    display->fillRect(0, 40, 400, 3, GxEPD_BLACK);
+    gfx->fillRect(0, 40, 400, 3, GxEPD_BLACK);
 }
 
 void DisplayManager::drawFooter(String status) {
-    // Konvertiere Umlaute
-    String statusASCII = StringUtils::toASCII(status);
-    
     // Thin Line
-    display->drawLine(0, 275, 400, 275, GxEPD_BLACK);
+    gfx->drawLine(0, 275, 400, 275, GxEPD_BLACK);
 
-    display->setFont(&FreeSans9pt7b);
-    display->setCursor(5, 295);
-    display->print(statusASCII);
+    gfx->setFont(&FreeSans9pt7b);
+    gfx->setCursor(5, 295);
+    gfx->print(status);
 }
 
-void DisplayManager::drawInvertedBadge(int x, int y, int w, int h, String text) {
-    display->fillRect(x, y, w, h, GxEPD_BLACK);
-    display->setTextColor(GxEPD_WHITE);
+void DisplayManager::drawInvertedBadge(int x, int y, int w, int h, const char* text) {
+    gfx->fillRect(x, y, w, h, GxEPD_BLACK);
+    gfx->setTextColor(GxEPD_WHITE);
     
     // Center text
-    display->setFont(&FreeSansBold9pt7b);
+    gfx->setFont(&FreeSansBold9pt7b);
     int16_t tbx, tby; uint16_t tbw, tbh;
-    display->getTextBounds(text, 0, 0, &tbx, &tby, &tbw, &tbh);
+    gfx->getTextBounds(text, 0, 0, &tbx, &tby, &tbw, &tbh);
     int textX = x + (w - tbw) / 2;
     int textY = y + (h + tbh) / 2; // Approximate center
 
-    display->setCursor(textX, textY);
-    display->print(text);
-    display->setTextColor(GxEPD_BLACK); // Reset
+    gfx->setCursor(textX, textY);
+    gfx->print(text);
+    gfx->setTextColor(GxEPD_BLACK); // Reset
 }
 
-void DisplayManager::drawDepartureRow(int y, const Departure& dep) {
-    // Konvertiere Umlaute
-    String lineASCII = StringUtils::toASCII(dep.line);
-    String directionASCII = StringUtils::toASCII(dep.direction);
-    
+void DisplayManager::drawDepartureRow(int y, const Departure& dep, const char* direction) {
+    // Linie und Zielort liegen bereits als ASCII in der DepartureList
     // Line Badge
-    drawInvertedBadge(10, y + 5, 50, 40, lineASCII);
+    drawInvertedBadge(10, y + 5, 50, 40, dep.line);
 
     // Destination
-    display->setFont(&FreeSansBold9pt7b);
-    display->setCursor(70, y + 30);
-    display->print(directionASCII.substring(0, 18)); // Truncate
-
-    // Time
-    // Calculate minutes difference
-    time_t now;
-    time(&now);
-    time_t depTime = dep.getEffectiveTime();
-    double diffSeconds = difftime(depTime, now);
-    int diffMin = (int)(diffSeconds / 60);
+    char shown[19];
+    strncpy(shown, direction, sizeof(shown) - 1);
+    shown[sizeof(shown) - 1] = '\0';
+
+    gfx->setFont(&FreeSansBold9pt7b);
+    gfx->setCursor(70, y + 30);
+    gfx->print(shown); // Truncate
 
+    // Time (Minuten bis Abfahrt, ohne gültige Uhrzeit die Abfahrtszeit selbst)
     String timeStr;
-    if (diffMin <= 0) timeStr = "0'";
-    else if (diffMin > 60) timeStr = ">1h";
-    else timeStr = String(diffMin) + "'";
+    time_t effective = dep.getEffectiveTime();
+    if (renderTimeValid) {
+        timeStr = formatMinutes(effective, renderNow);
+    } else {
+        struct tm departure;
+        localtime_r(&effective, &departure);
+        char clock[6];
+        strftime(clock, sizeof(clock), "%H:%M", &departure);
+        timeStr = clock;
+    }
 
-    display->setFont(&FreeMonoBold12pt7b);
+    gfx->setFont(&FreeMonoBold12pt7b);
     int16_t tbx, tby; uint16_t tbw, tbh;
-    display->getTextBounds(timeStr, 0, 0, &tbx, &tby, &tbw, &tbh);
-    display->setCursor(400 - tbw - 10, y + 30);
-    display->print(timeStr);
+    gfx->getTextBounds(timeStr, 0, 0, &tbx, &tby, &tbw, &tbh);
+    gfx->setCursor(400 - tbw - 10, y + 30);
+    gfx->print(timeStr);
 
     // Separator
-    display->drawLine(0, y + 50, 400, y + 50, GxEPD_BLACK);
+    gfx->drawLine(0, y + 50, 400, y + 50, GxEPD_BLACK);
 }
 
 void DisplayManager::drawWifiSignal(int x, int y, int rssi) {
@@ -431,11 +638,7 @@ void DisplayManager::drawWifiSignal(int x, int y, int rssi) {
     // > -100: 1 Bar
     // else: 0 Bars
     
-    int bars = 0;
-    if (rssi > -55) bars = 4;
-    else if (rssi > -70) bars = 3;
-    else if (rssi > -85) bars = 2;
-    else if (rssi > -100) bars = 1;
+    int bars = wifiBars(rssi);
     
     // Zeichne Balken
     for (int i = 0; i < maxBars; i++) {
@@ -445,10 +648,26 @@ void DisplayManager::drawWifiSignal(int x, int y, int rssi) {
         
         if (i < bars) {
             // Gefüllter Balken
-            display->fillRect(xPos, yPos, barWidth, height, GxEPD_BLACK);
+            gfx->fillRect(xPos, yPos, barWidth, height, GxEPD_BLACK);
         } else {
             // Leerer Balken (Rahmen) oder dünne Linie
-            display->drawRect(xPos, yPos, barWidth, height, GxEPD_BLACK);
+            gfx->drawRect(xPos, yPos, barWidth, height, GxEPD_BLACK);
         }
     }
 }
+
+String DisplayManager::formatMinutes(time_t departure, time_t now) {
+    int diffMin = Countdown::minutesUntil(departure, now);
+
+    if (diffMin <= 0) return "0'";
+    if (diffMin > 60) return ">1h";
+    return String(diffMin) + "'";
+}
+
+int DisplayManager::wifiBars(int rssi) {
+    if (rssi > -55) return 4;
+    if (rssi > -70) return 3;
+    if (rssi > -85) return 2;
+    if (rssi > -100) return 1;
+    return 0;
+}
@@ -7,6 +7,9 @@
 #include <functional>
 #include "../Transport/TransportTypes.h"
 #include "../Core/SystemEvents.h"
+#include "dirty_regions.h"
+#include "frame_buffer.h"
+#include "countdown.h"
 
 enum DisplayState {
     STATE_BOOT,
@@ -16,10 +19,28 @@ enum DisplayState {
     STATE_ERROR
 };
 
+struct DisplayRefreshStats {
+    uint32_t fullRefreshes;     // Updates mit Full Refresh
+    uint32_t partialRefreshes;  // Updates nur mit Partial Windows
+    uint32_t skipped;           // Updates ohne sichtbare Änderung
+    uint32_t lastRefreshMs;     // Dauer des letzten Updates (Zeichnen + Refresh)
+    uint32_t lastBytes;         // Pixeldaten des letzten Updates (Bytes über SPI)
+    uint8_t lastWindows;        // Partial Windows des letzten Updates (0 = Full Refresh)
+    uint32_t firstDeparturesMs; // millis() ab Boot, als erstmals Abfahrten auf dem Panel standen (0 = noch nie)
+};
+
+// Seitenpuffer von GxEPD2 im internen RAM: ein Viertel des Panels (3750 statt
+// 15000 Bytes). Fenster werden in bis zu vier Seiten übertragen, das Bild
+// selbst liegt ohnehin im FrameBuffer.
+static const uint16_t DISPLAY_PAGE_HEIGHT = GxEPD2_420_GYE042A87::HEIGHT / 4;
+typedef GxEPD2_BW<GxEPD2_420_GYE042A87, DISPLAY_PAGE_HEIGHT> DisplayPanel;
+
 // Display Manager Class
 class DisplayManager {
 public:
-    DisplayManager(GxEPD2_BW<GxEPD2_420_GYE042A87, GxEPD2_420_GYE042A87::HEIGHT>* disp);
+    static const size_t VISIBLE_ROWS = 4;   // Abfahrten auf dem Dashboard (y = 50, 105, 160, 215)
+    
+    DisplayManager(DisplayPanel* disp);
 
     // Startet den Display-Task
     void begin(QueueHandle_t eventQueue);
@@ -29,18 +50,32 @@ public:
     void wakeup();
     void update(SystemEvent event);
 
-    // Data Setters
-    void setDepartures(const std::vector<Departure>& departures);
+    // Data Setters (Texte werden hier einmalig nach ASCII transliteriert)
+    void setDepartures(DepartureSnapshotPtr snapshot);
     void setStationName(String name);
     void setErrorMessage(String msg);
     
-    using DataProvider = std::function<std::vector<Departure>()>;
+    using DataProvider = std::function<DepartureSnapshotPtr()>;
     void setDataProvider(DataProvider provider);
+    
+    // Liefert den Stationsnamen nach EVENT_CONFIG_CHANGED (wird im Display-Task aufgerufen)
+    using StationNameProvider = std::function<String()>;
+    void setStationNameProvider(StationNameProvider provider);
+    
+    // Fordert einen Poll an, wenn beim Countdown keine Abfahrten mehr nachrücken können
+    using RefetchRequest = std::function<void()>;
+    void setRefetchRequest(RefetchRequest request);
+    
+    DisplayRefreshStats getRefreshStats() const { return refreshStats; }
 
 private:
+    // Full Refresh gegen Ghosting: nach so vielen Partial Updates bzw. spätestens nach dieser Zeit
+    static const uint32_t FULL_REFRESH_EVERY = 20;
+    static const unsigned long FULL_REFRESH_INTERVAL_MS = 3600000;
+    
     static void taskCode(void* pvParameters);
     
-    GxEPD2_BW<GxEPD2_420_GYE042A87, GxEPD2_420_GYE042A87::HEIGHT>* display;
+    DisplayPanel* display;
     bool initialized;
     uint32_t updateCounter;
     TaskHandle_t taskHandle;
@@ -48,10 +83,33 @@ private:
     DisplayState currentState;
 
     // Data
-    std::vector<Departure> currentDepartures;
-    String stationName;
-    String errorMessage;
+    DepartureSnapshotPtr currentSnapshot;   // Geteilter Stand, Anzeige nutzt Haltestelle 0
+    String stationName;     // Bereits ASCII
+    String errorMessage;    // Bereits ASCII
     DataProvider dataProvider;
+    StationNameProvider stationNameProvider;
+    RefetchRequest refetchRequest;
+    
+    // Offscreen-Rendering: gfx zeigt auf den Framebuffer, ohne Puffer direkt auf das Display
+    FrameBuffer frameBuffer;
+    Adafruit_GFX* gfx;
+    
+    // Partial Refresh
+    DirtyRegions regions;
+    DisplayState shownState;         // Zuletzt auf das Panel geschriebener Screen
+    bool frameShown;                 // shownFrameHash ist gültig
+    uint32_t shownFrameHash;         // Hash des Bildes auf dem Panel
+    bool panelRamValid;              // Controller-RAM enthält das angezeigte Bild (Panel war nicht stromlos)
+    uint32_t partialsSinceFull;
+    unsigned long lastFullRefresh;
+    DisplayRefreshStats refreshStats;
+    
+    // Einmal pro Update eingefroren, damit alle Teile des Bildes denselben Stand zeigen
+    struct tm renderTime;
+    bool renderTimeValid;
+    time_t renderNow;
+    bool renderWifi;
+    int renderRssi;
 
     // Drawing Methods
     void drawUI(SystemEvent event);
@@ -66,9 +124,25 @@ private:
     // Helpers
     void drawHeader(String title, String rightText);
     void drawFooter(String status);
-    void drawInvertedBadge(int x, int y, int w, int h, String text);
-    void drawDepartureRow(int y, const Departure& dep);
+    void drawInvertedBadge(int x, int y, int w, int h, const char* text);
+    void drawDepartureRow(int y, const Departure& dep, const char* direction);
     void drawWifiSignal(int x, int y, int rssi);
+    
+    // Partial Refresh Helpers
+    void captureRenderState();
+    void updateRegions();
+    bool fullRefreshDue() const;
+    void refreshFull(SystemEvent event);
+    void refreshPartial();
+    void blitPages(const DisplayRect& rect);
+    String footerStatus(SystemEvent event) const;
+    bool hasDepartures() const;
+    
+    // Countdown: Wartezeit bis zum nächsten Minuten-Tick, -1 = kein Tick nötig
+    long msUntilTick() const;
+    void onMinuteTick();
+    static String formatMinutes(time_t departure, time_t now);
+    static int wifiBars(int rssi);
 };
 
 #endif // DISPLAY_MANAGER_H
@@ -0,0 +1,82 @@
+#include "frame_buffer.h"
+#include <GxEPD2_BW.h>
+#include "../Logger/Logger.h"
+
+FrameBuffer::FrameBuffer(int16_t w, int16_t h)
+    : Adafruit_GFX(w, h), _buffer(NULL), _stride((w + 7) / 8) {
+}
+
+FrameBuffer::~FrameBuffer() {
+    free(_buffer);
+}
+
+bool FrameBuffer::begin() {
+    if (_buffer) return true;
+
+    size_t size = (size_t)_stride * HEIGHT;
+    if (psramFound()) {
+        _buffer = (uint8_t*)ps_malloc(size);
+    }
+    if (!_buffer) {
+        Logger::info("DISPLAY", "No PSRAM for framebuffer, using internal heap");
+        _buffer = (uint8_t*)malloc(size);
+    }
+    if (!_buffer) return false;
+
+    memset(_buffer, 0xFF, size);
+    return true;
+}
+
+void FrameBuffer::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if (!_buffer || x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT) return;
+
+    uint8_t* byte = _buffer + y * _stride + x / 8;
+    uint8_t bit = 0x80 >> (x & 7);
+    if (color == GxEPD_BLACK) {
+        *byte &= ~bit;
+    } else {
+        *byte |= bit;
+    }
+}
+
+void FrameBuffer::fillScreen(uint16_t color) {
+    if (!_buffer) return;
+    memset(_buffer, color == GxEPD_BLACK ? 0x00 : 0xFF, (size_t)_stride * HEIGHT);
+}
+
+DisplayRect FrameBuffer::bounds() const {
+    DisplayRect rect = { 0, 0, (uint16_t)WIDTH, (uint16_t)HEIGHT };
+    return rect;
+}
+
+uint32_t FrameBuffer::hash(const DisplayRect& rect) const {
+    // FNV-1a über die Bytes des Rechtecks, Zeile für Zeile
+    uint32_t h = 2166136261UL;
+    if (!_buffer) return h;
+
+    for (uint16_t y = rect.y; y < rect.y + rect.h && y < HEIGHT; y++) {
+        const uint8_t* row = _buffer + y * _stride;
+        for (uint16_t i = rect.x / 8; i < (rect.x + rect.w) / 8 && i < _stride; i++) {
+            h ^= row[i];
+            h *= 16777619UL;
+        }
+    }
+    return h;
+}
+
+void FrameBuffer::blit(Adafruit_GFX& target, const DisplayRect& rect) const {
+    if (!_buffer) return;
+
+    // Ziel ist weiss vorbelegt: nur schwarze Pixel übertragen, weisse Bytes überspringen
+    target.fillScreen(GxEPD_WHITE);
+    for (uint16_t y = rect.y; y < rect.y + rect.h && y < HEIGHT; y++) {
+        const uint8_t* row = _buffer + y * _stride;
+        for (uint16_t i = rect.x / 8; i < (rect.x + rect.w) / 8 && i < _stride; i++) {
+            uint8_t bits = row[i];
+            if (bits == 0xFF) continue;
+            for (uint8_t b = 0; b < 8; b++) {
+                if (!(bits & (0x80 >> b))) target.drawPixel(i * 8 + b, y, GxEPD_BLACK);
+            }
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef FRAME_BUFFER_H
+#define FRAME_BUFFER_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include "dirty_regions.h"
+
+/**
+ * 1-bpp Offscreen-Framebuffer im PSRAM (Layout wie der GxEPD2 Puffer:
+ * Bit gesetzt = weiss, MSB = linkes Pixel). Die UI wird einmal pro Update
+ * hineingezeichnet; über Hashes einzelner Rechtecke lässt sich erkennen,
+ * ob und wo sich das Bild gegenüber dem Panel geändert hat.
+ * Rotation wird nicht unterstützt (Display läuft mit Rotation 0).
+ */
+class FrameBuffer : public Adafruit_GFX {
+public:
+    FrameBuffer(int16_t w, int16_t h);
+    ~FrameBuffer();
+
+    // Alloziert den Puffer (PSRAM, sonst interner Heap). false wenn kein Speicher.
+    bool begin();
+    bool valid() const { return _buffer != NULL; }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+
+    // Ganzes Bild bzw. Rechteck (x und w Vielfache von 8)
+    DisplayRect bounds() const;
+    uint32_t hash(const DisplayRect& rect) const;
+
+    // Füllt das Ziel (z.B. den GxEPD2 Seitenpuffer eines Partial Windows) weiss
+    // und überträgt die schwarzen Pixel des Rechtecks
+    void blit(Adafruit_GFX& target, const DisplayRect& rect) const;
+
+private:
+    uint8_t* _buffer;
+    uint16_t _stride;   // Bytes pro Zeile
+
+    FrameBuffer(const FrameBuffer&);
+    FrameBuffer& operator=(const FrameBuffer&);
+};
+
+#endif // FRAME_BUFFER_H
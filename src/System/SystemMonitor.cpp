@@ -15,9 +15,12 @@ void SystemMonitor::begin() {
 
 void SystemMonitor::taskCode(void* pvParameters) {
     for(;;) {
-        Logger::printf("SYSTEM", "Core %d | Heap: %d KB | Stack: %d bytes",
+        // Min Free Heap und grösster freier Block machen Heap-Churn/Fragmentierung pro Poll sichtbar
+        Logger::printf("SYSTEM", "Core %d | Heap: %d KB (min %d KB, max block %d KB) | Stack: %d bytes",
                      xPortGetCoreID(),
                      ESP.getFreeHeap() / 1024,
+                     ESP.getMinFreeHeap() / 1024,
+                     ESP.getMaxAllocHeap() / 1024,
                      uxTaskGetStackHighWaterMark(NULL));
 
         vTaskDelay(pdMS_TO_TICKS(5000));
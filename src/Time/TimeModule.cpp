@@ -1,15 +1,19 @@
 #include "TimeModule.h"
 #include "../Logger/Logger.h"
+#include "../Core/EventBus.h"
 #include <WiFi.h>
 
 TimeModule::TimeModule() : taskHandle(NULL), isSynced(false), isConfigured(false) {}
 
-void TimeModule::begin(QueueHandle_t eventQueue) {
-    this->eventQueue = eventQueue;
-    
+void TimeModule::begin() {
     // Wir konfigurieren NTP noch nicht hier, um Race-Conditions mit dem Wifi-Stack Init zu vermeiden.
     // Das passiert im Task sobald Wifi connected ist.
     
+    // Zeitzone schon jetzt: die Uhr läuft nach einem Neustart weiter (RTC), und
+    // Abfahrten aus dem Offline-Cache sollen vor dem NTP-Sync in Ortszeit erscheinen
+    setenv("TZ", TIMEZONE, 1);
+    tzset();
+    
     Logger::info("TIME", "Starting Time Task...");
     
     // Task starten, der auf Zeit-Sync prüft
@@ -57,10 +61,7 @@ void TimeModule::taskCode(void* pvParameters) {
                 Logger::printf("TIME", "Time synchronized: %s", module->getFormattedTime().c_str());
                 
                 // Event feuern
-                if (module->eventQueue != NULL) {
-                    SystemEvent event = EVENT_TIME_SYNCED;
-                    xQueueSend(module->eventQueue, &event, 0);
-                }
+                EventBus::publish(EVENT_TIME_SYNCED);
             }
         }
         
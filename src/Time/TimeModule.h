@@ -8,14 +8,13 @@
 class TimeModule {
 public:
     TimeModule();
-    void begin(QueueHandle_t eventQueue);
+    void begin();
     
     String getFormattedTime();
 
 private:
     static void taskCode(void* pvParameters);
     
-    QueueHandle_t eventQueue;
     TaskHandle_t taskHandle;
     bool isSynced;
     bool isConfigured;
@@ -0,0 +1,289 @@
+#include "DepartureCache.h"
+#include "../Logger/Logger.h"
+
+namespace {
+
+const char MAGIC[4] = { 'D', 'E', 'P', 'C' };
+const size_t HEADER_SIZE = 16;
+const size_t MAX_FILE_SIZE = 8192;
+const time_t MIN_VALID_TIME = 1577836800;
+
+uint32_t crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+void putU8(std::vector<uint8_t>& out, uint8_t value) {
+    out.push_back(value);
+}
+
+void putU16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(value & 0xFF);
+    out.push_back(value >> 8);
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back((value >> (8 * i)) & 0xFF);
+}
+
+void putStr(std::vector<uint8_t>& out, const char* text) {
+    size_t len = strlen(text);
+    if (len > 255) len = 255;
+    out.push_back((uint8_t)len);
+    out.insert(out.end(), (const uint8_t*)text, (const uint8_t*)text + len);
+}
+
+uint16_t getU16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+uint32_t getU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Liest die Nutzdaten mit Bereichsprüfung; nach einem Fehler bleibt `ok` false
+struct Reader {
+    const uint8_t* pos;
+    const uint8_t* end;
+    bool ok;
+
+    bool need(size_t bytes) {
+        if (ok && (size_t)(end - pos) < bytes) ok = false;
+        return ok;
+    }
+    uint8_t u8() {
+        return need(1) ? *pos++ : 0;
+    }
+    uint32_t u32() {
+        if (!need(4)) return 0;
+        uint32_t value = getU32(pos);
+        pos += 4;
+        return value;
+    }
+    // str-Eintrag ohne Kopie: Zeiger in die Nutzdaten, Länge in `len`
+    const uint8_t* str(size_t& len) {
+        len = u8();
+        if (!need(len)) return NULL;
+        const uint8_t* start = pos;
+        pos += len;
+        return start;
+    }
+    // str-Eintrag als C-String nach `out` (ggf. gekürzt)
+    void str(char* out, size_t capacity) {
+        size_t len;
+        const uint8_t* text = str(len);
+        copy(text, len, out, capacity);
+    }
+    static void copy(const uint8_t* text, size_t len, char* out, size_t capacity) {
+        size_t n = text ? len : 0;
+        if (n > capacity - 1) n = capacity - 1;
+        if (n) memcpy(out, text, n);
+        out[n] = '\0';
+    }
+};
+
+} // namespace
+
+DepartureCache::DepartureCache()
+    : _fs(NULL),
+      _path(NULL),
+      _savedAt(0)
+{
+}
+
+bool DepartureCache::begin(fs::FS* fs, const char* path) {
+    _fs = fs;
+    _path = path;
+
+    File file = _fs->open(_path, "r");
+    if (!file) return false;
+
+    size_t size = file.size();
+    if (size < HEADER_SIZE || size > MAX_FILE_SIZE) {
+        file.close();
+        return false;
+    }
+    std::vector<uint8_t> data(size);
+    size_t read = file.read(data.data(), size);
+    file.close();
+
+    if (read != size || memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) return false;
+    if (getU16(&data[4]) != SCHEMA_VERSION) {
+        Logger::info("CACHE", "Departure cache has an old schema, ignored");
+        return false;
+    }
+    uint32_t length = getU32(&data[8]);
+    if (length != size - HEADER_SIZE || crc32(&data[HEADER_SIZE], length) != getU32(&data[12])) {
+        Logger::error("CACHE", "Departure cache corrupt (CRC), ignored");
+        return false;
+    }
+    if (!decode(&data[HEADER_SIZE], length)) {
+        Logger::error("CACHE", "Departure cache unreadable, ignored");
+        return false;
+    }
+
+    Logger::printf("CACHE", "Loaded departure cache (%u bytes)", (unsigned)size);
+    return true;
+}
+
+bool DepartureCache::refreshDue(const String* stopIds, time_t now) const {
+    if (now < MIN_VALID_TIME) return false;
+    if (_savedAt == 0 || now - _savedAt >= REFRESH_S) return true;
+    for (size_t i = 0; i < MAX_STOPS; i++) {
+        if (stopIds[i] != _stopIds[i]) return true;
+    }
+    // Dichte Haltestelle: 20 Abfahrten reichen nur rund eine Stunde
+    time_t horizon = getHorizon();
+    return horizon != 0 && horizon - now < MIN_HORIZON_S && now - _savedAt >= MIN_REFRESH_S;
+}
+
+time_t DepartureCache::getHorizon() const {
+    time_t horizon = 0;
+    for (size_t i = 0; i < MAX_STOPS; i++) {
+        // Nicht volle Liste: die API hatte nicht mehr, ein tieferer Poll brächte nichts
+        if (_lists[i].size() < DepartureList::CAPACITY) continue;
+        time_t last = 0;
+        for (size_t j = 0; j < _lists[i].size(); j++) {
+            if (_lists[i][j].departureTime > last) last = _lists[i][j].departureTime;
+        }
+        if (last != 0 && (horizon == 0 || last < horizon)) horizon = last;
+    }
+    return horizon;
+}
+
+bool DepartureCache::store(const String* stopIds, const DepartureSnapshot& snapshot, time_t now) {
+    if (now < MIN_VALID_TIME) return false;
+
+    for (size_t i = 0; i < MAX_STOPS; i++) {
+        _stopIds[i] = stopIds[i];
+        _lists[i] = snapshot.stops[i];
+    }
+    _savedAt = now;
+    if (!_fs || !_path) return false;
+
+    std::vector<uint8_t> data;
+    data.reserve(1024);
+    data.insert(data.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    putU16(data, SCHEMA_VERSION);
+    putU16(data, MAX_STOPS);
+    putU32(data, 0);    // Länge und CRC werden unten eingesetzt
+    putU32(data, 0);
+    encode(data);
+
+    uint32_t length = data.size() - HEADER_SIZE;
+    uint32_t crc = crc32(&data[HEADER_SIZE], length);
+    for (int i = 0; i < 4; i++) {
+        data[8 + i] = (length >> (8 * i)) & 0xFF;
+        data[12 + i] = (crc >> (8 * i)) & 0xFF;
+    }
+
+    File file = _fs->open(_path, "w");
+    if (!file) {
+        Logger::error("CACHE", "Cannot write departure cache");
+        return false;
+    }
+    size_t written = file.write(data.data(), data.size());
+    file.close();
+
+    Logger::printf("CACHE", "Departure cache saved (%u bytes)", (unsigned)written);
+    return written == data.size();
+}
+
+void DepartureCache::encode(std::vector<uint8_t>& out) const {
+    putU32(out, (uint32_t)_savedAt);
+    for (size_t i = 0; i < MAX_STOPS; i++) {
+        const DepartureList& list = _lists[i];
+        const DirectionTable& directions = list.directions();
+
+        putStr(out, _stopIds[i].c_str());
+        putU8(out, directions.size());
+        for (size_t d = 0; d < directions.size(); d++) {
+            putStr(out, directions.get(d));
+        }
+        putU8(out, list.size());
+        for (const Departure& dep : list) {
+            putU32(out, (uint32_t)dep.departureTime);
+            putU8(out, dep.mode);
+            putU8(out, dep.directionId);
+            putStr(out, dep.line);
+        }
+    }
+}
+
+bool DepartureCache::decode(const uint8_t* data, size_t length) {
+    Reader in = { data, data + length, true };
+    _savedAt = in.u32();
+
+    for (size_t i = 0; i < MAX_STOPS && in.ok; i++) {
+        char id[32];
+        in.str(id, sizeof(id));
+        _stopIds[i] = id;
+        _lists[i].clear();
+
+        // Zielorte einmal pro Haltestelle, Abfahrten verweisen per ID darauf
+        const uint8_t* directions[DirectionTable::MAX_ENTRIES];
+        size_t directionLens[DirectionTable::MAX_ENTRIES];
+        uint8_t directionCount = in.u8();
+        if (directionCount > DirectionTable::MAX_ENTRIES) in.ok = false;
+        for (uint8_t d = 0; d < directionCount && in.ok; d++) {
+            directions[d] = in.str(directionLens[d]);
+        }
+
+        uint8_t count = in.u8();
+        for (uint8_t n = 0; n < count && in.ok; n++) {
+            Departure dep;
+            dep.departureTime = in.u32();
+            dep.mode = (PtMode)in.u8();
+            uint8_t direction = in.u8();
+            in.str(dep.line, Departure::LINE_LEN);
+
+            char text[128];
+            if (direction < directionCount) {
+                Reader::copy(directions[direction], directionLens[direction], text, sizeof(text));
+            } else {
+                text[0] = '\0';
+            }
+            if (in.ok) _lists[i].add(dep, text);
+        }
+    }
+
+    if (!in.ok || _savedAt < MIN_VALID_TIME) {
+        for (size_t i = 0; i < MAX_STOPS; i++) {
+            _stopIds[i] = String();
+            _lists[i].clear();
+        }
+        _savedAt = 0;
+        return false;
+    }
+    return true;
+}
+
+bool DepartureCache::fallback(const String* stopIds, time_t now, DepartureSnapshot& out) const {
+    if (_savedAt == 0) return false;
+
+    bool timeValid = now >= MIN_VALID_TIME;
+    bool any = false;
+    for (size_t i = 0; i < MAX_STOPS; i++) {
+        out.stops[i].clear();
+        if (stopIds[i].isEmpty() || stopIds[i] != _stopIds[i]) continue;
+
+        const DepartureList& cached = _lists[i];
+        for (const Departure& dep : cached) {
+            if (timeValid && dep.departureTime < now) continue;
+            Departure planned = dep;
+            planned.estimatedTime = 0;
+            out.stops[i].add(planned, cached.direction(dep));
+        }
+        any = true;
+    }
+
+    out.fetchedAt = _savedAt;
+    out.offline = true;
+    return any;
+}
@@ -0,0 +1,78 @@
+#ifndef DEPARTURE_CACHE_H
+#define DEPARTURE_CACHE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <vector>
+#include "TransportTypes.h"
+
+/**
+ * Offline-Cache der Abfahrten in LittleFS.
+ *
+ * Hält pro Haltestelle die Liste des letzten "tiefen" Polls
+ * (DepartureList::CAPACITY Abfahrten statt der üblichen 4, einmal pro
+ * REFRESH_S oder früher, wenn der Vorrat knapp wird) und liefert daraus
+ * einen Ersatzstand:
+ * - beim Start, bevor WLAN, NTP und TLS stehen
+ * - solange keine Live-Daten kommen
+ *
+ * Reichweite: bewusst höchstens CAPACITY Abfahrten pro Haltestelle (kein
+ * eigener Zeithorizont), an einer dichten Haltestelle also etwa eine
+ * Stunde, nicht mehrere.
+ *
+ * Der Ersatzstand enthält nur Kurse, die laut Fahrplan noch nicht abgefahren
+ * sind, und keine Prognosen (die wären veraltet).
+ *
+ * Dateiformat (little endian), Header:
+ *   "DEPC", uint16 Version, uint16 Haltestellen, uint32 Länge, uint32 CRC-32
+ * Nutzdaten: uint32 Stand, dann pro Haltestelle
+ *   str ID, uint8 Zielorte, je str Zielort,
+ *   uint8 Abfahrten, je uint32 Fahrplanzeit, uint8 Verkehrsmittel, uint8 Zielort-ID, str Linie
+ * (str = uint8 Länge + Bytes). Falsche Version oder CRC: Datei wird ignoriert.
+ *
+ * Nur aus dem TransportTask bzw. vor dessen Start benutzen (kein Mutex).
+ */
+class DepartureCache {
+public:
+    static const size_t MAX_STOPS = DepartureSnapshot::MAX_STOPS;
+    static const uint16_t SCHEMA_VERSION = 1;
+    static const time_t REFRESH_S = 3600;       // Abstand der tiefen Polls
+    static const time_t MIN_HORIZON_S = 1800;   // Vorrat, unter dem früher aufgefrischt wird
+    static const time_t MIN_REFRESH_S = 600;    // Frühestens so oft (Flash-Schreibzugriffe)
+
+    DepartureCache();
+
+    // Lädt den gespeicherten Stand. false = keine gültige Datei
+    bool begin(fs::FS* fs, const char* path);
+
+    // Tiefer Poll fällig: nichts gespeichert, andere Haltestellen, Stand
+    // älter als REFRESH_S oder Vorrat kürzer als MIN_HORIZON_S (frühestens
+    // nach MIN_REFRESH_S). Ohne gültige Uhrzeit nie.
+    bool refreshDue(const String* stopIds, time_t now) const;
+
+    // Ergebnis eines tiefen Polls übernehmen und schreiben
+    bool store(const String* stopIds, const DepartureSnapshot& snapshot, time_t now);
+
+    // Ersatzstand für die aktuell konfigurierten Haltestellen (gleiche ID).
+    // Ohne gültige Uhrzeit werden abgefahrene Kurse nicht aussortiert.
+    // false = nichts Verwendbares im Cache.
+    bool fallback(const String* stopIds, time_t now, DepartureSnapshot& out) const;
+
+    time_t getSavedAt() const { return _savedAt; }
+
+    // Letzte Abfahrt, die der Cache noch abdeckt (früheste über alle
+    // Haltestellen mit voller Liste). 0 = keine volle Liste
+    time_t getHorizon() const;
+
+private:
+    fs::FS* _fs;
+    const char* _path;
+    String _stopIds[MAX_STOPS];
+    DepartureList _lists[MAX_STOPS];
+    time_t _savedAt;                // 0 = leer
+
+    void encode(std::vector<uint8_t>& out) const;
+    bool decode(const uint8_t* data, size_t length);
+};
+
+#endif // DEPARTURE_CACHE_H
@@ -0,0 +1,51 @@
+#include "DepartureDiff.h"
+
+static_assert(DepartureList::CAPACITY <= 32, "Change masks are 32 bit");
+
+DepartureChangeSet DepartureDiff::compare(const DepartureList& before, const DepartureList& after) {
+    DepartureChangeSet changes;
+    changes.count = after.size();
+    changes.previousCount = before.size();
+
+    uint32_t matched = 0;   // Bereits zugeordnete Zeilen der alten Liste
+    for (size_t i = 0; i < after.size(); i++) {
+        const Departure& dep = after[i];
+
+        int found = -1;
+        for (size_t j = 0; j < before.size(); j++) {
+            if ((matched & (1UL << j)) == 0 && sameTrip(before, before[j], after, dep)) {
+                found = (int)j;
+                break;
+            }
+        }
+
+        DepartureChange change;
+        if (found < 0) {
+            change = DEPARTURE_NEW;
+        } else {
+            matched |= 1UL << found;
+            if (before[found].getEffectiveTime() != dep.getEffectiveTime()) {
+                change = DEPARTURE_DELAY_CHANGED;
+            } else if ((size_t)found != i) {
+                change = DEPARTURE_REORDERED;
+            } else {
+                change = DEPARTURE_UNCHANGED;
+            }
+        }
+
+        changes.rows[i] = change;
+        if (change != DEPARTURE_UNCHANGED) changes.changedMask |= 1UL << i;
+    }
+
+    for (size_t j = 0; j < before.size(); j++) {
+        if ((matched & (1UL << j)) == 0) changes.gone++;
+    }
+    return changes;
+}
+
+bool DepartureDiff::sameTrip(const DepartureList& before, const Departure& old,
+                             const DepartureList& after, const Departure& dep) {
+    return old.departureTime == dep.departureTime &&
+           strcmp(old.line, dep.line) == 0 &&
+           strcmp(before.direction(old), after.direction(dep)) == 0;
+}
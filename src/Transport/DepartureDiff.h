@@ -0,0 +1,23 @@
+#ifndef DEPARTURE_DIFF_H
+#define DEPARTURE_DIFF_H
+
+#include <Arduino.h>
+#include "TransportTypes.h"
+
+/**
+ * Vergleicht zwei Abfahrtslisten derselben Haltestelle zeilenweise.
+ *
+ * Ein Kurs wird über Linie, Zielort (Text, nicht ID) und Fahrplanzeit
+ * wiedererkannt; jede alte Zeile wird höchstens einmal zugeordnet.
+ * Die Zeiten sind absolute UTC-Epochs, ein Datumswechsel spielt daher keine Rolle.
+ */
+class DepartureDiff {
+public:
+    static DepartureChangeSet compare(const DepartureList& before, const DepartureList& after);
+
+private:
+    static bool sameTrip(const DepartureList& before, const Departure& old,
+                         const DepartureList& after, const Departure& dep);
+};
+
+#endif // DEPARTURE_DIFF_H
@@ -0,0 +1,328 @@
+#include "LineCatalog.h"
+#include "../Core/StringUtils.h"
+#include "../Logger/Logger.h"
+
+namespace {
+
+const char* FILE_HEADER = "lines 1";
+const time_t MIN_VALID_TIME = 1577836800;
+const time_t SECONDS_PER_DAY = 86400;
+
+const uint32_t FNV_OFFSET = 2166136261u;
+const uint32_t FNV_PRIME = 16777619u;
+
+uint32_t fnv1a(const char* s, uint32_t hash) {
+    for (; *s; s++) hash = (hash ^ (uint8_t)*s) * FNV_PRIME;
+    // Trenner, damit "1" + "0Bern" nicht "10" + "Bern" ergibt
+    return (hash ^ 0xFF) * FNV_PRIME;
+}
+
+uint32_t hashOf(const char* line, PtMode mode, const char* direction) {
+    uint32_t hash = fnv1a(line, FNV_OFFSET);
+    hash = (hash ^ (uint8_t)mode) * FNV_PRIME;
+    return fnv1a(direction, hash);
+}
+
+} // namespace
+
+// --- LineSet ---
+
+LineSet::LineSet() {
+    clear();
+}
+
+void LineSet::clear() {
+    _entries.clear();
+    memset(_index, INDEX_EMPTY, sizeof(_index));
+}
+
+size_t LineSet::probe(uint32_t hash, const char* line, PtMode mode, const char* direction) const {
+    size_t slot = hash & (INDEX_SIZE - 1);
+    for (;;) {
+        uint8_t pos = _index[slot];
+        if (pos == INDEX_EMPTY) return slot;
+        const Entry& entry = _entries[pos];
+        if (entry.hash == hash && entry.mode == mode &&
+            strcmp(entry.line, line) == 0 && entry.direction == direction) {
+            return slot;
+        }
+        slot = (slot + 1) & (INDEX_SIZE - 1);
+    }
+}
+
+bool LineSet::add(const char* line, PtMode mode, const char* direction, uint16_t seenDay) {
+    if (!direction) direction = "";
+    char ascii[Departure::LINE_LEN];
+    StringUtils::toASCII(line ? line : "", ascii, sizeof(ascii));
+
+    uint32_t hash = hashOf(ascii, mode, direction);
+    size_t slot = probe(hash, ascii, mode, direction);
+    if (_index[slot] != INDEX_EMPTY) {
+        Entry& entry = _entries[_index[slot]];
+        if (seenDay > entry.seenDay) entry.seenDay = seenDay;
+        return false;
+    }
+
+    Entry entry;
+    memcpy(entry.line, ascii, sizeof(entry.line));
+    entry.mode = mode;
+    entry.seenDay = seenDay;
+    entry.hash = hash;
+    entry.direction = direction;
+
+    if (_entries.size() < MAX_LINES) {
+        _index[slot] = (uint8_t)_entries.size();
+        _entries.push_back(entry);
+        return true;
+    }
+
+    // Voll: am längsten nicht gesehene Linie ersetzen (falls älter)
+    size_t oldest = 0;
+    for (size_t i = 1; i < _entries.size(); i++) {
+        if (_entries[i].seenDay < _entries[oldest].seenDay) oldest = i;
+    }
+    if (_entries[oldest].seenDay > seenDay) return false;
+    _entries.erase(_entries.begin() + oldest);
+    _entries.push_back(entry);
+    rebuildIndex();
+    return true;
+}
+
+size_t LineSet::prune(uint16_t cutoffDay) {
+    size_t before = _entries.size();
+    for (size_t i = 0; i < _entries.size(); ) {
+        if (_entries[i].seenDay < cutoffDay) {
+            _entries.erase(_entries.begin() + i);
+        } else {
+            i++;
+        }
+    }
+    size_t removed = before - _entries.size();
+    if (removed > 0) rebuildIndex();
+    return removed;
+}
+
+void LineSet::rebuildIndex() {
+    memset(_index, INDEX_EMPTY, sizeof(_index));
+    for (size_t i = 0; i < _entries.size(); i++) {
+        const Entry& entry = _entries[i];
+        _index[probe(entry.hash, entry.line, entry.mode, entry.direction.c_str())] = (uint8_t)i;
+    }
+}
+
+void LineSet::toLineInfo(std::vector<LineInfo>& out) const {
+    out.reserve(out.size() + _entries.size());
+    for (const Entry& entry : _entries) {
+        LineInfo info;
+        info.line = entry.line;
+        info.direction = entry.direction;
+        info.type = ptModeToString(entry.mode);
+        out.push_back(info);
+    }
+}
+
+// --- LineCatalog ---
+
+LineCatalog::LineCatalog()
+    : _count(0),
+      _clock(0),
+      _dirty(false),
+      _fs(NULL),
+      _path(NULL)
+{
+    _mutex = xSemaphoreCreateMutex();
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void LineCatalog::setStorage(fs::FS* fs, const char* path) {
+    _fs = fs;
+    _path = path;
+    load();
+}
+
+uint16_t LineCatalog::dayOf(time_t now) {
+    return now < MIN_VALID_TIME ? 0 : (uint16_t)(now / SECONDS_PER_DAY);
+}
+
+bool LineCatalog::lookup(const String& stopId, time_t now, std::vector<LineInfo>& lines) {
+    uint16_t day = dayOf(now);
+    if (!_mutex) return false;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Stop* stop = find(stopId);
+    bool fresh = day && stop && stop->completeDay && day - stop->completeDay < TTL_DAYS;
+    if (fresh) {
+        lines.clear();
+        stop->lines.toLineInfo(lines);
+        stop->lastUsed = ++_clock;
+        _stats.hits++;
+    } else {
+        _stats.misses++;
+    }
+    xSemaphoreGive(_mutex);
+    return fresh;
+}
+
+void LineCatalog::merge(const String& stopId, const DepartureList& departures, time_t now) {
+    uint16_t day = dayOf(now);
+    if (!_mutex || !day || stopId.length() == 0 || departures.empty()) return;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Stop* stop = slotFor(stopId);
+    for (const Departure& dep : departures) {
+        if (dep.line[0] == '\0') continue;
+        if (stop->lines.add(dep.line, dep.mode, departures.direction(dep), day)) {
+            _stats.learned++;
+            _dirty = true;
+        }
+    }
+    if (stop->lines.prune(day - TTL_DAYS) > 0) _dirty = true;
+    // Aufgefrischte Zeitstempel nur einmal pro Tag sichern
+    if (day != stop->seenDay) {
+        stop->seenDay = day;
+        _dirty = true;
+    }
+    stop->lastUsed = ++_clock;
+    xSemaphoreGive(_mutex);
+}
+
+bool LineCatalog::mergeComplete(const String& stopId, const LineSet& lines, time_t now, std::vector<LineInfo>& merged) {
+    // Leere Antwort (z.B. nachts) macht den Katalog nicht vollständig
+    uint16_t day = dayOf(now);
+    if (!_mutex || !day || stopId.length() == 0 || lines.empty()) return false;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Stop* stop = slotFor(stopId);
+    for (const LineSet::Entry& entry : lines._entries) {
+        stop->lines.add(entry.line, entry.mode, entry.direction.c_str(), day);
+    }
+    stop->lines.prune(day - TTL_DAYS);
+    stop->completeDay = day;
+    stop->seenDay = day;
+    stop->lastUsed = ++_clock;
+    _dirty = true;
+    merged.clear();
+    stop->lines.toLineInfo(merged);
+    xSemaphoreGive(_mutex);
+    return true;
+}
+
+LineCatalog::Stop* LineCatalog::find(const String& stopId) {
+    for (size_t i = 0; i < _count; i++) {
+        if (_stops[i].id == stopId) return &_stops[i];
+    }
+    return NULL;
+}
+
+LineCatalog::Stop* LineCatalog::slotFor(const String& stopId) {
+    Stop* stop = find(stopId);
+    if (stop) return stop;
+
+    if (_count < MAX_STOPS) {
+        stop = &_stops[_count++];
+    } else {
+        // Voll: am längsten nicht benutzte Haltestelle ersetzen
+        stop = &_stops[0];
+        for (size_t i = 1; i < _count; i++) {
+            if (_stops[i].lastUsed < stop->lastUsed) stop = &_stops[i];
+        }
+    }
+    stop->id = stopId;
+    stop->completeDay = 0;
+    stop->seenDay = 0;
+    stop->lastUsed = 0;
+    stop->lines.clear();
+    return stop;
+}
+
+bool LineCatalog::save() {
+    if (!_fs || !_path || !_mutex) return false;
+
+    // Inhalt unter dem Mutex zusammenstellen, geschrieben wird ohne
+    String content;
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (!_dirty) {
+        xSemaphoreGive(_mutex);
+        return false;
+    }
+    _dirty = false;
+
+    // Pro Haltestelle "id, Tag der Linienabfrage, Anzahl", dann je Linie
+    // "Linie, Verkehrsmittel, zuletzt gesehen, Zielort"
+    content = FILE_HEADER;
+    content += '\n';
+    for (size_t i = 0; i < _count; i++) {
+        const Stop& stop = _stops[i];
+        content += stop.id + "\t" + String(stop.completeDay) + "\t" + String((unsigned)stop.lines.size()) + "\n";
+        for (const LineSet::Entry& entry : stop.lines._entries) {
+            content += String(entry.line) + "\t" + ptModeToString(entry.mode) + "\t" +
+                       String(entry.seenDay) + "\t" + entry.direction + "\n";
+        }
+    }
+    xSemaphoreGive(_mutex);
+
+    File file = _fs->open(_path, "w");
+    if (!file) {
+        Logger::error("LINES", "Cannot write line catalog");
+        return false;
+    }
+    file.print(content);
+    file.close();
+    return true;
+}
+
+void LineCatalog::load() {
+    if (!_fs || !_path || !_mutex) return;
+
+    File file = _fs->open(_path, "r");
+    if (!file) return;
+
+    String header = file.readStringUntil('\n');
+    if (header != FILE_HEADER) {
+        file.close();
+        return;
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    _count = 0;
+    while (file.available() && _count < MAX_STOPS) {
+        String fields[4];
+        if (StringUtils::split(file.readStringUntil('\n'), '\t', fields, 3) != 3) break;
+
+        Stop& stop = _stops[_count];
+        stop.id = fields[0];
+        stop.completeDay = (uint16_t)fields[1].toInt();
+        stop.seenDay = 0;
+        stop.lines.clear();
+        long count = fields[2].toInt();
+        for (long i = 0; i < count; i++) {
+            if (StringUtils::split(file.readStringUntil('\n'), '\t', fields, 4) != 4) continue;
+            uint16_t seenDay = (uint16_t)fields[2].toInt();
+            stop.lines.add(fields[0].c_str(), ptModeFromString(fields[1].c_str()), fields[3].c_str(), seenDay);
+            if (seenDay > stop.seenDay) stop.seenDay = seenDay;
+        }
+        _count++;
+    }
+    // Nach dem Start gelten alle als gleich lange unbenutzt
+    for (size_t i = 0; i < _count; i++) {
+        _stops[i].lastUsed = 0;
+    }
+    _clock = 0;
+    _dirty = false;
+    xSemaphoreGive(_mutex);
+    file.close();
+
+    Logger::printf("LINES", "Loaded line catalog for %u stops", (unsigned)_count);
+}
+
+LineCatalogStats LineCatalog::getStats() {
+    LineCatalogStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (!_mutex) return stats;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    stats = _stats;
+    stats.stops = _count;
+    xSemaphoreGive(_mutex);
+    return stats;
+}
@@ -0,0 +1,136 @@
+#ifndef LINE_CATALOG_H
+#define LINE_CATALOG_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <vector>
+#include "TransportTypes.h"
+
+/**
+ * Menge von Linien einer Haltestelle (Linie + Verkehrsmittel + Zielort).
+ *
+ * Doppelte werden über einen Hash-Index erkannt (offene Adressierung,
+ * höchstens halb voll): ein Vergleich pro Abfahrt statt eines Durchlaufs
+ * über alle bisherigen Linien.
+ */
+class LineSet {
+public:
+    static const size_t MAX_LINES = 48;
+
+    LineSet();
+
+    void clear();
+
+    // Übernimmt eine Linie bzw. frischt `seenDay` auf. Die Liniennummer wird
+    // wie in DepartureList nach ASCII transliteriert. Ist die Menge voll,
+    // ersetzt eine neue Linie die am längsten nicht gesehene.
+    // true = Linie war neu.
+    bool add(const char* line, PtMode mode, const char* direction, uint16_t seenDay);
+
+    // Entfernt Linien, die vor `cutoffDay` zuletzt gesehen wurden
+    size_t prune(uint16_t cutoffDay);
+
+    size_t size() const { return _entries.size(); }
+    bool empty() const { return _entries.empty(); }
+
+    // Für die Web-API, in der Reihenfolge des ersten Auftretens
+    void toLineInfo(std::vector<LineInfo>& out) const;
+
+private:
+    friend class LineCatalog;
+
+    static const size_t INDEX_SIZE = 128;   // Zweierpotenz, >= 2 * MAX_LINES
+    static const uint8_t INDEX_EMPTY = 0xFF;
+
+    struct Entry {
+        char line[Departure::LINE_LEN];
+        PtMode mode;
+        uint16_t seenDay;       // Tage seit 1970 (UTC)
+        uint32_t hash;
+        String direction;
+    };
+
+    std::vector<Entry> _entries;
+    uint8_t _index[INDEX_SIZE];     // Position in _entries, INDEX_EMPTY = frei
+
+    // Slot des gesuchten Eintrags oder der freie Slot, an dem er stehen müsste
+    size_t probe(uint32_t hash, const char* line, PtMode mode, const char* direction) const;
+    void rebuildIndex();
+};
+
+struct LineCatalogStats {
+    uint32_t hits;          // Linienauswahl ohne OJP-Request beantwortet
+    uint32_t misses;        // Unbekannt, unvollständig oder abgelaufen: Request nötig
+    uint32_t learned;       // Neue Linien aus regulären Polls
+    uint32_t stops;
+};
+
+/**
+ * Linienkatalog pro Haltestelle für die Linienauswahl der Web-Oberfläche.
+ *
+ * Eine Linienabfrage (50 Abfahrten) macht den Katalog einer Haltestelle
+ * "vollständig"; jeder reguläre Poll ergänzt danach die Linien der
+ * konfigurierten Haltestellen (z.B. Nachtlinien) und frischt sie auf.
+ * Beantwortet wird nur aus vollständigen Katalogen, die jünger als TTL_DAYS
+ * sind. Linien, die TTL_DAYS lang nicht mehr vorkamen, fallen weg.
+ *
+ * Zeitstempel haben Tagesauflösung: geschrieben wird nur bei neuen Linien,
+ * neuer Linienabfrage oder einem neuen Tag, nicht bei jedem Poll. Ohne
+ * gültige Uhrzeit (vor dem NTP-Sync) wird weder gelernt noch geantwortet.
+ *
+ * Zugriff aus Webserver und TransportTask, deshalb der Mutex.
+ */
+class LineCatalog {
+public:
+    static const size_t MAX_STOPS = 8;
+    static const uint16_t TTL_DAYS = 7;
+
+    LineCatalog();
+
+    // Persistenz aktivieren und vorhandenen Stand laden. Ohne Aufruf nur im RAM.
+    void setStorage(fs::FS* fs, const char* path);
+
+    // Linien aus einem vollständigen, nicht abgelaufenen Katalog
+    bool lookup(const String& stopId, time_t now, std::vector<LineInfo>& lines);
+
+    // Abfahrten eines regulären Polls einarbeiten
+    void merge(const String& stopId, const DepartureList& departures, time_t now);
+
+    // Ergebnis einer Linienabfrage einarbeiten, Katalog gilt danach als
+    // vollständig. `merged` = Katalog inkl. früher gelernter Linien.
+    // false = nicht übernommen (leer oder keine gültige Uhrzeit).
+    bool mergeComplete(const String& stopId, const LineSet& lines, time_t now, std::vector<LineInfo>& merged);
+
+    // Geänderten Stand schreiben (falls Persistenz aktiv und etwas neu ist)
+    bool save();
+
+    LineCatalogStats getStats();
+
+private:
+    struct Stop {
+        String id;
+        uint16_t completeDay;   // Letzte Linienabfrage, 0 = nie
+        uint16_t seenDay;       // Letzter Poll bzw. jüngste Linie
+        uint32_t lastUsed;      // LRU-Zähler
+        LineSet lines;
+    };
+
+    SemaphoreHandle_t _mutex;
+    Stop _stops[MAX_STOPS];
+    size_t _count;
+    uint32_t _clock;
+    bool _dirty;
+    fs::FS* _fs;
+    const char* _path;
+    LineCatalogStats _stats;
+
+    // Aufrufer hält _mutex
+    Stop* find(const String& stopId);
+    Stop* slotFor(const String& stopId);
+    void load();
+
+    // Tage seit 1970, 0 ohne gültige Uhrzeit
+    static uint16_t dayOf(time_t now);
+};
+
+#endif // LINE_CATALOG_H
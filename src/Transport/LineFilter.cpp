@@ -0,0 +1,124 @@
+#include "LineFilter.h"
+#include "../Core/StringUtils.h"
+
+LineFilter::LineFilter()
+    : _ruleCount(0), _serverEnabled(true), _serverMisses(0) {
+}
+
+void LineFilter::normalize(const char* input, char* out, size_t capacity) {
+    StringUtils::toASCII(input ? input : "", out, capacity);
+
+    const char* start = out;
+    while (*start == ' ') start++;
+    size_t len = 0;
+    for (const char* p = start; *p; p++) {
+        out[len++] = (char)tolower((unsigned char)*p);
+    }
+    while (len > 0 && out[len - 1] == ' ') len--;
+    out[len] = '\0';
+}
+
+void LineFilter::configure(const LineConfig* rules, size_t count) {
+    _ruleCount = 0;
+    for (size_t i = 0; i < count && _ruleCount < MAX_RULES; i++) {
+        Rule& rule = _rules[_ruleCount];
+        normalize(rules[i].name.c_str(), rule.line, sizeof(rule.line));
+        if (rule.line[0] == '\0') continue;
+        normalize(rules[i].direction.c_str(), rule.direction, sizeof(rule.direction));
+        _ruleCount++;
+    }
+    dropRefs();
+    _serverMisses = 0;
+}
+
+void LineFilter::dropRefs() {
+    for (size_t i = 0; i < MAX_RULES; i++) _rules[i].refCount = 0;
+}
+
+uint8_t LineFilter::matchMask(const Departure& dep, const char* direction) const {
+    char line[Departure::LINE_LEN * 2];
+    char dir[DIRECTION_LEN];
+    normalize(dep.line, line, sizeof(line));
+    bool dirReady = false;
+
+    uint8_t mask = 0;
+    for (size_t i = 0; i < _ruleCount; i++) {
+        const Rule& rule = _rules[i];
+        if (strcmp(rule.line, line) != 0) continue;
+        if (rule.direction[0] != '\0') {
+            if (!dirReady) {
+                normalize(direction, dir, sizeof(dir));
+                dirReady = true;
+            }
+            if (strcmp(rule.direction, dir) != 0) continue;
+        }
+        mask |= 1 << i;
+    }
+    return mask;
+}
+
+bool LineFilter::matches(const Departure& dep, const char* direction) const {
+    return !active() || matchMask(dep, direction) != 0;
+}
+
+void LineFilter::learn(const Departure& dep, const char* direction, const char* lineRef) {
+    if (!lineRef || lineRef[0] == '\0' || strlen(lineRef) >= REF_LEN) return;
+    uint8_t mask = matchMask(dep, direction);
+
+    for (size_t i = 0; i < _ruleCount; i++) {
+        if (!(mask & (1 << i))) continue;
+        Rule& rule = _rules[i];
+        bool known = false;
+        for (size_t r = 0; r < rule.refCount && r < REFS_PER_RULE; r++) {
+            if (strcmp(rule.refs[r], lineRef) == 0) known = true;
+        }
+        if (known) continue;
+        // Mehr Refs als Platz (z.B. Linie mehrerer Betreiber): lieber ungefiltert
+        // anfragen als Abfahrten verlieren, die Regel bleibt dann ohne Server-Filter
+        if (rule.refCount >= REFS_PER_RULE) {
+            rule.refCount = REFS_PER_RULE + 1;
+            continue;
+        }
+        strcpy(rule.refs[rule.refCount++], lineRef);
+    }
+}
+
+size_t LineFilter::serverRefs(const char** out, size_t capacity) const {
+    if (!active() || !_serverEnabled) return 0;
+
+    size_t count = 0;
+    for (size_t i = 0; i < _ruleCount; i++) {
+        const Rule& rule = _rules[i];
+        if (rule.refCount == 0 || rule.refCount > REFS_PER_RULE) return 0;
+        for (size_t r = 0; r < rule.refCount; r++) {
+            // Zwei Regeln mit derselben Linie (Hin- und Rückrichtung) teilen sich die Ref
+            bool duplicate = false;
+            for (size_t k = 0; k < count; k++) {
+                if (strcmp(out[k], rule.refs[r]) == 0) duplicate = true;
+            }
+            if (duplicate) continue;
+            if (count >= capacity) return 0;
+            out[count++] = rule.refs[r];
+        }
+    }
+    if (count < capacity) out[count] = NULL;
+    return count;
+}
+
+void LineFilter::onResponse(bool rejected, bool serverFiltered, size_t matched) {
+    if (!serverFiltered) return;
+
+    if (rejected) {
+        _serverEnabled = false;
+        dropRefs();
+        return;
+    }
+    if (matched > 0) {
+        _serverMisses = 0;
+        return;
+    }
+    // Keine Treffer trotz Filter: Refs können veraltet sein, ungefiltert neu lernen.
+    // Bleibt das mehrfach so, liegt es am Filter selbst
+    dropRefs();
+    if (++_serverMisses >= MAX_SERVER_MISSES) _serverEnabled = false;
+}
@@ -0,0 +1,76 @@
+#ifndef LINE_FILTER_H
+#define LINE_FILTER_H
+
+#include <Arduino.h>
+#include "TransportTypes.h"
+#include "OjpRequestTemplate.h"
+#include "../Core/ConfigStore.h"
+
+/**
+ * Filter der Hauptstation auf die konfigurierten Linien (Line1/Line2).
+ *
+ * Lokal: Linie und Zielort müssen übereinstimmen (wie im Web-Dashboard),
+ * leerer Zielort = beide Richtungen. Verglichen wird in ASCII ohne
+ * Gross-/Kleinschreibung, die Regeln werden dafür einmal vorbereitet.
+ *
+ * Server: Der OJP LineFilter braucht die siri:LineRef, die Konfiguration
+ * kennt nur den Liniennamen. Die Refs werden deshalb aus den Antworten
+ * gelernt und erst gesendet, wenn jede Regel eine hat (sonst fehlten Linien).
+ * Der Zielort bleibt lokal. Weist der Server den Filter zurück, bleibt es
+ * für diese Sitzung beim lokalen Filter.
+ *
+ * Nur aus dem TransportTask verwenden.
+ */
+class LineFilter {
+public:
+    static const size_t MAX_RULES = 2;
+    static const size_t REFS_PER_RULE = OJP_MAX_LINE_FILTER / MAX_RULES;
+    // So viele gefilterte Requests ohne Treffer in Folge, dann nur noch lokal
+    static const uint8_t MAX_SERVER_MISSES = 3;
+    static const size_t REF_LEN = 48;               // Wie OjpStreamParser::LINE_REF_LEN
+    static const size_t DIRECTION_LEN = 64;
+
+    LineFilter();
+
+    // Regeln ohne Liniennamen werden ignoriert; gelernte Refs werden verworfen
+    void configure(const LineConfig* rules, size_t count);
+
+    // Mindestens eine Regel aktiv, sonst passt jede Abfahrt
+    bool active() const { return _ruleCount > 0; }
+
+    bool matches(const Departure& dep, const char* direction) const;
+
+    // Merkt sich die LineRef einer passenden Abfahrt
+    void learn(const Departure& dep, const char* direction, const char* lineRef);
+
+    // Refs für den Server-Filter (NULL-terminiert, falls Platz), 0 = ungefiltert anfragen
+    size_t serverRefs(const char** out, size_t capacity) const;
+
+    // Ergebnis eines Polls: `rejected` = Server hat den Request abgelehnt,
+    // `serverFiltered` = Request enthielt serverRefs(), `matched` = passende Abfahrten
+    void onResponse(bool rejected, bool serverFiltered, size_t matched);
+
+    bool serverEnabled() const { return _serverEnabled; }
+
+private:
+    struct Rule {
+        char line[Departure::LINE_LEN];
+        char direction[DIRECTION_LEN];              // Leer = jede Richtung
+        char refs[REFS_PER_RULE][REF_LEN];
+        uint8_t refCount;                           // REFS_PER_RULE + 1 = zu viele, nicht filterbar
+    };
+
+    Rule _rules[MAX_RULES];
+    uint8_t _ruleCount;
+    bool _serverEnabled;
+    uint8_t _serverMisses;
+
+    // Bit i = Regel i passt
+    uint8_t matchMask(const Departure& dep, const char* direction) const;
+    void dropRefs();
+
+    // ASCII, Kleinbuchstaben, ohne führende/abschliessende Leerzeichen
+    static void normalize(const char* input, char* out, size_t capacity);
+};
+
+#endif // LINE_FILTER_H
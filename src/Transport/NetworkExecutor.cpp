@@ -0,0 +1,174 @@
+#include "NetworkExecutor.h"
+
+NetworkExecutor::NetworkExecutor() : _nextId(1) {
+    _mutex = xSemaphoreCreateMutex();
+    memset(&_stats, 0, sizeof(_stats));
+    for (size_t i = 0; i < MAX_JOBS; i++) {
+        _slots[i].id = 0;
+        _slots[i].state = SLOT_FREE;
+        _slots[i].rerun = false;
+        _slots[i].doneAt = 0;
+    }
+}
+
+uint32_t NetworkExecutor::submit(NetworkJobType type, const String& key, NetworkJobPriority priority,
+                                 LookupResultPtr* result, bool* created) {
+    if (created) *created = false;
+    if (!_mutex) return 0;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    expire(millis());
+
+    // Single-flight: gleicher Job wartet, läuft oder ist gerade fertig geworden
+    Slot* freeSlot = NULL;
+    for (size_t i = 0; i < MAX_JOBS; i++) {
+        Slot& slot = _slots[i];
+        if (slot.state == SLOT_FREE) {
+            if (!freeSlot) freeSlot = &slot;
+            continue;
+        }
+        if (slot.type != type || slot.key != key) continue;
+
+        if (priority > slot.priority) slot.priority = priority;
+        if (result && slot.state == SLOT_DONE) *result = slot.result;
+        // Laufender Poll fragt den alten Stand ab: danach noch einmal
+        if (type == JOB_POLL && slot.state == SLOT_RUNNING) slot.rerun = true;
+        _stats.coalesced++;
+        uint32_t id = slot.id;
+        xSemaphoreGive(_mutex);
+        return id;
+    }
+
+    if (!freeSlot) {
+        _stats.rejected++;
+        xSemaphoreGive(_mutex);
+        return 0;
+    }
+
+    freeSlot->id = _nextId++;
+    if (_nextId == 0) _nextId = 1;
+    freeSlot->type = type;
+    freeSlot->priority = priority;
+    freeSlot->state = SLOT_PENDING;
+    freeSlot->rerun = false;
+    freeSlot->key = key;
+    freeSlot->result.reset();
+    _stats.submitted++;
+    _stats.pending++;
+    if (created) *created = true;
+
+    uint32_t id = freeSlot->id;
+    xSemaphoreGive(_mutex);
+    return id;
+}
+
+uint32_t NetworkExecutor::find(NetworkJobType type, const String& key, LookupResultPtr* result) {
+    if (!_mutex) return 0;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    expire(millis());
+    uint32_t id = 0;
+    for (size_t i = 0; i < MAX_JOBS; i++) {
+        Slot& slot = _slots[i];
+        if (slot.state == SLOT_FREE || slot.type != type || slot.key != key) continue;
+        if (result && slot.state == SLOT_DONE) *result = slot.result;
+        id = slot.id;
+        break;
+    }
+    xSemaphoreGive(_mutex);
+    return id;
+}
+
+size_t NetworkExecutor::cancel(NetworkJobType type, const String& key, bool (*superseded)(const String&, const String&)) {
+    if (!_mutex) return 0;
+
+    size_t cancelled = 0;
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    for (size_t i = 0; i < MAX_JOBS; i++) {
+        Slot& slot = _slots[i];
+        if (slot.state != SLOT_PENDING || slot.type != type || slot.key == key) continue;
+        if (!superseded(slot.key, key)) continue;
+        slot.state = SLOT_FREE;
+        slot.key = String();
+        _stats.pending--;
+        _stats.cancelled++;
+        cancelled++;
+    }
+    xSemaphoreGive(_mutex);
+    return cancelled;
+}
+
+bool NetworkExecutor::take(NetworkJob& job) {
+    if (!_mutex) return false;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Slot* best = NULL;
+    for (size_t i = 0; i < MAX_JOBS; i++) {
+        Slot& slot = _slots[i];
+        if (slot.state != SLOT_PENDING) continue;
+        // IDs steigen monoton (Überlauf nach 2^32 Jobs ignoriert)
+        if (!best || slot.priority > best->priority ||
+            (slot.priority == best->priority && slot.id < best->id)) {
+            best = &slot;
+        }
+    }
+    if (best) {
+        best->state = SLOT_RUNNING;
+        job.id = best->id;
+        job.type = best->type;
+        job.key = best->key;
+    }
+    xSemaphoreGive(_mutex);
+    return best != NULL;
+}
+
+void NetworkExecutor::complete(uint32_t id, LookupResultPtr result) {
+    if (!_mutex) return;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    for (size_t i = 0; i < MAX_JOBS; i++) {
+        Slot& slot = _slots[i];
+        if (slot.id != id || slot.state != SLOT_RUNNING) continue;
+
+        _stats.completed++;
+        if (!result && slot.rerun) {
+            // Bleibt offen (pending unverändert), der Worker holt ihn mit take() gleich wieder
+            slot.state = SLOT_PENDING;
+            slot.rerun = false;
+            _stats.rerun++;
+            break;
+        }
+        _stats.pending--;
+        if (result) {
+            slot.state = SLOT_DONE;
+            slot.result = result;
+            slot.doneAt = millis();
+        } else {
+            slot.state = SLOT_FREE;
+            slot.key = String();
+        }
+        break;
+    }
+    xSemaphoreGive(_mutex);
+}
+
+NetworkExecutorStats NetworkExecutor::getStats() {
+    NetworkExecutorStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (!_mutex) return stats;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    stats = _stats;
+    xSemaphoreGive(_mutex);
+    return stats;
+}
+
+void NetworkExecutor::expire(unsigned long now) {
+    for (size_t i = 0; i < MAX_JOBS; i++) {
+        Slot& slot = _slots[i];
+        if (slot.state != SLOT_DONE || now - slot.doneAt < RESULT_TTL_MS) continue;
+        slot.state = SLOT_FREE;
+        slot.key = String();
+        slot.result.reset();
+    }
+}
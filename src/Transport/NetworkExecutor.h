@@ -0,0 +1,122 @@
+#ifndef NETWORK_EXECUTOR_H
+#define NETWORK_EXECUTOR_H
+
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+#include "TransportTypes.h"
+
+enum NetworkJobType : uint8_t {
+    JOB_POLL,           // Gebündelter Abfahrts-Request aller Haltestellen
+    JOB_STOP_SEARCH,    // key = Suchbegriff
+    JOB_LINES           // key = StopId
+};
+
+enum NetworkJobPriority : uint8_t {
+    PRIORITY_BACKGROUND = 0,
+    PRIORITY_INTERACTIVE = 1    // Jemand wartet in der Web-Oberfläche
+};
+
+enum LookupStatus : uint8_t {
+    LOOKUP_OK,
+    LOOKUP_OFFLINE,     // Kein WLAN, Request wurde nicht gesendet
+    LOOKUP_FAILED       // HTTP-/Verbindungsfehler oder ungültige Antwort der API
+};
+
+// Ergebnis einer Suche bzw. Linienabfrage (leer bei Fehler, siehe `status`)
+struct LookupResult {
+    LookupStatus status;
+    std::vector<StopSearchResult> stops;
+    std::vector<LineInfo> lines;
+
+    LookupResult() : status(LOOKUP_OK) {}
+};
+typedef std::shared_ptr<const LookupResult> LookupResultPtr;
+
+struct NetworkJob {
+    uint32_t id;
+    NetworkJobType type;
+    String key;
+};
+
+struct NetworkExecutorStats {
+    uint32_t submitted;     // Neu angelegte Jobs
+    uint32_t coalesced;     // An einen gleichen wartenden/laufenden/fertigen Job angehängt
+    uint32_t rerun;         // Polls, die wegen eines Auslösers während des Laufs wiederholt wurden
+    uint32_t rejected;      // Warteschlange voll
+    uint32_t cancelled;     // Verworfen, bevor sie liefen (überholt)
+    uint32_t completed;
+    uint32_t pending;       // Aktuell wartend oder laufend
+};
+
+/**
+ * Warteschlange für alle Requests über die OJP-Verbindung.
+ *
+ * Abgearbeitet wird von genau einem Task (TransportTask), damit sich Suche,
+ * Linienabfrage und Poll nie gegenseitig ins Gehege kommen und kein
+ * Web-Handler auf einen TLS-Round-Trip warten muss.
+ *
+ * - Priorität: interaktive Jobs vor Hintergrund-Polls, sonst älteste zuerst.
+ *   Ein laufender Request wird nicht unterbrochen.
+ * - Single-flight: Gleicher Typ + Schlüssel ergibt denselben Job, solange er
+ *   wartet, läuft oder sein Ergebnis noch RESULT_TTL_MS abholbar ist.
+ *   Polls haben kein Ergebnis und sind nach dem Abschluss sofort frei.
+ * - Polls: Ein neuer Poll hängt sich nur an einen wartenden an. Läuft gerade
+ *   einer, wird er nach dem Abschluss einmal wiederholt (er hat den Stand vor
+ *   dem Auslöser, z.B. einer neuen Haltestelle, abgefragt).
+ */
+class NetworkExecutor {
+public:
+    static const size_t MAX_JOBS = 8;
+    static const uint32_t RESULT_TTL_MS = 5000;    // Zeit zum Abholen per erneuter Anfrage
+
+    NetworkExecutor();
+
+    // Legt einen Job an oder hängt sich an einen gleichen an. Liefert die
+    // Job-ID, 0 = Warteschlange voll. `result` wird gesetzt, falls das
+    // Ergebnis schon da ist; `created` ob ein neuer Job angelegt wurde
+    // (dann muss der Worker geweckt werden).
+    uint32_t submit(NetworkJobType type, const String& key, NetworkJobPriority priority,
+                    LookupResultPtr* result = NULL, bool* created = NULL);
+
+    // ID eines gleichen Jobs (wartend, laufend oder fertig), ohne einen
+    // anzulegen; 0 = keiner. `result` wie bei submit().
+    uint32_t find(NetworkJobType type, const String& key, LookupResultPtr* result = NULL);
+
+    // Verwirft wartende Jobs des Typs, die laut `superseded(wartenderKey, key)`
+    // überholt sind (ausser dem Job für `key` selbst). Laufende bleiben.
+    size_t cancel(NetworkJobType type, const String& key, bool (*superseded)(const String&, const String&));
+
+    // Worker: nächsten Job holen (höchste Priorität, dann älteste ID)
+    bool take(NetworkJob& job);
+
+    // Worker: Job abschliessen. Ohne Ergebnis (Poll) wird der Platz sofort frei,
+    // ausser der Poll wurde während des Laufs erneut angefordert: dann wartet er wieder.
+    void complete(uint32_t id, LookupResultPtr result);
+
+    NetworkExecutorStats getStats();
+
+private:
+    enum SlotState : uint8_t { SLOT_FREE, SLOT_PENDING, SLOT_RUNNING, SLOT_DONE };
+
+    struct Slot {
+        uint32_t id;
+        NetworkJobType type;
+        NetworkJobPriority priority;
+        SlotState state;
+        bool rerun;             // Poll nach dem Abschluss erneut einreihen
+        String key;
+        unsigned long doneAt;
+        LookupResultPtr result;
+    };
+
+    SemaphoreHandle_t _mutex;
+    Slot _slots[MAX_JOBS];
+    uint32_t _nextId;
+    NetworkExecutorStats _stats;
+
+    // Abgelaufene Ergebnisse freigeben (Aufrufer hält _mutex)
+    void expire(unsigned long now);
+};
+
+#endif // NETWORK_EXECUTOR_H
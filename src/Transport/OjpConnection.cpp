@@ -0,0 +1,134 @@
+#include "OjpConnection.h"
+#include <WiFi.h>
+#include "../Logger/Logger.h"
+#include "certs.h"
+
+OjpConnection::OjpConnection(const char* host, const char* path, const char* apiKey)
+    : _host(host),
+      _path(path),
+      _authorization(String("Bearer ") + apiKey),
+      _resolvedAt(0),
+      _resolved(false),
+      _lastUsed(0)
+{
+    _mutex = xSemaphoreCreateMutex();
+    memset(&_stats, 0, sizeof(_stats));
+
+#ifdef DEV_BUILD
+    _client.setInsecure();
+#endif
+}
+
+int OjpConnection::post(const uint8_t* body, size_t length, Stream& sink, int& written) {
+    written = 0;
+    if (!_mutex) return HTTPC_ERROR_CONNECTION_REFUSED;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+
+    int httpCode = HTTPC_ERROR_CONNECTION_REFUSED;
+
+    // Zweiter Versuch nur, wenn eine wiederverwendete Verbindung inzwischen tot war
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool reused = isReusable();
+        if (!reused) {
+            _client.stop();
+            if (!connect()) break;
+        }
+
+        _http.setReuse(true);
+        if (!_http.begin(_client, _host, PORT, _path, true)) break;
+        _http.addHeader("Content-Type", "application/xml");
+        _http.addHeader("Authorization", _authorization);
+        _http.addHeader("User-Agent", "CrowPanel-OEV-Display/1.0");
+
+        unsigned long start = millis();
+        httpCode = _http.POST((uint8_t*)body, length);
+
+        if (httpCode < 0 && reused) {
+            // Server hat die Keep-Alive-Verbindung geschlossen
+            Logger::printf("OJP", "Reused connection failed (%s), reconnecting", _http.errorToString(httpCode).c_str());
+            _http.end();
+            _client.stop();
+            _stats.reconnects++;
+            continue;
+        }
+
+        if (httpCode > 0) {
+            _stats.requests++;
+            _stats.lastTtfbMs = millis() - start;
+            _stats.avgTtfbMs = (_stats.requests == 1)
+                ? _stats.lastTtfbMs
+                : (_stats.avgTtfbMs * 7 + _stats.lastTtfbMs) / 8;
+        }
+
+        if (httpCode == HTTP_CODE_OK) {
+            written = _http.writeToStream(&sink);
+        }
+
+        // Hält die Verbindung offen, sofern der Server nicht "Connection: close" geschickt hat
+        _http.end();
+        if (httpCode < 0 || written < 0) {
+            _client.stop();
+        }
+        _lastUsed = millis();
+        break;
+    }
+
+    xSemaphoreGive(_mutex);
+    return httpCode;
+}
+
+void OjpConnection::close() {
+    if (!_mutex) return;
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    _client.stop();
+    xSemaphoreGive(_mutex);
+}
+
+bool OjpConnection::isReusable() {
+    if (!_client.connected()) return false;
+    return (millis() - _lastUsed) < IDLE_TIMEOUT_MS;
+}
+
+bool OjpConnection::connect() {
+    if (!resolveHost()) return false;
+
+    unsigned long start = millis();
+
+    // Verbindung über die gecachte IP, der Hostname wird für SNI/Zertifikat weitergegeben
+#ifdef DEV_BUILD
+    int ok = _client.connect(_address, PORT, _host, NULL, NULL, NULL);
+#else
+    int ok = _client.connect(_address, PORT, _host, ROOT_CA_CERT, NULL, NULL);
+#endif
+
+    if (!ok) {
+        // IP könnte sich geändert haben: beim nächsten Versuch neu auflösen
+        _resolved = false;
+        Logger::printf("OJP", "TLS connect to %s failed", _host);
+        return false;
+    }
+
+    _stats.handshakes++;
+    _stats.lastHandshakeMs = millis() - start;
+    Logger::printf("OJP", "TLS handshake #%d took %d ms", _stats.handshakes, _stats.lastHandshakeMs);
+    return true;
+}
+
+bool OjpConnection::resolveHost() {
+    if (_resolved && (millis() - _resolvedAt) < DNS_TTL_MS) {
+        return true;
+    }
+
+    IPAddress address;
+    if (!WiFi.hostByName(_host, address)) {
+        Logger::printf("OJP", "DNS lookup for %s failed", _host);
+        return false;
+    }
+
+    _stats.dnsLookups++;
+    _address = address;
+    _resolvedAt = millis();
+    _resolved = true;
+    return true;
+}
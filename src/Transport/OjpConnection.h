@@ -0,0 +1,66 @@
+#ifndef OJP_CONNECTION_H
+#define OJP_CONNECTION_H
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+#include <HTTPClient.h>
+
+struct OjpConnectionStats {
+    uint32_t requests;         // Ausgeführte POSTs
+    uint32_t handshakes;       // Neu aufgebaute TLS-Verbindungen
+    uint32_t reconnects;       // Wiederholungen nach toter Keep-Alive-Verbindung
+    uint32_t dnsLookups;       // Tatsächliche DNS-Abfragen (Rest aus dem Cache)
+    uint32_t lastHandshakeMs;  // Dauer des letzten TLS-Handshakes
+    uint32_t lastTtfbMs;       // Zeit vom Senden bis zu den Response-Headern
+    uint32_t avgTtfbMs;        // Gleitender Mittelwert der TTFB
+};
+
+/**
+ * Langlebige HTTPS-Verbindung zum OJP Endpoint.
+ *
+ * Alle Requests des TransportModule (Abfahrten, Haltestellensuche,
+ * Linienabfrage) laufen über denselben WiFiClientSecure mit HTTP/1.1
+ * Keep-Alive. Der TLS-Handshake fällt dadurch nur beim ersten Request,
+ * nach Idle-Timeout oder nach einem Verbindungsabbruch an.
+ * Die Aufrufer kommen aus verschiedenen Tasks und werden per Mutex serialisiert.
+ */
+class OjpConnection {
+public:
+    OjpConnection(const char* host, const char* path, const char* apiKey);
+
+    // Sendet `body` per POST. Bei HTTP 200 wird die Antwort in `sink` geschrieben,
+    // `written` enthält dann das Ergebnis von writeToStream() (sonst 0).
+    // Rückgabe: HTTP Status (> 0) oder HTTPClient-Fehlercode (< 0)
+    int post(const uint8_t* body, size_t length, Stream& sink, int& written);
+
+    // Schliesst die Verbindung (z.B. nach WLAN-Verlust)
+    void close();
+
+    OjpConnectionStats getStats() const { return _stats; }
+
+private:
+    static const uint16_t PORT = 443;
+    static const unsigned long IDLE_TIMEOUT_MS = 55000;  // Kürzer als übliche Server-Timeouts
+    static const unsigned long DNS_TTL_MS = 600000;      // 10 Minuten
+
+    const char* _host;
+    const char* _path;
+    String _authorization;
+
+    WiFiClientSecure _client;
+    HTTPClient _http;
+    SemaphoreHandle_t _mutex;
+
+    IPAddress _address;
+    unsigned long _resolvedAt;
+    bool _resolved;
+    unsigned long _lastUsed;
+
+    OjpConnectionStats _stats;
+
+    bool isReusable();
+    bool connect();
+    bool resolveHost();
+};
+
+#endif // OJP_CONNECTION_H
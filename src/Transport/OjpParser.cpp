@@ -1,86 +1,49 @@
 #include "OjpParser.h"
+#include "OjpPath.h"
+#include "OjpRequestTemplate.h"
+#include "../Logger/Logger.h"
 #include <tinyxml2.h>
 #include <time.h>
+#include <string.h>
 
 using namespace tinyxml2;
 
 String OjpParser::buildRequestXml(const String& stationId, const String& requestorRef, int limit) {
     // Aktuelle Zeit für Request (in UTC)
-    time_t now;
-    time(&now);
-    struct tm* timeinfo = gmtime(&now);
-    char timeStr[30];
-    strftime(timeStr, sizeof(timeStr), "%Y-%m-%dT%H:%M:%SZ", timeinfo);
+    OjpRequestValues values(time(NULL));
+    values.requestor = requestorRef.c_str();
+    values.limit = limit;
     
-    // OJP 2.0 Format (für Endpoint /ojp20)
-    String xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
-    xml += "<OJP xmlns=\"http://www.vdv.de/ojp\" xmlns:siri=\"http://www.siri.org.uk/siri\" version=\"2.0\">";
-    xml += "<OJPRequest>";
-    xml += "<siri:ServiceRequest>";
-    xml += "<siri:ServiceRequestContext><siri:Language>de</siri:Language></siri:ServiceRequestContext>";
-    xml += "<siri:RequestTimestamp>" + String(timeStr) + "</siri:RequestTimestamp>";
-    xml += "<siri:RequestorRef>" + requestorRef + "</siri:RequestorRef>";
-    xml += "<OJPStopEventRequest>";
-    xml += "<siri:RequestTimestamp>" + String(timeStr) + "</siri:RequestTimestamp>";
-    xml += "<siri:MessageIdentifier>StopEvent1</siri:MessageIdentifier>";
-    xml += "<Location>";
-    xml += "<PlaceRef>";
-    xml += "<siri:StopPointRef>" + stationId + "</siri:StopPointRef>";
-    xml += "<Name><Text>Station</Text></Name>";
-    xml += "</PlaceRef>";
-    xml += "</Location>";
-    xml += "<Params>";
-    xml += "<NumberOfResults>" + String(limit) + "</NumberOfResults>";
-    xml += "<StopEventType>departure</StopEventType>";
-    xml += "<IncludePreviousCalls>false</IncludePreviousCalls>";
-    xml += "<IncludeOnwardCalls>false</IncludeOnwardCalls>";
-    xml += "<UseRealtimeData>full</UseRealtimeData>";
-    xml += "</Params>";
-    xml += "</OJPStopEventRequest>";
-    xml += "</siri:ServiceRequest>";
-    xml += "</OJPRequest>";
-    xml += "</OJP>";
-    
-    return xml;
+    // OJP 2.0 Format (für Endpoint /ojp20), siehe OjpRequestTemplate
+    const char* stopRefs[] = { stationId.c_str() };
+    return OjpRequestTemplate::renderStopEvents(values, stopRefs, 1);
+}
+
+int OjpParser::parseStopIndex(const char* messageRef) {
+    static const size_t PREFIX_LEN = sizeof(OJP_STOP_EVENT_MESSAGE_PREFIX) - 1;
+    if (!messageRef || strncmp(messageRef, OJP_STOP_EVENT_MESSAGE_PREFIX, PREFIX_LEN) != 0) return -1;
+
+    const char* digits = messageRef + PREFIX_LEN;
+    if (*digits < '1' || *digits > '9') return -1;
+    int number = 0;
+    for (const char* p = digits; *p; p++) {
+        if (*p < '0' || *p > '9' || number > 1000) return -1;
+        number = number * 10 + (*p - '0');
+    }
+    return number - 1;
 }
 
 String OjpParser::buildLocationSearchXml(const String& query, const String& requestorRef) {
     // Aktuelle Zeit für Request (in UTC)
-    time_t now;
-    time(&now);
-    struct tm* timeinfo = gmtime(&now);
-    char timeStr[30];
-    strftime(timeStr, sizeof(timeStr), "%Y-%m-%dT%H:%M:%SZ", timeinfo);
+    OjpRequestValues values(time(NULL));
+    values.requestor = requestorRef.c_str();
+    values.query = query.c_str();   // Benutzereingabe, wird XML-escaped
     
     // OJP 2.0 Format für LocationInformationRequest
-    String xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
-    xml += "<OJP xmlns=\"http://www.vdv.de/ojp\" xmlns:siri=\"http://www.siri.org.uk/siri\" version=\"2.0\">";
-    xml += "<OJPRequest>";
-    xml += "<siri:ServiceRequest>";
-    xml += "<siri:ServiceRequestContext><siri:Language>de</siri:Language></siri:ServiceRequestContext>";
-    xml += "<siri:RequestTimestamp>" + String(timeStr) + "</siri:RequestTimestamp>";
-    xml += "<siri:RequestorRef>" + requestorRef + "</siri:RequestorRef>";
-    xml += "<OJPLocationInformationRequest>";
-    xml += "<siri:RequestTimestamp>" + String(timeStr) + "</siri:RequestTimestamp>";
-    xml += "<siri:MessageIdentifier>LocationSearch1</siri:MessageIdentifier>";
-    xml += "<InitialInput>";
-    xml += "<Name>" + query + "</Name>";
-    xml += "</InitialInput>";
-    xml += "<Restrictions>";
-    xml += "<Type>stop</Type>";
-    xml += "<NumberOfResults>10</NumberOfResults>";
-    xml += "<IncludePtModes>true</IncludePtModes>";
-    xml += "</Restrictions>";
-    xml += "</OJPLocationInformationRequest>";
-    xml += "</siri:ServiceRequest>";
-    xml += "</OJPRequest>";
-    xml += "</OJP>";
-    
-    return xml;
+    return OjpRequestTemplate::LOCATION_SEARCH.render(values);
 }
 
-std::vector<Departure> OjpParser::parseResponse(const String& xmlContent) {
-    std::vector<Departure> departures;
+bool OjpParser::parseResponse(const String& xmlContent, DepartureList* lists, size_t count) {
     XMLDocument doc;
     
     // TinyXML2 erwartet char*, String muss gecastet werden
@@ -88,328 +51,245 @@ std::vector<Departure> OjpParser::parseResponse(const String& xmlContent) {
     // aber sicherheitshalber prüfen wir den Rückgabewert.
     XMLError err = doc.Parse(xmlContent.c_str());
     if (err != XML_SUCCESS) {
-        Serial.printf("XML Parse Error: %d\n", err);
-        return departures;
+        Logger::printf("OJP", "XML Parse Error: %d", err);
+        return false;
     }
 
-    // Navigiere durch die OJP Struktur
+    // Navigiere durch die OJP Struktur (Prefix-unabhängig)
     // <OJP> -> <OJPResponse> -> <ServiceDelivery> -> <OJPStopEventDelivery> -> <StopEventResult>
+    static const OjpTag DELIVERY_PATH[] = {
+        OJP_TAG_OJP, OJP_TAG_OJP_RESPONSE, OJP_TAG_SERVICE_DELIVERY, OJP_TAG_STOP_EVENT_DELIVERY
+    };
     
-    XMLElement* root = doc.FirstChildElement("siri:OJP");
-    // Fallback falls Namespaces im Root anders gehandhabt werden oder fehlen
-    if (!root) root = doc.FirstChildElement("OJP"); 
-    
-    if (!root) {
-        Serial.println("OJP Root not found");
-        return departures;
-    }
-
-    XMLElement* response = root->FirstChildElement("siri:OJPResponse");
-    if (!response) response = root->FirstChildElement("OJPResponse");
-    
-    if (!response) {
-        Serial.println("OJPResponse not found");
-        return departures;
-    }
-
-    XMLElement* serviceDelivery = response->FirstChildElement("siri:ServiceDelivery");
-    if (!serviceDelivery) serviceDelivery = response->FirstChildElement("ServiceDelivery");
-
-    if (!serviceDelivery) {
-        Serial.println("ServiceDelivery not found");
-        return departures;
-    }
-
-    XMLElement* stopEventDelivery = serviceDelivery->FirstChildElement("ojp:OJPStopEventDelivery");
-    if (!stopEventDelivery) stopEventDelivery = serviceDelivery->FirstChildElement("OJPStopEventDelivery");
+    // ===== OJP 2.0 Struktur =====
+    // StopEvent
+    //   ├── ThisCall
+    //   │   └── CallAtStop
+    //   │       └── ServiceDeparture (Zeiten hier!)
+    //   └── Service (Linien-Info hier, NICHT in ServiceDeparture!)
+    static const OjpTag DEPARTURE_PATH[] = {
+        OJP_TAG_THIS_CALL, OJP_TAG_CALL_AT_STOP, OJP_TAG_SERVICE_DEPARTURE
+    };
+    // Fallback für andere Strukturen
+    static const OjpTag DEPARTURE_FALLBACK_PATH[] = {
+        OJP_TAG_THIS_CALL, OJP_TAG_SERVICE_DEPARTURE
+    };
     
-    if (!stopEventDelivery) {
-        Serial.println("OJPStopEventDelivery not found");
-        return departures;
+    XMLElement* firstDelivery = OjpPath::resolve(&doc, DELIVERY_PATH);
+    if (!firstDelivery) {
+        Logger::error("OJP", "OJPStopEventDelivery not found");
+        return false;
     }
 
-    // Iteriere über alle StopEventResult Elemente
-    XMLElement* stopEventResult = stopEventDelivery->FirstChildElement("ojp:StopEventResult");
-    if (!stopEventResult) stopEventResult = stopEventDelivery->FirstChildElement("StopEventResult");
-
-    while (stopEventResult) {
-        XMLElement* stopEvent = stopEventResult->FirstChildElement("ojp:StopEvent");
-        if (!stopEvent) stopEvent = stopEventResult->FirstChildElement("StopEvent");
+    // Gebündelte Requests: eine Delivery pro Haltestelle, Zuordnung über RequestMessageRef
+    size_t ordinal = 0;
+    for (XMLElement* stopEventDelivery = firstDelivery;
+         stopEventDelivery;
+         stopEventDelivery = OjpPath::nextSibling(stopEventDelivery, OJP_TAG_STOP_EVENT_DELIVERY), ordinal++) {
+        int stop = parseStopIndex(OjpPath::childText(stopEventDelivery, OJP_TAG_REQUEST_MESSAGE_REF));
+        if (stop < 0) stop = (int)ordinal;
+        if ((size_t)stop >= count) continue;
+        DepartureList& out = lists[stop];
 
-        if (stopEvent) {
+        // Iteriere über alle StopEventResult Elemente
+        for (XMLElement* stopEventResult = OjpPath::firstChild(stopEventDelivery, OJP_TAG_STOP_EVENT_RESULT);
+             stopEventResult;
+             stopEventResult = OjpPath::nextSibling(stopEventResult, OJP_TAG_STOP_EVENT_RESULT)) {
+        
+            XMLElement* stopEvent = OjpPath::firstChild(stopEventResult, OJP_TAG_STOP_EVENT);
+            if (!stopEvent) continue;
+        
             Departure dep;
-            
-            // ===== OJP 2.0 Struktur =====
-            // StopEvent
-            //   ├── ThisCall
-            //   │   └── CallAtStop
-            //   │       └── ServiceDeparture (Zeiten hier!)
-            //   └── Service (Linien-Info hier, NICHT in ServiceDeparture!)
-            
+            const char* direction = "";
+        
             // 1. Zeiten aus ThisCall/CallAtStop/ServiceDeparture
-            XMLElement* thisCall = stopEvent->FirstChildElement("ojp:ThisCall");
-            if (!thisCall) thisCall = stopEvent->FirstChildElement("ThisCall");
+            XMLElement* serviceDeparture = OjpPath::resolve(stopEvent, DEPARTURE_PATH);
+            if (!serviceDeparture) serviceDeparture = OjpPath::resolve(stopEvent, DEPARTURE_FALLBACK_PATH);
+        
+            if (serviceDeparture) {
+                const char* timetabled = OjpPath::childText(serviceDeparture, OJP_TAG_TIMETABLED_TIME);
+                if (timetabled) dep.departureTime = parseIsoTime(timetabled);
             
-            if (thisCall) {
-                // OJP 2.0: CallAtStop statt direkt ServiceDeparture
-                XMLElement* callAtStop = thisCall->FirstChildElement("ojp:CallAtStop");
-                if (!callAtStop) callAtStop = thisCall->FirstChildElement("CallAtStop");
-                
-                XMLElement* serviceDeparture = NULL;
-                if (callAtStop) {
-                    serviceDeparture = callAtStop->FirstChildElement("ojp:ServiceDeparture");
-                    if (!serviceDeparture) serviceDeparture = callAtStop->FirstChildElement("ServiceDeparture");
-                }
-                // Fallback für andere Strukturen
-                if (!serviceDeparture) {
-                    serviceDeparture = thisCall->FirstChildElement("ojp:ServiceDeparture");
-                    if (!serviceDeparture) serviceDeparture = thisCall->FirstChildElement("ServiceDeparture");
-                }
-                
-                if (serviceDeparture) {
-                    XMLElement* timeElem = serviceDeparture->FirstChildElement("ojp:TimetabledTime");
-                    if (!timeElem) timeElem = serviceDeparture->FirstChildElement("TimetabledTime");
-                    if (timeElem && timeElem->GetText()) {
-                        dep.departureTime = parseIsoTime(timeElem->GetText());
-                    }
-                    
-                    XMLElement* estTimeElem = serviceDeparture->FirstChildElement("ojp:EstimatedTime");
-                    if (!estTimeElem) estTimeElem = serviceDeparture->FirstChildElement("EstimatedTime");
-                    if (estTimeElem && estTimeElem->GetText()) {
-                        dep.estimatedTime = parseIsoTime(estTimeElem->GetText());
-                    } else {
-                        dep.estimatedTime = 0;
-                    }
-                }
+                const char* estimated = OjpPath::childText(serviceDeparture, OJP_TAG_ESTIMATED_TIME);
+                if (estimated) dep.estimatedTime = parseIsoTime(estimated);
             }
-            
+        
             // 2. Service-Info direkt unter StopEvent (NICHT in ServiceDeparture!)
-            XMLElement* service = stopEvent->FirstChildElement("ojp:Service");
-            if (!service) service = stopEvent->FirstChildElement("Service");
-            
+            XMLElement* service = OjpPath::firstChild(stopEvent, OJP_TAG_SERVICE);
             if (service) {
                 // Linienname: PublishedServiceName (nicht PublishedLineName!)
-                XMLElement* psn = service->FirstChildElement("ojp:PublishedServiceName");
-                if (!psn) psn = service->FirstChildElement("PublishedServiceName");
+                XMLElement* psn = OjpPath::firstChild(service, OJP_TAG_PUBLISHED_SERVICE_NAME);
                 if (psn) {
-                    XMLElement* textElem = psn->FirstChildElement("ojp:Text");
-                    if (!textElem) textElem = psn->FirstChildElement("Text");
-                    if (textElem && textElem->GetText()) {
-                        dep.line = textElem->GetText();
-                    } else if (psn->GetText()) {
-                        dep.line = psn->GetText();
-                    }
+                    const char* text = OjpPath::childText(psn, OJP_TAG_TEXT);
+                    if (!text) text = psn->GetText();
+                    if (text) dep.setLine(text);
                 }
-                
+            
                 // Ziel: DestinationText -> Text
-                XMLElement* destText = service->FirstChildElement("ojp:DestinationText");
-                if (!destText) destText = service->FirstChildElement("DestinationText");
+                XMLElement* destText = OjpPath::firstChild(service, OJP_TAG_DESTINATION_TEXT);
                 if (destText) {
-                    XMLElement* textElem = destText->FirstChildElement("ojp:Text");
-                    if (!textElem) textElem = destText->FirstChildElement("Text");
-                    if (textElem && textElem->GetText()) {
-                        dep.direction = textElem->GetText();
-                    } else if (destText->GetText()) {
-                        dep.direction = destText->GetText();
-                    }
+                    const char* text = OjpPath::childText(destText, OJP_TAG_TEXT);
+                    if (!text) text = destText->GetText();
+                    if (text) direction = text;
                 }
-                
+            
                 // Verkehrsmittel: Mode -> PtMode
-                XMLElement* modeElem = service->FirstChildElement("ojp:Mode");
-                if (!modeElem) modeElem = service->FirstChildElement("Mode");
-                if (modeElem) {
-                    XMLElement* ptMode = modeElem->FirstChildElement("ojp:PtMode");
-                    if (!ptMode) ptMode = modeElem->FirstChildElement("PtMode");
-                    if (ptMode && ptMode->GetText()) {
-                        dep.type = ptMode->GetText();
-                    }
-                }
+                const char* ptMode = OjpPath::childText(OjpPath::firstChild(service, OJP_TAG_MODE), OJP_TAG_PT_MODE);
+                if (ptMode) dep.mode = ptModeFromString(ptMode);
             }
-            
+        
             // Nur hinzufügen wenn wir mindestens Abfahrtszeit haben
-            if (dep.departureTime > 0) {
-                departures.push_back(dep);
+            if (dep.departureTime > 0 && !out.add(dep, direction)) {
+                break; // Liste voll
             }
         }
-        
-        // Nächstes StopEventResult
-        XMLElement* nextResult = stopEventResult->NextSiblingElement("ojp:StopEventResult");
-        if (!nextResult) nextResult = stopEventResult->NextSiblingElement("StopEventResult");
-        stopEventResult = nextResult;
     }
 
-    return departures;
+    return true;
 }
 
-std::vector<StopSearchResult> OjpParser::parseLocationSearchResponse(const String& xmlContent) {
-    std::vector<StopSearchResult> results;
+bool OjpParser::parseLocationSearchResponse(const String& xmlContent, std::vector<StopSearchResult>& results, size_t& placeCount) {
+    results.clear();
+    placeCount = 0;
     XMLDocument doc;
     
     XMLError err = doc.Parse(xmlContent.c_str());
     if (err != XML_SUCCESS) {
-        Serial.printf("XML Parse Error: %d\n", err);
-        return results;
+        Logger::printf("OJP", "XML Parse Error: %d", err);
+        return false;
     }
     
-    // Navigiere durch die OJP Struktur
+    // Navigiere durch die OJP Struktur (Prefix-unabhängig)
     // <OJP> -> <OJPResponse> -> <ServiceDelivery> -> <OJPLocationInformationDelivery> -> <PlaceResult>
+    static const OjpTag DELIVERY_PATH[] = {
+        OJP_TAG_OJP, OJP_TAG_OJP_RESPONSE, OJP_TAG_SERVICE_DELIVERY, OJP_TAG_LOCATION_INFORMATION_DELIVERY
+    };
+    static const OjpTag STOP_PLACE_PATH[] = { OJP_TAG_PLACE, OJP_TAG_STOP_PLACE };
     
-    XMLElement* root = doc.FirstChildElement("siri:OJP");
-    if (!root) root = doc.FirstChildElement("OJP");
-    
-    if (!root) {
-        Serial.println("OJP Root not found");
-        return results;
-    }
-    
-    XMLElement* response = root->FirstChildElement("siri:OJPResponse");
-    if (!response) response = root->FirstChildElement("OJPResponse");
-    
-    if (!response) {
-        Serial.println("OJPResponse not found");
-        return results;
-    }
-    
-    XMLElement* serviceDelivery = response->FirstChildElement("siri:ServiceDelivery");
-    if (!serviceDelivery) serviceDelivery = response->FirstChildElement("ServiceDelivery");
-    
-    if (!serviceDelivery) {
-        Serial.println("ServiceDelivery not found");
-        return results;
-    }
-    
-    XMLElement* locationDelivery = serviceDelivery->FirstChildElement("ojp:OJPLocationInformationDelivery");
-    if (!locationDelivery) locationDelivery = serviceDelivery->FirstChildElement("OJPLocationInformationDelivery");
-    
+    XMLElement* locationDelivery = OjpPath::resolve(&doc, DELIVERY_PATH);
     if (!locationDelivery) {
-        Serial.println("OJPLocationInformationDelivery not found");
-        return results;
+        Logger::error("OJP", "OJPLocationInformationDelivery not found");
+        return false;
     }
     
     // Iteriere über alle PlaceResult Elemente
-    XMLElement* placeResult = locationDelivery->FirstChildElement("ojp:PlaceResult");
-    if (!placeResult) placeResult = locationDelivery->FirstChildElement("PlaceResult");
-    
-    while (placeResult) {
-        XMLElement* place = placeResult->FirstChildElement("ojp:Place");
-        if (!place) place = placeResult->FirstChildElement("Place");
+    for (XMLElement* placeResult = OjpPath::firstChild(locationDelivery, OJP_TAG_PLACE_RESULT);
+         placeResult;
+         placeResult = OjpPath::nextSibling(placeResult, OJP_TAG_PLACE_RESULT)) {
+        placeCount++;
         
-        if (place) {
-            XMLElement* stopPlace = place->FirstChildElement("ojp:StopPlace");
-            if (!stopPlace) stopPlace = place->FirstChildElement("StopPlace");
-            
-            if (stopPlace) {
-                StopSearchResult result;
-                
-                // StopPlaceRef (die ID die wir brauchen)
-                XMLElement* refElem = stopPlace->FirstChildElement("ojp:StopPlaceRef");
-                if (!refElem) refElem = stopPlace->FirstChildElement("StopPlaceRef");
-                if (refElem && refElem->GetText()) {
-                    result.id = refElem->GetText();
-                }
-                
-                // StopPlaceName -> Text
-                XMLElement* nameElem = stopPlace->FirstChildElement("ojp:StopPlaceName");
-                if (!nameElem) nameElem = stopPlace->FirstChildElement("StopPlaceName");
-                if (nameElem) {
-                    XMLElement* textElem = nameElem->FirstChildElement("ojp:Text");
-                    if (!textElem) textElem = nameElem->FirstChildElement("Text");
-                    if (textElem && textElem->GetText()) {
-                        result.name = textElem->GetText();
-                    }
-                }
-                
-                // TopographicPlaceName -> Text (optional)
-                XMLElement* topoElem = stopPlace->FirstChildElement("ojp:TopographicPlaceName");
-                if (!topoElem) topoElem = stopPlace->FirstChildElement("TopographicPlaceName");
-                if (topoElem) {
-                    XMLElement* textElem = topoElem->FirstChildElement("ojp:Text");
-                    if (!textElem) textElem = topoElem->FirstChildElement("Text");
-                    if (textElem && textElem->GetText()) {
-                        result.topographicPlace = textElem->GetText();
-                    }
-                }
-                
-                // Nur hinzufügen wenn wir mindestens ID und Name haben
-                if (result.id.length() > 0 && result.name.length() > 0) {
-                    results.push_back(result);
-                }
-            }
-        }
+        XMLElement* stopPlace = OjpPath::resolve(placeResult, STOP_PLACE_PATH);
+        if (!stopPlace) continue;
+        
+        StopSearchResult result;
+        
+        // StopPlaceRef (die ID die wir brauchen)
+        const char* ref = OjpPath::childText(stopPlace, OJP_TAG_STOP_PLACE_REF);
+        if (ref) result.id = ref;
         
-        // Nächstes PlaceResult
-        XMLElement* nextResult = placeResult->NextSiblingElement("ojp:PlaceResult");
-        if (!nextResult) nextResult = placeResult->NextSiblingElement("PlaceResult");
-        placeResult = nextResult;
+        // StopPlaceName -> Text
+        const char* name = OjpPath::childText(OjpPath::firstChild(stopPlace, OJP_TAG_STOP_PLACE_NAME), OJP_TAG_TEXT);
+        if (name) result.name = name;
+        
+        // TopographicPlaceName -> Text (optional)
+        const char* topo = OjpPath::childText(OjpPath::firstChild(stopPlace, OJP_TAG_TOPOGRAPHIC_PLACE_NAME), OJP_TAG_TEXT);
+        if (topo) result.topographicPlace = topo;
+        
+        // Nur hinzufügen wenn wir mindestens ID und Name haben
+        if (result.id.length() > 0 && result.name.length() > 0) {
+            results.push_back(result);
+        }
     }
     
-    return results;
+    return true;
+}
+
+namespace {
+
+// Tage seit 1970-01-01 für ein proleptisch gregorianisches Datum
+// (days_from_civil nach H. Hinnant, in C++11-constexpr Form)
+constexpr int32_t civilYear(int32_t y, uint32_t m) { return m <= 2 ? y - 1 : y; }
+constexpr int32_t civilEra(int32_t y) { return (y >= 0 ? y : y - 399) / 400; }
+constexpr int32_t dayOfYear(uint32_t m, uint32_t d) { return (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1; }
+constexpr int32_t dayOfEra(int32_t yoe, int32_t doy) { return yoe * 365 + yoe / 4 - yoe / 100 + doy; }
+constexpr int32_t daysFromCivilAdjusted(int32_t y, uint32_t m, uint32_t d) {
+    return civilEra(y) * 146097 + dayOfEra(y - civilEra(y) * 400, dayOfYear(m, d)) - 719468;
+}
+constexpr int32_t daysFromCivil(int32_t y, uint32_t m, uint32_t d) {
+    return daysFromCivilAdjusted(civilYear(y, m), m, d);
+}
+
+static_assert(daysFromCivil(1970, 1, 1) == 0, "Epoch");
+static_assert(daysFromCivil(2000, 3, 1) == 11017, "Schaltjahr 2000");
+static_assert(daysFromCivil(2038, 1, 19) == 24855, "2038");
+
+// Liest genau `count` Ziffern, verschiebt `p` dahinter
+bool readDigits(const char*& p, int count, int& out) {
+    int value = 0;
+    for (int i = 0; i < count; i++) {
+        char c = p[i];
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
+    }
+    p += count;
+    out = value;
+    return true;
 }
 
+bool expect(const char*& p, char c) {
+    if (*p != c) return false;
+    p++;
+    return true;
+}
+
+} // namespace
+
 time_t OjpParser::parseIsoTime(const char* isoTime) {
-    // Format: 2024-12-20T14:30:00Z (UTC) oder 2024-12-20T15:30:00+01:00 (mit Offset)
-    struct tm tm = {0};
+    // Fixes Format: YYYY-MM-DDThh:mm:ss[.fff][Z|+hh:mm|-hh:mm]
+    // Ergebnis ist direkt die UTC-Epoch: keine libc-Zeitzonenfunktionen,
+    // kein sscanf, keine Allokation. Ohne Zonenangabe wird UTC angenommen.
+    if (!isoTime) return 0;
+    const char* p = isoTime;
     
     int year, month, day, hour, minute, second;
-    char tzSign = 0;
-    int tzHour = 0, tzMin = 0;
+    if (!readDigits(p, 4, year) || !expect(p, '-') ||
+        !readDigits(p, 2, month) || !expect(p, '-') ||
+        !readDigits(p, 2, day)) {
+        return 0;
+    }
+    if (*p != 'T' && *p != 't' && *p != ' ') return 0;
+    p++;
+    if (!readDigits(p, 2, hour) || !expect(p, ':') ||
+        !readDigits(p, 2, minute) || !expect(p, ':') ||
+        !readDigits(p, 2, second)) {
+        return 0;
+    }
     
-    // Versuche Format mit Zeitzone zu parsen
-    int parsed = sscanf(isoTime, "%d-%d-%dT%d:%d:%d%c%d:%d", 
-                        &year, &month, &day, &hour, &minute, &second, 
-                        &tzSign, &tzHour, &tzMin);
+    if (month < 1 || month > 12 || day < 1 || day > 31 ||
+        hour > 24 || minute > 59 || second > 60) {
+        return 0;
+    }
+    // 24:00:00 = Ende des Tages (ISO 8601), sonst ist 24 keine gültige Stunde
+    if (hour == 24 && (minute != 0 || second != 0)) return 0;
     
-    if (parsed >= 6) {
-        tm.tm_year = year - 1900;
-        tm.tm_mon = month - 1;
-        tm.tm_mday = day;
-        tm.tm_hour = hour;
-        tm.tm_min = minute;
-        tm.tm_sec = second;
-        tm.tm_isdst = 0;
-        
-        // Berechne den Offset der Zeit im String
-        int inputOffsetSeconds = 0;
-        if (parsed >= 7) {
-            if (tzSign == 'Z') {
-                inputOffsetSeconds = 0; // UTC
-            } else if (tzSign == '+') {
-                inputOffsetSeconds = tzHour * 3600 + tzMin * 60;
-            } else if (tzSign == '-') {
-                inputOffsetSeconds = -(tzHour * 3600 + tzMin * 60);
-            }
-        }
-        
-        // Berechne lokalen Offset durch Vergleich von localtime und gmtime
-        time_t now = time(NULL);
-        struct tm localTm, utcTm;
-        localtime_r(&now, &localTm);
-        gmtime_r(&now, &utcTm);
-        
-        // Lokaler Offset = lokale Zeit - UTC Zeit (in Sekunden)
-        int localOffset = (localTm.tm_hour - utcTm.tm_hour) * 3600 +
-                          (localTm.tm_min - utcTm.tm_min) * 60;
-        // Korrektur für Tageswechsel
-        if (localTm.tm_mday != utcTm.tm_mday) {
-            if (localTm.tm_mday > utcTm.tm_mday || 
-                (localTm.tm_mday == 1 && utcTm.tm_mday > 1)) {
-                localOffset += 24 * 3600;
-            } else {
-                localOffset -= 24 * 3600;
-            }
-        }
-        
-        // mktime interpretiert tm als lokale Zeit
-        time_t result = mktime(&tm);
-        
-        // Korrektur: Die Zeit im String hat inputOffsetSeconds
-        // mktime hat localOffset angenommen
-        // Also müssen wir die Differenz korrigieren
-        result += (localOffset - inputOffsetSeconds);
-        
-        return result;
+    // Sekundenbruchteile werden abgeschnitten (time_t hat Sekundenauflösung)
+    if (*p == '.' || *p == ',') {
+        p++;
+        while (*p >= '0' && *p <= '9') p++;
     }
-    return 0;
+    
+    // Offset der Zeit im String
+    int offsetSeconds = 0;
+    if (*p == '+' || *p == '-') {
+        int sign = (*p == '+') ? 1 : -1;
+        p++;
+        int tzHour, tzMin = 0;
+        if (!readDigits(p, 2, tzHour)) return 0;
+        if (*p == ':') p++;
+        if (*p >= '0' && *p <= '9' && !readDigits(p, 2, tzMin)) return 0;
+        offsetSeconds = sign * (tzHour * 3600 + tzMin * 60);
+    }
+    
+    int32_t days = daysFromCivil(year, (uint32_t)month, (uint32_t)day);
+    return (time_t)days * 86400 + hour * 3600 + minute * 60 + second - offsetSeconds;
 }
-
-
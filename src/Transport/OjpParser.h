@@ -7,17 +7,24 @@
 
 class OjpParser {
 public:
-    // Parst die OJP XML Antwort und extrahiert Abfahrten
-    static std::vector<Departure> parseResponse(const String& xmlContent);
+    // Parst die OJP XML Antwort (DOM) und hängt die Abfahrten an `lists` an.
+    // Bei gebündelten Requests landet jede Delivery in lists[Haltestellen-Index]
+    // (über RequestMessageRef, sonst Reihenfolge). Deliveries ausserhalb von `count` werden ignoriert.
+    // Gibt false bei ungültigem XML oder fehlender Delivery zurück.
+    static bool parseResponse(const String& xmlContent, DepartureList* lists, size_t count);
     
     // Erstellt den XML Request Body für die OJP API
     static String buildRequestXml(const String& stationId, const String& requestorRef, int limit = 4);
     
+    // "StopEvent3" -> 2, -1 wenn die Referenz nicht von uns stammt
+    static int parseStopIndex(const char* messageRef);
+    
     // Erstellt den XML Request Body für die Haltestellensuche (LocationInformationRequest)
     static String buildLocationSearchXml(const String& query, const String& requestorRef = "CrowPanel");
     
-    // Parst die LocationInformationResponse und extrahiert Haltestellen
-    static std::vector<StopSearchResult> parseLocationSearchResponse(const String& xmlContent);
+    // Parst die LocationInformationResponse und extrahiert Haltestellen; false bei ungültiger
+    // Antwort. `placeCount` = Anzahl PlaceResults inkl. übersprungener (zum Erkennen des Trefferlimits)
+    static bool parseLocationSearchResponse(const String& xmlContent, std::vector<StopSearchResult>& results, size_t& placeCount);
     
     // Hilfsfunktion zum Parsen eines ISO 8601 Zeitstrings
     static time_t parseIsoTime(const char* isoTime);
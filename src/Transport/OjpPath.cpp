@@ -0,0 +1,122 @@
+#include "OjpPath.h"
+#include <tinyxml2.h>
+#include <string.h>
+
+using namespace tinyxml2;
+
+namespace {
+
+const uint32_t FNV_OFFSET = 2166136261u;
+const uint32_t FNV_PRIME = 16777619u;
+
+constexpr uint32_t fnv1a(const char* s, uint32_t hash = FNV_OFFSET) {
+    return *s ? fnv1a(s + 1, (hash ^ (uint8_t)*s) * FNV_PRIME) : hash;
+}
+
+struct TagEntry {
+    uint32_t hash;
+    const char* name;
+    OjpTag tag;
+};
+
+#define OJP_TAG_ENTRY(name, tag) { fnv1a(name), name, tag }
+
+// Hashes werden zur Compile-Zeit berechnet
+const TagEntry TAGS[] = {
+    OJP_TAG_ENTRY("OJP", OJP_TAG_OJP),
+    OJP_TAG_ENTRY("OJPResponse", OJP_TAG_OJP_RESPONSE),
+    OJP_TAG_ENTRY("ServiceDelivery", OJP_TAG_SERVICE_DELIVERY),
+    OJP_TAG_ENTRY("RequestMessageRef", OJP_TAG_REQUEST_MESSAGE_REF),
+    OJP_TAG_ENTRY("OJPStopEventDelivery", OJP_TAG_STOP_EVENT_DELIVERY),
+    OJP_TAG_ENTRY("StopEventResult", OJP_TAG_STOP_EVENT_RESULT),
+    OJP_TAG_ENTRY("StopEvent", OJP_TAG_STOP_EVENT),
+    OJP_TAG_ENTRY("ThisCall", OJP_TAG_THIS_CALL),
+    OJP_TAG_ENTRY("CallAtStop", OJP_TAG_CALL_AT_STOP),
+    OJP_TAG_ENTRY("ServiceDeparture", OJP_TAG_SERVICE_DEPARTURE),
+    OJP_TAG_ENTRY("TimetabledTime", OJP_TAG_TIMETABLED_TIME),
+    OJP_TAG_ENTRY("EstimatedTime", OJP_TAG_ESTIMATED_TIME),
+    OJP_TAG_ENTRY("Service", OJP_TAG_SERVICE),
+    OJP_TAG_ENTRY("PublishedServiceName", OJP_TAG_PUBLISHED_SERVICE_NAME),
+    OJP_TAG_ENTRY("LineRef", OJP_TAG_LINE_REF),
+    OJP_TAG_ENTRY("DestinationText", OJP_TAG_DESTINATION_TEXT),
+    OJP_TAG_ENTRY("Mode", OJP_TAG_MODE),
+    OJP_TAG_ENTRY("PtMode", OJP_TAG_PT_MODE),
+    OJP_TAG_ENTRY("Text", OJP_TAG_TEXT),
+    OJP_TAG_ENTRY("OJPLocationInformationDelivery", OJP_TAG_LOCATION_INFORMATION_DELIVERY),
+    OJP_TAG_ENTRY("PlaceResult", OJP_TAG_PLACE_RESULT),
+    OJP_TAG_ENTRY("Place", OJP_TAG_PLACE),
+    OJP_TAG_ENTRY("StopPlace", OJP_TAG_STOP_PLACE),
+    OJP_TAG_ENTRY("StopPlaceRef", OJP_TAG_STOP_PLACE_REF),
+    OJP_TAG_ENTRY("StopPlaceName", OJP_TAG_STOP_PLACE_NAME),
+    OJP_TAG_ENTRY("TopographicPlaceName", OJP_TAG_TOPOGRAPHIC_PLACE_NAME),
+};
+
+#undef OJP_TAG_ENTRY
+
+} // namespace
+
+OjpTag OjpPath::intern(const char* qualifiedName) {
+    if (!qualifiedName) return OJP_TAG_UNKNOWN;
+
+    // Ein Durchlauf: Hash über den lokalen Namen, Prefix wird beim ':' verworfen
+    const char* local = qualifiedName;
+    uint32_t hash = FNV_OFFSET;
+    for (const char* p = qualifiedName; *p; p++) {
+        if (*p == ':') {
+            local = p + 1;
+            hash = FNV_OFFSET;
+        } else {
+            hash = (hash ^ (uint8_t)*p) * FNV_PRIME;
+        }
+    }
+
+    for (const TagEntry& entry : TAGS) {
+        if (entry.hash == hash) {
+            // Ein einziger strcmp zur Absicherung gegen Hash-Kollisionen
+            return strcmp(local, entry.name) == 0 ? entry.tag : OJP_TAG_UNKNOWN;
+        }
+    }
+    return OJP_TAG_UNKNOWN;
+}
+
+OjpTag OjpPath::tagOf(XMLElement* element) {
+    // UserData speichert tag + 1, damit NULL "noch nicht interniert" bleibt
+    uintptr_t cached = (uintptr_t)element->GetUserData();
+    if (cached) return (OjpTag)(cached - 1);
+
+    OjpTag tag = intern(element->Name());
+    element->SetUserData((void*)(uintptr_t)(tag + 1));
+    return tag;
+}
+
+XMLElement* OjpPath::firstChild(XMLNode* parent, OjpTag tag) {
+    if (!parent) return NULL;
+    for (XMLElement* child = parent->FirstChildElement(); child; child = child->NextSiblingElement()) {
+        if (tagOf(child) == tag) return child;
+    }
+    return NULL;
+}
+
+XMLElement* OjpPath::nextSibling(XMLElement* element, OjpTag tag) {
+    if (!element) return NULL;
+    for (XMLElement* sibling = element->NextSiblingElement(); sibling; sibling = sibling->NextSiblingElement()) {
+        if (tagOf(sibling) == tag) return sibling;
+    }
+    return NULL;
+}
+
+XMLElement* OjpPath::resolve(XMLNode* from, const OjpTag* path, size_t length) {
+    XMLNode* node = from;
+    XMLElement* element = NULL;
+    for (size_t i = 0; i < length; i++) {
+        element = firstChild(node, path[i]);
+        if (!element) return NULL;
+        node = element;
+    }
+    return element;
+}
+
+const char* OjpPath::childText(XMLNode* parent, OjpTag tag) {
+    XMLElement* child = firstChild(parent, tag);
+    return child ? child->GetText() : NULL;
+}
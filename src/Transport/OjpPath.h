@@ -0,0 +1,89 @@
+#ifndef OJP_PATH_H
+#define OJP_PATH_H
+
+#include <Arduino.h>
+
+namespace tinyxml2 {
+class XMLNode;
+class XMLElement;
+}
+
+/**
+ * Interne IDs für alle OJP/SIRI Tags, die von den Parsern ausgewertet werden.
+ * Der Namespace-Prefix ("ojp:", "siri:", ...) spielt keine Rolle:
+ * es wird nur der lokale Name verglichen.
+ */
+enum OjpTag : uint8_t {
+    OJP_TAG_UNKNOWN,
+
+    // Envelope
+    OJP_TAG_OJP,
+    OJP_TAG_OJP_RESPONSE,
+    OJP_TAG_SERVICE_DELIVERY,
+    OJP_TAG_REQUEST_MESSAGE_REF,
+
+    // StopEventRequest
+    OJP_TAG_STOP_EVENT_DELIVERY,
+    OJP_TAG_STOP_EVENT_RESULT,
+    OJP_TAG_STOP_EVENT,
+    OJP_TAG_THIS_CALL,
+    OJP_TAG_CALL_AT_STOP,
+    OJP_TAG_SERVICE_DEPARTURE,
+    OJP_TAG_TIMETABLED_TIME,
+    OJP_TAG_ESTIMATED_TIME,
+    OJP_TAG_SERVICE,
+    OJP_TAG_PUBLISHED_SERVICE_NAME,
+    OJP_TAG_LINE_REF,
+    OJP_TAG_DESTINATION_TEXT,
+    OJP_TAG_MODE,
+    OJP_TAG_PT_MODE,
+    OJP_TAG_TEXT,
+
+    // LocationInformationRequest
+    OJP_TAG_LOCATION_INFORMATION_DELIVERY,
+    OJP_TAG_PLACE_RESULT,
+    OJP_TAG_PLACE,
+    OJP_TAG_STOP_PLACE,
+    OJP_TAG_STOP_PLACE_REF,
+    OJP_TAG_STOP_PLACE_NAME,
+    OJP_TAG_TOPOGRAPHIC_PLACE_NAME,
+
+    OJP_TAG_COUNT
+};
+
+/**
+ * Kompilierte Pfade über interne Tag-IDs.
+ *
+ * Jeder Elementname wird genau einmal gehasht (Prefix wird dabei übersprungen)
+ * und auf eine OjpTag-ID abgebildet, die am Element gecacht wird. Die eigentliche Navigation vergleicht
+ * danach nur noch Integer statt "ojp:X"/"X" per strcmp zu probieren.
+ */
+class OjpPath {
+public:
+    // Bildet einen (qualifizierten) Elementnamen auf seine Tag-ID ab
+    static OjpTag intern(const char* qualifiedName);
+
+    // Tag-ID eines Elements. Wird beim ersten Besuch interniert und im UserData
+    // des Elements gecacht: weitere Suchen über dieselben Geschwister kosten
+    // danach weder Name() noch Hash.
+    static OjpTag tagOf(tinyxml2::XMLElement* element);
+
+    // Erstes Kind-Element mit dem Tag (oder NULL)
+    static tinyxml2::XMLElement* firstChild(tinyxml2::XMLNode* parent, OjpTag tag);
+
+    // Nächstes Geschwister-Element mit dem Tag (oder NULL)
+    static tinyxml2::XMLElement* nextSibling(tinyxml2::XMLElement* element, OjpTag tag);
+
+    // Folgt dem Pfad ab `from`, jeweils über das erste passende Kind
+    static tinyxml2::XMLElement* resolve(tinyxml2::XMLNode* from, const OjpTag* path, size_t length);
+
+    template<size_t N>
+    static tinyxml2::XMLElement* resolve(tinyxml2::XMLNode* from, const OjpTag (&path)[N]) {
+        return resolve(from, path, N);
+    }
+
+    // Text des ersten Kind-Elements mit dem Tag (oder NULL)
+    static const char* childText(tinyxml2::XMLNode* parent, OjpTag tag);
+};
+
+#endif // OJP_PATH_H
@@ -0,0 +1,326 @@
+#include "OjpRequestTemplate.h"
+#include <string.h>
+
+namespace {
+
+#define OJP_PART(text, slot) { text, sizeof(text) - 1, slot }
+#define OJP_STRINGIFY(value) #value
+#define OJP_NUMBER(value) OJP_STRINGIFY(value)
+
+// OJP 2.0 StopEventRequest (Endpoint /ojp20), aufgeteilt damit mehrere
+// OJPStopEventRequests in einem ServiceRequest gebündelt werden können
+constexpr OjpTemplatePart STOP_EVENT_HEADER_PARTS[] = {
+    OJP_PART("<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+             "<OJP xmlns=\"http://www.vdv.de/ojp\" xmlns:siri=\"http://www.siri.org.uk/siri\" version=\"2.0\">"
+             "<OJPRequest>"
+             "<siri:ServiceRequest>"
+             "<siri:ServiceRequestContext><siri:Language>de</siri:Language></siri:ServiceRequestContext>"
+             "<siri:RequestTimestamp>", OJP_SLOT_TIMESTAMP),
+    OJP_PART("</siri:RequestTimestamp>"
+             "<siri:RequestorRef>", OJP_SLOT_REQUESTOR),
+    OJP_PART("</siri:RequestorRef>", OJP_SLOT_END),
+};
+
+// Ein OJPStopEventRequest pro Haltestelle
+constexpr OjpTemplatePart STOP_EVENT_ITEM_PARTS[] = {
+    OJP_PART("<OJPStopEventRequest>"
+             "<siri:RequestTimestamp>", OJP_SLOT_TIMESTAMP),
+    OJP_PART("</siri:RequestTimestamp>"
+             "<siri:MessageIdentifier>", OJP_SLOT_MESSAGE_ID),
+    OJP_PART("</siri:MessageIdentifier>"
+             "<Location>"
+             "<PlaceRef>"
+             "<siri:StopPointRef>", OJP_SLOT_STOP_REF),
+    OJP_PART("</siri:StopPointRef>"
+             "<Name><Text>Station</Text></Name>"
+             "</PlaceRef>"
+             "</Location>"
+             "<Params>", OJP_SLOT_LINE_FILTER),
+    OJP_PART("<NumberOfResults>", OJP_SLOT_LIMIT),
+    OJP_PART("</NumberOfResults>"
+             "<StopEventType>departure</StopEventType>"
+             "<IncludePreviousCalls>false</IncludePreviousCalls>"
+             "<IncludeOnwardCalls>false</IncludeOnwardCalls>"
+             "<UseRealtimeData>full</UseRealtimeData>"
+             "</Params>"
+             "</OJPStopEventRequest>", OJP_SLOT_END),
+};
+
+constexpr OjpTemplatePart STOP_EVENT_FOOTER_PARTS[] = {
+    OJP_PART("</siri:ServiceRequest>"
+             "</OJPRequest>"
+             "</OJP>", OJP_SLOT_END),
+};
+
+// OJP 2.0 LocationInformationRequest
+constexpr OjpTemplatePart LOCATION_SEARCH_PARTS[] = {
+    OJP_PART("<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+             "<OJP xmlns=\"http://www.vdv.de/ojp\" xmlns:siri=\"http://www.siri.org.uk/siri\" version=\"2.0\">"
+             "<OJPRequest>"
+             "<siri:ServiceRequest>"
+             "<siri:ServiceRequestContext><siri:Language>de</siri:Language></siri:ServiceRequestContext>"
+             "<siri:RequestTimestamp>", OJP_SLOT_TIMESTAMP),
+    OJP_PART("</siri:RequestTimestamp>"
+             "<siri:RequestorRef>", OJP_SLOT_REQUESTOR),
+    OJP_PART("</siri:RequestorRef>"
+             "<OJPLocationInformationRequest>"
+             "<siri:RequestTimestamp>", OJP_SLOT_TIMESTAMP),
+    OJP_PART("</siri:RequestTimestamp>"
+             "<siri:MessageIdentifier>LocationSearch1</siri:MessageIdentifier>"
+             "<InitialInput>"
+             "<Name>", OJP_SLOT_QUERY),
+    OJP_PART("</Name>"
+             "</InitialInput>"
+             "<Restrictions>"
+             "<Type>stop</Type>"
+             "<NumberOfResults>" OJP_NUMBER(OJP_LOCATION_SEARCH_RESULTS) "</NumberOfResults>"
+             "<IncludePtModes>true</IncludePtModes>"
+             "</Restrictions>"
+             "</OJPLocationInformationRequest>"
+             "</siri:ServiceRequest>"
+             "</OJPRequest>"
+             "</OJP>", OJP_SLOT_END),
+};
+
+#undef OJP_PART
+#undef OJP_NUMBER
+#undef OJP_STRINGIFY
+
+// Summe der statischen Blocklängen (Compile-Zeit)
+constexpr size_t staticLength(const OjpTemplatePart* part) {
+    return part->length + (part->slot == OJP_SLOT_END ? 0 : staticLength(part + 1));
+}
+
+// Zählt nur die Bytes (Längenberechnung)
+struct CountSink {
+    size_t length;
+    CountSink() : length(0) {}
+    void append(const char*, size_t len) { length += len; }
+};
+
+// Schreibt in einen ausreichend grossen Puffer
+struct BufferSink {
+    char* out;
+    explicit BufferSink(char* buffer) : out(buffer) {}
+    void append(const char* data, size_t len) {
+        memcpy(out, data, len);
+        out += len;
+    }
+};
+
+// Hängt an einen vorab reservierten String an
+struct StringSink {
+    String& out;
+    explicit StringSink(String& target) : out(target) {}
+    void append(const char* data, size_t len) { out.concat(data, len); }
+};
+
+// Text mit XML-Escaping ausgeben (unveränderte Abschnitte am Stück)
+template<typename Sink>
+void appendEscaped(Sink& sink, const char* text) {
+    if (!text) return;
+    const char* run = text;
+    for (const char* p = text; *p; p++) {
+        const char* entity;
+        switch (*p) {
+            case '&':  entity = "&amp;"; break;
+            case '<':  entity = "&lt;"; break;
+            case '>':  entity = "&gt;"; break;
+            case '"':  entity = "&quot;"; break;
+            case '\'': entity = "&apos;"; break;
+            default: continue;
+        }
+        sink.append(run, p - run);
+        sink.append(entity, strlen(entity));
+        run = p + 1;
+    }
+    sink.append(run, strlen(run));
+}
+
+template<typename Sink>
+void appendInt(Sink& sink, int value) {
+    char digits[12];
+    char* p = digits + sizeof(digits);
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+    do {
+        *--p = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) *--p = '-';
+    sink.append(p, digits + sizeof(digits) - p);
+}
+
+// OJP 2.0 LineFilter (steht in den Params vor NumberOfResults), nichts ohne Refs
+template<typename Sink>
+void appendLineFilter(Sink& sink, const char* const* lineRefs) {
+    static const char OPEN[] = "<LineFilter>";
+    static const char LINE_OPEN[] = "<Line><siri:LineRef>";
+    static const char LINE_CLOSE[] = "</siri:LineRef></Line>";
+    static const char CLOSE[] = "<Exclude>false</Exclude></LineFilter>";
+    if (!lineRefs[0]) return;
+    sink.append(OPEN, sizeof(OPEN) - 1);
+    for (size_t i = 0; i < OJP_MAX_LINE_FILTER && lineRefs[i]; i++) {
+        sink.append(LINE_OPEN, sizeof(LINE_OPEN) - 1);
+        appendEscaped(sink, lineRefs[i]);
+        sink.append(LINE_CLOSE, sizeof(LINE_CLOSE) - 1);
+    }
+    sink.append(CLOSE, sizeof(CLOSE) - 1);
+}
+
+// Werte der i-ten Haltestelle übernehmen, false = Slot überspringen
+inline bool itemValues(const char* const* stopRefs, size_t i, OjpRequestValues& item) {
+    if (!stopRefs[i]) return false;
+    item.stopRef = stopRefs[i];
+    return true;
+}
+
+inline bool itemValues(const OjpStopEventQuery* queries, size_t i, OjpRequestValues& item) {
+    const OjpStopEventQuery& query = queries[i];
+    if (!query.stopRef) return false;
+    item.stopRef = query.stopRef;
+    item.limit = query.limit;
+    memcpy(item.lineRefs, query.lineRefs, sizeof(item.lineRefs));
+    return true;
+}
+
+template<typename Sink>
+void appendSlot(Sink& sink, OjpSlot slot, const OjpRequestValues& values) {
+    switch (slot) {
+        case OJP_SLOT_TIMESTAMP: sink.append(values.timestamp, sizeof(values.timestamp) - 1); break;
+        case OJP_SLOT_REQUESTOR: appendEscaped(sink, values.requestor); break;
+        case OJP_SLOT_STOP_REF:  appendEscaped(sink, values.stopRef); break;
+        case OJP_SLOT_QUERY:     appendEscaped(sink, values.query); break;
+        case OJP_SLOT_LIMIT:     appendInt(sink, values.limit); break;
+        case OJP_SLOT_MESSAGE_ID:
+            sink.append(OJP_STOP_EVENT_MESSAGE_PREFIX, sizeof(OJP_STOP_EVENT_MESSAGE_PREFIX) - 1);
+            appendInt(sink, values.messageIndex + 1);
+            break;
+        case OJP_SLOT_LINE_FILTER: appendLineFilter(sink, values.lineRefs); break;
+        case OJP_SLOT_END:       break;
+    }
+}
+
+// Ein Durchlauf über alle Blöcke und Platzhalter
+template<typename Sink>
+void emit(const OjpTemplatePart* parts, const OjpRequestValues& values, Sink& sink) {
+    for (const OjpTemplatePart* part = parts; ; part++) {
+        sink.append(part->text, part->length);
+        if (part->slot == OJP_SLOT_END) return;
+        appendSlot(sink, part->slot, values);
+    }
+}
+
+void writeDigits(char* out, int value, int count) {
+    while (count-- > 0) {
+        out[count] = '0' + value % 10;
+        value /= 10;
+    }
+}
+
+} // namespace
+
+const OjpRequestTemplate OjpRequestTemplate::STOP_EVENT_HEADER(STOP_EVENT_HEADER_PARTS, staticLength(STOP_EVENT_HEADER_PARTS));
+const OjpRequestTemplate OjpRequestTemplate::STOP_EVENT_ITEM(STOP_EVENT_ITEM_PARTS, staticLength(STOP_EVENT_ITEM_PARTS));
+const OjpRequestTemplate OjpRequestTemplate::STOP_EVENT_FOOTER(STOP_EVENT_FOOTER_PARTS, staticLength(STOP_EVENT_FOOTER_PARTS));
+const OjpRequestTemplate OjpRequestTemplate::LOCATION_SEARCH(LOCATION_SEARCH_PARTS, staticLength(LOCATION_SEARCH_PARTS));
+
+OjpRequestValues::OjpRequestValues(time_t now)
+    : requestor(""), stopRef(""), query(""), limit(0), messageIndex(0) {
+    memset(lineRefs, 0, sizeof(lineRefs));
+    // Zeitstempel einmal formatieren, wird zweimal eingesetzt
+    struct tm t;
+    gmtime_r(&now, &t);
+    memcpy(timestamp, "0000-00-00T00:00:00Z", sizeof(timestamp));
+    writeDigits(timestamp, t.tm_year + 1900, 4);
+    writeDigits(timestamp + 5, t.tm_mon + 1, 2);
+    writeDigits(timestamp + 8, t.tm_mday, 2);
+    writeDigits(timestamp + 11, t.tm_hour, 2);
+    writeDigits(timestamp + 14, t.tm_min, 2);
+    writeDigits(timestamp + 17, t.tm_sec, 2);
+}
+
+size_t OjpRequestTemplate::length(const OjpRequestValues& values) const {
+    // Statische Blöcke sind vorberechnet, gezählt werden nur die eingesetzten Werte
+    CountSink sink;
+    for (const OjpTemplatePart* part = _parts; part->slot != OJP_SLOT_END; part++) {
+        appendSlot(sink, part->slot, values);
+    }
+    return _staticLength + sink.length;
+}
+
+size_t OjpRequestTemplate::render(const OjpRequestValues& values, char* out, size_t capacity) const {
+    size_t len = length(values);
+    if (!out || len + 1 > capacity) return 0;
+
+    BufferSink sink(out);
+    emit(_parts, values, sink);
+    out[len] = '\0';
+    return len;
+}
+
+String OjpRequestTemplate::render(const OjpRequestValues& values) const {
+    String body;
+    body.reserve(length(values));
+    StringSink sink(body);
+    emit(_parts, values, sink);
+    return body;
+}
+
+template<typename Sink, typename Stops>
+void OjpRequestTemplate::emitStopEvents(const OjpRequestValues& values, Stops stops, size_t count, Sink& sink) {
+    emit(STOP_EVENT_HEADER._parts, values, sink);
+    OjpRequestValues item = values;
+    for (size_t i = 0; i < count; i++) {
+        if (!itemValues(stops, i, item)) continue;
+        item.messageIndex = (uint8_t)i;
+        emit(STOP_EVENT_ITEM._parts, item, sink);
+    }
+    emit(STOP_EVENT_FOOTER._parts, values, sink);
+}
+
+template<typename Stops>
+size_t OjpRequestTemplate::stopEventsLength(const OjpRequestValues& values, Stops stops, size_t count) {
+    size_t len = STOP_EVENT_HEADER.length(values) + STOP_EVENT_FOOTER.length(values);
+    OjpRequestValues item = values;
+    for (size_t i = 0; i < count; i++) {
+        if (!itemValues(stops, i, item)) continue;
+        item.messageIndex = (uint8_t)i;
+        len += STOP_EVENT_ITEM.length(item);
+    }
+    return len;
+}
+
+size_t OjpRequestTemplate::renderStopEvents(const OjpRequestValues& values, const char* const* stopRefs, size_t count,
+                                            char* out, size_t capacity) {
+    size_t len = stopEventsLength(values, stopRefs, count);
+    if (!out || len + 1 > capacity) return 0;
+
+    BufferSink sink(out);
+    emitStopEvents(values, stopRefs, count, sink);
+    out[len] = '\0';
+    return len;
+}
+
+String OjpRequestTemplate::renderStopEvents(const OjpRequestValues& values, const char* const* stopRefs, size_t count) {
+    String body;
+    body.reserve(stopEventsLength(values, stopRefs, count));
+    StringSink sink(body);
+    emitStopEvents(values, stopRefs, count, sink);
+    return body;
+}
+
+size_t OjpRequestTemplate::renderStopEvents(const OjpRequestValues& values, const OjpStopEventQuery* queries, size_t count,
+                                            char* out, size_t capacity) {
+    size_t len = stopEventsLength(values, queries, count);
+    if (!out || len + 1 > capacity) return 0;
+
+    BufferSink sink(out);
+    emitStopEvents(values, queries, count, sink);
+    out[len] = '\0';
+    return len;
+}
+
+OjpStopEventQuery::OjpStopEventQuery()
+    : stopRef(NULL), limit(0) {
+    memset(lineRefs, 0, sizeof(lineRefs));
+}
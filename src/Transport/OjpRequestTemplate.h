@@ -0,0 +1,111 @@
+#ifndef OJP_REQUEST_TEMPLATE_H
+#define OJP_REQUEST_TEMPLATE_H
+
+#include <Arduino.h>
+#include <time.h>
+
+// Platzhalter, die beim Rendern in das statische XML eingesetzt werden
+enum OjpSlot : uint8_t {
+    OJP_SLOT_END,        // Ende des Templates
+    OJP_SLOT_TIMESTAMP,
+    OJP_SLOT_REQUESTOR,
+    OJP_SLOT_STOP_REF,
+    OJP_SLOT_LIMIT,
+    OJP_SLOT_QUERY,
+    OJP_SLOT_MESSAGE_ID,     // "StopEvent<n>", n = messageIndex + 1
+    OJP_SLOT_LINE_FILTER     // <LineFilter> aus lineRefs, leer ohne Refs
+};
+
+// Prefix der MessageIdentifier gebündelter StopEventRequests
+#define OJP_STOP_EVENT_MESSAGE_PREFIX "StopEvent"
+
+// NumberOfResults der Haltestellensuche. Weniger Treffer = vollständige Liste
+// (darauf baut der StopSearchCache beim Filtern längerer Suchbegriffe).
+#define OJP_LOCATION_SEARCH_RESULTS 10
+
+// Maximale Anzahl siri:LineRef im LineFilter einer Haltestelle
+#define OJP_MAX_LINE_FILTER 4
+
+// Statischer Textblock (liegt im Flash) gefolgt von einem Platzhalter
+struct OjpTemplatePart {
+    const char* text;
+    uint16_t length;
+    OjpSlot slot;
+};
+
+// Werte für die Platzhalter. Texte werden beim Rendern XML-escaped.
+struct OjpRequestValues {
+    char timestamp[21];      // "YYYY-MM-DDTHH:MM:SSZ"
+    const char* requestor;
+    const char* stopRef;
+    const char* query;
+    int limit;
+    uint8_t messageIndex;    // Index der Haltestelle im gebündelten Request
+    const char* lineRefs[OJP_MAX_LINE_FILTER];   // LineFilter, NULL = Ende
+
+    explicit OjpRequestValues(time_t now);
+};
+
+// Parameter einer Haltestelle im gebündelten StopEventRequest
+struct OjpStopEventQuery {
+    const char* stopRef;     // NULL = Slot überspringen
+    int limit;               // NumberOfResults
+    const char* lineRefs[OJP_MAX_LINE_FILTER];   // Nur diese Linien (siri:LineRef), NULL = Ende
+
+    OjpStopEventQuery();
+};
+
+/**
+ * Vorkompilierte OJP Request-Bodies.
+ *
+ * Das XML ist in statische Blöcke mit dazwischenliegenden Platzhaltern
+ * zerlegt; die Länge der statischen Teile steht schon zur Compile-Zeit fest.
+ * Rendern ist ein einziger Durchlauf in einen vorgegebenen Puffer (keine
+ * Allokation) oder in einen String, der vorher exakt reserviert wird
+ * (eine Allokation).
+ */
+class OjpRequestTemplate {
+public:
+    static const OjpRequestTemplate LOCATION_SEARCH;
+
+    // Gebündelter StopEventRequest: ein OJPStopEventRequest pro Haltestelle
+    // in `stopRefs` (NULL = Slot überspringen), MessageIdentifier "StopEvent<i+1>"
+    // (i = Index in `stopRefs`). Ansonsten wie render().
+    static size_t renderStopEvents(const OjpRequestValues& values, const char* const* stopRefs, size_t count,
+                                   char* out, size_t capacity);
+    static String renderStopEvents(const OjpRequestValues& values, const char* const* stopRefs, size_t count);
+
+    // Wie oben, aber NumberOfResults und LineFilter pro Haltestelle aus `queries`
+    // (`values.limit` und `values.lineRefs` werden dann ignoriert)
+    static size_t renderStopEvents(const OjpRequestValues& values, const OjpStopEventQuery* queries, size_t count,
+                                   char* out, size_t capacity);
+
+    constexpr OjpRequestTemplate(const OjpTemplatePart* parts, size_t staticLength)
+        : _parts(parts), _staticLength(staticLength) {}
+
+    // Exakte Länge des gerenderten Bodys (ohne Nullterminator)
+    size_t length(const OjpRequestValues& values) const;
+
+    // Schreibt den Body nullterminiert nach `out`. Gibt die Länge zurück,
+    // oder 0 wenn `capacity` nicht reicht (dann wird nichts geschrieben).
+    size_t render(const OjpRequestValues& values, char* out, size_t capacity) const;
+
+    // Body als String (genau eine Allokation)
+    String render(const OjpRequestValues& values) const;
+
+private:
+    static const OjpRequestTemplate STOP_EVENT_HEADER;
+    static const OjpRequestTemplate STOP_EVENT_ITEM;
+    static const OjpRequestTemplate STOP_EVENT_FOOTER;
+
+    const OjpTemplatePart* _parts;
+    size_t _staticLength;
+
+    template<typename Stops>
+    static size_t stopEventsLength(const OjpRequestValues& values, Stops stops, size_t count);
+
+    template<typename Sink, typename Stops>
+    static void emitStopEvents(const OjpRequestValues& values, Stops stops, size_t count, Sink& sink);
+};
+
+#endif // OJP_REQUEST_TEMPLATE_H
@@ -0,0 +1,480 @@
+#include "OjpStreamParser.h"
+#include "OjpParser.h"
+#include "../Logger/Logger.h"
+#include <string.h>
+
+namespace {
+
+const uint32_t FNV_OFFSET = 2166136261u;
+const uint32_t FNV_PRIME = 16777619u;
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+} // namespace
+
+static_assert(OJP_TAG_COUNT <= 64, "Frame::seenChildren needs one bit per OjpTag");
+
+OjpStreamParser::OjpStreamParser(DepartureCallback onDeparture)
+    : _onDeparture(onDeparture) {
+    reset();
+}
+
+void OjpStreamParser::reset() {
+    _state = ST_TEXT;
+    _error = false;
+    _rootClosed = false;
+    _departureCount = 0;
+    _depth = 0;
+    _overflow = 0;
+    _resultDepth = -1;
+    _deliveryCount = 0;
+    _stop = 0;
+    _nameLen = 0;
+    _nameHash = FNV_OFFSET;
+    _quote = 0;
+    _slash = false;
+    _match = 0;
+    _captureField = FIELD_NONE;
+    _captureDepth = 0;
+    _textLen = 0;
+    _entityLen = 0;
+    resetPending();
+}
+
+void OjpStreamParser::resetPending() {
+    _pending.timetabled = 0;
+    _pending.estimated = 0;
+    _pending.timetabledDirect = 0;
+    _pending.estimatedDirect = 0;
+    _pending.callAtStopDeparture = false;
+    _pending.mode = PT_MODE_UNKNOWN;
+    _pending.line[0] = '\0';
+    _pending.lineDirect[0] = '\0';
+    _pending.lineRef[0] = '\0';
+    _pending.direction[0] = '\0';
+    _pending.directionDirect[0] = '\0';
+}
+
+size_t OjpStreamParser::write(uint8_t c) {
+    char ch = (char)c;
+    feed(&ch, 1);
+    return 1;
+}
+
+size_t OjpStreamParser::write(const uint8_t* buffer, size_t size) {
+    feed(reinterpret_cast<const char*>(buffer), size);
+    // Immer alles "annehmen", sonst bricht HTTPClient::writeToStream() ab
+    return size;
+}
+
+void OjpStreamParser::feed(const char* data, size_t len) {
+    for (size_t i = 0; i < len && !_error; i++) {
+        consume(data[i]);
+    }
+}
+
+bool OjpStreamParser::finish() {
+    if (_error) return false;
+    return _rootClosed && _depth == 0 && _overflow == 0 && _state == ST_TEXT;
+}
+
+void OjpStreamParser::consume(char c) {
+    switch (_state) {
+        case ST_TEXT:
+            if (c == '<') {
+                _state = ST_LT;
+            } else if (_captureField != FIELD_NONE) {
+                if (c == '&') {
+                    _entityLen = 0;
+                    _state = ST_ENTITY;
+                } else {
+                    appendText(c);
+                }
+            }
+            break;
+
+        case ST_ENTITY:
+            if (c == ';') {
+                flushEntity();
+                _state = ST_TEXT;
+            } else if (c == '<' || _entityLen >= ENTITY_LEN - 1) {
+                // Kein gültiges Entity: Rohtext übernehmen
+                appendText('&');
+                for (size_t i = 0; i < _entityLen; i++) appendText(_entity[i]);
+                _state = ST_TEXT;
+                consume(c);
+            } else {
+                _entity[_entityLen++] = c;
+            }
+            break;
+
+        case ST_LT:
+            _nameLen = 0;
+            _nameHash = FNV_OFFSET;
+            if (c == '/') {
+                _state = ST_END_NAME;
+            } else if (c == '!') {
+                _state = ST_BANG;
+            } else if (c == '?') {
+                _match = 0;
+                _state = ST_PI;
+            } else {
+                _state = ST_START_NAME;
+                consume(c);
+            }
+            break;
+
+        case ST_START_NAME:
+            if (isSpace(c)) {
+                _quote = 0;
+                _slash = false;
+                _state = ST_START_ATTRS;
+            } else if (c == '/') {
+                _quote = 0;
+                _slash = true;
+                _state = ST_START_ATTRS;
+            } else if (c == '>') {
+                _state = ST_TEXT;
+                startElement(false);
+            } else {
+                if (_nameLen < NAME_LEN - 1) _name[_nameLen++] = c;
+                _nameHash = (_nameHash ^ (uint8_t)c) * FNV_PRIME;
+            }
+            break;
+
+        case ST_START_ATTRS:
+            // Attribute werden nicht ausgewertet, nur Quotes beachten
+            if (_quote) {
+                if (c == _quote) _quote = 0;
+            } else if (c == '"' || c == '\'') {
+                _quote = c;
+                _slash = false;
+            } else if (c == '/') {
+                _slash = true;
+            } else if (c == '>') {
+                _state = ST_TEXT;
+                startElement(_slash);
+            } else if (!isSpace(c)) {
+                _slash = false;
+            }
+            break;
+
+        case ST_END_NAME:
+            if (c == '>') {
+                _state = ST_TEXT;
+                endElement(_nameHash);
+            } else if (!isSpace(c)) {
+                _nameHash = (_nameHash ^ (uint8_t)c) * FNV_PRIME;
+            }
+            break;
+
+        case ST_BANG: {
+            // Unterscheidet <!-- ... -->, <![CDATA[ ... ]]> und <!DOCTYPE ...>
+            static const char COMMENT[] = "--";
+            static const char CDATA[] = "[CDATA[";
+            _name[_nameLen++] = c;
+            bool maybeComment = _nameLen <= 2 && strncmp(_name, COMMENT, _nameLen) == 0;
+            bool maybeCdata = _nameLen <= 7 && strncmp(_name, CDATA, _nameLen) == 0;
+            _match = 0;
+            if (maybeComment && _nameLen == 2) {
+                _state = ST_COMMENT;
+            } else if (maybeCdata && _nameLen == 7) {
+                _state = ST_CDATA;
+            } else if (!maybeComment && !maybeCdata) {
+                _state = (c == '>') ? ST_TEXT : ST_DECL;
+            }
+            break;
+        }
+
+        case ST_COMMENT:
+            if (c == '-') {
+                if (_match < 2) _match++;
+            } else if (c == '>' && _match == 2) {
+                _state = ST_TEXT;
+            } else {
+                _match = 0;
+            }
+            break;
+
+        case ST_CDATA:
+            if (c == ']') {
+                if (_match < 2) {
+                    _match++;
+                } else if (_captureField != FIELD_NONE) {
+                    appendText(']');
+                }
+            } else if (c == '>' && _match == 2) {
+                _state = ST_TEXT;
+            } else {
+                if (_captureField != FIELD_NONE) {
+                    for (uint8_t i = 0; i < _match; i++) appendText(']');
+                    appendText(c);
+                }
+                _match = 0;
+            }
+            break;
+
+        case ST_DECL:
+            if (c == '>') _state = ST_TEXT;
+            break;
+
+        case ST_PI:
+            if (c == '>' && _match) {
+                _state = ST_TEXT;
+            } else {
+                _match = (c == '?') ? 1 : 0;
+            }
+            break;
+    }
+}
+
+void OjpStreamParser::startElement(bool selfClosing) {
+    // Direkter Text des Elternelements endet mit dem ersten Kind-Element (wie GetText())
+    if (_captureField != FIELD_NONE) {
+        commitCapture();
+    }
+
+    if (_overflow > 0 || _depth >= MAX_DEPTH) {
+        if (!selfClosing) _overflow++;
+        return;
+    }
+
+    _name[_nameLen] = '\0';
+    OjpTag tag = OjpPath::intern(_name);
+
+    bool first = true;
+    bool parentChain = (_depth == 0);
+    if (_depth > 0) {
+        Frame& parent = _stack[_depth - 1];
+        uint64_t bit = 1ull << tag;
+        first = (parent.seenChildren & bit) == 0;
+        parent.seenChildren |= bit;
+        parentChain = parent.firstChain;
+    }
+
+    // OJP -> OJPResponse -> ServiceDelivery -> OJPStopEventDelivery -> StopEventResult
+    static const OjpTag ENVELOPE[] = {
+        OJP_TAG_OJP, OJP_TAG_OJP_RESPONSE, OJP_TAG_SERVICE_DELIVERY, OJP_TAG_STOP_EVENT_DELIVERY
+    };
+    const size_t envelopeDepth = sizeof(ENVELOPE) / sizeof(ENVELOPE[0]);
+
+    bool chain;
+    if (_depth + 1 < envelopeDepth) {
+        chain = parentChain && first && tag == ENVELOPE[_depth];
+    } else if (_depth + 1 == envelopeDepth) {
+        // Gebündelte Requests: jede OJPStopEventDelivery gehört zu einer Haltestelle.
+        // Standard ist die Reihenfolge, RequestMessageRef überschreibt sie.
+        chain = parentChain && tag == OJP_TAG_STOP_EVENT_DELIVERY;
+        if (chain) {
+            _stop = _deliveryCount++;
+        }
+    } else if (_depth == envelopeDepth && _resultDepth < 0) {
+        // Alle StopEventResults werden ausgewertet, nicht nur das erste
+        chain = parentChain && tag == OJP_TAG_STOP_EVENT_RESULT;
+        if (chain) {
+            _resultDepth = (int)_depth;
+            resetPending();
+        } else if (parentChain && first && tag == OJP_TAG_REQUEST_MESSAGE_REF) {
+            _captureField = FIELD_MESSAGE_REF;
+            _captureDepth = _depth;
+            _textLen = 0;
+        }
+    } else {
+        chain = parentChain && first;
+    }
+
+    Frame& frame = _stack[_depth];
+    frame.nameHash = _nameHash;
+    frame.seenChildren = 0;
+    frame.tag = tag;
+    frame.firstChain = chain;
+    size_t index = _depth++;
+
+    if (chain && _resultDepth >= 0 && (int)index > _resultDepth) {
+        if (tag == OJP_TAG_SERVICE_DEPARTURE && index == (size_t)_resultDepth + 4 &&
+            _stack[index - 1].tag == OJP_TAG_CALL_AT_STOP) {
+            _pending.callAtStopDeparture = true;
+        }
+
+        Field field = fieldFor(index);
+        if (field != FIELD_NONE) {
+            _captureField = field;
+            _captureDepth = index;
+            _textLen = 0;
+        }
+    }
+
+    if (selfClosing) {
+        endElement(frame.nameHash);
+    }
+}
+
+void OjpStreamParser::endElement(uint32_t nameHash) {
+    if (_overflow > 0) {
+        _overflow--;
+        return;
+    }
+
+    if (_depth == 0) {
+        _error = true;
+        Logger::error("OJP_STREAM", "Unexpected closing tag");
+        return;
+    }
+
+    size_t index = _depth - 1;
+    if (_stack[index].nameHash != nameHash) {
+        _error = true;
+        Logger::error("OJP_STREAM", "Mismatched closing tag");
+        return;
+    }
+
+    if (_captureField != FIELD_NONE && _captureDepth == index) {
+        commitCapture();
+    }
+
+    if (_resultDepth == (int)index) {
+        Departure dep;
+        dep.departureTime = _pending.callAtStopDeparture ? _pending.timetabled : _pending.timetabledDirect;
+        dep.estimatedTime = _pending.callAtStopDeparture ? _pending.estimated : _pending.estimatedDirect;
+        dep.setLine(_pending.line[0] ? _pending.line : _pending.lineDirect);
+        dep.mode = _pending.mode;
+        const char* direction = _pending.direction[0] ? _pending.direction : _pending.directionDirect;
+
+        // Nur melden wenn wir mindestens Abfahrtszeit haben
+        if (dep.departureTime > 0) {
+            _departureCount++;
+            if (_onDeparture) _onDeparture(_stop, dep, direction, _pending.lineRef);
+        }
+        _resultDepth = -1;
+    }
+
+    _depth = index;
+    if (_depth == 0) {
+        _rootClosed = true;
+    }
+}
+
+OjpStreamParser::Field OjpStreamParser::fieldFor(size_t index) const {
+    struct Pattern {
+        Field field;
+        uint8_t length;
+        OjpTag tags[5];
+    };
+
+    // Pfade relativ zum StopEventResult
+    static const Pattern PATTERNS[] = {
+        { FIELD_TIMETABLED, 5, { OJP_TAG_STOP_EVENT, OJP_TAG_THIS_CALL, OJP_TAG_CALL_AT_STOP, OJP_TAG_SERVICE_DEPARTURE, OJP_TAG_TIMETABLED_TIME } },
+        { FIELD_ESTIMATED, 5, { OJP_TAG_STOP_EVENT, OJP_TAG_THIS_CALL, OJP_TAG_CALL_AT_STOP, OJP_TAG_SERVICE_DEPARTURE, OJP_TAG_ESTIMATED_TIME } },
+        { FIELD_TIMETABLED_DIRECT, 4, { OJP_TAG_STOP_EVENT, OJP_TAG_THIS_CALL, OJP_TAG_SERVICE_DEPARTURE, OJP_TAG_TIMETABLED_TIME } },
+        { FIELD_ESTIMATED_DIRECT, 4, { OJP_TAG_STOP_EVENT, OJP_TAG_THIS_CALL, OJP_TAG_SERVICE_DEPARTURE, OJP_TAG_ESTIMATED_TIME } },
+        { FIELD_LINE, 4, { OJP_TAG_STOP_EVENT, OJP_TAG_SERVICE, OJP_TAG_PUBLISHED_SERVICE_NAME, OJP_TAG_TEXT } },
+        { FIELD_LINE_DIRECT, 3, { OJP_TAG_STOP_EVENT, OJP_TAG_SERVICE, OJP_TAG_PUBLISHED_SERVICE_NAME } },
+        { FIELD_LINE_REF, 3, { OJP_TAG_STOP_EVENT, OJP_TAG_SERVICE, OJP_TAG_LINE_REF } },
+        { FIELD_DIRECTION, 4, { OJP_TAG_STOP_EVENT, OJP_TAG_SERVICE, OJP_TAG_DESTINATION_TEXT, OJP_TAG_TEXT } },
+        { FIELD_DIRECTION_DIRECT, 3, { OJP_TAG_STOP_EVENT, OJP_TAG_SERVICE, OJP_TAG_DESTINATION_TEXT } },
+        { FIELD_MODE, 4, { OJP_TAG_STOP_EVENT, OJP_TAG_SERVICE, OJP_TAG_MODE, OJP_TAG_PT_MODE } },
+    };
+
+    size_t length = index - (size_t)_resultDepth;
+    for (const Pattern& p : PATTERNS) {
+        if (p.length != length) continue;
+        bool match = true;
+        for (size_t i = 0; i < length && match; i++) {
+            match = _stack[_resultDepth + 1 + i].tag == p.tags[i];
+        }
+        if (match) return p.field;
+    }
+    return FIELD_NONE;
+}
+
+void OjpStreamParser::appendText(char c) {
+    // Führender Whitespace wird wie bei tinyxml2 verworfen
+    if (_textLen == 0 && isSpace(c)) return;
+    if (_textLen < TEXT_LEN - 1) _text[_textLen++] = c;
+}
+
+void OjpStreamParser::appendUtf8(uint32_t cp) {
+    if (cp < 0x80) {
+        appendText((char)cp);
+    } else if (cp < 0x800) {
+        appendText((char)(0xC0 | (cp >> 6)));
+        appendText((char)(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        appendText((char)(0xE0 | (cp >> 12)));
+        appendText((char)(0x80 | ((cp >> 6) & 0x3F)));
+        appendText((char)(0x80 | (cp & 0x3F)));
+    } else {
+        appendText((char)(0xF0 | (cp >> 18)));
+        appendText((char)(0x80 | ((cp >> 12) & 0x3F)));
+        appendText((char)(0x80 | ((cp >> 6) & 0x3F)));
+        appendText((char)(0x80 | (cp & 0x3F)));
+    }
+}
+
+void OjpStreamParser::flushEntity() {
+    _entity[_entityLen] = '\0';
+
+    if (_entityLen > 1 && _entity[0] == '#') {
+        bool hex = (_entity[1] == 'x' || _entity[1] == 'X');
+        uint32_t cp = strtoul(_entity + (hex ? 2 : 1), NULL, hex ? 16 : 10);
+        if (cp > 0 && cp <= 0x10FFFF) {
+            appendUtf8(cp);
+            return;
+        }
+    } else if (strcmp(_entity, "amp") == 0) {
+        appendText('&');
+        return;
+    } else if (strcmp(_entity, "lt") == 0) {
+        appendText('<');
+        return;
+    } else if (strcmp(_entity, "gt") == 0) {
+        appendText('>');
+        return;
+    } else if (strcmp(_entity, "quot") == 0) {
+        appendText('"');
+        return;
+    } else if (strcmp(_entity, "apos") == 0) {
+        appendText('\'');
+        return;
+    }
+
+    // Unbekanntes Entity bleibt (wie bei tinyxml2) unverändert stehen
+    appendText('&');
+    for (size_t i = 0; i < _entityLen; i++) appendText(_entity[i]);
+    appendText(';');
+}
+
+void OjpStreamParser::copyText(char* target, size_t size) const {
+    size_t len = (_textLen < size - 1) ? _textLen : size - 1;
+    memcpy(target, _text, len);
+    target[len] = '\0';
+}
+
+void OjpStreamParser::commitCapture() {
+    Field field = _captureField;
+    _captureField = FIELD_NONE;
+    if (_state == ST_ENTITY) _state = ST_TEXT;
+    if (_textLen == 0) return;
+    _text[_textLen] = '\0';
+
+    switch (field) {
+        case FIELD_TIMETABLED:        _pending.timetabled = OjpParser::parseIsoTime(_text); break;
+        case FIELD_ESTIMATED:         _pending.estimated = OjpParser::parseIsoTime(_text); break;
+        case FIELD_TIMETABLED_DIRECT: _pending.timetabledDirect = OjpParser::parseIsoTime(_text); break;
+        case FIELD_ESTIMATED_DIRECT:  _pending.estimatedDirect = OjpParser::parseIsoTime(_text); break;
+        case FIELD_LINE:              copyText(_pending.line, sizeof(_pending.line)); break;
+        case FIELD_LINE_DIRECT:       copyText(_pending.lineDirect, sizeof(_pending.lineDirect)); break;
+        case FIELD_LINE_REF:          copyText(_pending.lineRef, sizeof(_pending.lineRef)); break;
+        case FIELD_DIRECTION:         copyText(_pending.direction, sizeof(_pending.direction)); break;
+        case FIELD_DIRECTION_DIRECT:  copyText(_pending.directionDirect, sizeof(_pending.directionDirect)); break;
+        case FIELD_MODE:              _pending.mode = ptModeFromString(_text); break;
+        case FIELD_MESSAGE_REF: {
+            int stop = OjpParser::parseStopIndex(_text);
+            if (stop >= 0) _stop = (size_t)stop;
+            break;
+        }
+        default: break;
+    }
+}
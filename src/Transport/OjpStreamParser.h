@@ -0,0 +1,151 @@
+#ifndef OJP_STREAM_PARSER_H
+#define OJP_STREAM_PARSER_H
+
+#include <Arduino.h>
+#include <functional>
+#include "TransportTypes.h"
+#include "OjpPath.h"
+
+/**
+ * Streamender (SAX-artiger) Parser für OJP StopEventResponses.
+ *
+ * Liest die HTTP-Antwort Chunk für Chunk (z.B. via HTTPClient::writeToStream())
+ * und meldet jede Abfahrt über den Callback, sobald ihr StopEventResult
+ * geschlossen wird. Es wird weder der komplette Body noch ein DOM im Heap
+ * gehalten: der Speicherbedarf ist durch den Chunk des HTTPClients und die
+ * festen Puffer unten begrenzt.
+ *
+ * Die Semantik entspricht OjpParser::parseResponse() (jeweils erstes
+ * passendes Kind-Element, gleiche Fallbacks, Deliveries gebündelter
+ * Requests werden über RequestMessageRef den Haltestellen zugeordnet).
+ */
+class OjpStreamParser : public Stream {
+public:
+    // Der Zielort wird separat übergeben, damit der Empfänger ihn in seine
+    // eigene DirectionTable internieren kann (dep.directionId ist noch leer).
+    // `stop` ist der Haltestellen-Index der Delivery (gebündelte Requests, sonst 0).
+    // `lineRef` ist die siri:LineRef des Kurses ("" wenn nicht vorhanden), z.B. für den OJP LineFilter.
+    using DepartureCallback = std::function<void(size_t stop, const Departure& dep, const char* direction, const char* lineRef)>;
+
+    explicit OjpStreamParser(DepartureCallback onDeparture);
+
+    // Setzt den Parser für eine neue Antwort zurück
+    void reset();
+
+    // Verarbeitet den nächsten Chunk der Antwort
+    void feed(const char* data, size_t len);
+
+    // Muss nach dem letzten Chunk aufgerufen werden.
+    // Gibt false zurück, wenn das Dokument fehlerhaft oder unvollständig war.
+    bool finish();
+
+    size_t getDepartureCount() const { return _departureCount; }
+
+    // Stream Interface (nur Schreiben wird genutzt)
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+
+private:
+    static const size_t MAX_DEPTH = 24;
+    static const size_t NAME_LEN = 48;
+    static const size_t TEXT_LEN = 128;
+    static const size_t ENTITY_LEN = 12;
+    static const size_t LINE_REF_LEN = 48;
+
+    enum Field : uint8_t {
+        FIELD_NONE,
+        FIELD_TIMETABLED,
+        FIELD_ESTIMATED,
+        FIELD_TIMETABLED_DIRECT,
+        FIELD_ESTIMATED_DIRECT,
+        FIELD_LINE,
+        FIELD_LINE_DIRECT,
+        FIELD_LINE_REF,
+        FIELD_DIRECTION,
+        FIELD_DIRECTION_DIRECT,
+        FIELD_MODE,
+        FIELD_MESSAGE_REF
+    };
+
+    enum State : uint8_t {
+        ST_TEXT,
+        ST_ENTITY,
+        ST_LT,
+        ST_START_NAME,
+        ST_START_ATTRS,
+        ST_END_NAME,
+        ST_BANG,
+        ST_COMMENT,
+        ST_CDATA,
+        ST_DECL,
+        ST_PI
+    };
+
+    struct Frame {
+        uint64_t seenChildren; // Bitmaske der bereits gesehenen Kind-Tags
+        uint32_t nameHash;
+        OjpTag tag;
+        bool firstChain;       // Element ist auf dem ganzen Pfad ab StopEventResult das erste seiner Art
+    };
+
+    // Sammelt die Felder des aktuellen StopEventResult
+    struct Pending {
+        time_t timetabled;
+        time_t estimated;
+        time_t timetabledDirect;
+        time_t estimatedDirect;
+        bool callAtStopDeparture;
+        PtMode mode;
+        char line[Departure::LINE_LEN];
+        char lineDirect[Departure::LINE_LEN];
+        char lineRef[LINE_REF_LEN];
+        char direction[TEXT_LEN];
+        char directionDirect[TEXT_LEN];
+    };
+
+    DepartureCallback _onDeparture;
+
+    State _state;
+    bool _error;
+    bool _rootClosed;
+    size_t _departureCount;
+
+    Frame _stack[MAX_DEPTH];
+    size_t _depth;
+    size_t _overflow;     // Ebenen jenseits von MAX_DEPTH (werden ignoriert)
+    int _resultDepth;     // Tiefe des offenen StopEventResult, -1 wenn keins offen
+    size_t _deliveryCount; // Bisher geöffnete OJPStopEventDeliveries
+    size_t _stop;          // Haltestellen-Index der aktuellen Delivery
+
+    char _name[NAME_LEN];
+    size_t _nameLen;
+    uint32_t _nameHash;
+    char _quote;
+    bool _slash;
+    uint8_t _match;       // Fortschritt beim Erkennen von Kommentar/CDATA-Enden
+
+    Field _captureField;
+    size_t _captureDepth;
+    char _text[TEXT_LEN];
+    size_t _textLen;
+    char _entity[ENTITY_LEN];
+    size_t _entityLen;
+
+    Pending _pending;
+
+    void consume(char c);
+    void startElement(bool selfClosing);
+    void endElement(uint32_t nameHash);
+    void appendText(char c);
+    void appendUtf8(uint32_t codepoint);
+    void flushEntity();
+    void commitCapture();
+    void copyText(char* target, size_t size) const;
+    void resetPending();
+    Field fieldFor(size_t depth) const;
+};
+
+#endif // OJP_STREAM_PARSER_H
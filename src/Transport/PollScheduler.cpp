@@ -0,0 +1,119 @@
+#include "PollScheduler.h"
+
+namespace {
+
+// Zeiten vor 2020 bedeuten: Uhr noch nicht per NTP synchronisiert
+const time_t MIN_VALID_TIME = 1577836800;
+const uint8_t MAX_BACKOFF_STEPS = 5;
+const uint64_t MS_PER_DAY = 86400000ULL;
+
+} // namespace
+
+PollScheduler::PollScheduler()
+    : _minMs(DEFAULT_MIN_MS),
+      _maxMs(DEFAULT_MAX_MS),
+      _lastIntervalMs(BASELINE_MS),
+      _failures(0),
+      _scheduledMs(0),
+      _polls(0),
+      _previousCount(0)
+{
+}
+
+void PollScheduler::setLimits(uint32_t minMs, uint32_t maxMs) {
+    _maxMs = maxMs;
+    _minMs = (minMs > maxMs) ? maxMs : minMs;
+}
+
+uint32_t PollScheduler::next(const DepartureList* lists, size_t count, time_t now, bool success) {
+    if (count > MAX_LISTS) count = MAX_LISTS;
+    uint32_t interval = clamp(decide(lists, count, now, success));
+
+    if (success) {
+        for (size_t i = 0; i < count; i++) _previous[i] = lists[i];
+        _previousCount = count;
+    }
+
+    _lastIntervalMs = interval;
+    _scheduledMs += interval;
+    _polls++;
+    return interval;
+}
+
+uint32_t PollScheduler::decide(const DepartureList* lists, size_t count, time_t now, bool success) {
+    if (!success) {
+        // Backoff: 30s, 60s, 120s, ... bis zur Obergrenze
+        if (_failures < MAX_BACKOFF_STEPS) _failures++;
+        return BASELINE_MS << (_failures - 1);
+    }
+    _failures = 0;
+
+    if (now < MIN_VALID_TIME) return BASELINE_MS;
+
+    // Nächste noch nicht abgefahrene Abfahrt über alle Haltestellen
+    bool any = false;
+    time_t nextDeparture = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (lists[i].empty()) continue;
+        any = true;
+
+        if (i < _previousCount && estimatesMoving(lists[i], _previous[i])) return _minMs;
+
+        for (const Departure& dep : lists[i]) {
+            time_t t = dep.getEffectiveTime();
+            if (t >= now && (nextDeparture == 0 || t < nextDeparture)) {
+                nextDeparture = t;
+            }
+        }
+    }
+
+    // Kein Betrieb (z.B. nachts): selten nachfragen
+    if (!any) return _maxMs;
+
+    if (nextDeparture == 0) {
+        // Listen bestehen nur aus abgefahrenen Kursen: sofort nachladen
+        return _minMs;
+    }
+
+    time_t untilNext = nextDeparture - now;
+    if (untilNext <= NEAR_WINDOW_S) return NEAR_INTERVAL_MS;
+
+    // Erst wieder pollen, wenn die Abfahrt ins Nah-Fenster rückt
+    return (uint32_t)(untilNext - NEAR_WINDOW_S) * 1000;
+}
+
+bool PollScheduler::estimatesMoving(const DepartureList& departures, const DepartureList& previous) const {
+    for (const Departure& dep : departures) {
+        if (dep.estimatedTime == 0) continue;
+
+        // Gleicher Kurs = gleiche Linie, gleiches Ziel, gleiche Fahrplanzeit.
+        // Die Zielort-IDs sind über Polls derselben Haltestelle stabil (inheritDirections).
+        for (const Departure& old : previous) {
+            if (old.departureTime != dep.departureTime ||
+                old.directionId != dep.directionId ||
+                strcmp(old.line, dep.line) != 0) {
+                continue;
+            }
+            time_t before = old.getEffectiveTime();
+            time_t drift = dep.estimatedTime > before ? dep.estimatedTime - before : before - dep.estimatedTime;
+            if (drift >= ESTIMATE_DRIFT_S) return true;
+            break;
+        }
+    }
+    return false;
+}
+
+uint32_t PollScheduler::clamp(uint32_t ms) const {
+    if (ms < _minMs) return _minMs;
+    if (ms > _maxMs) return _maxMs;
+    return ms;
+}
+
+int32_t PollScheduler::getCallsSavedPerDay() const {
+    if (_scheduledMs == 0) return 0;
+
+    // Calls, die das feste Intervall in derselben Zeit gemacht hätte, minus tatsächliche Calls
+    int64_t baselineCalls = (int64_t)(_scheduledMs / BASELINE_MS);
+    int64_t saved = baselineCalls - (int64_t)_polls;
+    return (int32_t)(saved * (int64_t)MS_PER_DAY / (int64_t)_scheduledMs);
+}
@@ -0,0 +1,75 @@
+#ifndef POLL_SCHEDULER_H
+#define POLL_SCHEDULER_H
+
+#include <Arduino.h>
+#include <time.h>
+#include "TransportTypes.h"
+
+struct PollStats {
+    uint32_t intervalMs;        // Zuletzt gewähltes Intervall
+    int32_t callsSavedPerDay;   // Gegenüber festem 30s-Intervall (hochgerechnet)
+};
+
+/**
+ * Bestimmt das Intervall bis zum nächsten Poll aus den Abfahrtsdaten selbst.
+ *
+ * - Prognosen bewegen sich: Untergrenze
+ * - Nächste Abfahrt in wenigen Minuten: NEAR_INTERVAL_MS (Prognosen nachführen;
+ *   die Minuten zählt das Display selbst herunter)
+ * - Nächste Abfahrt weit weg: erst kurz vor dem Nah-Fenster wieder pollen
+ * - Keine Abfahrten (Nacht, kein Betrieb): Obergrenze
+ * - Fehler: exponentielles Backoff ab dem Standardintervall
+ *
+ * Reine Logik ohne Netzwerk/RTOS: die Uhrzeit wird übergeben.
+ */
+class PollScheduler {
+public:
+    static const uint32_t BASELINE_MS = 30000;          // Bisheriges festes Intervall
+    static const uint32_t DEFAULT_MIN_MS = 20000;
+    static const uint32_t DEFAULT_MAX_MS = 300000;
+    static const time_t NEAR_WINDOW_S = 300;            // "Bald" = innerhalb 5 Minuten
+    static const uint32_t NEAR_INTERVAL_MS = 60000;     // Intervall im Nah-Fenster (begrenzt auf min/max)
+    static const time_t ESTIMATE_DRIFT_S = 60;          // Ab dieser Änderung gilt eine Prognose als bewegt
+    static const size_t MAX_LISTS = 3;                  // Haltestellen pro (gebündeltem) Poll
+
+    PollScheduler();
+
+    // Unter- und Obergrenze des Intervalls (ms), Untergrenze wird ggf. auf die Obergrenze begrenzt
+    void setLimits(uint32_t minMs, uint32_t maxMs);
+    uint32_t getMinMs() const { return _minMs; }
+    uint32_t getMaxMs() const { return _maxMs; }
+
+    // Nach jedem Poll aufrufen. Liefert die Wartezeit bis zum nächsten Poll in ms.
+    // `lists` sind die Abfahrten aller abgefragten Haltestellen (max. MAX_LISTS),
+    // `now` ist die aktuelle UTC-Zeit, `success` ob der Poll Daten geliefert hat.
+    uint32_t next(const DepartureList* lists, size_t count, time_t now, bool success);
+
+    uint32_t next(const DepartureList& departures, time_t now, bool success) {
+        return next(&departures, 1, now, success);
+    }
+
+    uint32_t getLastIntervalMs() const { return _lastIntervalMs; }
+
+    // Gesparte API-Calls pro Tag gegenüber dem festen 30s-Intervall (hochgerechnet)
+    int32_t getCallsSavedPerDay() const;
+
+private:
+    uint32_t _minMs;
+    uint32_t _maxMs;
+    uint32_t _lastIntervalMs;
+    uint8_t _failures;
+
+    // Statistik: geplante Wartezeit insgesamt und Anzahl Polls
+    uint64_t _scheduledMs;
+    uint32_t _polls;
+
+    // Vorheriger Stand zum Erkennen von bewegten Prognosen
+    DepartureList _previous[MAX_LISTS];
+    size_t _previousCount;
+
+    uint32_t decide(const DepartureList* lists, size_t count, time_t now, bool success);
+    bool estimatesMoving(const DepartureList& departures, const DepartureList& previous) const;
+    uint32_t clamp(uint32_t ms) const;
+};
+
+#endif // POLL_SCHEDULER_H
@@ -0,0 +1,33 @@
+#include "RequestPlanner.h"
+
+RequestPlanner::RequestPlanner()
+    : _rows(DEFAULT_ROWS), _ratio(DEFAULT_RATIO * RATIO_ONE) {
+}
+
+void RequestPlanner::setRowCapacity(uint8_t rows) {
+    _rows = rows > 0 ? rows : 1;
+}
+
+void RequestPlanner::reset() {
+    _ratio = DEFAULT_RATIO * RATIO_ONE;
+}
+
+int RequestPlanner::limitFor(bool filtered, bool deep) const {
+    uint32_t limit = _rows + LOOKAHEAD_ROWS;
+    if (deep && limit < DepartureList::CAPACITY) limit = DepartureList::CAPACITY;
+    if (filtered) limit = (limit * _ratio + RATIO_ONE - 1) / RATIO_ONE;
+    return limit < MAX_RESULTS ? (int)limit : MAX_RESULTS;
+}
+
+void RequestPlanner::record(size_t received, size_t kept) {
+    // Leere Antwort (Nacht) sagt nichts über den Filter aus
+    if (received == 0) return;
+
+    uint32_t measured = kept > 0 ? (uint32_t)(received * RATIO_ONE / kept) : MAX_RESULTS * RATIO_ONE;
+    if (measured < RATIO_ONE) measured = RATIO_ONE;
+    if (measured > MAX_RESULTS * RATIO_ONE) measured = MAX_RESULTS * RATIO_ONE;
+    // Halb alt, halb neu: ein Ausreisser verdoppelt das Limit nicht sofort.
+    // Gerundet wird zum Messwert hin, sonst bliebe es bei 1:1 ewig eine Abfahrt zu viel
+    uint32_t sum = _ratio + measured;
+    _ratio = (uint16_t)((measured > _ratio ? sum + 1 : sum) / 2);
+}
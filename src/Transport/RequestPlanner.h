@@ -0,0 +1,48 @@
+#ifndef REQUEST_PLANNER_H
+#define REQUEST_PLANNER_H
+
+#include <Arduino.h>
+#include "TransportTypes.h"
+
+/**
+ * Bestimmt NumberOfResults pro Haltestelle aus dem, was tatsächlich angezeigt wird.
+ *
+ * - Grundlage: Zeilen des Layouts plus LOOKAHEAD_ROWS Reserve, aus der das
+ *   Display lokal nachrückt, wenn vorne Kurse abgefahren sind
+ * - Tiefer Poll (Offline-Cache): mindestens die volle DepartureList
+ * - Verwirft ein lokaler Filter Abfahrten, wird um das beobachtete Verhältnis
+ *   empfangen/behalten hochgerechnet (geglättet, anfangs DEFAULT_RATIO)
+ * - Nie mehr als MAX_RESULTS
+ *
+ * Reine Logik ohne Netzwerk/RTOS.
+ */
+class RequestPlanner {
+public:
+    static const uint8_t LOOKAHEAD_ROWS = 4;
+    static const uint8_t DEFAULT_ROWS = 4;
+    static const uint8_t MAX_RESULTS = 40;
+    static const uint8_t DEFAULT_RATIO = 3;
+
+    RequestPlanner();
+
+    // Zeilen, die das aktive Layout für die Hauptstation zeichnet
+    void setRowCapacity(uint8_t rows);
+    uint8_t getRowCapacity() const { return _rows; }
+
+    // NumberOfResults; `filtered` = ein lokaler Filter verwirft Abfahrten
+    int limitFor(bool filtered, bool deep) const;
+
+    // Nach einem gefilterten Poll: empfangene und behaltene Abfahrten
+    void record(size_t received, size_t kept);
+
+    // Neue Filterregeln: das alte Verhältnis gilt nicht mehr
+    void reset();
+
+private:
+    static const uint16_t RATIO_ONE = 16;   // Verhältnis als Festkomma (x16)
+
+    uint8_t _rows;
+    uint16_t _ratio;
+};
+
+#endif // REQUEST_PLANNER_H
@@ -0,0 +1,275 @@
+#include "StopSearchCache.h"
+#include "../Core/StringUtils.h"
+#include "../Logger/Logger.h"
+
+namespace {
+
+const char* FILE_HEADER = "stopsearch 1";
+
+bool isWordChar(char c) {
+    return isalnum((unsigned char)c);
+}
+
+// Beginnt ein Wort in `text` mit `word[0..len)`?
+bool hasWordPrefix(const char* text, const char* word, size_t len) {
+    const char* p = text;
+    while (*p) {
+        while (*p && !isWordChar(*p)) p++;
+        if (strncmp(p, word, len) == 0) return true;
+        while (*p && isWordChar(*p)) p++;
+    }
+    return false;
+}
+
+} // namespace
+
+StopSearchCache::StopSearchCache()
+    : _count(0),
+      _clock(0),
+      _dirty(false),
+      _fs(NULL),
+      _path(NULL)
+{
+    _mutex = xSemaphoreCreateMutex();
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void StopSearchCache::setStorage(fs::FS* fs, const char* path) {
+    _fs = fs;
+    _path = path;
+    load();
+}
+
+String StopSearchCache::normalize(const String& query) {
+    String ascii = StringUtils::toASCII(query);
+    String out;
+    out.reserve(ascii.length());
+    bool space = false;
+    for (size_t i = 0; i < ascii.length(); i++) {
+        char c = ascii[i];
+        if (isspace((unsigned char)c)) {
+            space = out.length() > 0;
+            continue;
+        }
+        if (space) {
+            out += ' ';
+            space = false;
+        }
+        out += (char)tolower((unsigned char)c);
+    }
+    return out;
+}
+
+bool StopSearchCache::supersedes(const String& pending, const String& query) {
+    String a = normalize(pending);
+    String b = normalize(query);
+    return a.startsWith(b) || b.startsWith(a);
+}
+
+bool StopSearchCache::lookup(const String& query, std::vector<StopSearchResult>& results) {
+    String key = normalize(query);
+    if (!_mutex || key.length() == 0) return false;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+
+    // Exakter Treffer, sonst das längste vollständige Präfix
+    Entry* exact = NULL;
+    Entry* prefix = NULL;
+    for (size_t i = 0; i < _count; i++) {
+        Entry& entry = _entries[i];
+        if (entry.key == key) {
+            exact = &entry;
+            break;
+        }
+        if (!entry.truncated && key.startsWith(entry.key) &&
+            (!prefix || entry.key.length() > prefix->key.length())) {
+            prefix = &entry;
+        }
+    }
+
+    bool found = true;
+    if (exact) {
+        results = exact->results;
+        exact->lastUsed = ++_clock;
+        _stats.hits++;
+    } else if (prefix) {
+        results.clear();
+        for (const StopSearchResult& stop : prefix->results) {
+            if (matches(stop, key)) results.push_back(stop);
+        }
+        prefix->lastUsed = ++_clock;
+        _stats.prefixHits++;
+    } else {
+        _stats.misses++;
+        found = false;
+    }
+
+    xSemaphoreGive(_mutex);
+    return found;
+}
+
+void StopSearchCache::put(const String& query, const std::vector<StopSearchResult>& results, bool truncated) {
+    String key = normalize(query);
+    if (!_mutex || key.length() == 0) return;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+
+    // Vollständige Liste: Verlängerungen lassen sich ab jetzt daraus filtern,
+    // ältere Einträge dafür würden nur abweichen
+    if (!truncated) {
+        for (size_t i = 0; i < _count; ) {
+            if (_entries[i].key != key && _entries[i].key.startsWith(key)) {
+                removeAt(i);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    Entry* entry = slotFor(key);
+    entry->key = key;
+    entry->results = results;
+    entry->truncated = truncated;
+    entry->lastUsed = ++_clock;
+    _dirty = true;
+
+    xSemaphoreGive(_mutex);
+}
+
+StopSearchCache::Entry* StopSearchCache::slotFor(const String& key) {
+    for (size_t i = 0; i < _count; i++) {
+        if (_entries[i].key == key) return &_entries[i];
+    }
+    if (_count < MAX_ENTRIES) return &_entries[_count++];
+
+    // Voll: am längsten nicht benutzten Eintrag ersetzen
+    Entry* oldest = &_entries[0];
+    for (size_t i = 1; i < _count; i++) {
+        if (_entries[i].lastUsed < oldest->lastUsed) oldest = &_entries[i];
+    }
+    return oldest;
+}
+
+void StopSearchCache::removeAt(size_t index) {
+    for (size_t i = index; i + 1 < _count; i++) {
+        _entries[i] = _entries[i + 1];
+    }
+    _count--;
+    _entries[_count].key = String();
+    _entries[_count].results.clear();
+}
+
+bool StopSearchCache::matches(const StopSearchResult& stop, const String& query) {
+    String text = normalize(stop.name);
+    text += ' ';
+    text += normalize(stop.topographicPlace);
+
+    const char* word = query.c_str();
+    for (;;) {
+        while (*word && !isWordChar(*word)) word++;
+        if (!*word) return true;
+        const char* end = word;
+        while (*end && isWordChar(*end)) end++;
+        if (!hasWordPrefix(text.c_str(), word, end - word)) return false;
+        word = end;
+    }
+}
+
+bool StopSearchCache::save() {
+    if (!_fs || !_path || !_mutex) return false;
+
+    // Inhalt unter dem Mutex zusammenstellen, geschrieben wird ohne
+    String content;
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (!_dirty) {
+        xSemaphoreGive(_mutex);
+        return false;
+    }
+    _dirty = false;
+
+    // Neueste zuerst: beim Laden ergibt die Reihenfolge wieder die LRU-Ordnung
+    bool written[MAX_ENTRIES] = { false };
+    content = FILE_HEADER;
+    content += '\n';
+    for (size_t n = 0; n < _count; n++) {
+        size_t newest = MAX_ENTRIES;
+        for (size_t i = 0; i < _count; i++) {
+            if (written[i]) continue;
+            if (newest == MAX_ENTRIES || _entries[i].lastUsed > _entries[newest].lastUsed) newest = i;
+        }
+        written[newest] = true;
+        const Entry& entry = _entries[newest];
+        content += entry.key + "\t" + (entry.truncated ? "1" : "0") + "\t" + String((unsigned)entry.results.size()) + "\n";
+        for (const StopSearchResult& stop : entry.results) {
+            content += stop.id + "\t" + stop.name + "\t" + stop.topographicPlace + "\n";
+        }
+    }
+    xSemaphoreGive(_mutex);
+
+    File file = _fs->open(_path, "w");
+    if (!file) {
+        Logger::error("SEARCH", "Cannot write stop search cache");
+        return false;
+    }
+    file.print(content);
+    file.close();
+    return true;
+}
+
+void StopSearchCache::load() {
+    if (!_fs || !_path || !_mutex) return;
+
+    File file = _fs->open(_path, "r");
+    if (!file) return;
+
+    String header = file.readStringUntil('\n');
+    if (header != FILE_HEADER) {
+        file.close();
+        return;
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    _count = 0;
+    while (file.available() && _count < MAX_ENTRIES) {
+        String fields[3];
+        if (StringUtils::split(file.readStringUntil('\n'), '\t', fields, 3) != 3) break;
+
+        Entry& entry = _entries[_count];
+        entry.key = fields[0];
+        entry.truncated = (fields[1] == "1");
+        entry.results.clear();
+        long count = fields[2].toInt();
+        for (long i = 0; i < count; i++) {
+            String stopFields[3];
+            StringUtils::split(file.readStringUntil('\n'), '\t', stopFields, 3);
+            StopSearchResult stop;
+            stop.id = stopFields[0];
+            stop.name = stopFields[1];
+            stop.topographicPlace = stopFields[2];
+            entry.results.push_back(stop);
+        }
+        _count++;
+    }
+    // Datei ist neueste zuerst sortiert
+    for (size_t i = 0; i < _count; i++) {
+        _entries[i].lastUsed = _count - i;
+    }
+    _clock = _count;
+    _dirty = false;
+    xSemaphoreGive(_mutex);
+    file.close();
+
+    Logger::printf("SEARCH", "Loaded %u cached stop searches", (unsigned)_count);
+}
+
+StopSearchCacheStats StopSearchCache::getStats() {
+    StopSearchCacheStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (!_mutex) return stats;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    stats = _stats;
+    stats.entries = _count;
+    xSemaphoreGive(_mutex);
+    return stats;
+}
@@ -0,0 +1,85 @@
+#ifndef STOP_SEARCH_CACHE_H
+#define STOP_SEARCH_CACHE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <vector>
+#include "TransportTypes.h"
+
+struct StopSearchCacheStats {
+    uint32_t hits;          // Gleicher (normalisierter) Suchbegriff schon im Cache
+    uint32_t prefixHits;    // Lokal aus einem kürzeren, vollständigen Ergebnis gefiltert
+    uint32_t misses;        // Musste ans OJP
+    uint32_t entries;
+};
+
+/**
+ * LRU-Cache für die Haltestellensuche (Autocomplete in der Web-Oberfläche).
+ *
+ * Schlüssel ist der normalisierte Suchbegriff: transliteriert wie auf dem
+ * Display (ü -> ue, é -> e), klein geschrieben, Leerraum zusammengefasst.
+ * Annahme: die OJP-Suche unterscheidet weder Gross-/Kleinschreibung noch
+ * Schreibweisen von Umlauten.
+ *
+ * Präfix-Wiederverwendung: Hatte ein kürzerer Suchbegriff weniger als
+ * OJP_LOCATION_SEARCH_RESULTS Treffer, war seine Liste vollständig. Ein
+ * längerer Begriff wird dann lokal gefiltert: jedes Wort der Suche muss
+ * Anfang eines Wortes in Name oder Ort sein. Ein neues vollständiges
+ * Ergebnis ersetzt alle gespeicherten Verlängerungen seines Schlüssels.
+ *
+ * Optional wird der Inhalt in LittleFS gehalten (Textdatei, neueste zuerst)
+ * und beim Start wieder geladen. Zugriff aus Webserver und TransportTask,
+ * deshalb der Mutex.
+ */
+class StopSearchCache {
+public:
+    static const size_t MAX_ENTRIES = 16;
+
+    StopSearchCache();
+
+    // Persistenz aktivieren und vorhandenen Stand laden. Ohne Aufruf nur im RAM.
+    void setStorage(fs::FS* fs, const char* path);
+
+    // Treffer (exakt oder per Präfix) in `results`. false = ans OJP fragen.
+    bool lookup(const String& query, std::vector<StopSearchResult>& results);
+
+    // Ergebnis einer OJP-Suche übernehmen. `truncated` = Trefferlimit erreicht.
+    void put(const String& query, const std::vector<StopSearchResult>& results, bool truncated);
+
+    // Geänderten Stand schreiben (falls Persistenz aktiv und etwas neu ist)
+    bool save();
+
+    StopSearchCacheStats getStats();
+
+    static String normalize(const String& query);
+
+    // Für das Verwerfen veralteter Suchen: `pending` ist ein früherer oder
+    // späterer Tipp-Stand derselben Eingabe (Präfix in einer Richtung)
+    static bool supersedes(const String& pending, const String& query);
+
+private:
+    struct Entry {
+        String key;                             // Normalisiert
+        std::vector<StopSearchResult> results;
+        bool truncated;
+        uint32_t lastUsed;                      // LRU-Zähler
+    };
+
+    SemaphoreHandle_t _mutex;
+    Entry _entries[MAX_ENTRIES];
+    size_t _count;
+    uint32_t _clock;
+    bool _dirty;
+    fs::FS* _fs;
+    const char* _path;
+    StopSearchCacheStats _stats;
+
+    // Aufrufer hält _mutex
+    Entry* slotFor(const String& key);
+    void removeAt(size_t index);
+    void load();
+
+    static bool matches(const StopSearchResult& stop, const String& query);
+};
+
+#endif // STOP_SEARCH_CACHE_H
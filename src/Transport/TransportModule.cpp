@@ -1,33 +1,75 @@
 #include "TransportModule.h"
 #include "OjpParser.h"
+#include "OjpStreamParser.h"
+#include "OjpRequestTemplate.h"
+#include "LineFilter.h"
+#include "DepartureDiff.h"
 #include <HTTPClient.h>
-#include <WiFiClientSecure.h>
-#include <memory>
+#include <StreamString.h>
+#include <LittleFS.h>
 #include "../Logger/Logger.h"
+#include "../Core/EventBus.h"
 #include "secrets.h"
-#include "certs.h"
-// #include "../Display/display_manager.h" // Entfernt, da wir jetzt SystemEvents nutzen
 
 // Endpoint für OJP 2.0 (Korrektur: ojp20 statt ojp2020)
-const char* OJP_API_URL = "https://api.opentransportdata.swiss/ojp20";
+const char* OJP_API_HOST = "api.opentransportdata.swiss";
+const char* OJP_API_PATH = "/ojp20";
+
+static_assert(TransportModule::MAX_STOPS <= PollScheduler::MAX_LISTS, "PollScheduler must track every stop");
+static_assert(TransportModule::MAX_STOPS == DepartureSnapshot::MAX_STOPS, "Snapshot must hold every stop");
+
+namespace {
+
+// Fehlerart eines gescheiterten Lookups (für den HTTP-Status der Web-Oberfläche)
+LookupStatus lookupFailure() {
+    return WiFi.status() == WL_CONNECTED ? LOOKUP_FAILED : LOOKUP_OFFLINE;
+}
+
+} // namespace
 
 TransportModule::TransportModule() 
-    : _updateInterval(30000), // 30 Sekunden
-      taskHandle(NULL),
-      eventQueue(NULL),
+    : taskHandle(NULL),
       _mutex(NULL),
-      configStore(NULL)
+      configStore(NULL),
+      _snapshot(std::make_shared<DepartureSnapshot>()),
+      _generation(0),
+      _connection(OJP_API_HOST, OJP_API_PATH, OJP_API_KEY),
+      _nextPollAt(0),
+      _offline(false),
+      _lastSuccessAt(0),
+      _configGeneration(0),
+      _lineRulesChanged(true),
+      _configChanged(false)
 {
     _mutex = xSemaphoreCreateMutex();
 }
 
-void TransportModule::begin(QueueHandle_t queue, ConfigStore* store) {
-    eventQueue = queue;
+void TransportModule::begin(ConfigStore* store) {
     configStore = store;
     
     // Initiale Config laden
     updateConfig();
     
+    // Geänderte Haltestellen, Linien oder Poll-Grenzen sofort übernehmen (ohne Neustart).
+    // Der Listener läuft im Task des Schreibenden (Webserver): nur markieren und den
+    // TransportTask wecken, der übernimmt die Config und pollt sofort
+    configStore->subscribe(CONFIG_CHANGE_STATION | CONFIG_CHANGE_STOPS | CONFIG_CHANGE_LINES | CONFIG_CHANGE_POLL,
+                           [this](const ConfigSnapshot&, uint32_t) {
+        _configChanged = true;
+        if (taskHandle != NULL) xTaskNotifyGive(taskHandle);
+    });
+    
+    // Caches nur sichern, wenn das Dateisystem schon existiert (nicht formatieren)
+    if (LittleFS.begin(false)) {
+        _searchCache.setStorage(&LittleFS, "/stopsearch.txt");
+        _lineCatalog.setStorage(&LittleFS, "/lines.txt");
+        
+        // Erstes Bild aus dem Cache, noch bevor WLAN, NTP und TLS stehen
+        if (_departureCache.begin(&LittleFS, "/departures.bin") && publishOffline()) {
+            Logger::info("TRANSPORT", "Showing cached departures until the first poll");
+        }
+    }
+    
     // Starte Task
     xTaskCreate(
         taskCode,          // Task Funktion
@@ -39,271 +81,518 @@ void TransportModule::begin(QueueHandle_t queue, ConfigStore* store) {
     );
 }
 
+void TransportModule::setRowCapacity(uint8_t rows) {
+    _planner.setRowCapacity(rows);
+}
+
 void TransportModule::updateConfig() {
     if (!configStore || !_mutex) return;
     
+    // Aufrufer: begin() und der TransportTask (vor jedem Poll, nach Config-Änderungen). Snapshot
+    // erst unter dem Mutex holen, damit kein älterer Stand einen neueren überschreibt.
+    // Unverändert = nichts zu tun (kein Log)
     xSemaphoreTake(_mutex, portMAX_DELAY);
+    ConfigSnapshotPtr config = configStore->getSnapshot();
+    if (config->generation == _configGeneration) {
+        xSemaphoreGive(_mutex);
+        return;
+    }
+    _configGeneration = config->generation;
     
     _apiKey = OJP_API_KEY;
-    StationConfig station = configStore->getStation();
-    _stationId = station.id;
+    DepartureSnapshotPtr current = std::atomic_load(&_snapshot);
+    std::shared_ptr<DepartureSnapshot> cleared;
+    for (size_t i = 0; i < MAX_STOPS; i++) {
+        const StationConfig& station = config->stops[i];
+        if (station.id != _stopIds[i]) {
+            // Neue Haltestelle: Abfahrten und Zielort-Tabelle gehören zur alten Station
+            if (!cleared) cleared = std::make_shared<DepartureSnapshot>(*current);
+            cleared->stops[i].clear();
+        }
+        if (i == 0 && station.id != _stopIds[i]) _lineRulesChanged = true;
+        _stopIds[i] = station.id;
+    }
+    
+    // Linienfilter der Hauptstation, übernommen beim nächsten Poll
+    const LineConfig rules[LineFilter::MAX_RULES] = { config->line1, config->line2 };
+    for (size_t i = 0; i < LineFilter::MAX_RULES; i++) {
+        if (rules[i].name != _lineRules[i].name || rules[i].direction != _lineRules[i].direction) {
+            _lineRules[i] = rules[i];
+            _lineRulesChanged = true;
+        }
+    }
+    if (cleared) {
+        for (size_t i = 0; i < MAX_STOPS; i++) {
+            cleared->changes[i] = DepartureDiff::compare(current->stops[i], cleared->stops[i]);
+        }
+        publish(cleared);
+    }
     
-    Logger::info("TRANSPORT", "Config updated from Store");
+    _scheduler.setLimits(config->poll.minSeconds * 1000, config->poll.maxSeconds * 1000);
+    
+    Logger::printf("TRANSPORT", "Config updated from Store (generation %u)", config->generation);
     Logger::info("TRANSPORT", "API Key used from secrets.h");
-    Logger::printf("TRANSPORT", "Station ID: %s", _stationId.c_str());
+    for (size_t i = 0; i < MAX_STOPS; i++) {
+        if (_stopIds[i].length() > 0) {
+            Logger::printf("TRANSPORT", "Station ID [%d]: %s", i, _stopIds[i].c_str());
+        }
+    }
     
     xSemaphoreGive(_mutex);
 }
 
-std::vector<Departure> TransportModule::getDepartures() {
-    std::vector<Departure> deps;
-    if (_mutex) {
-        xSemaphoreTake(_mutex, portMAX_DELAY);
-        deps = _departures;
-        xSemaphoreGive(_mutex);
-    }
-    return deps;
+DepartureSnapshotPtr TransportModule::getSnapshot() const {
+    return std::atomic_load(&_snapshot);
+}
+
+void TransportModule::publish(std::shared_ptr<DepartureSnapshot> next) {
+    next->generation = ++_generation;
+    next->publishedMs = millis();
+    std::atomic_store(&_snapshot, DepartureSnapshotPtr(next));
 }
 
 void TransportModule::taskCode(void* pvParameters) {
     TransportModule* module = (TransportModule*)pvParameters;
     
-    // Initialer Fetch
-    const TickType_t xFrequency = pdMS_TO_TICKS(module->_updateInterval);
+    // Erster Poll sofort
+    module->_executor.submit(JOB_POLL, String(), PRIORITY_BACKGROUND);
     
     for (;;) {
-        // 1. Config laden & Fetch ausführen
-        module->updateConfig();
+        // 0. Gespeicherte Config übernehmen: umkonfigurierte Haltestellen werden
+        //    geleert veröffentlicht, der Poll mit dem neuen Stand folgt sofort
+        if (module->_configChanged) {
+            module->_configChanged = false;
+            module->updateConfig();
+            module->_executor.submit(JOB_POLL, String(), PRIORITY_BACKGROUND);
+        }
         
-        bool ready = false;
-        if (module->_mutex) {
-            xSemaphoreTake(module->_mutex, portMAX_DELAY);
-            ready = (module->_stationId.length() > 0 && module->_apiKey.length() > 0);
-            xSemaphoreGive(module->_mutex);
+        // 1. Warteschlange abarbeiten: Suchen vor Polls
+        NetworkJob job;
+        while (module->_executor.take(job)) {
+            module->runJob(job);
         }
         
-        if (ready) {
-             module->fetchData();
-        } else {
-             Logger::info("TRANSPORT", "Missing configuration (API Key or Station ID)");
+        // 2. Warten: Entweder Intervall abgelaufen ODER neuer Job (requestStopSearch, triggerUpdate, Config)
+        // ulTaskNotifyTake gibt > 0 zurück, wenn ein Signal kam, 0 bei Timeout
+        long waitMs = (long)(module->_nextPollAt - millis());
+        if (waitMs > 0 && ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs)) > 0) {
+            continue;
         }
+        module->_executor.submit(JOB_POLL, String(), PRIORITY_BACKGROUND);
+    }
+}
 
-        // 2. Warten: Entweder Timeout (30s) abgelaufen ODER Signal bekommen (triggerUpdate)
-        // ulTaskNotifyTake gibt > 0 zurück, wenn ein Signal kam, 0 bei Timeout
-        if (ulTaskNotifyTake(pdTRUE, xFrequency) > 0) {
-            Logger::info("TRANSPORT", "Update triggered manually!");
+void TransportModule::runJob(const NetworkJob& job) {
+    unsigned long start = millis();
+    std::shared_ptr<LookupResult> result;
+    
+    switch (job.type) {
+        case JOB_POLL:
+            runPoll();
+            break;
+        case JOB_STOP_SEARCH: {
+            result = std::make_shared<LookupResult>();
+            bool truncated = false;
+            // Fehler nicht cachen, sonst bliebe die Suche leer
+            if (searchStops(job.key, result->stops, truncated)) {
+                _searchCache.put(job.key, result->stops, truncated);
+            } else {
+                result->status = lookupFailure();
+            }
+            break;
+        }
+        case JOB_LINES: {
+            result = std::make_shared<LookupResult>();
+            LineSet lines;
+            // Antwort inkl. der schon aus Polls bekannten Linien; ohne Katalog
+            // (leer, keine Uhrzeit) nur die abgefragten
+            if (!getAvailableLines(job.key, lines)) {
+                result->status = lookupFailure();
+            } else if (!_lineCatalog.mergeComplete(job.key, lines, time(NULL), result->lines)) {
+                lines.toLineInfo(result->lines);
+            }
+            break;
+        }
+    }
+    
+    _executor.complete(job.id, result);
+    Logger::printf("TRANSPORT", "Job #%u (type %d) done in %lu ms", job.id, job.type, millis() - start);
+}
+
+void TransportModule::runPoll() {
+    // 1. Config laden & Fetch ausführen
+    updateConfig();
+    
+    bool ready = false;
+    if (_mutex) {
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+        bool anyStop = false;
+        for (size_t i = 0; i < MAX_STOPS; i++) {
+            if (_stopIds[i].length() > 0) anyStop = true;
+        }
+        ready = (anyStop && _apiKey.length() > 0);
+        xSemaphoreGive(_mutex);
+    }
+    
+    uint32_t waitMs = PollScheduler::BASELINE_MS;
+    if (ready) {
+        bool success = fetchData();
+        
+        if (success) {
+            _offline = false;
+        } else if (!_offline) {
+            // Kurze Störung: Live-Stand mit Prognosen behalten, danach auf den Cache wechseln
+            time_t now = time(NULL);
+            // fetchedAt wandert nur bei geänderten Daten mit, taugt also nicht als Lebenszeichen
+            if (_lastSuccessAt == 0 || now - _lastSuccessAt >= OFFLINE_AFTER_S) {
+                if (publishOffline()) {
+                    Logger::info("TRANSPORT", "No live data, showing timetable from offline cache");
+                }
+            }
+        }
+        
+        // Nächsten Poll aus den (neuen oder bisherigen) Abfahrten ableiten
+        DepartureSnapshotPtr snapshot = getSnapshot();
+        if (_mutex) {
+            xSemaphoreTake(_mutex, portMAX_DELAY);
+            waitMs = _scheduler.next(snapshot->stops, MAX_STOPS, time(NULL), success);
+            xSemaphoreGive(_mutex);
         }
+        Logger::printf("TRANSPORT", "Next poll in %d s (saves ~%d calls/day)",
+                       waitMs / 1000, _scheduler.getCallsSavedPerDay());
+    } else {
+         Logger::info("TRANSPORT", "Missing configuration (API Key or Station ID)");
     }
+    
+    _nextPollAt = millis() + waitMs;
+    
+    // Neue Suchergebnisse und Linien gesammelt sichern statt nach jeder Änderung zu schreiben
+    _searchCache.save();
+    _lineCatalog.save();
 }
 
 void TransportModule::triggerUpdate() {
-    if (taskHandle != NULL) {
+    Logger::info("TRANSPORT", "Update triggered manually!");
+    LookupResultPtr unused;
+    request(JOB_POLL, String(), unused);
+}
+
+uint32_t TransportModule::requestStopSearch(const String& query, LookupResultPtr& result) {
+    // Läuft schon (oder gerade fertig): Browser fragt nach seinem Job
+    uint32_t id = _executor.find(JOB_STOP_SEARCH, query, &result);
+    if (id) return id;
+    
+    std::shared_ptr<LookupResult> cached = std::make_shared<LookupResult>();
+    if (_searchCache.lookup(query, cached->stops)) {
+        result = cached;
+        return 0;
+    }
+    
+    // Weitergetippt: ältere Tipp-Stände, die noch warten, braucht niemand mehr
+    _executor.cancel(JOB_STOP_SEARCH, query, StopSearchCache::supersedes);
+    return request(JOB_STOP_SEARCH, query, result);
+}
+
+uint32_t TransportModule::requestLines(const String& stopId, LookupResultPtr& result) {
+    uint32_t id = _executor.find(JOB_LINES, stopId, &result);
+    if (id) return id;
+    
+    std::shared_ptr<LookupResult> cached = std::make_shared<LookupResult>();
+    if (_lineCatalog.lookup(stopId, time(NULL), cached->lines)) {
+        result = cached;
+        return 0;
+    }
+    return request(JOB_LINES, stopId, result);
+}
+
+uint32_t TransportModule::request(NetworkJobType type, const String& key, LookupResultPtr& result) {
+    bool created = false;
+    NetworkJobPriority priority = (type == JOB_POLL) ? PRIORITY_BACKGROUND : PRIORITY_INTERACTIVE;
+    uint32_t id = _executor.submit(type, key, priority, &result, &created);
+    if (created && taskHandle != NULL) {
         xTaskNotifyGive(taskHandle);
     }
+    return id;
+}
+
+NetworkExecutorStats TransportModule::getExecutorStats() {
+    return _executor.getStats();
 }
 
-std::vector<StopSearchResult> TransportModule::searchStops(const String& query) {
-    std::vector<StopSearchResult> results;
+StopSearchCacheStats TransportModule::getSearchCacheStats() {
+    return _searchCache.getStats();
+}
+
+LineCatalogStats TransportModule::getLineCatalogStats() {
+    return _lineCatalog.getStats();
+}
+
+bool TransportModule::searchStops(const String& query, std::vector<StopSearchResult>& results, bool& truncated) {
+    results.clear();
+    truncated = false;
     
     if (WiFi.status() != WL_CONNECTED) {
         Logger::info("TRANSPORT", "Wifi not connected, cannot search stops");
-        return results;
+        return false;
     }
     
     if (query.length() == 0) {
         Logger::info("TRANSPORT", "Empty search query");
-        return results;
+        return false;
     }
     
-    std::unique_ptr<WiFiClientSecure> client(new WiFiClientSecure());
-    if (client) {
-        configureTLS(client.get());
-        
-        HTTPClient http;
-        
-        if (http.begin(*client, OJP_API_URL)) {
-            http.addHeader("Content-Type", "application/xml");
-            http.addHeader("Authorization", "Bearer " + String(OJP_API_KEY));
-            http.addHeader("User-Agent", "CrowPanel-OEV-Display/1.0");
-            
-            String requestBody = OjpParser::buildLocationSearchXml(query);
-            Logger::printf("TRANSPORT", "Searching stops for: %s", query.c_str());
-            
-            int httpCode = http.POST(requestBody);
+    String requestBody = OjpParser::buildLocationSearchXml(query);
+    Logger::printf("TRANSPORT", "Searching stops for: %s", query.c_str());
+    
+    StreamString payload;
+    int written = 0;
+    int httpCode = _connection.post((const uint8_t*)requestBody.c_str(), requestBody.length(), payload, written);
+    
+    if (httpCode > 0) {
+        if (httpCode == HTTP_CODE_OK) {
+            Logger::info("TRANSPORT", "Location search response received");
             
-            if (httpCode > 0) {
-                if (httpCode == HTTP_CODE_OK) {
-                    String payload = http.getString();
-                    Logger::info("TRANSPORT", "Location search response received");
-                    
-                    results = OjpParser::parseLocationSearchResponse(payload);
-                    Logger::printf("TRANSPORT", "Found %d stops", results.size());
-                } else {
-                    Logger::printf("TRANSPORT", "HTTP Error: %d", httpCode);
-                    if (httpCode == 403) {
-                        Logger::error("TRANSPORT", "API Key invalid or not yet active.");
-                    }
-                }
-            } else {
-                Logger::printf("TRANSPORT", "HTTP Connection failed: %s", http.errorToString(httpCode).c_str());
+            size_t places = 0;
+            if (!OjpParser::parseLocationSearchResponse(payload, results, places)) return false;
+            truncated = places >= OJP_LOCATION_SEARCH_RESULTS;
+            Logger::printf("TRANSPORT", "Found %d stops", results.size());
+            return true;
+        } else {
+            Logger::printf("TRANSPORT", "HTTP Error: %d", httpCode);
+            if (httpCode == 403) {
+                Logger::error("TRANSPORT", "API Key invalid or not yet active.");
             }
-            
-            http.end();
         }
+    } else {
+        Logger::printf("TRANSPORT", "HTTP Connection failed: %s", HTTPClient::errorToString(httpCode).c_str());
     }
     
-    return results;
+    return false;
 }
 
-std::vector<LineInfo> TransportModule::getAvailableLines(const String& stopId) {
-    std::vector<LineInfo> lines;
+bool TransportModule::getAvailableLines(const String& stopId, LineSet& lines) {
+    lines.clear();
     
     if (WiFi.status() != WL_CONNECTED) {
         Logger::info("TRANSPORT", "Wifi not connected, cannot get lines");
-        return lines;
+        return false;
     }
     
     if (stopId.length() == 0) {
         Logger::info("TRANSPORT", "Empty stop ID");
-        return lines;
+        return false;
     }
     
-    std::unique_ptr<WiFiClientSecure> client(new WiFiClientSecure());
-    if (client) {
-        configureTLS(client.get());
-        
-        HTTPClient http;
-        
-        if (http.begin(*client, OJP_API_URL)) {
-            http.addHeader("Content-Type", "application/xml");
-            http.addHeader("Authorization", "Bearer " + String(OJP_API_KEY));
-            http.addHeader("User-Agent", "CrowPanel-OEV-Display/1.0");
-            
-            // Request mit höherem Limit um mehr Linien zu finden
-            String requestBody = OjpParser::buildRequestXml(stopId, "CrowPanel", 50);
-            Logger::printf("TRANSPORT", "Getting available lines for stop: %s", stopId.c_str());
-            
-            int httpCode = http.POST(requestBody);
-            
-            if (httpCode > 0) {
-                if (httpCode == HTTP_CODE_OK) {
-                    String payload = http.getString();
-                    Logger::info("TRANSPORT", "Lines response received");
-                    
-                    std::vector<Departure> departures = OjpParser::parseResponse(payload);
-                    
-                    for (const auto& dep : departures) {
-                        bool exists = false;
-                        for (const auto& existing : lines) {
-                            if (existing.line == dep.line && 
-                                existing.direction == dep.direction && 
-                                existing.type == dep.type) {
-                                exists = true;
-                                break;
-                            }
-                        }
-                        
-                        if (!exists && dep.line.length() > 0) {
-                            LineInfo info;
-                            info.line = dep.line;
-                            info.direction = dep.direction;
-                            info.type = dep.type;
-                            lines.push_back(info);
-                        }
-                    }
-                    
-                    Logger::printf("TRANSPORT", "Found %d unique lines", lines.size());
-                } else {
-                    Logger::printf("TRANSPORT", "HTTP Error: %d", httpCode);
-                    if (httpCode == 403) {
-                        Logger::error("TRANSPORT", "API Key invalid or not yet active.");
-                    }
-                }
+    // Request mit höherem Limit um mehr Linien zu finden
+    String requestBody = OjpParser::buildRequestXml(stopId, "CrowPanel", 50);
+    Logger::printf("TRANSPORT", "Getting available lines for stop: %s", stopId.c_str());
+    
+    // Streaming: Abfahrten werden direkt beim Lesen über den Hash-Index
+    // dedupliziert, ohne die (grosse) 50er-Antwort als String/DOM zu halten
+    OjpStreamParser parser([&lines](size_t, const Departure& dep, const char* direction, const char*) {
+        if (dep.line[0] == '\0') return;
+        lines.add(dep.line, dep.mode, direction, 0);
+    });
+    
+    int written = 0;
+    int httpCode = _connection.post((const uint8_t*)requestBody.c_str(), requestBody.length(), parser, written);
+    
+    if (httpCode > 0) {
+        if (httpCode == HTTP_CODE_OK) {
+            if (written < 0 || !parser.finish()) {
+                Logger::printf("TRANSPORT", "Lines response incomplete or invalid (%d)", written);
+                lines.clear();
             } else {
-                Logger::printf("TRANSPORT", "HTTP Connection failed: %s", http.errorToString(httpCode).c_str());
+                Logger::printf("TRANSPORT", "Found %d unique lines", lines.size());
+                return true;
+            }
+        } else {
+            Logger::printf("TRANSPORT", "HTTP Error: %d", httpCode);
+            if (httpCode == 403) {
+                Logger::error("TRANSPORT", "API Key invalid or not yet active.");
             }
-            
-            http.end();
         }
+    } else {
+        Logger::printf("TRANSPORT", "HTTP Connection failed: %s", HTTPClient::errorToString(httpCode).c_str());
     }
     
-    return lines;
+    return false;
 }
 
-void TransportModule::fetchData() {
+bool TransportModule::fetchData() {
     if (WiFi.status() != WL_CONNECTED) {
         Logger::info("TRANSPORT", "Wifi not connected, skipping update");
-        return;
+        _connection.close();
+        return false;
     }
 
-    // Thread-safe copy of API Key
-    String key;
+    // Neuer Stand wird privat befüllt und erst nach erfolgreichem Parsen veröffentlicht
+    std::shared_ptr<DepartureSnapshot> next = std::make_shared<DepartureSnapshot>();
+    String stopIds[MAX_STOPS];
+    bool rulesChanged = false;
     if (_mutex) {
         xSemaphoreTake(_mutex, portMAX_DELAY);
-        key = _apiKey;
+        DepartureSnapshotPtr current = std::atomic_load(&_snapshot);
+        for (size_t i = 0; i < MAX_STOPS; i++) {
+            stopIds[i] = _stopIds[i];
+            // Zielort-IDs bleiben über Polls derselben Haltestelle stabil
+            next->stops[i].inheritDirections(current->stops[i]);
+        }
+        if (_lineRulesChanged) {
+            _lineFilter.configure(_lineRules, LineFilter::MAX_RULES);
+            _planner.reset();
+            _lineRulesChanged = false;
+            rulesChanged = true;
+        }
         xSemaphoreGive(_mutex);
     }
-
-    std::unique_ptr<WiFiClientSecure> client(new WiFiClientSecure());
-    if (client) {
-        configureTLS(client.get());
-        
-        HTTPClient http;
-        
-        if (http.begin(*client, OJP_API_URL)) {
-            http.addHeader("Content-Type", "application/xml");
-            http.addHeader("Authorization", "Bearer " + key);
-            http.addHeader("User-Agent", "CrowPanel-OEV-Display/1.0");
-            
-            String sId;
-            if (_mutex) {
-                xSemaphoreTake(_mutex, portMAX_DELAY);
-                sId = _stationId;
-                xSemaphoreGive(_mutex);
-            }
-            
-            String requestBody = OjpParser::buildRequestXml(sId, "CrowPanelDisplay");
-            Logger::info("TRANSPORT", "Sending OJP Request...");
-            
-            int httpCode = http.POST(requestBody);
-            
-            if (httpCode > 0) {
-                if (httpCode == HTTP_CODE_OK) {
-                    String payload = http.getString();
-                    Logger::info("TRANSPORT", "OJP Response received");
-                    
-                    std::vector<Departure> newDepartures = OjpParser::parseResponse(payload);
-                    Logger::printf("TRANSPORT", "Parsed %d departures", newDepartures.size());
-                    
-                    if (_mutex) {
-                        xSemaphoreTake(_mutex, portMAX_DELAY);
-                        _departures = newDepartures;
-                        xSemaphoreGive(_mutex);
+    
+    // Einmal pro Stunde (bzw. nach neuer Konfiguration) die volle Liste für den Offline-Cache holen
+    time_t now = time(NULL);
+    bool deep = _departureCache.refreshDue(stopIds, now) || rulesChanged;
+    
+    // Ein gebündelter Request für alle Haltestellen: ein Handshake, ein Round Trip.
+    // Die Hauptstation fragt nur so viele Abfahrten an, wie das Display nach dem
+    // Linienfilter braucht, gelernte LineRefs filtern schon auf dem Server.
+    OjpStopEventQuery queries[MAX_STOPS];
+    for (size_t i = 0; i < MAX_STOPS; i++) {
+        if (stopIds[i].isEmpty()) continue;
+        queries[i].stopRef = stopIds[i].c_str();
+        queries[i].limit = _planner.limitFor(false, deep);
+    }
+    bool localFilter = _lineFilter.active() && queries[0].stopRef;
+    bool serverFilter = localFilter && _lineFilter.serverRefs(queries[0].lineRefs, OJP_MAX_LINE_FILTER) > 0;
+    if (localFilter) queries[0].limit = _planner.limitFor(true, deep);
+    
+    // Body direkt in den festen Puffer rendern (keine Allokation pro Poll)
+    OjpRequestValues values(now);
+    values.requestor = "CrowPanelDisplay";
+    size_t bodyLength = OjpRequestTemplate::renderStopEvents(values, queries, MAX_STOPS,
+                                                             _requestBuffer, sizeof(_requestBuffer));
+    if (bodyLength == 0) {
+        Logger::error("TRANSPORT", "OJP Request too large for buffer");
+        return false;
+    }
+    Logger::printf("TRANSPORT", "Sending OJP Request (%d bytes, %d results%s)...", bodyLength,
+                   queries[0].limit, serverFilter ? ", line filter" : "");
+    
+    // Body wird chunkweise direkt aus dem TLS-Stream geparst und
+    // über den Delivery-Index auf die Haltestellen verteilt
+    DepartureSnapshot* incoming = next.get();
+    LineFilter* filter = localFilter ? &_lineFilter : NULL;
+    size_t received = 0;
+    size_t kept = 0;
+    OjpStreamParser parser([incoming, filter, &received, &kept](size_t stop, const Departure& dep,
+                                                                const char* direction, const char* lineRef) {
+        if (stop >= MAX_STOPS) return;
+        if (stop == 0 && filter) {
+            received++;
+            filter->learn(dep, direction, lineRef);
+            if (!filter->matches(dep, direction)) return;
+            kept++;
+        }
+        incoming->stops[stop].add(dep, direction);
+    });
+    
+    int written = 0;
+    int httpCode = _connection.post((const uint8_t*)_requestBuffer, bodyLength, parser, written);
+    
+    if (httpCode > 0) {
+        if (httpCode == HTTP_CODE_OK) {
+            if (written < 0 || !parser.finish()) {
+                Logger::printf("TRANSPORT", "OJP Response incomplete or invalid (%d)", written);
+            } else {
+                OjpConnectionStats stats = _connection.getStats();
+                Logger::printf("TRANSPORT", "Parsed %d departures (%d bytes, TTFB %d ms, %d handshakes)",
+                               parser.getDepartureCount(), written, stats.lastTtfbMs, stats.handshakes);
+                if (localFilter) {
+                    Logger::printf("TRANSPORT", "Line filter kept %d of %d departures", kept, received);
+                    _planner.record(received, kept);
+                    _lineFilter.onResponse(false, serverFilter, kept);
+                }
+                
+                _lastSuccessAt = time(NULL);
+                bool changed = false;
+                if (_mutex) {
+                    xSemaphoreTake(_mutex, portMAX_DELAY);
+                    DepartureSnapshotPtr current = std::atomic_load(&_snapshot);
+                    for (size_t i = 0; i < MAX_STOPS; i++) {
+                        // Haltestelle wurde während des Requests umkonfiguriert: Daten verwerfen
+                        if (stopIds[i] != _stopIds[i]) next->stops[i].clear();
+                        next->changes[i] = DepartureDiff::compare(current->stops[i], next->stops[i]);
                     }
-                    
-                    if (eventQueue) {
-                        SystemEvent event = EVENT_DATA_AVAILABLE;
-                        xQueueSend(eventQueue, &event, 0);
+                    // Unveränderte Daten nicht veröffentlichen: Generation bleibt, kein Event.
+                    // Ausnahme: Live-Daten lösen den Offline-Stand immer ab.
+                    changed = next->changed() || current->offline;
+                    if (changed) {
+                        next->fetchedAt = time(NULL);
+                        publish(next);
                     }
+                    xSemaphoreGive(_mutex);
+                }
+                
+                if (!changed) {
+                    Logger::info("TRANSPORT", "Departures unchanged, no update");
                 } else {
-                    Logger::printf("TRANSPORT", "HTTP Error: %d", httpCode);
-                    if (httpCode == 403) {
-                         Logger::error("TRANSPORT", "API Key invalid or not yet active. Please check your email/account.");
-                    }
+                    EventBus::publish(EVENT_DATA_AVAILABLE);
                 }
-            } else {
-                Logger::printf("TRANSPORT", "HTTP Connection failed: %s", http.errorToString(httpCode).c_str());
+                
+                // Linienkatalog lernt mit (umkonfigurierte Haltestellen sind oben geleert)
+                for (size_t i = 0; i < MAX_STOPS; i++) {
+                    _lineCatalog.merge(stopIds[i], next->stops[i], now);
+                }
+                if (deep) _departureCache.store(stopIds, *next, now);
+                return true;
             }
-            
-            http.end();
+        } else {
+            Logger::printf("TRANSPORT", "HTTP Error: %d", httpCode);
+            if (httpCode == 403) {
+                 Logger::error("TRANSPORT", "API Key invalid or not yet active. Please check your email/account.");
+            }
+            // Ungültiger Request: mit LineFilter nicht erneut versuchen
+            if (httpCode == 400 && serverFilter) {
+                Logger::error("TRANSPORT", "Server rejected line filter, filtering locally");
+                _lineFilter.onResponse(true, true, 0);
+            }
+        }
+    } else {
+        Logger::printf("TRANSPORT", "HTTP Connection failed: %s", HTTPClient::errorToString(httpCode).c_str());
+    }
+    
+    return false;
+}
+
+bool TransportModule::publishOffline() {
+    std::shared_ptr<DepartureSnapshot> next = std::make_shared<DepartureSnapshot>();
+    bool published = false;
+    if (_mutex) {
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+        if (_departureCache.fallback(_stopIds, time(NULL), *next)) {
+            DepartureSnapshotPtr current = std::atomic_load(&_snapshot);
+            for (size_t i = 0; i < MAX_STOPS; i++) {
+                next->changes[i] = DepartureDiff::compare(current->stops[i], next->stops[i]);
+            }
+            publish(next);
+            _offline = true;
+            published = true;
         }
+        xSemaphoreGive(_mutex);
     }
+    if (published) EventBus::publish(EVENT_DATA_AVAILABLE);
+    return published;
+}
+
+OjpConnectionStats TransportModule::getConnectionStats() {
+    return _connection.getStats();
 }
 
-void TransportModule::configureTLS(WiFiClientSecure* client) {
-#ifdef DEV_BUILD
-    client->setInsecure();
-#else
-    client->setCACert(ROOT_CA_CERT);
-#endif
+PollStats TransportModule::getPollStats() {
+    PollStats stats = { 0, 0 };
+    if (_mutex) {
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+        stats.intervalMs = _scheduler.getLastIntervalMs();
+        stats.callsSavedPerDay = _scheduler.getCallsSavedPerDay();
+        xSemaphoreGive(_mutex);
+    }
+    return stats;
 }
@@ -3,48 +3,121 @@
 
 #include <Arduino.h>
 #include <vector>
-#include <WiFiClientSecure.h>
 #include "TransportTypes.h"
+#include "OjpConnection.h"
+#include "PollScheduler.h"
+#include "NetworkExecutor.h"
+#include "StopSearchCache.h"
+#include "LineCatalog.h"
+#include "DepartureCache.h"
+#include "LineFilter.h"
+#include "RequestPlanner.h"
 #include "../Core/ConfigStore.h"
 #include "../Core/SystemEvents.h"
 
 class TransportModule {
 public:
+    // Alle konfigurierten Haltestellen werden in einem gebündelten Request abgefragt
+    static const size_t MAX_STOPS = ConfigStore::MAX_STOPS;
+    
+    // Ohne erfolgreichen Poll seit so vielen Sekunden gilt der Stand als veraltet:
+    // dann übernimmt der Offline-Cache (Fahrplanzeiten, das Display zählt lokal herunter)
+    static const time_t OFFLINE_AFTER_S = 120;
+    
     TransportModule();
     
-    void begin(QueueHandle_t eventQueue, ConfigStore* configStore);
+    // Zeilen des Display-Layouts, danach richtet sich NumberOfResults (vor begin() aufrufen)
+    void setRowCapacity(uint8_t rows);
     
-    // Config wird jetzt intern aus dem Store geholt
+    // Neue Daten werden als EVENT_DATA_AVAILABLE über den EventBus gemeldet.
+    // Liegt ein Offline-Cache vor, ist er danach sofort als Snapshot verfügbar.
+    void begin(ConfigStore* configStore);
+    
+    // Übernimmt den Stand aus dem ConfigStore, nur wenn sich dessen Generation geändert hat.
+    // Läuft automatisch vor jedem Poll und nach jeder relevanten Änderung im Store.
     void updateConfig();
     
-    // Weckt den Task auf für ein sofortiges Update
+    // Reiht einen sofortigen Poll ein (mehrfache Aufrufe ergeben einen Poll)
     void triggerUpdate();
 
-    std::vector<Departure> getDepartures();
+    // Aktueller Stand aller Haltestellen. Lock-frei für Leser, keine Kopie der Listen;
+    // unverändert gegenüber einem früheren Stand, wenn `generation` gleich ist.
+    DepartureSnapshotPtr getSnapshot() const;
+    
+    // Haltestellensuche bzw. Linienabfrage, blockiert nicht: der Request läuft im
+    // TransportTask vor dem nächsten Poll. Liefert die Job-ID (0 = Warteschlange voll
+    // oder Antwort aus dem Cache); `result` ist gesetzt, sobald das Ergebnis da ist.
+    // Bis dahin einfach erneut aufrufen, gleiche Anfragen teilen sich einen Job.
+    // Suchen kommen wenn möglich aus dem StopSearchCache; überholte Tipp-Stände,
+    // die noch warten, werden verworfen. Linien kommen wenn möglich aus dem LineCatalog.
+    uint32_t requestStopSearch(const String& query, LookupResultPtr& result);
+    uint32_t requestLines(const String& stopId, LookupResultPtr& result);
     
-    // Synchrone Haltestellensuche (blockiert bis Antwort da)
-    std::vector<StopSearchResult> searchStops(const String& query);
+    NetworkExecutorStats getExecutorStats();
+    StopSearchCacheStats getSearchCacheStats();
+    LineCatalogStats getLineCatalogStats();
     
-    // Synchrone Linienabfrage für eine Haltestelle (blockiert bis Antwort da)
-    std::vector<LineInfo> getAvailableLines(const String& stopId);
+    // Handshakes, Reconnects und TTFB der OJP-Verbindung
+    OjpConnectionStats getConnectionStats();
+    
+    // Aktuelles Poll-Intervall und gesparte API-Calls
+    PollStats getPollStats();
 
 private:
     static void taskCode(void* pvParameters);
     
     ConfigStore* configStore;
     
-    String _stationId;
+    String _stopIds[MAX_STOPS];     // Leere ID = Slot nicht belegt
+    LineConfig _lineRules[LineFilter::MAX_RULES];   // Line1/Line2 der Hauptstation
+    bool _lineRulesChanged;         // fetchData() übernimmt die Regeln in _lineFilter
+    volatile bool _configChanged;   // Vom ConfigStore-Listener gesetzt, TransportTask ruft updateConfig()
     String _apiKey;
-    unsigned long _updateInterval; // ms
+    uint32_t _configGeneration;     // Zuletzt übernommene ConfigStore-Generation (unter _mutex)
+    PollScheduler _scheduler;       // Bestimmt das Intervall bis zum nächsten Poll
+    
+    // Veröffentlichter Stand, nur über std::atomic_load/atomic_store zugreifen
+    DepartureSnapshotPtr _snapshot;
+    uint32_t _generation;           // Letzte vergebene Generation (unter _mutex)
     
-    std::vector<Departure> _departures;
-    SemaphoreHandle_t _mutex; // Für Thread-safe Zugriff auf Daten
+    // Arbeitspuffer für fetchData() (nur vom TransportTask genutzt)
+    char _requestBuffer[2048];
+    SemaphoreHandle_t _mutex; // Für Config, Scheduler und das Veröffentlichen (nicht für Leser)
     
     TaskHandle_t taskHandle;
-    QueueHandle_t eventQueue;
     
-    void fetchData();
-    void configureTLS(WiFiClientSecure* client);
+    // Gemeinsame Keep-Alive-Verbindung für Abfahrten, Suche und Linien
+    OjpConnection _connection;
+    
+    // Alle Requests laufen über diese Warteschlange im TransportTask
+    NetworkExecutor _executor;
+    unsigned long _nextPollAt;      // millis() des nächsten planmässigen Polls (nur TransportTask)
+    
+    StopSearchCache _searchCache;   // Autocomplete, in LittleFS gesichert (falls gemountet)
+    LineCatalog _lineCatalog;       // Linienauswahl, lernt aus jedem Poll mit
+    DepartureCache _departureCache; // Abfahrten für Start und Offline-Betrieb (nur TransportTask)
+    bool _offline;                  // Veröffentlichter Stand kommt aus dem Offline-Cache
+    time_t _lastSuccessAt;          // Letzter erfolgreich geparster Poll (auch unverändert), 0 = keiner
+    LineFilter _lineFilter;         // Nur konfigurierte Linien an der Hauptstation (nur TransportTask)
+    RequestPlanner _planner;        // NumberOfResults pro Haltestelle (nur TransportTask)
+    
+    uint32_t request(NetworkJobType type, const String& key, LookupResultPtr& result);
+    void runJob(const NetworkJob& job);
+    void runPoll();
+    
+    // Blockierende Requests, nur aus dem TransportTask aufrufen
+    // false bei Fehler; `truncated` = Trefferlimit erreicht
+    bool searchStops(const String& query, std::vector<StopSearchResult>& results, bool& truncated);
+    bool getAvailableLines(const String& stopId, LineSet& lines);
+    
+    // true wenn neue Abfahrten übernommen wurden
+    bool fetchData();
+    
+    // Ersatzstand aus dem Offline-Cache veröffentlichen, false = keiner vorhanden
+    bool publishOffline();
+    
+    // Vergibt die nächste Generation und tauscht den Stand aus (Aufrufer hält _mutex)
+    void publish(std::shared_ptr<DepartureSnapshot> next);
 };
 
 #endif // TRANSPORT_MODULE_H
@@ -0,0 +1,93 @@
+#include "TransportTypes.h"
+#include "../Core/StringUtils.h"
+
+namespace {
+
+struct PtModeName {
+    PtMode mode;
+    const char* name;
+};
+
+const PtModeName PT_MODE_NAMES[] = {
+    { PT_MODE_BUS, "bus" },
+    { PT_MODE_TROLLEY_BUS, "trolleyBus" },
+    { PT_MODE_TRAM, "tram" },
+    { PT_MODE_RAIL, "rail" },
+    { PT_MODE_URBAN_RAIL, "urbanRail" },
+    { PT_MODE_METRO, "metro" },
+    { PT_MODE_COACH, "coach" },
+    { PT_MODE_WATER, "water" },
+    { PT_MODE_TELECABIN, "telecabin" },
+    { PT_MODE_FUNICULAR, "funicular" },
+};
+
+} // namespace
+
+PtMode ptModeFromString(const char* text) {
+    if (!text) return PT_MODE_UNKNOWN;
+    for (const PtModeName& entry : PT_MODE_NAMES) {
+        if (strcmp(text, entry.name) == 0) return entry.mode;
+    }
+    return PT_MODE_UNKNOWN;
+}
+
+const char* ptModeToString(PtMode mode) {
+    for (const PtModeName& entry : PT_MODE_NAMES) {
+        if (entry.mode == mode) return entry.name;
+    }
+    return "";
+}
+
+uint8_t DirectionTable::intern(const char* text) {
+    if (!text) text = "";
+
+    for (uint8_t i = 0; i < _count; i++) {
+        if (strcmp(_pool + _offsets[i], text) == 0) return i;
+    }
+
+    size_t len = strlen(text) + 1;
+    if (_count >= MAX_ENTRIES || _used + len >= POOL_SIZE) {
+        return DIRECTION_NONE;
+    }
+
+    // ASCII-Form direkt hinter dem Original. Füllt sie den Restplatz ganz aus,
+    // könnte sie gekürzt sein: dann gilt die Tabelle als voll.
+    char* ascii = _pool + _used + len;
+    size_t remaining = POOL_SIZE - _used - len;
+    size_t asciiLen = StringUtils::toASCII(text, ascii, remaining) + 1;
+    bool same = (asciiLen == len && memcmp(ascii, text, len) == 0);
+    if (!same && asciiLen >= remaining) {
+        return DIRECTION_NONE;
+    }
+
+    memcpy(_pool + _used, text, len);
+    _offsets[_count] = _used;
+    _asciiOffsets[_count] = same ? _used : _used + len;
+    _used += same ? len : len + asciiLen;
+    return _count++;
+}
+
+bool DepartureList::add(const Departure& dep, const char* direction) {
+    if (_count >= CAPACITY) return false;
+
+    uint8_t id = _directions.intern(direction);
+    if (id == DIRECTION_NONE) {
+        // Tabelle voll (z.B. viele alte Ziele aus früheren Polls): aufräumen und nochmals versuchen
+        compactDirections();
+        id = _directions.intern(direction);
+    }
+
+    _items[_count] = dep;
+    _items[_count].directionId = id;
+    StringUtils::toASCII(dep.line, _items[_count].line, Departure::LINE_LEN);
+    _count++;
+    return true;
+}
+
+void DepartureList::compactDirections() {
+    DirectionTable previous = _directions;
+    _directions.clear();
+    for (uint8_t i = 0; i < _count; i++) {
+        _items[i].directionId = _directions.intern(previous.get(_items[i].directionId));
+    }
+}
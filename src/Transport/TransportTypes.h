@@ -3,20 +3,213 @@
 
 #include <Arduino.h>
 #include <time.h>
+#include <string.h>
+#include <memory>
+
+// Verkehrsmittel (OJP PtMode)
+enum PtMode : uint8_t {
+    PT_MODE_UNKNOWN,
+    PT_MODE_BUS,
+    PT_MODE_TROLLEY_BUS,
+    PT_MODE_TRAM,
+    PT_MODE_RAIL,
+    PT_MODE_URBAN_RAIL,
+    PT_MODE_METRO,
+    PT_MODE_COACH,
+    PT_MODE_WATER,
+    PT_MODE_TELECABIN,
+    PT_MODE_FUNICULAR
+};
+
+// "tram" -> PT_MODE_TRAM, unbekannte Werte -> PT_MODE_UNKNOWN
+PtMode ptModeFromString(const char* text);
+
+// PT_MODE_TRAM -> "tram", PT_MODE_UNKNOWN -> ""
+const char* ptModeToString(PtMode mode);
+
+static const uint8_t DIRECTION_NONE = 0xFF;
 
 struct Departure {
-    String line;        // Liniennummer (z.B. "11")
-    String direction;   // Zielort (z.B. "Auzelg")
-    time_t departureTime; // Geplante Abfahrtszeit
-    time_t estimatedTime; // Prognostizierte Abfahrtszeit (falls verfügbar)
-    String type;        // Verkehrsmittel (Bus, Tram, Train, etc.)
-    
+    static const size_t LINE_LEN = 12;
+
+    char line[LINE_LEN];    // Liniennummer (z.B. "11"), inline statt Heap-String
+    time_t departureTime;   // Geplante Abfahrtszeit
+    time_t estimatedTime;   // Prognostizierte Abfahrtszeit (falls verfügbar)
+    PtMode mode;            // Verkehrsmittel (Bus, Tram, Train, etc.)
+    uint8_t directionId;    // Zielort, Index in die DirectionTable der Liste
+
+    Departure() : departureTime(0), estimatedTime(0), mode(PT_MODE_UNKNOWN), directionId(DIRECTION_NONE) {
+        line[0] = '\0';
+    }
+
+    void setLine(const char* text) {
+        strncpy(line, text ? text : "", LINE_LEN - 1);
+        line[LINE_LEN - 1] = '\0';
+    }
+
     // Hilfsfunktion: Gibt die effektive Zeit zurück (Estimated falls vorhanden, sonst Planned)
     time_t getEffectiveTime() const {
         return (estimatedTime > 0) ? estimatedTime : departureTime;
     }
 };
 
+/**
+ * String-Tabelle für Zielorte einer Haltestelle.
+ * An einer Haltestelle wiederholen sich die Ziele stark, deshalb speichert
+ * jede Abfahrt nur eine ID. Der Pool liegt inline: Kopieren braucht keinen Heap.
+ *
+ * Zu jedem Eintrag wird beim Anlegen die ASCII-Form für das Display abgelegt
+ * (nur wenn sie sich vom Original unterscheidet, sonst zeigt sie auf dasselbe Offset).
+ */
+class DirectionTable {
+public:
+    static const size_t MAX_ENTRIES = 24;
+    static const size_t POOL_SIZE = 768;
+
+    DirectionTable() { clear(); }
+
+    void clear() {
+        _count = 0;
+        _used = 0;
+    }
+
+    // Liefert die ID eines (ggf. neu angelegten) Eintrags, DIRECTION_NONE wenn voll
+    uint8_t intern(const char* text);
+
+    // Text zur ID, "" für DIRECTION_NONE oder unbekannte IDs
+    const char* get(uint8_t id) const {
+        return (id < _count) ? _pool + _offsets[id] : "";
+    }
+
+    // Transliterierter Text zur ID (siehe StringUtils::toASCII)
+    const char* getASCII(uint8_t id) const {
+        return (id < _count) ? _pool + _asciiOffsets[id] : "";
+    }
+
+    size_t size() const { return _count; }
+
+private:
+    char _pool[POOL_SIZE];
+    uint16_t _offsets[MAX_ENTRIES];
+    uint16_t _asciiOffsets[MAX_ENTRIES];
+    uint16_t _used;
+    uint8_t _count;
+};
+
+/**
+ * Abfahrtsliste mit fester Kapazität inklusive Zielort-Tabelle.
+ * Kopieren ist ein einfaches memcpy — keine Allokation pro Refresh.
+ */
+class DepartureList {
+public:
+    static const size_t CAPACITY = 20;
+
+    DepartureList() : _count(0) {}
+
+    void clear() {
+        _count = 0;
+        _directions.clear();
+    }
+
+    // Übernimmt nur die Zielort-Tabelle (stabile IDs über mehrere Polls derselben Haltestelle)
+    void inheritDirections(const DepartureList& previous) {
+        _directions = previous._directions;
+    }
+
+    // Fügt eine Abfahrt hinzu und interniert den Zielort. Die Linie wird dabei
+    // nach ASCII transliteriert. false wenn die Liste voll ist.
+    bool add(const Departure& dep, const char* direction);
+
+    size_t size() const { return _count; }
+    bool empty() const { return _count == 0; }
+
+    const Departure& operator[](size_t index) const { return _items[index]; }
+    const Departure* begin() const { return _items; }
+    const Departure* end() const { return _items + _count; }
+
+    const char* direction(const Departure& dep) const { return _directions.get(dep.directionId); }
+    const char* directionASCII(const Departure& dep) const { return _directions.getASCII(dep.directionId); }
+    const DirectionTable& directions() const { return _directions; }
+
+private:
+    Departure _items[CAPACITY];
+    uint8_t _count;
+    DirectionTable _directions;
+
+    // Baut die Tabelle nur mit den noch genutzten Zielorten neu auf
+    void compactDirections();
+};
+
+// Einordnung einer Zeile der neuen Liste gegenüber dem vorherigen Stand
+enum DepartureChange : uint8_t {
+    DEPARTURE_UNCHANGED,        // Gleicher Kurs, gleiche Zeit, gleiche Position
+    DEPARTURE_DELAY_CHANGED,    // Gleicher Kurs, Prognose geändert
+    DEPARTURE_NEW,              // Kurs war vorher nicht in der Liste
+    DEPARTURE_REORDERED         // Gleicher Kurs und Zeit, aber andere Position
+};
+
+/**
+ * Zeilenweise Änderungen einer Abfahrtsliste gegenüber dem vorherigen Stand
+ * (siehe DepartureDiff). Weggefallene Kurse (abgefahren, ausgefallen)
+ * erscheinen nur in `gone`.
+ */
+struct DepartureChangeSet {
+    DepartureChange rows[DepartureList::CAPACITY];  // Pro Zeile der neuen Liste
+    uint32_t changedMask;       // Bit i = Zeile i ist nicht DEPARTURE_UNCHANGED
+    uint8_t count;              // Zeilen der neuen Liste
+    uint8_t previousCount;      // Zeilen der alten Liste
+    uint8_t gone;               // Kurse der alten Liste, die nicht mehr vorkommen
+
+    DepartureChangeSet() : changedMask(0), count(0), previousCount(0), gone(0) {}
+
+    // Keine sichtbare Änderung: gleiche Kurse, Zeiten und Reihenfolge
+    bool empty() const { return changedMask == 0 && count == previousCount; }
+
+    // true wenn sich in den ersten `visibleRows` Zeilen etwas geändert hat
+    bool affects(size_t visibleRows) const {
+        uint32_t mask = visibleRows >= 32 ? 0xFFFFFFFFUL : ((1UL << visibleRows) - 1);
+        if (changedMask & mask) return true;
+        size_t shown = count < visibleRows ? count : visibleRows;
+        size_t shownBefore = previousCount < visibleRows ? previousCount : visibleRows;
+        return shown != shownBefore;
+    }
+};
+
+/**
+ * Unveränderlicher Stand aller Haltestellen nach einem Poll.
+ *
+ * Wird vom TransportModule einmal befüllt und dann per atomarem Pointer-Tausch
+ * veröffentlicht (RCU-artig). Leser halten nur eine Referenz, ein älterer Stand
+ * bleibt gültig, solange noch jemand ihn hält.
+ */
+struct DepartureSnapshot {
+    static const size_t MAX_STOPS = 3;
+
+    uint32_t generation;              // Steigt mit jeder Veröffentlichung, 0 = noch keine Daten
+    time_t fetchedAt;                 // Zeitpunkt des Polls (UTC), 0 wenn leer
+    uint32_t publishedMs;             // millis() beim Veröffentlichen (für die Push-Latenz)
+    bool offline;                     // Aus dem Offline-Cache: nur Fahrplanzeiten, `fetchedAt` = Stand des Caches
+    DepartureList stops[MAX_STOPS];   // 0 = Hauptstation
+    DepartureChangeSet changes[MAX_STOPS];  // Gegenüber dem vorherigen Stand
+
+    DepartureSnapshot() : generation(0), fetchedAt(0), publishedMs(0), offline(false) {}
+
+    bool changed() const {
+        for (size_t i = 0; i < MAX_STOPS; i++) {
+            if (!changes[i].empty()) return true;
+        }
+        return false;
+    }
+
+    // Leere Liste für ungültige Indizes
+    const DepartureList& stop(size_t index) const {
+        static const DepartureList EMPTY;
+        return index < MAX_STOPS ? stops[index] : EMPTY;
+    }
+};
+
+typedef std::shared_ptr<const DepartureSnapshot> DepartureSnapshotPtr;
+
 struct StopSearchResult {
     String id;                // z.B. "8503000"
     String name;              // z.B. "Zürich HB"
@@ -30,5 +223,3 @@ struct LineInfo {
 };
 
 #endif // TRANSPORT_TYPES_H
-
-
@@ -0,0 +1,76 @@
+#include "DepartureJson.h"
+#include <ArduinoJson.h>
+
+DepartureJson::DepartureJson() : _mutex(NULL), _bootId(0) {
+    for (size_t i = 0; i < DepartureSnapshot::MAX_STOPS; i++) {
+        _entries[i].generation = 0;
+    }
+}
+
+void DepartureJson::begin(uint32_t bootId) {
+    _bootId = bootId;
+    _mutex = xSemaphoreCreateMutex();
+}
+
+String DepartureJson::etag(size_t stop, uint32_t generation) const {
+    char tag[32];
+    snprintf(tag, sizeof(tag), "\"%08lx-%lu-%u\"", (unsigned long)_bootId,
+             (unsigned long)generation, (unsigned)stop);
+    return String(tag);
+}
+
+DepartureJson::Entry DepartureJson::get(size_t stop, const DepartureSnapshot& snapshot) {
+    Entry result;
+    result.generation = snapshot.generation;
+    if (stop >= DepartureSnapshot::MAX_STOPS || !_mutex) {
+        result.body = serialize(stop, snapshot);
+        return result;
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Entry& cached = _entries[stop];
+    if (cached.body && cached.generation == snapshot.generation) {
+        result.body = cached.body;
+        xSemaphoreGive(_mutex);
+        return result;
+    }
+    xSemaphoreGive(_mutex);
+
+    // Serialisieren ohne Lock; nur übernehmen, wenn inzwischen kein neuerer Stand im Cache liegt
+    result.body = serialize(stop, snapshot);
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (!cached.body || snapshot.generation > cached.generation) {
+        cached = result;
+    }
+    xSemaphoreGive(_mutex);
+    return result;
+}
+
+std::shared_ptr<const String> DepartureJson::serialize(size_t stop, const DepartureSnapshot& snapshot) {
+    // Die Minuten bis zur Abfahrt berechnet der Client aus `timestamp`
+    const DepartureList& departures = snapshot.stop(stop);
+
+    JsonDocument doc;
+    JsonArray depsArray = doc["departures"].to<JsonArray>();
+    
+    for (const auto& dep : departures) {
+        JsonObject obj = depsArray.add<JsonObject>();
+        obj["line"] = dep.line;
+        obj["direction"] = departures.direction(dep);
+        obj["type"] = ptModeToString(dep.mode);
+        obj["timestamp"] = (long)dep.getEffectiveTime();
+    }
+    
+    // Füge Metadaten hinzu
+    doc["stop"] = stop;
+    doc["generation"] = snapshot.generation;
+    doc["count"] = departures.size();
+    doc["fetched_at"] = (long)snapshot.fetchedAt;
+    doc["offline"] = snapshot.offline;
+    
+    String* body = new String();
+    body->reserve(measureJson(doc));
+    serializeJson(doc, *body);
+    return std::shared_ptr<const String>(body);
+}
@@ -0,0 +1,43 @@
+#ifndef DEPARTURE_JSON_H
+#define DEPARTURE_JSON_H
+
+#include <Arduino.h>
+#include <memory>
+#include "../Transport/TransportTypes.h"
+
+/**
+ * Serialisierte Abfahrten pro Haltestelle, wie sie /api/departures und der
+ * Push-Kanal (/api/events) ausliefern.
+ *
+ * Der Body hängt nur vom Snapshot ab (keine aktuelle Uhrzeit) und wird pro
+ * Generation einmal erzeugt. REST-Handler (AsyncTCP Task) und WebEventStream
+ * (eigener Task) teilen sich den Cache, deshalb der Mutex.
+ */
+class DepartureJson {
+public:
+    struct Entry {
+        uint32_t generation;
+        std::shared_ptr<const String> body;     // NULL = noch nicht erzeugt
+    };
+
+    DepartureJson();
+
+    // `bootId` macht ETags über Neustarts eindeutig (Generation beginnt wieder bei 1)
+    void begin(uint32_t bootId);
+
+    // Starkes ETag für Stand und Haltestelle, ohne etwas zu serialisieren
+    String etag(size_t stop, uint32_t generation) const;
+
+    // Body zum Snapshot. Wird bei neuer Generation erzeugt; der Aufrufer hält
+    // den String per shared_ptr, ein späterer Neuaufbau gibt ihn nicht frei.
+    Entry get(size_t stop, const DepartureSnapshot& snapshot);
+
+private:
+    SemaphoreHandle_t _mutex;
+    uint32_t _bootId;
+    Entry _entries[DepartureSnapshot::MAX_STOPS];
+
+    static std::shared_ptr<const String> serialize(size_t stop, const DepartureSnapshot& snapshot);
+};
+
+#endif // DEPARTURE_JSON_H
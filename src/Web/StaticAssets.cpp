@@ -0,0 +1,154 @@
+#include "StaticAssets.h"
+#include "../Logger/Logger.h"
+
+#ifdef WEB_ASSETS_EMBEDDED
+#include <web_assets_embedded.h>    // .pio/webgen, von scripts/build_web_assets.py
+#endif
+
+namespace {
+
+const char* MANIFEST_PATH = "/assets.idx";
+const size_t MANIFEST_MAX = 512;
+const char* CACHE_IMMUTABLE = "public, max-age=31536000, immutable";
+const char* CACHE_REVALIDATE = "no-cache";
+
+bool endsWith(const char* text, const char* suffix) {
+    size_t textLen = strlen(text);
+    size_t suffixLen = strlen(suffix);
+    return textLen >= suffixLen && strcmp(text + textLen - suffixLen, suffix) == 0;
+}
+
+} // namespace
+
+StaticAssets::StaticAssets() : _fs(NULL), _count(0) {
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+bool StaticAssets::begin(fs::FS& fs) {
+    _fs = &fs;
+    _count = 0;
+
+    File file = fs.open(MANIFEST_PATH, "r");
+    if (!file) {
+        Logger::info("WEB", "No asset manifest, serving uncompressed files");
+        return false;
+    }
+
+    char manifest[MANIFEST_MAX + 1];
+    size_t len = file.read((uint8_t*)manifest, MANIFEST_MAX);
+    file.close();
+    manifest[len] = '\0';
+
+    // Eine Zeile pro Datei: "<pfad> <hash> <gz-bytes> <roh-bytes>"
+    char* save = NULL;
+    for (char* line = strtok_r(manifest, "\n", &save); line && _count < MAX_ASSETS; line = strtok_r(NULL, "\n", &save)) {
+        char path[PATH_LEN];
+        char hash[HASH_LEN + 1];
+        unsigned long size = 0;
+        if (sscanf(line, "%23s %8s %lu", path, hash, &size) != 3 || path[0] != '/') continue;
+        add(path, hash, size, NULL);
+    }
+
+    Logger::printf("WEB", "%u precompressed assets", (unsigned)_count);
+    return _count > 0;
+}
+
+bool StaticAssets::beginEmbedded() {
+#ifdef WEB_ASSETS_EMBEDDED
+    _fs = NULL;
+    _count = 0;
+    for (size_t i = 0; i < sizeof(EMBEDDED_WEB_ASSETS) / sizeof(EMBEDDED_WEB_ASSETS[0]); i++) {
+        const EmbeddedWebAsset& asset = EMBEDDED_WEB_ASSETS[i];
+        add(asset.path, asset.hash, asset.size, asset.data);
+    }
+    _stats.embedded = true;
+    Logger::printf("WEB", "%u embedded assets", (unsigned)_count);
+    return _count > 0;
+#else
+    return false;
+#endif
+}
+
+bool StaticAssets::add(const char* path, const char* hash, uint32_t size, const uint8_t* data) {
+    if (_count >= MAX_ASSETS || strlen(path) >= PATH_LEN || strlen(hash) != HASH_LEN) return false;
+
+    Asset& asset = _assets[_count++];
+    strcpy(asset.path, path);
+    snprintf(asset.etag, sizeof(asset.etag), "\"%s\"", hash);
+    asset.size = size;
+    asset.contentType = contentTypeFor(path);
+    asset.data = data;
+    return true;
+}
+
+bool StaticAssets::canHandle(AsyncWebServerRequest* request) {
+    if (request->method() != HTTP_GET) return false;
+    return find(request->url()) != NULL;
+}
+
+void StaticAssets::handleRequest(AsyncWebServerRequest* request) {
+    unsigned long startUs = micros();
+    const Asset* asset = find(request->url());
+    if (!asset) {
+        request->send(404);
+        return;
+    }
+    _stats.requests++;
+
+    // Versionierte URL: Inhalt kann sich unter dieser Adresse nie ändern
+    bool versioned = false;
+    if (request->hasParam("v")) {
+        const String& version = request->getParam("v")->value();
+        versioned = version.length() == HASH_LEN && strncmp(version.c_str(), asset->etag + 1, HASH_LEN) == 0;
+    }
+    const char* cacheControl = versioned ? CACHE_IMMUTABLE : CACHE_REVALIDATE;
+
+    if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == asset->etag) {
+        _stats.notModified++;
+        AsyncWebServerResponse* response = request->beginResponse(304);
+        response->addHeader("ETag", asset->etag);
+        response->addHeader("Cache-Control", cacheControl);
+        request->send(response);
+        record(startUs);
+        return;
+    }
+
+    AsyncWebServerResponse* response;
+    if (asset->data) {
+        // Liest beim Senden direkt aus dem gemappten Flash
+        response = request->beginResponse(200, asset->contentType, asset->data, asset->size);
+    } else {
+        // Pfad endet auf .gz: AsyncFileResponse setzt dann selbst kein Content-Encoding
+        response = request->beginResponse(*_fs, String(asset->path) + ".gz", asset->contentType);
+    }
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("ETag", asset->etag);
+    response->addHeader("Cache-Control", cacheControl);
+    request->send(response);
+    _stats.bytesSent += asset->size;
+    record(startUs);
+}
+
+void StaticAssets::record(unsigned long startUs) {
+    uint32_t us = micros() - startUs;
+    _stats.handleUs = (_stats.requests == 1) ? us : (_stats.handleUs * 7 + us) / 8;
+}
+
+const StaticAssets::Asset* StaticAssets::find(const String& url) const {
+    const char* path = (url == "/") ? "/index.html" : url.c_str();
+    for (size_t i = 0; i < _count; i++) {
+        if (strcmp(_assets[i].path, path) == 0) return &_assets[i];
+    }
+    return NULL;
+}
+
+const char* StaticAssets::contentTypeFor(const char* path) {
+    if (endsWith(path, ".html")) return "text/html";
+    if (endsWith(path, ".js")) return "application/javascript";
+    if (endsWith(path, ".css")) return "text/css";
+    if (endsWith(path, ".json")) return "application/json";
+    if (endsWith(path, ".svg")) return "image/svg+xml";
+    if (endsWith(path, ".ico")) return "image/x-icon";
+    if (endsWith(path, ".png")) return "image/png";
+    return "application/octet-stream";
+}
@@ -0,0 +1,78 @@
+#ifndef STATIC_ASSETS_H
+#define STATIC_ASSETS_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <FS.h>
+
+struct StaticAssetStats {
+    uint32_t requests;          // Anfragen an die Web-Oberfläche (HTML/JS/CSS)
+    uint32_t notModified;       // Davon mit 304 beantwortet (kein Dateizugriff)
+    uint32_t bytesSent;         // Ausgelieferte Bytes (komprimiert, ohne Header)
+    uint32_t handleUs;          // Zeit im Handler bis zur fertigen Antwort (gleitender Mittelwert)
+    bool embedded;              // Dateien aus der Firmware statt aus LittleFS
+};
+
+/**
+ * Liefert die vorkomprimierten Dateien der Web-Oberfläche aus LittleFS.
+ *
+ * scripts/build_web_assets.py legt pro Datei `<name>.gz` und das Manifest
+ * `assets.idx` (Pfad, Content-Hash, Grössen) ins Image. Das Manifest wird beim
+ * Start einmal gelesen; Revalidierungen werden danach ohne Flash-Zugriff mit
+ * 304 beantwortet.
+ *
+ * - Body immer mit `Content-Encoding: gzip` (jeder Browser kann das)
+ * - ETag = Content-Hash
+ * - `?v=<hash>` passend (so verweist index.html auf app.js/style.css):
+ *   `Cache-Control: public, max-age=31536000, immutable`
+ * - sonst (index.html, Aufruf ohne Version): `no-cache`, d.h. Revalidierung per ETag
+ *
+ * Mit -DWEB_ASSETS_EMBEDDED kommen dieselben gzip-Daten als const Arrays aus
+ * der Firmware (web_assets_embedded.h, ebenfalls vom Build-Script erzeugt).
+ * Sie liegen im memory-mapped Flash und gehen beim Senden direkt von dort in
+ * den TCP-Puffer, ohne Zwischenpuffer und ohne Dateisystem; LittleFS wird
+ * dann gar nicht gemountet.
+ */
+class StaticAssets : public AsyncWebHandler {
+public:
+    static const size_t MAX_ASSETS = 8;
+    static const size_t PATH_LEN = 24;
+    static const size_t HASH_LEN = 8;
+
+    StaticAssets();
+
+    // Liest das Manifest. false = Image ohne Manifest (z.B. alter Upload), dann
+    // bleibt serveStatic() zuständig.
+    bool begin(fs::FS& fs);
+
+    // Übernimmt die in die Firmware kompilierten Dateien. false = ohne
+    // WEB_ASSETS_EMBEDDED gebaut.
+    bool beginEmbedded();
+
+    StaticAssetStats getStats() const { return _stats; }
+
+    bool canHandle(AsyncWebServerRequest* request) override;
+    void handleRequest(AsyncWebServerRequest* request) override;
+    bool isRequestHandlerTrivial() override { return true; }
+
+private:
+    struct Asset {
+        char path[PATH_LEN];        // "/app.js"
+        char etag[HASH_LEN + 3];    // "\"cf9ea030\""
+        uint32_t size;              // Komprimierte Grösse
+        const char* contentType;
+        const uint8_t* data;        // Eingebettet (Flash), NULL = "<path>.gz" aus LittleFS
+    };
+
+    fs::FS* _fs;
+    Asset _assets[MAX_ASSETS];
+    size_t _count;
+    StaticAssetStats _stats;
+
+    bool add(const char* path, const char* hash, uint32_t size, const uint8_t* data);
+    const Asset* find(const String& url) const;
+    void record(unsigned long startUs);
+    static const char* contentTypeFor(const char* path);
+};
+
+#endif // STATIC_ASSETS_H
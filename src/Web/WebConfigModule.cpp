@@ -11,6 +11,8 @@ static const size_t LIMIT_LINE_NAME      = 20;
 static const size_t LIMIT_DIRECTION      = 100;
 static const size_t LIMIT_SEARCH_QUERY   = 50;
 static const size_t LIMIT_STOP_ID        = 20;
+static const uint32_t LIMIT_POLL_MIN_S   = 10;
+static const uint32_t LIMIT_POLL_MAX_S   = 3600;
 
 WebConfigModule::WebConfigModule() : server(80), configStore(NULL), wifiManager(NULL), transportModule(NULL), deviceIdentity(NULL) {}
 
@@ -19,15 +21,22 @@ void WebConfigModule::begin(ConfigStore* config, WifiManager* wifi, TransportMod
     this->wifiManager = wifi;
     this->transportModule = transport;
     this->deviceIdentity = identity;
-    
+    departureJson.begin(esp_random());
+    unsigned long start = millis();
+
+#ifdef WEB_ASSETS_EMBEDDED
+    // Web-Oberfläche liegt in der Firmware, LittleFS wird nicht gebraucht
+    staticAssets.beginEmbedded();
+#else
     if(!LittleFS.begin(true)){
         Logger::error("WEB", "An Error has occurred while mounting LittleFS");
         return;
     }
+#endif
     
     setupRoutes();
     server.begin();
-    Logger::info("WEB", "Web Server started");
+    Logger::printf("WEB", "Web Server started after %lu ms", millis() - start);
 
     // Start mDNS
     if (MDNS.begin("crowpanel")) {
@@ -99,9 +108,23 @@ void WebConfigModule::setupRoutes() {
     server.on("/api/device", HTTP_GET, [this](AsyncWebServerRequest *request) {
         this->handleDeviceInfo(request);
     });
+
+    // Push: Abfahrten, WLAN- und Zeitstatus per Server-Sent Events
+    if (transportModule) {
+        eventStream.begin(server, &departureJson, transportModule, wifiManager);
+    }
     
     // Static Files - MUSS am Ende stehen, da "/" alles matched
-    server.serveStatic("/", LittleFS, "/").setDefaultFile("index.html");
+    // Vorkomprimierte Dateien mit ETag (build_web_assets.py), sonst Fallback auf die Rohdateien
+#ifdef WEB_ASSETS_EMBEDDED
+    server.addHandler(&staticAssets);
+#else
+    if (staticAssets.begin(LittleFS)) {
+        server.addHandler(&staticAssets);
+    } else {
+        server.serveStatic("/", LittleFS, "/").setDefaultFile("index.html");
+    }
+#endif
 }
 
 void WebConfigModule::handleStatus(AsyncWebServerRequest *request) {
@@ -118,22 +141,98 @@ void WebConfigModule::handleStatus(AsyncWebServerRequest *request) {
         doc["fw_version"] = deviceIdentity->getFirmwareVersion();
     }
     
+    // OJP Verbindung: Handshakes vs. Requests zeigt, wie gut Keep-Alive greift
+    if (transportModule) {
+        OjpConnectionStats ojp = transportModule->getConnectionStats();
+        doc["ojp"]["requests"] = ojp.requests;
+        doc["ojp"]["handshakes"] = ojp.handshakes;
+        doc["ojp"]["reconnects"] = ojp.reconnects;
+        doc["ojp"]["dns_lookups"] = ojp.dnsLookups;
+        doc["ojp"]["handshake_ms"] = ojp.lastHandshakeMs;
+        doc["ojp"]["ttfb_ms"] = ojp.lastTtfbMs;
+        doc["ojp"]["ttfb_avg_ms"] = ojp.avgTtfbMs;
+        
+        PollStats poll = transportModule->getPollStats();
+        doc["poll"]["interval_s"] = poll.intervalMs / 1000;
+        doc["poll"]["saved_per_day"] = poll.callsSavedPerDay;
+        
+        // Push-Kanal: Clients, Nachrichten und Latenz ab Veröffentlichung
+        WebEventStats events = eventStream.getStats();
+        doc["events"]["clients"] = events.clients;
+        doc["events"]["pushed"] = events.pushed;
+        doc["events"]["deferred"] = events.deferred;
+        doc["events"]["latency_ms"] = events.lastLatencyMs;
+        doc["events"]["latency_avg_ms"] = events.avgLatencyMs;
+    }
+
+    // Web-Oberfläche: wie viele Seitenaufrufe nur revalidiert wurden
+    StaticAssetStats assets = staticAssets.getStats();
+    doc["assets"]["requests"] = assets.requests;
+    doc["assets"]["not_modified"] = assets.notModified;
+    doc["assets"]["bytes"] = assets.bytesSent;
+    doc["assets"]["handle_us"] = assets.handleUs;
+    doc["assets"]["embedded"] = assets.embedded;
+    
+    // Netzwerk-Warteschlange: wie oft gleiche Anfragen zusammengelegt wurden
+    if (transportModule) {
+        NetworkExecutorStats jobs = transportModule->getExecutorStats();
+        doc["jobs"]["submitted"] = jobs.submitted;
+        doc["jobs"]["coalesced"] = jobs.coalesced;
+        doc["jobs"]["rejected"] = jobs.rejected;
+        doc["jobs"]["cancelled"] = jobs.cancelled;
+        doc["jobs"]["rerun"] = jobs.rerun;
+        doc["jobs"]["pending"] = jobs.pending;
+        
+        // Haltestellensuche: lokal beantwortete Suchen = gesparte API-Calls
+        StopSearchCacheStats search = transportModule->getSearchCacheStats();
+        uint32_t local = search.hits + search.prefixHits;
+        uint32_t total = local + search.misses;
+        doc["search_cache"]["hits"] = search.hits;
+        doc["search_cache"]["prefix_hits"] = search.prefixHits;
+        doc["search_cache"]["misses"] = search.misses;
+        doc["search_cache"]["entries"] = search.entries;
+        doc["search_cache"]["calls_saved"] = local;
+        doc["search_cache"]["hit_ratio"] = total ? (float)local / total : 0.0f;
+        
+        LineCatalogStats lines = transportModule->getLineCatalogStats();
+        doc["line_catalog"]["hits"] = lines.hits;
+        doc["line_catalog"]["misses"] = lines.misses;
+        doc["line_catalog"]["learned"] = lines.learned;
+        doc["line_catalog"]["stops"] = lines.stops;
+    }
+    
+    // Ein Snapshot aus dem RAM für alle Einstellungen (kein NVS-Zugriff)
+    ConfigSnapshotPtr config = configStore->getSnapshot();
+    doc["poll"]["min"] = config->poll.minSeconds;
+    doc["poll"]["max"] = config->poll.maxSeconds;
+    
+    ConfigStoreStats configStats = configStore->getStats();
+    doc["config"]["generation"] = configStats.generation;
+    doc["config"]["nvs_reads"] = configStats.nvsReads;
+    doc["config"]["nvs_writes"] = configStats.nvsWrites;
+    doc["config"]["nvs_commits"] = configStats.nvsCommits;
+    
     // Config Status
-    doc["configured"] = configStore->hasWifiConfig();
+    doc["configured"] = config->ssid.length() > 0;
     
     // Current station config
-    StationConfig station = configStore->getStation();
-    doc["station"]["name"] = station.name;
-    doc["station"]["id"] = station.id;
+    doc["station"]["name"] = config->stops[0].name;
+    doc["station"]["id"] = config->stops[0].id;
+    
+    // Zusätzliche Haltestellen (werden im selben Request abgefragt)
+    JsonArray stops = doc["stops"].to<JsonArray>();
+    for (size_t i = 1; i < ConfigStore::MAX_STOPS; i++) {
+        JsonObject obj = stops.add<JsonObject>();
+        obj["name"] = config->stops[i].name;
+        obj["id"] = config->stops[i].id;
+    }
     
     // Current line configs
-    LineConfig line1 = configStore->getLine1();
-    doc["line1"]["name"] = line1.name;
-    doc["line1"]["dir"] = line1.direction;
+    doc["line1"]["name"] = config->line1.name;
+    doc["line1"]["dir"] = config->line1.direction;
     
-    LineConfig line2 = configStore->getLine2();
-    doc["line2"]["name"] = line2.name;
-    doc["line2"]["dir"] = line2.direction;
+    doc["line2"]["name"] = config->line2.name;
+    doc["line2"]["dir"] = config->line2.direction;
     
     String response;
     serializeJson(doc, response);
@@ -221,6 +320,10 @@ void WebConfigModule::handleConfigSave(AsyncWebServerRequest *request, uint8_t *
     
     Logger::info("WEB", "Received new config");
     
+    // Alle Felder als ein NVS-Commit; bei einem Validierungsfehler wird nichts übernommen
+    ConfigUpdate update(configStore);
+    ConfigSnapshotPtr before = configStore->getSnapshot();
+    
     if (doc["ssid"].is<const char*>()) {
         String ssid = doc["ssid"].as<String>();
         if (ssid.length() > LIMIT_SSID) {
@@ -252,6 +355,25 @@ void WebConfigModule::handleConfigSave(AsyncWebServerRequest *request, uint8_t *
         }
     }
     
+    // Zusätzliche Haltestellen: Eintrag i belegt Slot i+1, leere ID gibt den Slot frei
+    if (doc["stops"].is<JsonArray>()) {
+        JsonArray stops = doc["stops"];
+        if (stops.size() > ConfigStore::MAX_STOPS - 1) {
+            request->send(400, "application/json", "{\"status\":\"error\",\"message\":\"Too many stops\"}");
+            return;
+        }
+        size_t slot = 1;
+        for (JsonObject st : stops) {
+            String stName = st["name"].as<String>();
+            String stId = st["id"].as<String>();
+            if (stName.length() > LIMIT_STATION_NAME || stId.length() > LIMIT_STATION_ID) {
+                request->send(400, "application/json", "{\"status\":\"error\",\"message\":\"Station data too long\"}");
+                return;
+            }
+            configStore->setStop(slot++, stName, stId);
+        }
+    }
+    
     if (doc["line1"].is<JsonObject>()) {
         JsonObject l1 = doc["line1"];
         String l1Name = l1["name"].as<String>();
@@ -278,6 +400,17 @@ void WebConfigModule::handleConfigSave(AsyncWebServerRequest *request, uint8_t *
         }
     }
 
+    if (doc["poll"].is<JsonObject>()) {
+        JsonObject poll = doc["poll"];
+        uint32_t pollMin = poll["min"] | 0u;
+        uint32_t pollMax = poll["max"] | 0u;
+        if (pollMin < LIMIT_POLL_MIN_S || pollMax > LIMIT_POLL_MAX_S || pollMin > pollMax) {
+            request->send(400, "application/json", "{\"status\":\"error\",\"message\":\"Invalid poll interval\"}");
+            return;
+        }
+        configStore->setPollInterval(pollMin, pollMax);
+    }
+
     if (doc["web_password"].is<const char*>()) {
         String webPw = doc["web_password"].as<String>();
         if (webPw.length() <= LIMIT_PASSWORD) {
@@ -286,10 +419,23 @@ void WebConfigModule::handleConfigSave(AsyncWebServerRequest *request, uint8_t *
         }
     }
     
-    request->send(200, "application/json", "{\"status\":\"ok\",\"message\":\"Saved. Restarting...\"}");
+    if (!update.commit()) {
+        request->send(500, "application/json", "{\"status\":\"error\",\"message\":\"Could not save settings\"}");
+        return;
+    }
+    
+    // Kein Neustart: die Module übernehmen die Änderungen über ihre ConfigStore-Listener
+    // (Transport: Haltestellen/Linien/Poll, Display: Stationsname, WLAN: nur neue Zugangsdaten)
+    uint32_t changed = ConfigStore::changes(*before, *configStore->getSnapshot());
+    JsonDocument result;
+    result["status"] = "ok";
+    result["message"] = changed ? "Saved and applied" : "No changes";
+    result["restart"] = false;
+    result["reconnect"] = (changed & CONFIG_CHANGE_WIFI) != 0;
     
-    delay(1000);
-    ESP.restart();
+    String response;
+    serializeJson(result, response);
+    request->send(200, "application/json", response);
 }
 
 void WebConfigModule::handleStopSearch(AsyncWebServerRequest *request) {
@@ -315,14 +461,16 @@ void WebConfigModule::handleStopSearch(AsyncWebServerRequest *request) {
         return;
     }
     
-    Logger::printf("WEB", "Stop search request: %s", query.c_str());
-    
-    std::vector<StopSearchResult> stops = transportModule->searchStops(query);
+    // Läuft im TransportTask; bis das Ergebnis da ist, fragt der Browser erneut
+    LookupResultPtr lookup;
+    uint32_t job = transportModule->requestStopSearch(query, lookup);
+    if (sendPendingLookup(request, job, lookup)) return;
+    if (sendFailedLookup(request, lookup)) return;
     
     JsonDocument doc;
     JsonArray results = doc["results"].to<JsonArray>();
     
-    for (const auto& stop : stops) {
+    for (const auto& stop : lookup->stops) {
         JsonObject obj = results.add<JsonObject>();
         obj["id"] = stop.id;
         obj["name"] = stop.name;
@@ -358,14 +506,15 @@ void WebConfigModule::handleLineSearch(AsyncWebServerRequest *request) {
         return;
     }
     
-    Logger::printf("WEB", "Line search request for stop: %s", stopId.c_str());
-    
-    std::vector<LineInfo> lines = transportModule->getAvailableLines(stopId);
+    LookupResultPtr lookup;
+    uint32_t job = transportModule->requestLines(stopId, lookup);
+    if (sendPendingLookup(request, job, lookup)) return;
+    if (sendFailedLookup(request, lookup)) return;
     
     JsonDocument doc;
     JsonArray linesArray = doc["lines"].to<JsonArray>();
     
-    for (const auto& line : lines) {
+    for (const auto& line : lookup->lines) {
         JsonObject obj = linesArray.add<JsonObject>();
         obj["line"] = line.line;
         obj["dir"] = line.direction;
@@ -377,6 +526,39 @@ void WebConfigModule::handleLineSearch(AsyncWebServerRequest *request) {
     request->send(200, "application/json", response);
 }
 
+bool WebConfigModule::sendPendingLookup(AsyncWebServerRequest *request, uint32_t job, const LookupResultPtr& lookup) {
+    if (lookup) return false;
+    
+    AsyncWebServerResponse *response;
+    if (job == 0) {
+        response = request->beginResponse(503, "application/json", "{\"error\":\"Busy, try again\"}");
+    } else {
+        // 202: Job läuft, gleiche URL erneut abfragen (teilt sich denselben Job)
+        char body[48];
+        snprintf(body, sizeof(body), "{\"job\":%u,\"status\":\"pending\"}", job);
+        response = request->beginResponse(202, "application/json", body);
+    }
+    response->addHeader("Retry-After", "1");
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+    return true;
+}
+
+bool WebConfigModule::sendFailedLookup(AsyncWebServerRequest *request, const LookupResultPtr& lookup) {
+    switch (lookup->status) {
+        case LOOKUP_OK:
+            return false;
+        case LOOKUP_OFFLINE:
+            // Ohne Retry-After: erneutes Abfragen hilft erst nach dem Reconnect
+            request->send(503, "application/json", "{\"error\":\"No network connection\"}");
+            return true;
+        case LOOKUP_FAILED:
+            request->send(502, "application/json", "{\"error\":\"OJP request failed\"}");
+            return true;
+    }
+    return false;
+}
+
 void WebConfigModule::handleDepartures(AsyncWebServerRequest *request) {
     if (!transportModule) {
         request->send(500, "application/json", "{\"error\":\"TransportModule not available\"}");
@@ -385,41 +567,43 @@ void WebConfigModule::handleDepartures(AsyncWebServerRequest *request) {
     
     Logger::info("WEB", "Departures request");
     
-    // Hole die aktuellen Abfahrten vom TransportModule
-    std::vector<Departure> departures = transportModule->getDepartures();
-    
-    JsonDocument doc;
-    JsonArray depsArray = doc["departures"].to<JsonArray>();
-    
-    // Aktuelle Zeit für Berechnung
-    time_t now;
-    time(&now);
-    
-    for (const auto& dep : departures) {
-        JsonObject obj = depsArray.add<JsonObject>();
-        obj["line"] = dep.line;
-        obj["direction"] = dep.direction;
-        obj["type"] = dep.type;
-        
-        // Berechne Minuten bis Abfahrt
-        time_t depTime = dep.getEffectiveTime();
-        double diffSeconds = difftime(depTime, now);
-        int diffMin = (int)(diffSeconds / 60);
-        
-        if (diffMin < 0) diffMin = 0;
-        obj["minutes"] = diffMin;
-        
-        // Timestamp für Debugging
-        obj["timestamp"] = (long)depTime;
+    // Optional ?stop=<index> für zusätzliche Haltestellen (Standard: Hauptstation)
+    size_t stop = 0;
+    if (request->hasParam("stop")) {
+        long index = request->getParam("stop")->value().toInt();
+        if (index < 0 || (size_t)index >= TransportModule::MAX_STOPS) {
+            request->send(400, "application/json", "{\"error\":\"Invalid stop index\"}");
+            return;
+        }
+        stop = (size_t)index;
     }
     
-    // Füge Metadaten hinzu
-    doc["count"] = departures.size();
-    doc["timestamp"] = (long)now;
-    
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    // Aktueller Stand vom TransportModule (geteilt, keine Kopie der Liste)
+    DepartureSnapshotPtr snapshot = transportModule->getSnapshot();
+    String etag = departureJson.etag(stop, snapshot->generation);
+
+    // Client hat diesen Stand schon: 304 ohne Body und ohne JSON-Arbeit
+    if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == etag) {
+        AsyncWebServerResponse* response = request->beginResponse(304);
+        response->addHeader("ETag", etag);
+        response->addHeader("Cache-Control", "no-cache");
+        request->send(response);
+        return;
+    }
+
+    // Body wird nicht kopiert: die Response hält eine Referenz auf den gecachten String,
+    // der so auch einen Neuaufbau des Caches während des Sendens überlebt
+    std::shared_ptr<const String> body = departureJson.get(stop, *snapshot).body;
+    AsyncWebServerResponse* response = request->beginResponse("application/json", body->length(),
+        [body](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            size_t len = body->length() - index;
+            if (len > maxLen) len = maxLen;
+            memcpy(buffer, body->c_str() + index, len);
+            return len;
+        });
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
 }
 
 bool WebConfigModule::checkAuth(AsyncWebServerRequest *request) {
@@ -10,6 +10,9 @@
 #include "../Wifi/WifiManager.h"
 #include "../Transport/TransportModule.h"
 #include "../DeviceIdentity/DeviceIdentity.h"
+#include "DepartureJson.h"
+#include "WebEventStream.h"
+#include "StaticAssets.h"
 
 class WebConfigModule {
 public:
@@ -23,6 +26,10 @@ private:
     WifiManager* wifiManager;
     TransportModule* transportModule;
     DeviceIdentity* deviceIdentity;
+
+    DepartureJson departureJson;    // Gemeinsam für /api/departures und /api/events
+    WebEventStream eventStream;
+    StaticAssets staticAssets;      // Web-Oberfläche (gzip, ETag)
     
     void setupRoutes();
     void handleScan(AsyncWebServerRequest *request);
@@ -31,6 +38,8 @@ private:
     void handleConfigSave(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
     void handleStopSearch(AsyncWebServerRequest *request);
     void handleLineSearch(AsyncWebServerRequest *request);
+    bool sendPendingLookup(AsyncWebServerRequest *request, uint32_t job, const LookupResultPtr& lookup);
+    bool sendFailedLookup(AsyncWebServerRequest *request, const LookupResultPtr& lookup);
     void handleDepartures(AsyncWebServerRequest *request);
     void handleDeviceInfo(AsyncWebServerRequest *request);
     bool checkAuth(AsyncWebServerRequest *request);
@@ -0,0 +1,210 @@
+#include "WebEventStream.h"
+#include <WiFi.h>
+#include <time.h>
+#include "../Core/EventBus.h"
+#include "../Logger/Logger.h"
+
+namespace {
+
+// Zeiten vor 2020 bedeuten: Uhr noch nicht per NTP synchronisiert
+const time_t MIN_VALID_TIME = 1577836800;
+const size_t QUEUE_LENGTH = 8;
+
+// Zusätzliche Haltestellen nur senden, wenn sie Daten haben oder gerade geleert wurden
+bool includeStop(const DepartureSnapshot& snapshot, size_t stop) {
+    return stop == 0 || !snapshot.stop(stop).empty() || !snapshot.changes[stop].empty();
+}
+
+} // namespace
+
+WebEventStream::WebEventStream()
+    : _source("/api/events"),
+      _departures(NULL),
+      _transport(NULL),
+      _wifi(NULL),
+      _clientCount(0),
+      _mutex(NULL),
+      _queue(NULL),
+      _taskHandle(NULL)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void WebEventStream::begin(AsyncWebServer& server, DepartureJson* departures, TransportModule* transport, WifiManager* wifi) {
+    _departures = departures;
+    _transport = transport;
+    _wifi = wifi;
+
+    _mutex = xSemaphoreCreateMutex();
+    _queue = xQueueCreate(QUEUE_LENGTH, sizeof(SystemEvent));
+    if (!_mutex || !_queue) {
+        Logger::error("WEB", "Event stream: out of memory");
+        return;
+    }
+
+    // Weitere Browser bekommen 404 und bleiben beim Polling
+    _source.setFilter([this](AsyncWebServerRequest* request) {
+        return _source.count() < MAX_CLIENTS;
+    });
+    _source.onConnect([this](AsyncEventSourceClient* client) {
+        addClient(client);
+    });
+    _source.onDisconnect([this](AsyncEventSourceClient* client) {
+        removeClient(client);
+    });
+    server.addHandler(&_source);
+
+    // Verlustbehaftet: der Task liest den Zustand ohnehin selbst nach
+    EventBus::subscribe(_queue, true);
+
+    xTaskCreate(
+        taskCode,
+        "WebEventTask",
+        4096,
+        this,
+        1,
+        &_taskHandle
+    );
+}
+
+WebEventStats WebEventStream::getStats() {
+    WebEventStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (!_mutex) return stats;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    stats = _stats;
+    stats.clients = _clientCount;
+    xSemaphoreGive(_mutex);
+    return stats;
+}
+
+void WebEventStream::taskCode(void* pvParameters) {
+    WebEventStream* stream = (WebEventStream*)pvParameters;
+    bool deferred = false;
+
+    for (;;) {
+        SystemEvent event;
+        TickType_t wait = pdMS_TO_TICKS(deferred ? RETRY_MS : KEEPALIVE_MS);
+        if (xQueueReceive(stream->_queue, &event, wait) == pdTRUE) {
+            // Coalescing: alles, was inzwischen aufgelaufen ist, ergibt einen Durchlauf
+            while (xQueueReceive(stream->_queue, &event, 0) == pdTRUE) {}
+        }
+        deferred = stream->flush();
+    }
+}
+
+void WebEventStream::addClient(AsyncEventSourceClient* client) {
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (_clientCount < MAX_CLIENTS) {
+        ClientState& state = _clients[_clientCount++];
+        state.client = client;
+        state.generation = 0;
+        state.wifiState = -1;
+        state.timeSynced = false;
+        state.timeSent = false;
+        state.lastSent = millis();
+    }
+    size_t count = _clientCount;
+    xSemaphoreGive(_mutex);
+
+    Logger::printf("WEB", "Event stream client connected (%d)", (int)count);
+    wake();
+}
+
+void WebEventStream::removeClient(AsyncEventSourceClient* client) {
+    // Wartet ggf. auf einen laufenden flush(), danach gibt die Library den Client frei
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    for (size_t i = 0; i < _clientCount; i++) {
+        if (_clients[i].client == client) {
+            _clients[i] = _clients[--_clientCount];
+            break;
+        }
+    }
+    xSemaphoreGive(_mutex);
+}
+
+void WebEventStream::wake() {
+    SystemEvent event = EVENT_UPDATE_TRIGGER;
+    xQueueSend(_queue, &event, 0);
+}
+
+bool WebEventStream::flush() {
+    if (_clientCount == 0) return false;
+
+    DepartureSnapshotPtr snapshot = _transport->getSnapshot();
+    int8_t wifiState = _wifi ? (int8_t)_wifi->getState() : -1;
+    time_t now = time(NULL);
+    bool synced = now >= MIN_VALID_TIME;
+
+    // Nachrichten einmal pro Durchlauf erzeugen, für alle Clients gleich.
+    // Die Abfahrten kommen aus dem Cache von /api/departures (einmal pro Generation).
+    DepartureJson::Entry stops[DepartureSnapshot::MAX_STOPS];
+    for (size_t i = 0; i < DepartureSnapshot::MAX_STOPS; i++) {
+        if (includeStop(*snapshot, i)) stops[i] = _departures->get(i, *snapshot);
+    }
+
+    char wifiMessage[48];
+    snprintf(wifiMessage, sizeof(wifiMessage), "{\"state\":%d,\"rssi\":%d}",
+             wifiState, wifiState == WIFI_CONNECTED ? (int)WiFi.RSSI() : 0);
+    char timeMessage[48];
+    snprintf(timeMessage, sizeof(timeMessage), "{\"synced\":%s,\"time\":%ld}",
+             synced ? "true" : "false", (long)now);
+    char pingMessage[32];
+    snprintf(pingMessage, sizeof(pingMessage), "{\"generation\":%lu}", (unsigned long)snapshot->generation);
+
+    bool deferred = false;
+    unsigned long nowMs = millis();
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    for (size_t c = 0; c < _clientCount; c++) {
+        ClientState& state = _clients[c];
+        bool behind = state.generation != snapshot->generation ||
+                      state.wifiState != wifiState ||
+                      !state.timeSent || state.timeSynced != synced;
+
+        if (!behind) {
+            if (nowMs - state.lastSent >= KEEPALIVE_MS) send(state, pingMessage, "ping", 0);
+            continue;
+        }
+
+        // Client holt nicht ab: nichts nachschieben, später den dann neuesten Stand
+        if (state.client->packetsWaiting() >= MAX_PENDING) {
+            _stats.deferred++;
+            deferred = true;
+            continue;
+        }
+
+        if (state.wifiState != wifiState) {
+            send(state, wifiMessage, "wifi", 0);
+            state.wifiState = wifiState;
+        }
+        if (!state.timeSent || state.timeSynced != synced) {
+            send(state, timeMessage, "time", 0);
+            state.timeSent = true;
+            state.timeSynced = synced;
+        }
+        if (state.generation != snapshot->generation) {
+            for (size_t i = 0; i < DepartureSnapshot::MAX_STOPS; i++) {
+                if (stops[i].body) send(state, stops[i].body->c_str(), "departures", snapshot->generation);
+            }
+            // Latenz nur für echte Pushes messen, nicht für den Anfangsstand neuer Clients
+            if (state.generation != 0 && snapshot->publishedMs != 0) {
+                _stats.lastLatencyMs = millis() - snapshot->publishedMs;
+                _stats.avgLatencyMs = (_stats.avgLatencyMs == 0)
+                    ? _stats.lastLatencyMs
+                    : (_stats.avgLatencyMs * 7 + _stats.lastLatencyMs) / 8;
+            }
+            state.generation = snapshot->generation;
+        }
+    }
+    xSemaphoreGive(_mutex);
+
+    return deferred;
+}
+
+void WebEventStream::send(ClientState& state, const char* message, const char* event, uint32_t id) {
+    state.client->send(message, event, id);
+    state.lastSent = millis();
+    _stats.pushed++;
+}
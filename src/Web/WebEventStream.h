@@ -0,0 +1,78 @@
+#ifndef WEB_EVENT_STREAM_H
+#define WEB_EVENT_STREAM_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "DepartureJson.h"
+#include "../Transport/TransportModule.h"
+#include "../Wifi/WifiManager.h"
+
+struct WebEventStats {
+    uint32_t clients;           // Verbundene Browser
+    uint32_t pushed;            // Gesendete Nachrichten
+    uint32_t deferred;          // Zurückgestellt, weil der Client noch nicht abgeholt hat
+    uint32_t lastLatencyMs;     // Veröffentlichung im TransportModule bis Übergabe an AsyncTCP
+    uint32_t avgLatencyMs;      // Gleitender Mittelwert
+};
+
+/**
+ * Push-Kanal /api/events (Server-Sent Events) für die Web-Oberfläche.
+ *
+ * Ein eigener Task wird über den EventBus geweckt und schickt jedem Client
+ * den Stand, der ihm fehlt: Abfahrten (gleiches JSON wie /api/departures),
+ * WLAN-Zustand und Zeit-Sync. Gesendet wird immer der aktuelle Zustand,
+ * Zwischenstände fallen weg (Coalescing).
+ *
+ * Backpressure: Hat ein Client noch MAX_PENDING Nachrichten in seiner
+ * Sendequeue, bekommt er nichts Neues, sondern später den dann neuesten
+ * Stand. Ein langsamer Browser belegt so höchstens wenige Nachrichten Heap.
+ */
+class WebEventStream {
+public:
+    static const size_t MAX_CLIENTS = 4;
+    static const size_t MAX_PENDING = 2;
+    static const uint32_t RETRY_MS = 500;           // Zurückgestellte Clients erneut prüfen
+    static const uint32_t KEEPALIVE_MS = 15000;     // "ping" an ruhige Clients
+
+    WebEventStream();
+
+    // Registriert /api/events (vor serveStatic aufrufen) und startet den Task
+    void begin(AsyncWebServer& server, DepartureJson* departures, TransportModule* transport, WifiManager* wifi);
+
+    WebEventStats getStats();
+
+private:
+    struct ClientState {
+        AsyncEventSourceClient* client;
+        uint32_t generation;        // Zuletzt gesendete Abfahrten (0 = noch keine)
+        int8_t wifiState;           // Zuletzt gesendeter WifiState, -1 = noch keiner
+        bool timeSynced;
+        bool timeSent;
+        unsigned long lastSent;
+    };
+
+    AsyncEventSource _source;
+    DepartureJson* _departures;
+    TransportModule* _transport;
+    WifiManager* _wifi;
+
+    ClientState _clients[MAX_CLIENTS];
+    size_t _clientCount;
+    SemaphoreHandle_t _mutex;      // Schützt _clients und _stats (AsyncTCP Task vs. eigener Task)
+    QueueHandle_t _queue;          // Weckt den Task, Inhalt egal
+    TaskHandle_t _taskHandle;
+
+    WebEventStats _stats;
+
+    static void taskCode(void* pvParameters);
+
+    void addClient(AsyncEventSourceClient* client);
+    void removeClient(AsyncEventSourceClient* client);
+    void wake();
+
+    // Schickt allen Clients den fehlenden Stand. true wenn Clients zurückgestellt wurden.
+    bool flush();
+    void send(ClientState& state, const char* message, const char* event, uint32_t id);
+};
+
+#endif // WEB_EVENT_STREAM_H
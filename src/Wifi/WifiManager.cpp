@@ -1,17 +1,24 @@
 #include "WifiManager.h"
 #include "../Logger/Logger.h"
+#include "../Core/EventBus.h"
 
 WifiManager::WifiManager() 
-    : currentState(WIFI_DISCONNECTED), lastCheckTime(0), connectionStartTime(0), internetTested(false), configStore(NULL), taskHandle(NULL), eventQueue(NULL) {}
+    : currentState(WIFI_DISCONNECTED), lastCheckTime(0), connectionStartTime(0), internetTested(false),
+      credentialsChanged(false), credentialsChangedAt(0), configStore(NULL), taskHandle(NULL) {}
 
-void WifiManager::begin(ConfigStore* config, QueueHandle_t queue) {
+void WifiManager::begin(ConfigStore* config) {
     this->configStore = config;
-    this->eventQueue = queue;
 
     // TCP/IP-Stack (lwIP) synchron initialisieren, damit AsyncWebServer::begin()
     // danach sicher aufgerufen werden kann – noch bevor der WiFi-Task läuft.
     WiFi.mode(WIFI_STA);
 
+    // Nur SSID/Passwort betreffen das WLAN; andere Einstellungen lassen die Verbindung stehen
+    config->subscribe(CONFIG_CHANGE_WIFI, [this](const ConfigSnapshot&, uint32_t) {
+        credentialsChangedAt = millis();
+        credentialsChanged = true;
+    });
+
     xTaskCreatePinnedToCore(
         taskCode,
         "WifiTask",
@@ -46,22 +53,13 @@ void WifiManager::taskCode(void* pvParameters) {
         if (currentState != lastState) {
              if (currentState == WIFI_CONNECTED) {
                  Logger::info("TASK_WIFI", "Wifi connected -> Sending event");
-                 if (instance->eventQueue != NULL) {
-                     SystemEvent event = EVENT_WIFI_CONNECTED;
-                     xQueueSend(instance->eventQueue, &event, portMAX_DELAY);
-                 }
+                 EventBus::publish(EVENT_WIFI_CONNECTED, portMAX_DELAY);
              } else if (currentState == WIFI_AP_MODE) {
                  Logger::info("TASK_WIFI", "AP Mode started -> Sending event");
-                 if (instance->eventQueue != NULL) {
-                     SystemEvent event = EVENT_WIFI_AP_MODE;
-                     xQueueSend(instance->eventQueue, &event, portMAX_DELAY);
-                 }
+                 EventBus::publish(EVENT_WIFI_AP_MODE, portMAX_DELAY);
              } else if (lastState == WIFI_CONNECTED && currentState == WIFI_DISCONNECTED) {
                  Logger::info("TASK_WIFI", "Wifi lost -> Sending event");
-                 if (instance->eventQueue != NULL) {
-                     SystemEvent event = EVENT_WIFI_LOST;
-                     xQueueSend(instance->eventQueue, &event, portMAX_DELAY);
-                 }
+                 EventBus::publish(EVENT_WIFI_LOST, portMAX_DELAY);
              }
              lastState = currentState;
         }
@@ -102,7 +100,32 @@ void WifiManager::startAP() {
     Logger::printf("WIFI", "AP IP: %s", IP.toString().c_str());
 }
 
+void WifiManager::applyCredentials() {
+    credentialsChanged = false;
+    Logger::info("WIFI", "Credentials changed -> Reconnecting");
+    
+    // Der Task sieht nur CONNECTED -> CONNECTING/AP_MODE und meldet den Abbruch
+    // sonst nicht: Display, Transport und SSE-Clients wie beim normalen Verlust informieren
+    if (currentState == WIFI_CONNECTED) {
+        Logger::info("TASK_WIFI", "Wifi lost -> Sending event");
+        EventBus::publish(EVENT_WIFI_LOST, portMAX_DELAY);
+    }
+    
+    if (currentState != WIFI_AP_MODE) WiFi.disconnect();
+    if (configStore->hasWifiConfig()) {
+        connect();
+    } else {
+        startAP();
+    }
+    lastCheckTime = millis();
+}
+
 void WifiManager::update() {
+    if (credentialsChanged && millis() - credentialsChangedAt > CREDENTIALS_GRACE) {
+        applyCredentials();
+        return;
+    }
+    
     switch (currentState) {
         case WIFI_DISCONNECTED:
             // Auto-reconnect nur wenn Config da ist
@@ -139,9 +162,8 @@ void WifiManager::update() {
             break;
             
         case WIFI_AP_MODE:
-            // Im AP Mode prüfen wir, ob wir vielleicht neue Config haben (z.B. durch User Eingabe via Web)
-            // Das WebConfigModule könnte einen Reconnect triggern, indem es den State resetet oder restart called.
-            // Vorerst bleiben wir im AP Mode.
+            // Neue Zugangsdaten aus dem Setup kommen über applyCredentials(),
+            // bis dahin bleiben wir im AP Mode
             break;
     }
 }
@@ -154,10 +176,7 @@ void WifiManager::checkInternet() {
         int httpCode = http.GET();
         if (httpCode > 0) {
             Logger::printf("WIFI", "Internet Check: OK (Code %d)", httpCode);
-            if (eventQueue) {
-                SystemEvent event = EVENT_INTERNET_OK;
-                xQueueSend(eventQueue, &event, portMAX_DELAY);
-            }
+            EventBus::publish(EVENT_INTERNET_OK, portMAX_DELAY);
         } else {
              Logger::printf("WIFI", "Internet Check: Failed (Error: %s)", http.errorToString(httpCode).c_str());
         }
@@ -18,8 +18,9 @@ class WifiManager {
 public:
     WifiManager();
     
-    // Startet den Wifi-Task
-    void begin(ConfigStore* configStore, QueueHandle_t eventQueue);
+    // Startet den Wifi-Task, Zustandswechsel gehen über den EventBus.
+    // Neue Zugangsdaten im ConfigStore lösen einen Reconnect aus (kein Neustart).
+    void begin(ConfigStore* configStore);
     
     WifiState getState();
     String getIpAddress();
@@ -32,18 +33,23 @@ private:
     void connect();
     void startAP();
     void checkInternet();
+    void applyCredentials();
 
     WifiState currentState;
     unsigned long lastCheckTime;
     unsigned long connectionStartTime;
     bool internetTested;
     
+    // Vom ConfigStore-Listener gesetzt, im WifiTask abgearbeitet
+    volatile bool credentialsChanged;
+    volatile unsigned long credentialsChangedAt;
+    
     ConfigStore* configStore;
     TaskHandle_t taskHandle;
-    QueueHandle_t eventQueue;
     
     const unsigned long CONNECTION_TIMEOUT = 15000; 
     const unsigned long RECONNECT_INTERVAL = 30000; 
+    const unsigned long CREDENTIALS_GRACE = 1000;   // Web-Antwort noch über die alte Verbindung senden
     const char* AP_SSID = "CrowPanel-Setup";
 };
 
@@ -13,11 +13,12 @@
 #include "Web/WebConfigModule.h"
 #include "Time/TimeModule.h"
 #include "Core/SystemEvents.h"
+#include "Core/EventBus.h"
 #include "DeviceIdentity/DeviceIdentity.h"
 
 // Display Treiber Instanz (GYE042A87 für CrowPanel 4.2")
-GxEPD2_BW<GxEPD2_420_GYE042A87, GxEPD2_420_GYE042A87::HEIGHT>
-  display(GxEPD2_420_GYE042A87(EPD_CS_PIN, EPD_DC_PIN, EPD_RST_PIN, EPD_BUSY_PIN));
+// Seitenpuffer = DISPLAY_PAGE_HEIGHT Zeilen, siehe display_manager.h
+DisplayPanel display(GxEPD2_420_GYE042A87(EPD_CS_PIN, EPD_DC_PIN, EPD_RST_PIN, EPD_BUSY_PIN));
 
 // Module
 DeviceIdentity deviceIdentity;
@@ -33,9 +34,18 @@ TimeModule timeModule;
 // Globale Event Queue
 QueueHandle_t displayEventQueue;
 
+// Stationsname für den Header: nur Name ohne Ortsangabe
+String displayStationName() {
+    StationConfig station = configStore.getStation();
+    if (station.name.length() == 0) return "Nicht konfiguriert";
+    return StringUtils::getStationNameOnly(station.name);
+}
+
 void setup() {
     Logger::init(115200);
-    delay(2000); // Warten auf Serial Monitor
+#ifdef DEV_BUILD
+    delay(2000); // Warten auf Serial Monitor (verzögert das erste Bild, daher nur im Dev-Build)
+#endif
 
     Logger::info("SETUP", "\n\n====================================");
     Logger::info("SETUP", "   CrowPanel Swiss Transport Display");
@@ -61,6 +71,7 @@ void setup() {
         Logger::error("SETUP", "Failed to create event queue!");
         return; // Fatal Error
     }
+    EventBus::subscribe(displayEventQueue);
     Logger::info("SETUP", "Event queue created");
 
     // 2. Module starten
@@ -69,29 +80,37 @@ void setup() {
     // Input (Buttons)
     inputManager.begin(displayEventQueue, &configStore, &transportModule);
 
+    // Time Module (NTP), setzt die Zeitzone für Abfahrten aus dem Offline-Cache
+    timeModule.begin();
+
+    // Transport vor dem Display: ein vorhandener Offline-Cache liefert das erste Bild.
+    // NumberOfResults richtet sich nach den Zeilen, die das Dashboard zeichnet
+    transportModule.setRowCapacity(DisplayManager::VISIBLE_ROWS);
+    transportModule.begin(&configStore);
+
+    // Data Provider verknüpfen (vor dem Start des Display-Tasks)
+    displayManager.setDataProvider([]() -> DepartureSnapshotPtr {
+        return transportModule.getSnapshot();
+    });
+    displayManager.setRefetchRequest([]() {
+        transportModule.triggerUpdate();
+    });
+
+    // Initialen Stationsnamen setzen, neue Hauptstation ohne Neustart übernehmen.
+    // Der Listener des TransportModule läuft vorher (früher registriert) und hat die
+    // Liste der alten Station dann schon geleert.
+    displayManager.setStationName(displayStationName());
+    displayManager.setStationNameProvider(displayStationName);
+    configStore.subscribe(CONFIG_CHANGE_STATION, [](const ConfigSnapshot&, uint32_t) {
+        SystemEvent event = EVENT_CONFIG_CHANGED;
+        xQueueSend(displayEventQueue, &event, 0);
+    });
+
     // Display
     displayManager.begin(displayEventQueue);
-    
-    // Data Provider verknüpfen
-    displayManager.setDataProvider([]() -> std::vector<Departure> {
-        return transportModule.getDepartures();
-    });
-    
-    // Initialen Stationsnamen setzen
-    StationConfig station = configStore.getStation();
-    if (station.name.length() > 0) {
-        // Nur Stationsname ohne Ortsangabe
-        String shortName = StringUtils::getStationNameOnly(station.name);
-        displayManager.setStationName(shortName);
-    } else {
-        displayManager.setStationName("Nicht konfiguriert");
-    }
 
     // Wifi
-    wifiManager.begin(&configStore, displayEventQueue);
-
-    // Time Module (NTP)
-    timeModule.begin(displayEventQueue);
+    wifiManager.begin(&configStore);
 
     // Web Config
     webConfigModule.begin(&configStore, &wifiManager, &transportModule, &deviceIdentity);
@@ -99,10 +118,6 @@ void setup() {
     // System Monitor
     systemMonitor.begin();
 
-    // Transport Module (Test)
-    transportModule.begin(displayEventQueue, &configStore);
-
-
     Logger::info("SETUP", "All modules started!");
     Logger::info("SETUP", "====================================\n");
 }
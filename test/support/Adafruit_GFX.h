@@ -0,0 +1,83 @@
+// Host-Ersatz für Adafruit_GFX.h - nur für die nativen Tests
+// Text wird nicht mit echten Glyphen gezeichnet: jedes Zeichen wird als
+// Bitmuster seines Codes gesetzt. Das genügt, damit unterschiedlicher Text
+// unterschiedliche Pixel (und damit Framebuffer-Hashes) ergibt.
+
+#pragma once
+
+#include <Arduino.h>
+
+struct GFXfont {
+    uint8_t yAdvance;
+};
+
+class Adafruit_GFX {
+public:
+    static const int16_t CHAR_WIDTH = 9;
+    static const int16_t CHAR_HEIGHT = 13;
+
+    Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _cursorX(0), _cursorY(0), _textColor(0), _rotation(0) {}
+    virtual ~Adafruit_GFX() {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+    virtual void fillScreen(uint16_t color) { fillRect(0, 0, WIDTH, HEIGHT, color); }
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        for (int16_t j = y; j < y + h; j++) {
+            for (int16_t i = x; i < x + w; i++) drawPixel(i, j, color);
+        }
+    }
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        drawLine(x, y, x + w - 1, y, color);
+        drawLine(x, y + h - 1, x + w - 1, y + h - 1, color);
+        drawLine(x, y, x, y + h - 1, color);
+        drawLine(x + w - 1, y, x + w - 1, y + h - 1, color);
+    }
+    // Nur waagrechte und senkrechte Linien (mehr zeichnet die UI nicht)
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+        if (y0 == y1) {
+            for (int16_t x = std::min(x0, x1); x <= std::max(x0, x1); x++) drawPixel(x, y0, color);
+        } else {
+            for (int16_t y = std::min(y0, y1); y <= std::max(y0, y1); y++) drawPixel(x0, y, color);
+        }
+    }
+
+    void setFont(const GFXfont*) {}
+    void setTextColor(uint16_t color) { _textColor = color; }
+    void setCursor(int16_t x, int16_t y) { _cursorX = x; _cursorY = y; }
+    void setRotation(uint8_t rotation) { _rotation = rotation; }
+
+    void getTextBounds(const char* text, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h) {
+        *x1 = x;
+        *y1 = y - CHAR_HEIGHT;
+        *w = (uint16_t)(strlen(text) * CHAR_WIDTH);
+        *h = CHAR_HEIGHT;
+    }
+    void getTextBounds(const String& text, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h) {
+        getTextBounds(text.c_str(), x, y, x1, y1, w, h);
+    }
+
+    size_t print(const char* text) {
+        for (const char* p = text; *p; p++, _cursorX += CHAR_WIDTH) {
+            for (int16_t bit = 0; bit < 8; bit++) {
+                if ((*p >> bit) & 1) fillRect(_cursorX + bit, _cursorY - 6, 1, 4, _textColor);
+            }
+        }
+        return strlen(text);
+    }
+    size_t print(const String& text) { return print(text.c_str()); }
+    size_t println(const char* text) { size_t n = print(text); println(); return n; }
+    size_t println(const String& text) { return println(text.c_str()); }
+    size_t println() { _cursorY += CHAR_HEIGHT + 7; return 1; }
+
+    int16_t width() const { return WIDTH; }
+    int16_t height() const { return HEIGHT; }
+
+protected:
+    int16_t WIDTH;
+    int16_t HEIGHT;
+    int16_t _cursorX;
+    int16_t _cursorY;
+    uint16_t _textColor;
+    uint8_t _rotation;
+};
@@ -0,0 +1,267 @@
+// Host-Ersatz für Arduino.h - nur für die nativen Tests (pio test -e native)
+// Bildet den Teil von Arduino-Core und FreeRTOS nach, den die getesteten
+// Module benutzen. Tasks laufen nicht, Mutexe sind No-ops, Queues liegen im RAM.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <time.h>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// ===== Arduino String =====
+
+class String {
+public:
+    String() {}
+    String(const char* text) : _s(text ? text : "") {}
+    String(const std::string& text) : _s(text) {}
+    String(char c) : _s(1, c) {}
+    String(int value) : _s(std::to_string(value)) {}
+    String(unsigned int value) : _s(std::to_string(value)) {}
+    String(long value) : _s(std::to_string(value)) {}
+    String(unsigned long value) : _s(std::to_string(value)) {}
+
+    unsigned int length() const { return (unsigned int)_s.size(); }
+    bool isEmpty() const { return _s.empty(); }
+    const char* c_str() const { return _s.c_str(); }
+    bool reserve(unsigned int size) { _s.reserve(size); return true; }
+
+    bool concat(const char* text, unsigned int len) { _s.append(text, len); return true; }
+    bool concat(const char* text) { if (text) _s += text; return true; }
+    bool concat(const String& text) { _s += text._s; return true; }
+    bool concat(char c) { _s += c; return true; }
+    String& operator+=(const String& text) { _s += text._s; return *this; }
+    String& operator+=(const char* text) { if (text) _s += text; return *this; }
+    String& operator+=(char c) { _s += c; return *this; }
+
+    friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+    friend String operator+(const String& a, const char* b) { return String(a._s + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String((a ? a : "") + b._s); }
+
+    bool operator==(const String& other) const { return _s == other._s; }
+    bool operator==(const char* other) const { return _s == (other ? other : ""); }
+    bool operator!=(const String& other) const { return _s != other._s; }
+    bool operator!=(const char* other) const { return !(*this == other); }
+    bool operator<(const String& other) const { return _s < other._s; }
+    char operator[](unsigned int index) const { return index < _s.size() ? _s[index] : '\0'; }
+
+    int indexOf(char c, unsigned int from = 0) const { return find(_s.find(c, from)); }
+    int indexOf(const String& text, unsigned int from = 0) const { return find(_s.find(text._s, from)); }
+    int lastIndexOf(char c) const { return find(_s.rfind(c)); }
+    int lastIndexOf(const String& text) const { return find(_s.rfind(text._s)); }
+    bool startsWith(const String& prefix) const { return _s.compare(0, prefix._s.size(), prefix._s) == 0; }
+    bool endsWith(const String& suffix) const {
+        return _s.size() >= suffix._s.size() && _s.compare(_s.size() - suffix._s.size(), suffix._s.size(), suffix._s) == 0;
+    }
+    String substring(unsigned int from) const { return from >= _s.size() ? String() : String(_s.substr(from)); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from >= _s.size() || to <= from) return String();
+        return String(_s.substr(from, to - from));
+    }
+    void trim() {
+        size_t begin = _s.find_first_not_of(" \t\r\n");
+        size_t end = _s.find_last_not_of(" \t\r\n");
+        _s = (begin == std::string::npos) ? std::string() : _s.substr(begin, end - begin + 1);
+    }
+    void toLowerCase() { for (size_t i = 0; i < _s.size(); i++) _s[i] = (char)tolower((unsigned char)_s[i]); }
+    void toUpperCase() { for (size_t i = 0; i < _s.size(); i++) _s[i] = (char)toupper((unsigned char)_s[i]); }
+    long toInt() const { return atol(_s.c_str()); }
+
+private:
+    std::string _s;
+
+    static int find(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+};
+
+// ===== Print / Stream / Serial =====
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        for (size_t i = 0; i < size; i++) write(buffer[i]);
+        return size;
+    }
+    virtual void flush() {}
+
+    size_t printf(const char* format, ...) {
+        char buffer[256];
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        if (len < 0) return 0;
+        size_t n = (size_t)len < sizeof(buffer) ? (size_t)len : sizeof(buffer) - 1;
+        return write((const uint8_t*)buffer, n);
+    }
+    size_t print(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+    size_t print(const String& text) { return print(text.c_str()); }
+    size_t println(const char* text) { return print(text) + println(); }
+    size_t println(const String& text) { return println(text.c_str()); }
+    size_t println() { return write('\n'); }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+// Ausgaben der Module landen auf stdout (sichtbar mit pio test -v)
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+    size_t write(const uint8_t* buffer, size_t size) override { return fwrite(buffer, 1, size, stdout); }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+};
+
+static HardwareSerial Serial;
+
+// ===== IPAddress =====
+
+class IPAddress {
+public:
+    IPAddress() : _value(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : _value(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+
+    operator uint32_t() const { return _value; }
+    bool operator==(const IPAddress& other) const { return _value == other._value; }
+    bool operator!=(const IPAddress& other) const { return _value != other._value; }
+
+private:
+    uint32_t _value;
+};
+
+// ===== Zeit, GPIO, Speicher =====
+
+// Tests können die Uhr vorstellen, statt zu warten (z.B. für TTLs)
+inline unsigned long& hostMillisOffset() {
+    static unsigned long offset = 0;
+    return offset;
+}
+
+inline void hostAdvanceMillis(unsigned long ms) { hostMillisOffset() += ms; }
+
+inline unsigned long millis() {
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return (unsigned long)duration_cast<milliseconds>(steady_clock::now() - start).count() + hostMillisOffset();
+}
+
+inline unsigned long micros() {
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return (unsigned long)duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+inline void delay(unsigned long) {}
+
+inline bool getLocalTime(struct tm* info, uint32_t = 5000) {
+    time_t now = time(NULL);
+    localtime_r(&now, info);
+    return now >= 1577836800;
+}
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return HIGH; }
+
+inline bool psramFound() { return false; }
+inline void* ps_malloc(size_t size) { return malloc(size); }
+
+// ===== FreeRTOS =====
+
+typedef void* TaskHandle_t;
+typedef void* QueueHandle_t;
+typedef void* SemaphoreHandle_t;
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef int portMUX_TYPE;
+
+#define pdTRUE ((BaseType_t)1)
+#define pdFALSE ((BaseType_t)0)
+#define pdPASS (pdTRUE)
+#define pdFAIL (pdFALSE)
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+
+// Tasks werden nicht gestartet: die Tests rufen die Logik direkt auf
+inline BaseType_t xTaskCreatePinnedToCore(void (*)(void*), const char*, uint32_t, void*, UBaseType_t, TaskHandle_t* handle, BaseType_t) {
+    if (handle) *handle = NULL;
+    return pdPASS;
+}
+inline BaseType_t xTaskCreate(void (*)(void*), const char*, uint32_t, void*, UBaseType_t, TaskHandle_t* handle) {
+    if (handle) *handle = NULL;
+    return pdPASS;
+}
+inline void vTaskDelete(TaskHandle_t) {}
+inline void vTaskDelay(TickType_t) {}
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
+inline void xTaskNotifyGive(TaskHandle_t) {}
+inline UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) { return 0; }
+
+// Queue mit fester Kapazität im RAM; Senden auf eine volle Queue schlägt sofort fehl
+struct HostQueue {
+    size_t itemSize;
+    size_t capacity;
+    std::deque<std::vector<uint8_t> > items;
+};
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    HostQueue* queue = new HostQueue();
+    queue->itemSize = itemSize;
+    queue->capacity = length;
+    return queue;
+}
+inline BaseType_t xQueueSend(QueueHandle_t handle, const void* item, TickType_t) {
+    HostQueue* queue = (HostQueue*)handle;
+    if (!queue || queue->items.size() >= queue->capacity) return pdFALSE;
+    const uint8_t* bytes = (const uint8_t*)item;
+    queue->items.push_back(std::vector<uint8_t>(bytes, bytes + queue->itemSize));
+    return pdTRUE;
+}
+inline BaseType_t xQueueReceive(QueueHandle_t handle, void* item, TickType_t) {
+    HostQueue* queue = (HostQueue*)handle;
+    if (!queue || queue->items.empty()) return pdFALSE;
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    return pdTRUE;
+}
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t handle) {
+    HostQueue* queue = (HostQueue*)handle;
+    return queue ? (UBaseType_t)queue->items.size() : 0;
+}
+
+// Single-threaded: Mutexe müssen nur einen gültigen Handle liefern
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { static int token; return &token; }
+inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { static int token; return &token; }
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
+inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t) { return pdTRUE; }
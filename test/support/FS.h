@@ -0,0 +1,73 @@
+// Host-Ersatz für FS.h - nur für die nativen Tests
+// Dateien liegen in einer Map im RAM; geschrieben wird beim close().
+
+#pragma once
+
+#include <Arduino.h>
+#include <map>
+
+namespace fs {
+
+class File : public Stream {
+public:
+    File() : _open(false), _pos(0), _files(NULL) {}
+    File(std::map<std::string, std::string>* files, const std::string& path, bool write)
+        : _open(true), _pos(0), _files(files) {
+        if (write) _writePath = path;
+        else _data = (*files)[path];
+    }
+
+    operator bool() const { return _open; }
+
+    size_t write(uint8_t c) override { _data += (char)c; return 1; }
+    size_t write(const uint8_t* buffer, size_t size) override { _data.append((const char*)buffer, size); return size; }
+    int available() override { return (int)(_data.size() - _pos); }
+    int read() override { return _pos < _data.size() ? (uint8_t)_data[_pos++] : -1; }
+    int peek() override { return _pos < _data.size() ? (uint8_t)_data[_pos] : -1; }
+    size_t read(uint8_t* buffer, size_t size) {
+        size_t n = std::min(size, _data.size() - _pos);
+        memcpy(buffer, _data.data() + _pos, n);
+        _pos += n;
+        return n;
+    }
+    size_t size() const { return _data.size(); }
+
+    String readStringUntil(char terminator) {
+        size_t end = _data.find(terminator, _pos);
+        if (end == std::string::npos) end = _data.size();
+        String line(_data.substr(_pos, end - _pos));
+        _pos = std::min(end + 1, _data.size());
+        return line;
+    }
+
+    void close() {
+        if (_open && !_writePath.empty()) (*_files)[_writePath] = _data;
+        _open = false;
+    }
+
+private:
+    bool _open;
+    std::string _data;
+    size_t _pos;
+    std::string _writePath;
+    std::map<std::string, std::string>* _files;
+};
+
+class FS {
+public:
+    File open(const char* path, const char* mode = "r") {
+        if (mode[0] != 'w' && !exists(path)) return File();
+        return File(&files, path, mode[0] == 'w');
+    }
+    File open(const String& path, const char* mode = "r") { return open(path.c_str(), mode); }
+    bool exists(const char* path) const { return files.count(path) != 0; }
+    bool exists(const String& path) const { return exists(path.c_str()); }
+    bool remove(const char* path) { return files.erase(path) != 0; }
+
+    // Inhalt für die Tests direkt zugänglich
+    std::map<std::string, std::string> files;
+};
+
+} // namespace fs
+
+using fs::File;
@@ -0,0 +1,6 @@
+// Host-Ersatz - nur für die nativen Tests (Glyphen zeichnet Adafruit_GFX.h nicht)
+#pragma once
+
+#include <Adafruit_GFX.h>
+
+static const GFXfont FreeSans9pt7b = { 20 };
@@ -0,0 +1,104 @@
+// Aufzeichnender Host-Ersatz für GxEPD2_BW.h - nur für die nativen Tests
+// Zeichnet nichts, merkt sich aber jedes Fenster, jede Seite und die Bytes,
+// die GxEPD2 per SPI an den Controller schicken würde. Damit lassen sich die
+// Transfergrössen der Partial Refreshes (siehe Display/README.md) prüfen.
+
+#pragma once
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+#define GxEPD_BLACK 0x0000
+#define GxEPD_WHITE 0xFFFF
+
+class GxEPD2_420_GYE042A87 {
+public:
+    static const int16_t WIDTH = 400;
+    static const int16_t HEIGHT = 300;
+
+    GxEPD2_420_GYE042A87(int16_t, int16_t, int16_t, int16_t) {}
+};
+
+// Ein übertragenes Fenster (bei setFullWindow das ganze Panel)
+struct GxEPD2_Window {
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+    bool full;
+};
+
+template<class Panel, int16_t page_height>
+class GxEPD2_BW : public Adafruit_GFX {
+public:
+    static const int16_t PAGE_HEIGHT = page_height;
+
+    explicit GxEPD2_BW(Panel) : Adafruit_GFX(Panel::WIDTH, Panel::HEIGHT) { reset(); }
+
+    void init(uint32_t = 0, bool = true, uint16_t = 10, bool = false) {}
+    void hibernate() { hibernates++; }
+
+    void setFullWindow() { setWindow(0, 0, WIDTH, HEIGHT, true); }
+    void setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+        // Wie GxEPD2: x und w auf ganze Bytes erweitern
+        uint16_t x0 = x - x % 8;
+        uint16_t x1 = (uint16_t)((x + w + 7) / 8 * 8);
+        setWindow(x0, y, x1 - x0, h, false);
+    }
+
+    void firstPage() { _pageY = _window.y; }
+
+    // Überträgt die aktuelle Seite; true solange weitere Seiten folgen
+    bool nextPage() {
+        uint16_t end = (uint16_t)(_window.y + _window.h);
+        uint16_t rows = (uint16_t)std::min<int>(page_height, end - _pageY);
+        bytes += (uint32_t)_window.w * rows / 8;
+        pages++;
+        _pageY = (uint16_t)(_pageY + rows);
+        if (_pageY < end) return true;
+        if (_window.full) fullRefreshes++;
+        else partialRefreshes++;
+        return false;
+    }
+
+    // Nur Pixel im Fenster und in der aktuellen Seite landen im Seitenpuffer
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        if (x < _window.x || x >= _window.x + _window.w) return;
+        bool inPage = y >= _pageY && y < _pageY + page_height && y < _window.y + _window.h;
+        if (color != GxEPD_BLACK) return;
+        if (inPage) blackPixels++;
+        else clippedPixels++;
+    }
+
+    void reset() {
+        windows.clear();
+        bytes = 0;
+        pages = 0;
+        blackPixels = 0;
+        clippedPixels = 0;
+        fullRefreshes = 0;
+        partialRefreshes = 0;
+        hibernates = 0;
+    }
+
+    // Aufzeichnung seit dem letzten reset()
+    std::vector<GxEPD2_Window> windows;
+    uint32_t bytes;             // Pixel-Bytes per SPI (w * h / 8 pro Fenster)
+    uint32_t pages;             // Durchläufe der firstPage()/nextPage()-Schleifen
+    uint32_t blackPixels;       // In die Seitenpuffer geschriebene schwarze Pixel
+    uint32_t clippedPixels;     // Schwarze Pixel im Fenster, aber ausserhalb der aktuellen Seite
+    uint32_t fullRefreshes;
+    uint32_t partialRefreshes;
+    uint32_t hibernates;
+
+private:
+    GxEPD2_Window _window;
+    uint16_t _pageY;
+
+    void setWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h, bool full) {
+        GxEPD2_Window window = { x, y, w, h, full };
+        _window = window;
+        _pageY = y;
+        windows.push_back(window);
+    }
+};
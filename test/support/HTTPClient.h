@@ -0,0 +1,92 @@
+// Host-Ersatz für HTTPClient.h - nur für die nativen Tests
+// Der "Server" antwortet mit dem, was in hostHttp() steht. Ein POST über eine
+// vom Server geschlossene Verbindung (hostTls().stale) schlägt fehl wie auf dem
+// Gerät: erst beim Senden, nicht schon bei connected().
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+
+#define HTTPC_ERROR_CONNECTION_REFUSED  (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED  (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED       (-4)
+#define HTTPC_ERROR_CONNECTION_LOST     (-5)
+
+typedef enum {
+    HTTP_CODE_OK = 200,
+    HTTP_CODE_BAD_REQUEST = 400,
+    HTTP_CODE_UNAUTHORIZED = 401,
+    HTTP_CODE_TOO_MANY_REQUESTS = 429,
+    HTTP_CODE_INTERNAL_SERVER_ERROR = 500
+} t_http_codes;
+
+struct HostHttpState {
+    int status;                 // Antwort auf den nächsten POST
+    String response;            // Body bei HTTP 200
+    bool closeAfter;            // Server schickt "Connection: close"
+    uint32_t posts;             // POSTs, die beim Server angekommen sind
+    uint32_t failedPosts;       // POSTs auf eine tote Verbindung
+    String lastBody;
+    String lastAuthorization;
+
+    HostHttpState() : status(HTTP_CODE_OK), closeAfter(false), posts(0), failedPosts(0) {}
+};
+
+inline HostHttpState& hostHttp() {
+    static HostHttpState state;
+    return state;
+}
+
+class HTTPClient {
+public:
+    HTTPClient() : _client(NULL), _reuse(false) {}
+
+    void setReuse(bool reuse) { _reuse = reuse; }
+
+    bool begin(WiFiClient& client, const char* host, uint16_t port, const char* uri, bool https) {
+        _client = &client;
+        return true;
+    }
+
+    void addHeader(const String& name, const String& value) {
+        if (name == "Authorization") hostHttp().lastAuthorization = value;
+    }
+
+    int POST(uint8_t* payload, size_t size) {
+        HostHttpState& http = hostHttp();
+        if (!_client || !_client->connected()) return HTTPC_ERROR_NOT_CONNECTED;
+        if (hostTls().stale) {
+            http.failedPosts++;
+            return HTTPC_ERROR_CONNECTION_LOST;
+        }
+        http.posts++;
+        http.lastBody = String();
+        http.lastBody.concat((const char*)payload, size);
+        return http.status;
+    }
+
+    int writeToStream(Stream* stream) {
+        const String& body = hostHttp().response;
+        return (int)stream->write((const uint8_t*)body.c_str(), body.length());
+    }
+
+    // Wie im Core: offen bleibt die Verbindung nur mit Reuse und ohne "Connection: close"
+    void end() {
+        if (_client && (!_reuse || hostHttp().closeAfter)) _client->stop();
+        _client = NULL;
+    }
+
+    static String errorToString(int error) {
+        switch (error) {
+            case HTTPC_ERROR_CONNECTION_REFUSED: return "connection refused";
+            case HTTPC_ERROR_NOT_CONNECTED: return "not connected";
+            case HTTPC_ERROR_CONNECTION_LOST: return "connection lost";
+            default: return String();
+        }
+    }
+
+private:
+    WiFiClient* _client;
+    bool _reuse;
+};
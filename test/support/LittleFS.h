@@ -0,0 +1,6 @@
+// Host-Ersatz für LittleFS.h - nur für die nativen Tests
+#pragma once
+
+#include <FS.h>
+
+static fs::FS LittleFS;
@@ -0,0 +1,12 @@
+// Host-Ersatz für Preferences.h - nur für die nativen Tests
+// (ConfigStore.h hält eine Instanz; ConfigStore.cpp wird nicht gebaut, die
+// Tests brauchen nur die Typen wie LineConfig)
+#pragma once
+
+#include <Arduino.h>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false) { return true; }
+    void end() {}
+};
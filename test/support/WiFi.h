@@ -0,0 +1,35 @@
+// Host-Ersatz für WiFi.h - nur für die nativen Tests (Display: Status und RSSI,
+// OjpConnection: DNS)
+#pragma once
+
+#include <Arduino.h>
+
+typedef enum { WL_IDLE_STATUS = 0, WL_CONNECTED = 3, WL_DISCONNECTED = 6 } wl_status_t;
+
+class WiFiClass {
+public:
+    WiFiClass() : connected(true), rssi(-60), dnsOk(true), dnsAddress(10, 0, 0, 1), dnsQueries(0) {}
+    wl_status_t status() const { return connected ? WL_CONNECTED : WL_DISCONNECTED; }
+    int RSSI() const { return rssi; }
+
+    int hostByName(const char* host, IPAddress& result) {
+        dnsQueries++;
+        if (!dnsOk) return 0;
+        result = dnsAddress;
+        return 1;
+    }
+
+    bool connected;
+    int rssi;
+    bool dnsOk;                 // hostByName() gelingt
+    IPAddress dnsAddress;       // Antwort von hostByName()
+    uint32_t dnsQueries;
+};
+
+// Eine Instanz für alle Übersetzungseinheiten, damit Tests den Zustand setzen können
+inline WiFiClass& hostWiFi() {
+    static WiFiClass instance;
+    return instance;
+}
+
+static WiFiClass& WiFi = hostWiFi();
@@ -0,0 +1,62 @@
+// Host-Ersatz für WiFiClientSecure.h - nur für die nativen Tests
+// Kein Netzwerk: der Zustand der TLS-Verbindung liegt in hostTls(), die Tests
+// setzen ihn (Server schliesst die Verbindung, Connect schlägt fehl) und prüfen,
+// wie oft verbunden wurde.
+#pragma once
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+struct HostTlsState {
+    bool open;              // Verbindung steht
+    bool stale;             // Vom Server geschlossen, connected() merkt es noch nicht
+    bool refuse;            // connect() schlägt fehl
+    uint32_t connects;      // Erfolgreiche Handshakes
+    uint32_t stops;         // Geschlossene offene Verbindungen
+    IPAddress address;      // Ziel des letzten connect()
+    String sniHost;         // Hostname des letzten connect()
+
+    HostTlsState() : open(false), stale(false), refuse(false), connects(0), stops(0) {}
+};
+
+inline HostTlsState& hostTls() {
+    static HostTlsState state;
+    return state;
+}
+
+class WiFiClient : public Stream {
+public:
+    virtual ~WiFiClient() {}
+
+    virtual uint8_t connected() { return hostTls().open; }
+
+    virtual void stop() {
+        HostTlsState& tls = hostTls();
+        if (tls.open) tls.stops++;
+        tls.open = false;
+        tls.stale = false;
+    }
+
+    size_t write(uint8_t) override { return 0; }
+    size_t write(const uint8_t*, size_t) override { return 0; }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+};
+
+class WiFiClientSecure : public WiFiClient {
+public:
+    void setInsecure() {}
+
+    int connect(IPAddress ip, uint16_t port, const char* host, const char* rootCA,
+                const char* cliCert, const char* cliKey) {
+        HostTlsState& tls = hostTls();
+        if (tls.refuse) return 0;
+        tls.open = true;
+        tls.stale = false;
+        tls.connects++;
+        tls.address = ip;
+        tls.sniHost = host;
+        return 1;
+    }
+};
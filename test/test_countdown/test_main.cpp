@@ -0,0 +1,101 @@
+#include <unity.h>
+#include "Display/countdown.h"
+
+namespace {
+
+const time_t MINUTE = 1759999980;       // Volle Minute (UTC), gültige Uhrzeit
+const time_t NOW = MINUTE + 10;         // hh:mm:10
+const size_t ROWS = 4;
+
+Departure departure(time_t planned, time_t estimated = 0) {
+    Departure dep;
+    dep.setLine("11");
+    dep.departureTime = planned;
+    dep.estimatedTime = estimated;
+    return dep;
+}
+
+// `count` Abfahrten im Minutentakt, die erste `firstOffset` Sekunden nach NOW
+DepartureList everyMinute(size_t count, long firstOffset) {
+    DepartureList list;
+    for (size_t i = 0; i < count; i++) list.add(departure(NOW + firstOffset + (long)i * 60), "Auzelg");
+    return list;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_minutes_count_on_clock_minute_boundaries() {
+    // 12:05:40 um 12:03:10 = 2', obwohl 2.5 Minuten übrig sind
+    TEST_ASSERT_EQUAL_INT(2, Countdown::minutesUntil(MINUTE + 2 * 60 + 30, NOW));
+    TEST_ASSERT_EQUAL_INT(1, Countdown::minutesUntil(MINUTE + 60, NOW));
+    TEST_ASSERT_EQUAL_INT(0, Countdown::minutesUntil(MINUTE + 50, NOW));
+    TEST_ASSERT_EQUAL_INT(0, Countdown::minutesUntil(NOW - 120, NOW));
+}
+
+void test_estimate_decides_whether_departed() {
+    TEST_ASSERT_TRUE(Countdown::departed(departure(NOW - 60), NOW));
+    TEST_ASSERT_FALSE(Countdown::departed(departure(NOW - 60, NOW + 60), NOW));
+    TEST_ASSERT_FALSE(Countdown::departed(departure(NOW), NOW));
+}
+
+void test_visible_skips_departed_and_promotes_reserve() {
+    DepartureList list = everyMinute(7, -110);      // Zwei Kurse bereits weg
+    const Departure* rows[ROWS];
+    TEST_ASSERT_EQUAL_size_t(ROWS, Countdown::visible(list, NOW, rows, ROWS));
+    TEST_ASSERT_EQUAL_PTR(&list[2], rows[0]);
+    TEST_ASSERT_EQUAL_PTR(&list[5], rows[3]);
+    TEST_ASSERT_EQUAL_size_t(2, Countdown::departedAhead(list, NOW));
+}
+
+void test_visible_without_clock_filters_nothing() {
+    DepartureList list = everyMinute(3, -130);
+    const Departure* rows[ROWS];
+    TEST_ASSERT_EQUAL_size_t(3, Countdown::visible(list, 1000, rows, ROWS));
+    TEST_ASSERT_EQUAL_PTR(&list[0], rows[0]);
+    TEST_ASSERT_EQUAL_size_t(0, Countdown::departedAhead(list, 1000));
+}
+
+void test_tick_fires_shortly_after_next_minute() {
+    TEST_ASSERT_EQUAL_UINT32(50000 + Countdown::TICK_MARGIN_MS, Countdown::msUntilTick(NOW));
+    TEST_ASSERT_EQUAL_UINT32(60000 + Countdown::TICK_MARGIN_MS, Countdown::msUntilTick(MINUTE));
+}
+
+void test_tick_without_clock_does_nothing() {
+    TEST_ASSERT_EQUAL(TICK_NONE, Countdown::onTick(everyMinute(8, 30), 1000, ROWS, false));
+}
+
+void test_tick_renders_when_nothing_departed() {
+    TEST_ASSERT_EQUAL(TICK_RENDER, Countdown::onTick(everyMinute(4, 30), NOW, ROWS, false));
+}
+
+void test_tick_renders_while_reserve_can_promote() {
+    // Ein Kurs weg, 7 übrig: Reserve füllt die 4 Zeilen
+    TEST_ASSERT_EQUAL(TICK_RENDER, Countdown::onTick(everyMinute(8, -30), NOW, ROWS, false));
+}
+
+void test_tick_refetches_when_reserve_is_used_up() {
+    // Ein Kurs weg, 4 übrig: der nächste hinterliesse eine Lücke
+    TEST_ASSERT_EQUAL(TICK_REFETCH, Countdown::onTick(everyMinute(5, -30), NOW, ROWS, false));
+}
+
+void test_offline_never_refetches() {
+    TEST_ASSERT_EQUAL(TICK_RENDER, Countdown::onTick(everyMinute(2, -30), NOW, ROWS, true));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_minutes_count_on_clock_minute_boundaries);
+    RUN_TEST(test_estimate_decides_whether_departed);
+    RUN_TEST(test_visible_skips_departed_and_promotes_reserve);
+    RUN_TEST(test_visible_without_clock_filters_nothing);
+    RUN_TEST(test_tick_fires_shortly_after_next_minute);
+    RUN_TEST(test_tick_without_clock_does_nothing);
+    RUN_TEST(test_tick_renders_when_nothing_departed);
+    RUN_TEST(test_tick_renders_while_reserve_can_promote);
+    RUN_TEST(test_tick_refetches_when_reserve_is_used_up);
+    RUN_TEST(test_offline_never_refetches);
+    return UNITY_END();
+}
@@ -0,0 +1,263 @@
+#include <unity.h>
+#include "Transport/DepartureCache.h"
+
+namespace {
+
+const char* const PATH = "/departures.bin";
+const time_t NOW = 1770199200;      // 2026-02-04T10:00:00Z
+const size_t HEADER_SIZE = 16;
+
+fs::FS* flash = NULL;
+DepartureSnapshot* snapshot = NULL;
+String stopIds[DepartureCache::MAX_STOPS];
+
+void addDeparture(DepartureList& list, const char* line, time_t planned, time_t estimated,
+                  PtMode mode, const char* direction) {
+    Departure dep;
+    dep.setLine(line);
+    dep.departureTime = planned;
+    dep.estimatedTime = estimated;
+    dep.mode = mode;
+    list.add(dep, direction);
+}
+
+// Zwei Haltestellen, die dritte ist nicht konfiguriert
+void fillSnapshot() {
+    stopIds[0] = "8591382";
+    stopIds[1] = "ch:1:sloid:3000";
+    stopIds[2] = "";
+    addDeparture(snapshot->stops[0], "11", NOW - 120, NOW - 60, PT_MODE_TRAM, "Z\xC3\xBCrich, Auzelg");
+    addDeparture(snapshot->stops[0], "11", NOW + 300, NOW + 360, PT_MODE_TRAM, "Z\xC3\xBCrich, Rehalp");
+    addDeparture(snapshot->stops[0], "32", NOW + 600, 0, PT_MODE_BUS, "Z\xC3\xBCrich, Strassenverkehrsamt");
+    addDeparture(snapshot->stops[0], "11", NOW + 900, 0, PT_MODE_TRAM, "Z\xC3\xBCrich, Auzelg");
+    addDeparture(snapshot->stops[1], "IC 1", NOW + 1200, NOW + 1260, PT_MODE_RAIL, "Gen\xC3\xA8ve-A\xC3\xA9roport");
+}
+
+std::string& file() {
+    return flash->files[PATH];
+}
+
+uint32_t crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+    }
+    return ~crc;
+}
+
+void putU32(std::string& data, size_t offset, uint32_t value) {
+    for (int i = 0; i < 4; i++) data[offset + i] = (char)((value >> (8 * i)) & 0xFF);
+}
+
+uint32_t getU32(const std::string& data, size_t offset) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--) value = (value << 8) | (uint8_t)data[offset + i];
+    return value;
+}
+
+// Länge und CRC im Header zur (veränderten) Nutzlast passend machen
+void resealHeader(std::string& data) {
+    size_t length = data.size() - HEADER_SIZE;
+    putU32(data, 8, (uint32_t)length);
+    putU32(data, 12, crc32((const uint8_t*)data.data() + HEADER_SIZE, length));
+}
+
+bool reload(DepartureCache& cache) {
+    return cache.begin(flash, PATH);
+}
+
+} // namespace
+
+void setUp() {
+    flash = new fs::FS();
+    snapshot = new DepartureSnapshot();
+    fillSnapshot();
+}
+
+void tearDown() {
+    delete snapshot;
+    delete flash;
+}
+
+void test_round_trip() {
+    DepartureCache cache;
+    TEST_ASSERT_FALSE(cache.begin(flash, PATH));        // Noch keine Datei
+    TEST_ASSERT_TRUE(cache.store(stopIds, *snapshot, NOW));
+    TEST_ASSERT_TRUE(flash->exists(PATH));
+
+    DepartureCache loaded;
+    TEST_ASSERT_TRUE(reload(loaded));
+    TEST_ASSERT_EQUAL_INT32((int32_t)NOW, (int32_t)loaded.getSavedAt());
+
+    // Ohne gültige Uhr: alles, nur Fahrplanzeiten
+    DepartureSnapshot out;
+    TEST_ASSERT_TRUE(loaded.fallback(stopIds, 0, out));
+    TEST_ASSERT_TRUE(out.offline);
+    TEST_ASSERT_EQUAL_INT32((int32_t)NOW, (int32_t)out.fetchedAt);
+    for (size_t s = 0; s < DepartureCache::MAX_STOPS; s++) {
+        const DepartureList& expected = snapshot->stops[s];
+        TEST_ASSERT_EQUAL_size_t(expected.size(), out.stops[s].size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            const Departure& dep = out.stops[s][i];
+            TEST_ASSERT_EQUAL_STRING(expected[i].line, dep.line);
+            TEST_ASSERT_EQUAL_INT32((int32_t)expected[i].departureTime, (int32_t)dep.departureTime);
+            TEST_ASSERT_EQUAL_INT32(0, (int32_t)dep.estimatedTime);
+            TEST_ASSERT_EQUAL_INT(expected[i].mode, dep.mode);
+            TEST_ASSERT_EQUAL_STRING(expected.direction(expected[i]), out.stops[s].direction(dep));
+            TEST_ASSERT_EQUAL_STRING(expected.directionASCII(expected[i]), out.stops[s].directionASCII(dep));
+        }
+    }
+    // Gleiche Zielorte teilen sich weiterhin eine ID
+    TEST_ASSERT_EQUAL_size_t(3, out.stops[0].directions().size());
+}
+
+void test_full_list_round_trip() {
+    DepartureList& list = snapshot->stops[0];
+    list.clear();
+    for (size_t i = 0; i < DepartureList::CAPACITY; i++) {
+        addDeparture(list, "7", NOW + 180 * (time_t)(i + 1), 0, PT_MODE_TRAM, i % 2 ? "Stettbach" : "Wollishofen");
+    }
+    DepartureCache cache;
+    cache.begin(flash, PATH);
+    TEST_ASSERT_TRUE(cache.store(stopIds, *snapshot, NOW));
+    TEST_ASSERT_EQUAL_INT32((int32_t)(NOW + 3600), (int32_t)cache.getHorizon());
+
+    DepartureCache loaded;
+    TEST_ASSERT_TRUE(reload(loaded));
+    TEST_ASSERT_EQUAL_INT32((int32_t)(NOW + 3600), (int32_t)loaded.getHorizon());
+    DepartureSnapshot out;
+    TEST_ASSERT_TRUE(loaded.fallback(stopIds, NOW, out));
+    TEST_ASSERT_EQUAL_size_t(DepartureList::CAPACITY, out.stops[0].size());
+}
+
+void test_filters_departed_rows() {
+    DepartureCache cache;
+    cache.begin(flash, PATH);
+    TEST_ASSERT_TRUE(cache.store(stopIds, *snapshot, NOW));
+
+    DepartureSnapshot out;
+    TEST_ASSERT_TRUE(cache.fallback(stopIds, NOW, out));
+    // Die Prognose (NOW - 60) zählt nicht, nur die Fahrplanzeit
+    TEST_ASSERT_EQUAL_size_t(3, out.stops[0].size());
+    TEST_ASSERT_EQUAL_INT32((int32_t)(NOW + 300), (int32_t)out.stops[0][0].departureTime);
+    TEST_ASSERT_EQUAL_STRING("Z\xC3\xBCrich, Rehalp", out.stops[0].direction(out.stops[0][0]));
+
+    // Eine halbe Stunde später ist nur noch der IC übrig
+    TEST_ASSERT_TRUE(cache.fallback(stopIds, NOW + 1000, out));
+    TEST_ASSERT_EQUAL_size_t(0, out.stops[0].size());
+    TEST_ASSERT_EQUAL_size_t(1, out.stops[1].size());
+
+    // Alles abgefahren: weiterhin ein (leerer) Ersatzstand für die Haltestellen
+    TEST_ASSERT_TRUE(cache.fallback(stopIds, NOW + 7200, out));
+    TEST_ASSERT_EQUAL_size_t(0, out.stops[1].size());
+}
+
+void test_other_stops_get_nothing() {
+    DepartureCache cache;
+    cache.begin(flash, PATH);
+    TEST_ASSERT_TRUE(cache.store(stopIds, *snapshot, NOW));
+
+    String changed[DepartureCache::MAX_STOPS] = { "8503000", "ch:1:sloid:3000", "" };
+    DepartureSnapshot out;
+    TEST_ASSERT_TRUE(cache.fallback(changed, NOW, out));
+    TEST_ASSERT_EQUAL_size_t(0, out.stops[0].size());
+    TEST_ASSERT_EQUAL_size_t(1, out.stops[1].size());
+
+    String others[DepartureCache::MAX_STOPS] = { "8503000", "8507000", "" };
+    TEST_ASSERT_FALSE(cache.fallback(others, NOW, out));
+    TEST_ASSERT_TRUE(cache.refreshDue(others, NOW + 60));
+    TEST_ASSERT_FALSE(cache.refreshDue(stopIds, NOW + 60));
+}
+
+void test_rejects_bad_crc() {
+    DepartureCache cache;
+    cache.begin(flash, PATH);
+    TEST_ASSERT_TRUE(cache.store(stopIds, *snapshot, NOW));
+    std::string original = file();
+
+    // Ein gekipptes Bit in der Nutzlast
+    file()[HEADER_SIZE + 10] ^= 0x01;
+    DepartureCache loaded;
+    TEST_ASSERT_FALSE(reload(loaded));
+    TEST_ASSERT_EQUAL_INT32(0, (int32_t)loaded.getSavedAt());
+    DepartureSnapshot out;
+    TEST_ASSERT_FALSE(loaded.fallback(stopIds, NOW, out));
+
+    // Falsche CRC im Header
+    file() = original;
+    putU32(file(), 12, getU32(original, 12) + 1);
+    TEST_ASSERT_FALSE(reload(loaded));
+
+    // Fremde Datei
+    file() = original;
+    file()[0] = 'X';
+    TEST_ASSERT_FALSE(reload(loaded));
+
+    file() = original;
+    TEST_ASSERT_TRUE(reload(loaded));
+}
+
+void test_rejects_other_version() {
+    DepartureCache cache;
+    cache.begin(flash, PATH);
+    TEST_ASSERT_TRUE(cache.store(stopIds, *snapshot, NOW));
+    TEST_ASSERT_EQUAL_INT(DepartureCache::SCHEMA_VERSION, (uint8_t)file()[4] | ((uint8_t)file()[5] << 8));
+
+    // Die Version liegt im Header und ist nicht von der CRC gedeckt
+    file()[4] = (char)(DepartureCache::SCHEMA_VERSION + 1);
+    DepartureCache loaded;
+    TEST_ASSERT_FALSE(reload(loaded));
+    TEST_ASSERT_EQUAL_INT32(0, (int32_t)loaded.getSavedAt());
+}
+
+void test_rejects_truncated_file() {
+    DepartureCache cache;
+    cache.begin(flash, PATH);
+    TEST_ASSERT_TRUE(cache.store(stopIds, *snapshot, NOW));
+    std::string original = file();
+    DepartureCache loaded;
+
+    // Abgeschnitten, Header passt nicht mehr zur Länge
+    file() = original.substr(0, original.size() - 1);
+    TEST_ASSERT_FALSE(reload(loaded));
+    file() = original.substr(0, HEADER_SIZE - 1);
+    TEST_ASSERT_FALSE(reload(loaded));
+
+    // Abgeschnitten, aber mit passender Länge und CRC: jede Schnittstelle
+    // muss an der Bereichsprüfung des Decoders scheitern
+    for (size_t cut = HEADER_SIZE; cut < original.size(); cut++) {
+        file() = original.substr(0, cut);
+        resealHeader(file());
+        TEST_ASSERT_FALSE(reload(loaded));
+        TEST_ASSERT_EQUAL_INT32(0, (int32_t)loaded.getSavedAt());
+    }
+
+    // resealHeader() rechnet wie store(): die unveränderte Datei bleibt gleich
+    file() = original;
+    resealHeader(file());
+    TEST_ASSERT_TRUE(file() == original);
+    TEST_ASSERT_TRUE(reload(loaded));
+}
+
+void test_needs_valid_time() {
+    DepartureCache cache;
+    cache.begin(flash, PATH);
+    TEST_ASSERT_FALSE(cache.store(stopIds, *snapshot, 1000));
+    TEST_ASSERT_FALSE(flash->exists(PATH));
+    TEST_ASSERT_FALSE(cache.refreshDue(stopIds, 1000));
+    TEST_ASSERT_TRUE(cache.refreshDue(stopIds, NOW));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_full_list_round_trip);
+    RUN_TEST(test_filters_departed_rows);
+    RUN_TEST(test_other_stops_get_nothing);
+    RUN_TEST(test_rejects_bad_crc);
+    RUN_TEST(test_rejects_other_version);
+    RUN_TEST(test_rejects_truncated_file);
+    RUN_TEST(test_needs_valid_time);
+    return UNITY_END();
+}
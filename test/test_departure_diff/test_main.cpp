@@ -0,0 +1,134 @@
+#include <unity.h>
+#include "Transport/DepartureDiff.h"
+
+namespace {
+
+const time_t T = 1760745540;        // 23:59 UTC
+
+Departure departure(const char* line, time_t planned, time_t estimated = 0) {
+    Departure dep;
+    dep.setLine(line);
+    dep.departureTime = planned;
+    dep.estimatedTime = estimated;
+    return dep;
+}
+
+DepartureList before;
+
+// Kopie von `before` ohne die Zeile `skip` (SIZE_MAX = alle)
+DepartureList copyWithout(size_t skip) {
+    DepartureList list;
+    for (size_t i = 0; i < before.size(); i++) {
+        if (i != skip) list.add(before[i], before.direction(before[i]));
+    }
+    return list;
+}
+
+} // namespace
+
+void setUp() {
+    before.clear();
+    before.add(departure("10", T), "Dornach");
+    before.add(departure("11", T + 120), "Aesch");
+    before.add(departure("10", T + 300), "Dornach");
+    before.add(departure("E11", T + 600), "Flueh");
+    before.add(departure("16", T + 900), "Bruderholz");
+}
+
+void tearDown() {}
+
+void test_identical_lists_are_empty() {
+    DepartureChangeSet changes = DepartureDiff::compare(before, copyWithout(SIZE_MAX));
+    TEST_ASSERT_TRUE(changes.empty());
+    TEST_ASSERT_FALSE(changes.affects(4));
+    TEST_ASSERT_EQUAL_UINT8(0, changes.gone);
+}
+
+void test_new_estimate_marks_delay_changed() {
+    DepartureList after;
+    for (const Departure& dep : before) {
+        Departure changed = dep;
+        if (strcmp(dep.line, "11") == 0) changed.estimatedTime = dep.departureTime + 180;
+        after.add(changed, before.direction(dep));
+    }
+    DepartureChangeSet changes = DepartureDiff::compare(before, after);
+    TEST_ASSERT_EQUAL_HEX32(0x2, changes.changedMask);
+    TEST_ASSERT_EQUAL(DEPARTURE_DELAY_CHANGED, changes.rows[1]);
+    TEST_ASSERT_TRUE(changes.affects(4));
+}
+
+void test_swapped_rows_are_reordered() {
+    DepartureList after;
+    after.add(before[1], "Aesch");
+    after.add(before[0], "Dornach");
+    for (size_t i = 2; i < before.size(); i++) after.add(before[i], before.direction(before[i]));
+    DepartureChangeSet changes = DepartureDiff::compare(before, after);
+    TEST_ASSERT_EQUAL_HEX32(0x3, changes.changedMask);
+    TEST_ASSERT_EQUAL(DEPARTURE_REORDERED, changes.rows[0]);
+    TEST_ASSERT_EQUAL(DEPARTURE_REORDERED, changes.rows[1]);
+    TEST_ASSERT_EQUAL(DEPARTURE_UNCHANGED, changes.rows[2]);
+}
+
+void test_cancelled_trip_is_gone_and_shifts_rows() {
+    DepartureChangeSet changes = DepartureDiff::compare(before, copyWithout(1));
+    TEST_ASSERT_EQUAL_UINT8(4, changes.count);
+    TEST_ASSERT_EQUAL_UINT8(5, changes.previousCount);
+    TEST_ASSERT_EQUAL_UINT8(1, changes.gone);
+    TEST_ASSERT_EQUAL(DEPARTURE_UNCHANGED, changes.rows[0]);
+    TEST_ASSERT_EQUAL(DEPARTURE_REORDERED, changes.rows[1]);
+    TEST_ASSERT_TRUE(changes.affects(4));
+}
+
+void test_lost_tail_beyond_visible_rows_does_not_affect_display() {
+    DepartureChangeSet changes = DepartureDiff::compare(before, copyWithout(4));
+    TEST_ASSERT_EQUAL_UINT8(1, changes.gone);
+    TEST_ASSERT_EQUAL_HEX32(0, changes.changedMask);
+    TEST_ASSERT_FALSE(changes.empty());
+    TEST_ASSERT_FALSE(changes.affects(4));
+}
+
+void test_midnight_rollover_appends_new_trip() {
+    DepartureList after = copyWithout(0);
+    after.add(departure("10", T + 86400 - 60), "Dornach");
+    DepartureChangeSet changes = DepartureDiff::compare(before, after);
+    TEST_ASSERT_EQUAL_UINT8(1, changes.gone);
+    TEST_ASSERT_EQUAL(DEPARTURE_REORDERED, changes.rows[0]);
+    TEST_ASSERT_EQUAL(DEPARTURE_NEW, changes.rows[4]);
+}
+
+void test_changed_direction_is_a_different_trip() {
+    DepartureList after;
+    for (size_t i = 0; i < before.size(); i++) {
+        after.add(before[i], i == 2 ? "Ruchfeld" : before.direction(before[i]));
+    }
+    DepartureChangeSet changes = DepartureDiff::compare(before, after);
+    TEST_ASSERT_EQUAL_UINT8(1, changes.gone);
+    TEST_ASSERT_EQUAL_HEX32(0x4, changes.changedMask);
+    TEST_ASSERT_EQUAL(DEPARTURE_NEW, changes.rows[2]);
+}
+
+void test_empty_lists() {
+    DepartureList empty;
+    DepartureChangeSet toEmpty = DepartureDiff::compare(before, empty);
+    TEST_ASSERT_EQUAL_UINT8(5, toEmpty.gone);
+    TEST_ASSERT_TRUE(toEmpty.affects(4));
+
+    DepartureChangeSet fromEmpty = DepartureDiff::compare(empty, before);
+    TEST_ASSERT_EQUAL_HEX32(0x1F, fromEmpty.changedMask);
+    TEST_ASSERT_EQUAL(DEPARTURE_NEW, fromEmpty.rows[0]);
+
+    TEST_ASSERT_TRUE(DepartureDiff::compare(empty, empty).empty());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_identical_lists_are_empty);
+    RUN_TEST(test_new_estimate_marks_delay_changed);
+    RUN_TEST(test_swapped_rows_are_reordered);
+    RUN_TEST(test_cancelled_trip_is_gone_and_shifts_rows);
+    RUN_TEST(test_lost_tail_beyond_visible_rows_does_not_affect_display);
+    RUN_TEST(test_midnight_rollover_appends_new_trip);
+    RUN_TEST(test_changed_direction_is_a_different_trip);
+    RUN_TEST(test_empty_lists);
+    return UNITY_END();
+}
@@ -0,0 +1,153 @@
+#include <unity.h>
+#include <thread>
+#include <WiFi.h>
+#include "Display/display_manager.h"
+#include "Transport/DepartureDiff.h"
+
+// Transfergrössen der Refreshes mit dem aufzeichnenden GxEPD2 aus test/support.
+// Die Anzeige rechnet mit der echten Uhr: Abfahrten liegen relativ zu time(NULL).
+
+namespace {
+
+typedef DisplayPanel Panel;
+
+const uint32_t FULL_FRAME_BYTES = 400 * 300 / 8;
+
+Panel* panel;
+DisplayManager* manager;
+DepartureSnapshotPtr current;
+time_t minuteStart;
+
+Departure departure(const char* line, time_t planned, time_t estimated = 0) {
+    Departure dep;
+    dep.setLine(line);
+    dep.departureTime = planned;
+    dep.estimatedTime = estimated;
+    return dep;
+}
+
+// Neuer Snapshot mit der Verspätung `delayS` auf der ersten Zeile
+void publish(time_t delayS) {
+    std::shared_ptr<DepartureSnapshot> next = std::make_shared<DepartureSnapshot>();
+    for (int i = 0; i < 6; i++) {
+        time_t planned = minuteStart + 150 + i * 300;
+        next->stops[0].add(departure(i % 2 ? "10" : "11", planned, i == 0 && delayS ? planned + delayS : 0),
+                           i % 2 ? "Dornach" : "Aesch");
+    }
+    next->fetchedAt = minuteStart;
+    if (current) {
+        next->generation = current->generation + 1;
+        next->changes[0] = DepartureDiff::compare(current->stops[0], next->stops[0]);
+    } else {
+        next->generation = 1;
+    }
+    current = next;
+}
+
+void update(SystemEvent event) {
+    panel->reset();
+    manager->update(event);
+}
+
+} // namespace
+
+void setUp() {
+    // Nicht über einen Minutenwechsel laufen: Uhrzeit und Minuten wären sonst auch geändert
+    while (time(NULL) % 60 >= 50) std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    minuteStart = time(NULL) / 60 * 60;
+
+    current.reset();
+    panel = new Panel(GxEPD2_420_GYE042A87(0, 0, 0, 0));
+    manager = new DisplayManager(panel);
+    manager->setDataProvider([]() { return current; });
+    manager->init();
+    publish(0);
+    update(EVENT_DATA_AVAILABLE);
+}
+
+void tearDown() {
+    delete manager;
+    delete panel;
+}
+
+void test_first_data_is_a_full_refresh() {
+    // Stand nach setUp(): erstes Dashboard
+    manager->update(EVENT_WIFI_CONNECTED);
+    TEST_ASSERT_EQUAL_UINT32(1, manager->getRefreshStats().fullRefreshes);
+    TEST_ASSERT_EQUAL_UINT32(FULL_FRAME_BYTES, manager->getRefreshStats().lastBytes);
+}
+
+void test_full_refresh_is_sent_in_four_pages() {
+    manager->setErrorMessage("API Key fehlt");
+    update(EVENT_UPDATE_TRIGGER);
+    TEST_ASSERT_EQUAL_UINT32(4, panel->pages);
+    TEST_ASSERT_EQUAL_UINT32(FULL_FRAME_BYTES, panel->bytes);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, panel->blackPixels);
+    // Jede Seite bekommt nur ihre Zeilen aus dem Framebuffer
+    TEST_ASSERT_EQUAL_UINT32(0, panel->clippedPixels);
+}
+
+void test_unchanged_frame_is_not_sent() {
+    update(EVENT_TIME_SYNCED);
+    update(EVENT_DATA_AVAILABLE);       // Gleiche Generation
+    TEST_ASSERT_EQUAL_UINT32(0, panel->bytes);
+    TEST_ASSERT_EQUAL_size_t(0, panel->windows.size());
+    TEST_ASSERT_EQUAL_UINT32(1, manager->getRefreshStats().skipped);
+}
+
+void test_delay_on_first_row_sends_only_that_row() {
+    publish(180);
+    update(EVENT_DATA_AVAILABLE);
+
+    DisplayRefreshStats stats = manager->getRefreshStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.partialRefreshes);
+    TEST_ASSERT_EQUAL_UINT32(stats.lastBytes, panel->bytes);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, panel->bytes);
+    // Eine Zeile (oder nur ihre Minuten) statt des ganzen Bildes
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(FULL_FRAME_BYTES / 4, panel->bytes);
+    TEST_ASSERT_EQUAL_UINT32(0, panel->clippedPixels);
+    for (size_t i = 0; i < panel->windows.size(); i++) {
+        TEST_ASSERT_FALSE(panel->windows[i].full);
+        TEST_ASSERT_EQUAL_UINT32(0, panel->windows[i].x % 8);
+        TEST_ASSERT_EQUAL_UINT32(0, panel->windows[i].w % 8);
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(40, panel->windows[i].y);      // Header bleibt
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(105, panel->windows[i].y);        // Ab Zeile 2 nichts
+    }
+}
+
+void test_full_refresh_after_twenty_partials() {
+    for (int i = 0; i < 20; i++) {
+        publish(i % 2 ? 60 : 180);
+        update(EVENT_DATA_AVAILABLE);
+    }
+    TEST_ASSERT_EQUAL_UINT32(20, manager->getRefreshStats().partialRefreshes);
+
+    publish(240);
+    update(EVENT_DATA_AVAILABLE);
+    TEST_ASSERT_EQUAL_UINT32(2, manager->getRefreshStats().fullRefreshes);
+    TEST_ASSERT_EQUAL_UINT32(FULL_FRAME_BYTES, panel->bytes);
+    TEST_ASSERT_TRUE(panel->windows[0].full);
+}
+
+void test_unchanged_error_screen_is_not_sent_again() {
+    WiFi.connected = false;
+    manager->setErrorMessage("API Key fehlt");
+    update(EVENT_UPDATE_TRIGGER);
+    TEST_ASSERT_EQUAL_UINT32(FULL_FRAME_BYTES, panel->bytes);
+    TEST_ASSERT_EQUAL_UINT32(1, panel->hibernates);
+
+    update(EVENT_UPDATE_TRIGGER);
+    TEST_ASSERT_EQUAL_UINT32(0, panel->bytes);
+    WiFi.connected = true;
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_data_is_a_full_refresh);
+    RUN_TEST(test_full_refresh_is_sent_in_four_pages);
+    RUN_TEST(test_unchanged_frame_is_not_sent);
+    RUN_TEST(test_delay_on_first_row_sends_only_that_row);
+    RUN_TEST(test_full_refresh_after_twenty_partials);
+    RUN_TEST(test_unchanged_error_screen_is_not_sent_again);
+    return UNITY_END();
+}
@@ -0,0 +1,70 @@
+#include <unity.h>
+#include "Core/EventBus.h"
+
+// Der Bus ist global: die Tests bauen aufeinander auf und laufen in dieser Reihenfolge
+
+namespace {
+
+QueueHandle_t displayQueue;
+QueueHandle_t webQueue;
+
+size_t drain(QueueHandle_t queue, SystemEvent* out, size_t capacity) {
+    size_t count = 0;
+    SystemEvent event;
+    while (count < capacity && xQueueReceive(queue, &event, 0) == pdTRUE) out[count++] = event;
+    return count;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_rejects_missing_queue() {
+    TEST_ASSERT_FALSE(EventBus::subscribe(NULL));
+}
+
+void test_every_subscriber_gets_the_event() {
+    displayQueue = xQueueCreate(10, sizeof(SystemEvent));
+    webQueue = xQueueCreate(1, sizeof(SystemEvent));
+    TEST_ASSERT_TRUE(EventBus::subscribe(displayQueue));
+    TEST_ASSERT_TRUE(EventBus::subscribe(webQueue, true));
+
+    EventBus::publish(EVENT_DATA_AVAILABLE);
+
+    SystemEvent events[4];
+    TEST_ASSERT_EQUAL_size_t(1, drain(displayQueue, events, 4));
+    TEST_ASSERT_EQUAL(EVENT_DATA_AVAILABLE, events[0]);
+    TEST_ASSERT_EQUAL_size_t(1, drain(webQueue, events, 4));
+    TEST_ASSERT_EQUAL(EVENT_DATA_AVAILABLE, events[0]);
+}
+
+void test_full_lossy_queue_drops_instead_of_blocking() {
+    EventBus::publish(EVENT_WIFI_CONNECTED);
+    EventBus::publish(EVENT_TIME_SYNCED);
+    EventBus::publish(EVENT_DATA_AVAILABLE);
+
+    // Display bekommt alles in Reihenfolge, der Web-Push nur den Weckruf
+    SystemEvent events[4];
+    TEST_ASSERT_EQUAL_size_t(3, drain(displayQueue, events, 4));
+    TEST_ASSERT_EQUAL(EVENT_WIFI_CONNECTED, events[0]);
+    TEST_ASSERT_EQUAL(EVENT_TIME_SYNCED, events[1]);
+    TEST_ASSERT_EQUAL(EVENT_DATA_AVAILABLE, events[2]);
+    TEST_ASSERT_EQUAL_size_t(1, drain(webQueue, events, 4));
+    TEST_ASSERT_EQUAL(EVENT_WIFI_CONNECTED, events[0]);
+}
+
+void test_subscribers_are_capped() {
+    TEST_ASSERT_TRUE(EventBus::subscribe(xQueueCreate(1, sizeof(SystemEvent)), true));
+    TEST_ASSERT_TRUE(EventBus::subscribe(xQueueCreate(1, sizeof(SystemEvent)), true));
+    TEST_ASSERT_FALSE(EventBus::subscribe(xQueueCreate(1, sizeof(SystemEvent)), true));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_rejects_missing_queue);
+    RUN_TEST(test_every_subscriber_gets_the_event);
+    RUN_TEST(test_full_lossy_queue_drops_instead_of_blocking);
+    RUN_TEST(test_subscribers_are_capped);
+    return UNITY_END();
+}
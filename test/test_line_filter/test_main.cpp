@@ -0,0 +1,263 @@
+#include <unity.h>
+#include "Transport/LineFilter.h"
+#include "Transport/RequestPlanner.h"
+
+namespace {
+
+LineFilter* filter = NULL;
+
+Departure departure(const char* line) {
+    Departure dep;
+    dep.setLine(line);
+    return dep;
+}
+
+void configure(const char* line1, const char* direction1, const char* line2 = "", const char* direction2 = "") {
+    LineConfig rules[2];
+    rules[0].name = line1;
+    rules[0].direction = direction1;
+    rules[1].name = line2;
+    rules[1].direction = direction2;
+    filter->configure(rules, 2);
+}
+
+size_t refs(const char** out) {
+    return filter->serverRefs(out, OJP_MAX_LINE_FILTER);
+}
+
+// Beide Regeln kennen ihre Ref, der Server-Filter ist bereit
+void learnTram11() {
+    configure("11", "");
+    filter->learn(departure("11"), "Auzelg", "ojp:91011:A");
+    const char* out[OJP_MAX_LINE_FILTER];
+    TEST_ASSERT_EQUAL_size_t(1, refs(out));
+}
+
+} // namespace
+
+void setUp() {
+    filter = new LineFilter();
+}
+
+void tearDown() {
+    delete filter;
+    filter = NULL;
+}
+
+void test_local_matching() {
+    TEST_ASSERT_FALSE(filter->active());
+    TEST_ASSERT_TRUE(filter->matches(departure("32"), "Irgendwo"));
+
+    configure("11", "Z\xC3\xBCrich, Auzelg", "S 9", "");
+    TEST_ASSERT_TRUE(filter->active());
+    // ASCII, ohne Gross-/Kleinschreibung und Leerzeichen am Rand
+    TEST_ASSERT_TRUE(filter->matches(departure("11"), "  zuerich, AUZELG "));
+    TEST_ASSERT_FALSE(filter->matches(departure("11"), "Z\xC3\xBCrich, Rehalp"));
+    TEST_ASSERT_FALSE(filter->matches(departure("111"), "Z\xC3\xBCrich, Auzelg"));
+    // Leerer Zielort: jede Richtung
+    TEST_ASSERT_TRUE(filter->matches(departure("s 9"), "Uster"));
+    TEST_ASSERT_TRUE(filter->matches(departure("S 9"), "Zug"));
+
+    // Regel ohne Liniennamen zählt nicht
+    configure("", "Auzelg");
+    TEST_ASSERT_FALSE(filter->active());
+}
+
+void test_learns_refs_of_matching_departures() {
+    configure("11", "Auzelg", "S 9", "");
+    const char* out[OJP_MAX_LINE_FILTER];
+
+    // Nicht passende Abfahrten und leere/zu lange Refs lehren nichts
+    filter->learn(departure("32"), "Auzelg", "ojp:91032:A");
+    filter->learn(departure("11"), "Rehalp", "ojp:91011:B");
+    filter->learn(departure("11"), "Auzelg", "");
+    filter->learn(departure("11"), "Auzelg", NULL);
+    char longRef[LineFilter::REF_LEN + 1];
+    memset(longRef, 'x', LineFilter::REF_LEN);
+    longRef[LineFilter::REF_LEN] = '\0';
+    filter->learn(departure("11"), "Auzelg", longRef);
+
+    filter->learn(departure("11"), "Auzelg", "ojp:91011:A");
+    // Erst wenn jede Regel eine Ref hat, sonst fehlten Linien
+    TEST_ASSERT_EQUAL_size_t(0, refs(out));
+
+    filter->learn(departure("S9"), "Uster", "ojp:1:S9");     // Andere Schreibweise passt nicht
+    TEST_ASSERT_EQUAL_size_t(0, refs(out));
+    filter->learn(departure("S 9"), "Uster", "ojp:11:S9");
+    filter->learn(departure("S 9"), "Zug", "ojp:11:S9");     // Schon bekannt
+    TEST_ASSERT_EQUAL_size_t(2, refs(out));
+    TEST_ASSERT_EQUAL_STRING("ojp:91011:A", out[0]);
+    TEST_ASSERT_EQUAL_STRING("ojp:11:S9", out[1]);
+    TEST_ASSERT_NULL(out[2]);
+
+    // Zu kleiner Ausgabepuffer: lieber ungefiltert
+    TEST_ASSERT_EQUAL_size_t(0, filter->serverRefs(out, 1));
+    TEST_ASSERT_EQUAL_size_t(2, filter->serverRefs(out, 2));
+}
+
+void test_ref_overflow_disables_rule() {
+    configure("7", "");
+    const char* out[OJP_MAX_LINE_FILTER];
+
+    // Linie mehrerer Betreiber: REFS_PER_RULE Refs passen noch
+    filter->learn(departure("7"), "Stettbach", "ojp:91007:A");
+    filter->learn(departure("7"), "Wollishofen", "ojp:91007:B");
+    TEST_ASSERT_EQUAL_size_t(LineFilter::REFS_PER_RULE, refs(out));
+
+    // Eine weitere: refCount = REFS_PER_RULE + 1, die Regel ist nicht filterbar
+    filter->learn(departure("7"), "Stettbach", "ojp:85:7");
+    TEST_ASSERT_EQUAL_size_t(0, refs(out));
+    // Bekannte oder weitere Refs ändern daran nichts
+    filter->learn(departure("7"), "Stettbach", "ojp:91007:A");
+    filter->learn(departure("7"), "Stettbach", "ojp:86:7");
+    TEST_ASSERT_EQUAL_size_t(0, refs(out));
+    TEST_ASSERT_TRUE(filter->matches(departure("7"), "Stettbach"));
+
+    // Neue Konfiguration beginnt von vorne
+    configure("7", "");
+    filter->learn(departure("7"), "Stettbach", "ojp:91007:A");
+    TEST_ASSERT_EQUAL_size_t(1, refs(out));
+}
+
+void test_duplicate_refs_across_rules() {
+    // Hin- und Rückrichtung derselben Linie
+    configure("11", "Auzelg", "11", "Rehalp");
+    const char* out[OJP_MAX_LINE_FILTER];
+
+    filter->learn(departure("11"), "Auzelg", "ojp:91011:A");
+    TEST_ASSERT_EQUAL_size_t(0, refs(out));
+    filter->learn(departure("11"), "Rehalp", "ojp:91011:A");
+    TEST_ASSERT_EQUAL_size_t(1, refs(out));
+    TEST_ASSERT_EQUAL_STRING("ojp:91011:A", out[0]);
+    TEST_ASSERT_NULL(out[1]);
+
+    // Eine Ref-Variante nur in einer Richtung kommt einmal dazu
+    filter->learn(departure("11"), "Rehalp", "ojp:91011:B");
+    TEST_ASSERT_EQUAL_size_t(2, refs(out));
+    TEST_ASSERT_EQUAL_STRING("ojp:91011:B", out[1]);
+    TEST_ASSERT_EQUAL_size_t(2, filter->serverRefs(out, 2));
+}
+
+void test_empty_result_drops_refs() {
+    learnTram11();
+    const char* out[OJP_MAX_LINE_FILTER];
+
+    // Ungefilterte Antworten zählen nicht
+    filter->onResponse(false, false, 0);
+    TEST_ASSERT_EQUAL_size_t(1, refs(out));
+
+    // Gefiltert ohne Treffer: Refs weg, ungefiltert neu lernen
+    filter->onResponse(false, true, 0);
+    TEST_ASSERT_EQUAL_size_t(0, refs(out));
+    TEST_ASSERT_TRUE(filter->serverEnabled());
+    filter->learn(departure("11"), "Auzelg", "ojp:91011:A");
+    TEST_ASSERT_EQUAL_size_t(1, refs(out));
+
+    // Treffer setzen den Zähler zurück
+    filter->onResponse(false, true, 3);
+    TEST_ASSERT_EQUAL_size_t(1, refs(out));
+}
+
+void test_disabled_after_three_misses() {
+    learnTram11();
+    const char* out[OJP_MAX_LINE_FILTER];
+
+    // Zwei Fehlschläge, ein Treffer, wieder zwei: noch aktiv
+    for (int round = 0; round < 2; round++) {
+        for (uint8_t miss = 0; miss + 1 < LineFilter::MAX_SERVER_MISSES; miss++) {
+            filter->onResponse(false, true, 0);
+            filter->learn(departure("11"), "Auzelg", "ojp:91011:A");
+        }
+        TEST_ASSERT_TRUE(filter->serverEnabled());
+        filter->onResponse(false, true, 2);
+    }
+
+    for (uint8_t miss = 0; miss < LineFilter::MAX_SERVER_MISSES; miss++) {
+        TEST_ASSERT_TRUE(filter->serverEnabled());
+        filter->onResponse(false, true, 0);
+        filter->learn(departure("11"), "Auzelg", "ojp:91011:A");
+    }
+    TEST_ASSERT_FALSE(filter->serverEnabled());
+    TEST_ASSERT_EQUAL_size_t(0, refs(out));
+    // Lokal wird weiter gefiltert
+    TEST_ASSERT_TRUE(filter->matches(departure("11"), "Auzelg"));
+    TEST_ASSERT_FALSE(filter->matches(departure("32"), "Auzelg"));
+}
+
+void test_disabled_after_http_400() {
+    learnTram11();
+    const char* out[OJP_MAX_LINE_FILTER];
+
+    filter->onResponse(true, true, 0);
+    TEST_ASSERT_FALSE(filter->serverEnabled());
+    filter->learn(departure("11"), "Auzelg", "ojp:91011:A");
+    TEST_ASSERT_EQUAL_size_t(0, refs(out));
+
+    // Gilt für die ganze Sitzung, auch mit neuen Regeln
+    configure("32", "");
+    filter->learn(departure("32"), "Strassenverkehrsamt", "ojp:91032:A");
+    TEST_ASSERT_EQUAL_size_t(0, refs(out));
+    TEST_ASSERT_TRUE(filter->matches(departure("32"), "Strassenverkehrsamt"));
+}
+
+void test_planner_limits() {
+    RequestPlanner planner;
+    const int base = RequestPlanner::DEFAULT_ROWS + RequestPlanner::LOOKAHEAD_ROWS;
+    TEST_ASSERT_EQUAL_INT(base, planner.limitFor(false, false));
+    TEST_ASSERT_EQUAL_INT(base * RequestPlanner::DEFAULT_RATIO, planner.limitFor(true, false));
+    TEST_ASSERT_EQUAL_INT(DepartureList::CAPACITY, planner.limitFor(false, true));
+    TEST_ASSERT_EQUAL_INT(RequestPlanner::MAX_RESULTS, planner.limitFor(true, true));
+
+    planner.setRowCapacity(0);
+    TEST_ASSERT_EQUAL_INT(1, planner.getRowCapacity());
+    planner.setRowCapacity(6);
+    TEST_ASSERT_EQUAL_INT(10, planner.limitFor(false, false));
+}
+
+void test_planner_scales_with_ratio() {
+    RequestPlanner planner;     // 8 Zeilen inkl. Reserve, Verhältnis anfangs 3
+
+    // Gemessen 3:1 -> unverändert
+    planner.record(24, 8);
+    TEST_ASSERT_EQUAL_INT(24, planner.limitFor(true, false));
+
+    // Gemessen 2:1 -> geglättet 2.5 -> 20
+    planner.record(20, 10);
+    TEST_ASSERT_EQUAL_INT(20, planner.limitFor(true, false));
+
+    // Leere Antwort sagt nichts aus
+    planner.record(0, 0);
+    TEST_ASSERT_EQUAL_INT(20, planner.limitFor(true, false));
+
+    // Mehr behalten als empfangen gibt es nicht: höchstens 1:1
+    for (int i = 0; i < 10; i++) planner.record(5, 10);
+    TEST_ASSERT_EQUAL_INT(8, planner.limitFor(true, false));
+    TEST_ASSERT_EQUAL_INT(DepartureList::CAPACITY, planner.limitFor(true, true));
+
+    // Nichts behalten: Verhältnis steigt, das Limit bleibt bei MAX_RESULTS
+    planner.record(40, 0);
+    int limit = planner.limitFor(true, false);
+    TEST_ASSERT_GREATER_THAN(8, limit);
+    for (int i = 0; i < 10; i++) planner.record(40, 0);
+    TEST_ASSERT_EQUAL_INT(RequestPlanner::MAX_RESULTS, planner.limitFor(true, false));
+    // Ungefiltert bleibt das Limit davon unberührt
+    TEST_ASSERT_EQUAL_INT(8, planner.limitFor(false, false));
+
+    // Neue Regeln: zurück auf den Startwert
+    planner.reset();
+    TEST_ASSERT_EQUAL_INT(24, planner.limitFor(true, false));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_local_matching);
+    RUN_TEST(test_learns_refs_of_matching_departures);
+    RUN_TEST(test_ref_overflow_disables_rule);
+    RUN_TEST(test_duplicate_refs_across_rules);
+    RUN_TEST(test_empty_result_drops_refs);
+    RUN_TEST(test_disabled_after_three_misses);
+    RUN_TEST(test_disabled_after_http_400);
+    RUN_TEST(test_planner_limits);
+    RUN_TEST(test_planner_scales_with_ratio);
+    return UNITY_END();
+}
@@ -0,0 +1,232 @@
+#include <unity.h>
+#include "Transport/NetworkExecutor.h"
+#include "Transport/StopSearchCache.h"
+
+// Die Uhr wird mit hostAdvanceMillis() vorgestellt; zwischen zwei Aufrufen
+// vergehen real nur wenige Millisekunden.
+
+namespace {
+
+NetworkExecutor* executor = NULL;
+
+// Holt den nächsten Job und prüft Typ und Schlüssel
+uint32_t takeExpect(NetworkJobType type, const char* key) {
+    NetworkJob job;
+    TEST_ASSERT_TRUE(executor->take(job));
+    TEST_ASSERT_EQUAL_INT(type, job.type);
+    TEST_ASSERT_EQUAL_STRING(key, job.key.c_str());
+    return job.id;
+}
+
+LookupResultPtr makeResult(const char* stopName) {
+    std::shared_ptr<LookupResult> result(new LookupResult());
+    StopSearchResult stop;
+    stop.name = stopName;
+    result->stops.push_back(stop);
+    return result;
+}
+
+} // namespace
+
+void setUp() {
+    executor = new NetworkExecutor();
+}
+
+void tearDown() {
+    delete executor;
+    executor = NULL;
+}
+
+void test_interactive_before_background() {
+    uint32_t poll = executor->submit(JOB_POLL, String(), PRIORITY_BACKGROUND);
+    uint32_t linesA = executor->submit(JOB_LINES, "8503000", PRIORITY_BACKGROUND);
+    uint32_t search = executor->submit(JOB_STOP_SEARCH, "Bern", PRIORITY_INTERACTIVE);
+    uint32_t linesB = executor->submit(JOB_LINES, "8507000", PRIORITY_INTERACTIVE);
+    TEST_ASSERT_TRUE(poll != 0 && linesA != 0 && search != 0 && linesB != 0);
+
+    // Interaktiv zuerst, innerhalb einer Priorität der älteste
+    TEST_ASSERT_EQUAL_UINT32(search, takeExpect(JOB_STOP_SEARCH, "Bern"));
+    TEST_ASSERT_EQUAL_UINT32(linesB, takeExpect(JOB_LINES, "8507000"));
+    TEST_ASSERT_EQUAL_UINT32(poll, takeExpect(JOB_POLL, ""));
+    TEST_ASSERT_EQUAL_UINT32(linesA, takeExpect(JOB_LINES, "8503000"));
+
+    NetworkJob job;
+    TEST_ASSERT_FALSE(executor->take(job));
+}
+
+void test_coalescing_raises_priority() {
+    uint32_t poll = executor->submit(JOB_POLL, String(), PRIORITY_BACKGROUND);
+    uint32_t lines = executor->submit(JOB_LINES, "8503000", PRIORITY_BACKGROUND);
+
+    // Jemand wartet jetzt auf die Linien: überholt den älteren Poll
+    TEST_ASSERT_EQUAL_UINT32(lines, executor->submit(JOB_LINES, "8503000", PRIORITY_INTERACTIVE));
+    TEST_ASSERT_EQUAL_UINT32(lines, takeExpect(JOB_LINES, "8503000"));
+    TEST_ASSERT_EQUAL_UINT32(poll, takeExpect(JOB_POLL, ""));
+
+    // Hintergrund-Anfrage senkt die Priorität nicht wieder
+    uint32_t search = executor->submit(JOB_STOP_SEARCH, "Bern", PRIORITY_INTERACTIVE);
+    uint32_t later = executor->submit(JOB_LINES, "8507000", PRIORITY_INTERACTIVE);
+    TEST_ASSERT_EQUAL_UINT32(search, executor->submit(JOB_STOP_SEARCH, "Bern", PRIORITY_BACKGROUND));
+    TEST_ASSERT_EQUAL_UINT32(search, takeExpect(JOB_STOP_SEARCH, "Bern"));
+    TEST_ASSERT_EQUAL_UINT32(later, takeExpect(JOB_LINES, "8507000"));
+}
+
+void test_single_flight() {
+    bool created = false;
+    uint32_t first = executor->submit(JOB_STOP_SEARCH, "Bern", PRIORITY_INTERACTIVE, NULL, &created);
+    TEST_ASSERT_TRUE(created);
+
+    // Wartend: gleicher Job
+    TEST_ASSERT_EQUAL_UINT32(first, executor->submit(JOB_STOP_SEARCH, "Bern", PRIORITY_INTERACTIVE, NULL, &created));
+    TEST_ASSERT_FALSE(created);
+    TEST_ASSERT_EQUAL_UINT32(first, executor->find(JOB_STOP_SEARCH, "Bern"));
+
+    // Anderer Typ oder Schlüssel: eigener Job
+    uint32_t lines = executor->submit(JOB_LINES, "Bern", PRIORITY_INTERACTIVE, NULL, &created);
+    TEST_ASSERT_TRUE(created);
+    TEST_ASSERT_TRUE(lines != first);
+    TEST_ASSERT_EQUAL_UINT32(0, executor->find(JOB_STOP_SEARCH, "Thun"));
+
+    // Laufend: weiterhin derselbe Job, nur ein Request
+    takeExpect(JOB_STOP_SEARCH, "Bern");
+    LookupResultPtr result;
+    TEST_ASSERT_EQUAL_UINT32(first, executor->submit(JOB_STOP_SEARCH, "Bern", PRIORITY_INTERACTIVE, &result, &created));
+    TEST_ASSERT_FALSE(created);
+    TEST_ASSERT_TRUE(!result);
+
+    NetworkExecutorStats stats = executor->getStats();
+    TEST_ASSERT_EQUAL_UINT32(2, stats.submitted);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.coalesced);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.pending);
+}
+
+void test_poll_rerun_after_trigger() {
+    // Wartender Poll: neuer Auslöser hängt sich an
+    uint32_t poll = executor->submit(JOB_POLL, String(), PRIORITY_BACKGROUND);
+    TEST_ASSERT_EQUAL_UINT32(poll, executor->submit(JOB_POLL, String(), PRIORITY_BACKGROUND));
+    takeExpect(JOB_POLL, "");
+    executor->complete(poll, LookupResultPtr());
+
+    // Poll ist ohne Ergebnis sofort frei
+    TEST_ASSERT_EQUAL_UINT32(0, executor->find(JOB_POLL, String()));
+    NetworkJob job;
+    TEST_ASSERT_FALSE(executor->take(job));
+
+    // Auslöser während des Laufs: genau eine Wiederholung
+    poll = executor->submit(JOB_POLL, String(), PRIORITY_BACKGROUND);
+    takeExpect(JOB_POLL, "");
+    TEST_ASSERT_EQUAL_UINT32(poll, executor->submit(JOB_POLL, String(), PRIORITY_BACKGROUND));
+    TEST_ASSERT_EQUAL_UINT32(poll, executor->submit(JOB_POLL, String(), PRIORITY_BACKGROUND));
+    executor->complete(poll, LookupResultPtr());
+    TEST_ASSERT_EQUAL_UINT32(poll, takeExpect(JOB_POLL, ""));
+    executor->complete(poll, LookupResultPtr());
+    TEST_ASSERT_FALSE(executor->take(job));
+
+    NetworkExecutorStats stats = executor->getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rerun);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.completed);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.pending);
+}
+
+void test_result_retained_for_ttl() {
+    uint32_t id = executor->submit(JOB_STOP_SEARCH, "Bern", PRIORITY_INTERACTIVE);
+    takeExpect(JOB_STOP_SEARCH, "Bern");
+    LookupResultPtr stored = makeResult("Bern");
+    executor->complete(id, stored);
+
+    // Erneute Anfrage (Polling der Web-Oberfläche) holt das Ergebnis ab
+    LookupResultPtr result;
+    bool created = true;
+    TEST_ASSERT_EQUAL_UINT32(id, executor->submit(JOB_STOP_SEARCH, "Bern", PRIORITY_INTERACTIVE, &result, &created));
+    TEST_ASSERT_FALSE(created);
+    TEST_ASSERT_TRUE(result == stored);
+
+    hostAdvanceMillis(NetworkExecutor::RESULT_TTL_MS - 1000);
+    result.reset();
+    TEST_ASSERT_EQUAL_UINT32(id, executor->find(JOB_STOP_SEARCH, "Bern", &result));
+    TEST_ASSERT_TRUE(result == stored);
+    NetworkJob job;
+    TEST_ASSERT_FALSE(executor->take(job));
+
+    // Nach RESULT_TTL_MS ist der Platz frei, eine neue Anfrage läuft neu
+    hostAdvanceMillis(1000);
+    result.reset();
+    TEST_ASSERT_EQUAL_UINT32(0, executor->find(JOB_STOP_SEARCH, "Bern", &result));
+    TEST_ASSERT_TRUE(!result);
+    uint32_t again = executor->submit(JOB_STOP_SEARCH, "Bern", PRIORITY_INTERACTIVE, &result, &created);
+    TEST_ASSERT_TRUE(created);
+    TEST_ASSERT_TRUE(again != id);
+    TEST_ASSERT_TRUE(!result);
+    // Das alte Ergebnis wird nur noch vom Test gehalten
+    TEST_ASSERT_EQUAL_INT(1, (int)stored.use_count());
+}
+
+void test_cancel_superseded_searches() {
+    // Tipp-Stände einer Eingabe, dazu eine fremde Suche und eine Linienabfrage
+    uint32_t running = executor->submit(JOB_STOP_SEARCH, "B", PRIORITY_INTERACTIVE);
+    takeExpect(JOB_STOP_SEARCH, "B");
+    executor->submit(JOB_STOP_SEARCH, "Be", PRIORITY_INTERACTIVE);
+    executor->submit(JOB_STOP_SEARCH, "ber", PRIORITY_INTERACTIVE);
+    executor->submit(JOB_STOP_SEARCH, "Bernx", PRIORITY_INTERACTIVE);
+    uint32_t other = executor->submit(JOB_STOP_SEARCH, "Thun", PRIORITY_INTERACTIVE);
+    uint32_t lines = executor->submit(JOB_LINES, "Be", PRIORITY_INTERACTIVE);
+    uint32_t current = executor->submit(JOB_STOP_SEARCH, "Bern", PRIORITY_INTERACTIVE);
+
+    // Präfixe und Verlängerungen (normalisiert) fallen weg, der laufende Job bleibt
+    TEST_ASSERT_EQUAL_size_t(3, executor->cancel(JOB_STOP_SEARCH, "Bern", StopSearchCache::supersedes));
+    TEST_ASSERT_EQUAL_UINT32(0, executor->find(JOB_STOP_SEARCH, "Be"));
+    TEST_ASSERT_EQUAL_UINT32(0, executor->find(JOB_STOP_SEARCH, "ber"));
+    TEST_ASSERT_EQUAL_UINT32(0, executor->find(JOB_STOP_SEARCH, "Bernx"));
+    TEST_ASSERT_EQUAL_UINT32(running, executor->find(JOB_STOP_SEARCH, "B"));
+
+    TEST_ASSERT_EQUAL_UINT32(other, takeExpect(JOB_STOP_SEARCH, "Thun"));
+    TEST_ASSERT_EQUAL_UINT32(lines, takeExpect(JOB_LINES, "Be"));
+    TEST_ASSERT_EQUAL_UINT32(current, takeExpect(JOB_STOP_SEARCH, "Bern"));
+    NetworkJob job;
+    TEST_ASSERT_FALSE(executor->take(job));
+
+    NetworkExecutorStats stats = executor->getStats();
+    TEST_ASSERT_EQUAL_UINT32(3, stats.cancelled);
+    TEST_ASSERT_EQUAL_UINT32(4, stats.pending);
+}
+
+void test_full_table_rejects() {
+    char key[8];
+    for (size_t i = 0; i < NetworkExecutor::MAX_JOBS; i++) {
+        snprintf(key, sizeof(key), "%u", (unsigned)i);
+        TEST_ASSERT_TRUE(executor->submit(JOB_LINES, key, PRIORITY_BACKGROUND) != 0);
+    }
+
+    // Kein Platz: 0 (Web-Handler antwortet 503), kein Job angelegt
+    bool created = true;
+    TEST_ASSERT_EQUAL_UINT32(0, executor->submit(JOB_STOP_SEARCH, "Bern", PRIORITY_INTERACTIVE, NULL, &created));
+    TEST_ASSERT_FALSE(created);
+    TEST_ASSERT_EQUAL_UINT32(1, executor->getStats().rejected);
+
+    // Anhängen an einen vorhandenen Job geht weiterhin
+    TEST_ASSERT_TRUE(executor->submit(JOB_LINES, "3", PRIORITY_INTERACTIVE) != 0);
+
+    // Fertige Ergebnisse belegen ihren Platz bis zum Ablauf der TTL
+    NetworkJob job;
+    TEST_ASSERT_TRUE(executor->take(job));
+    executor->complete(job.id, makeResult("x"));
+    TEST_ASSERT_EQUAL_UINT32(0, executor->submit(JOB_STOP_SEARCH, "Bern", PRIORITY_INTERACTIVE));
+    hostAdvanceMillis(NetworkExecutor::RESULT_TTL_MS);
+    TEST_ASSERT_TRUE(executor->submit(JOB_STOP_SEARCH, "Bern", PRIORITY_INTERACTIVE) != 0);
+
+    NetworkExecutorStats stats = executor->getStats();
+    TEST_ASSERT_EQUAL_UINT32(2, stats.rejected);
+    TEST_ASSERT_EQUAL_UINT32(NetworkExecutor::MAX_JOBS, stats.pending);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_interactive_before_background);
+    RUN_TEST(test_coalescing_raises_priority);
+    RUN_TEST(test_single_flight);
+    RUN_TEST(test_poll_rerun_after_trigger);
+    RUN_TEST(test_result_retained_for_ttl);
+    RUN_TEST(test_cancel_superseded_searches);
+    RUN_TEST(test_full_table_rejects);
+    return UNITY_END();
+}
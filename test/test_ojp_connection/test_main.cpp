@@ -0,0 +1,231 @@
+#include <unity.h>
+#include "Transport/OjpConnection.h"
+
+// Netzwerk, TLS und HTTP kommen aus den Ersatz-Headern in test/support
+// (hostWiFi(), hostTls(), hostHttp()); die Uhr wird mit hostAdvanceMillis()
+// vorgestellt. Session Resumption gibt es im Core nicht, sie wird nicht getestet.
+
+namespace {
+
+const char* const HOST = "api.opentransportdata.swiss";
+const char* const BODY = "<OJP/>";
+const unsigned long IDLE_TIMEOUT_MS = 55000;    // Wie OjpConnection
+const unsigned long DNS_TTL_MS = 600000;
+
+// Sammelt die Antwort wie der Parser-Stream
+class SinkStream : public Stream {
+public:
+    size_t write(uint8_t c) override { data += (char)c; return 1; }
+    size_t write(const uint8_t* buffer, size_t size) override { data.concat((const char*)buffer, size); return size; }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+
+    String data;
+};
+
+OjpConnection* connection = NULL;
+
+int post(int* writtenOut = NULL) {
+    SinkStream sink;
+    int written = -1;
+    int code = connection->post((const uint8_t*)BODY, strlen(BODY), sink, written);
+    if (writtenOut) *writtenOut = written;
+    if (code == HTTP_CODE_OK) TEST_ASSERT_EQUAL_STRING(hostHttp().response.c_str(), sink.data.c_str());
+    return code;
+}
+
+} // namespace
+
+void setUp() {
+    hostTls() = HostTlsState();
+    hostHttp() = HostHttpState();
+    hostHttp().response = "<OJPResponse/>";
+    hostWiFi().dnsOk = true;
+    hostWiFi().dnsAddress = IPAddress(10, 0, 0, 1);
+    hostWiFi().dnsQueries = 0;
+    connection = new OjpConnection(HOST, "/ojp20", "secret");
+}
+
+void tearDown() {
+    delete connection;
+    connection = NULL;
+}
+
+void test_first_post_connects() {
+    int written = 0;
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post(&written));
+    TEST_ASSERT_EQUAL_INT((int)hostHttp().response.length(), written);
+    TEST_ASSERT_EQUAL_STRING(BODY, hostHttp().lastBody.c_str());
+    TEST_ASSERT_EQUAL_STRING("Bearer secret", hostHttp().lastAuthorization.c_str());
+
+    // Verbunden per gecachter IP, Hostname als SNI
+    TEST_ASSERT_EQUAL_UINT32(1, hostTls().connects);
+    TEST_ASSERT_TRUE(hostTls().address == IPAddress(10, 0, 0, 1));
+    TEST_ASSERT_EQUAL_STRING(HOST, hostTls().sniHost.c_str());
+    TEST_ASSERT_TRUE(hostTls().open);
+
+    OjpConnectionStats stats = connection->getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.requests);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.handshakes);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.dnsLookups);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.reconnects);
+}
+
+void test_keep_alive_until_idle_timeout() {
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+
+    // Knapp unter dem Idle-Timeout: dieselbe Verbindung
+    hostAdvanceMillis(IDLE_TIMEOUT_MS - 1000);
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+    TEST_ASSERT_EQUAL_UINT32(1, hostTls().connects);
+    TEST_ASSERT_EQUAL_UINT32(0, hostTls().stops);
+
+    // Gemessen ab dem letzten Request, nicht ab dem Handshake
+    hostAdvanceMillis(IDLE_TIMEOUT_MS - 1000);
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+    TEST_ASSERT_EQUAL_UINT32(1, hostTls().connects);
+
+    // Idle-Timeout abgelaufen: schliessen und neu verbinden, ohne Fehlversuch
+    hostAdvanceMillis(IDLE_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+    TEST_ASSERT_EQUAL_UINT32(2, hostTls().connects);
+    TEST_ASSERT_EQUAL_UINT32(1, hostTls().stops);
+    TEST_ASSERT_EQUAL_UINT32(0, hostHttp().failedPosts);
+
+    OjpConnectionStats stats = connection->getStats();
+    TEST_ASSERT_EQUAL_UINT32(4, stats.requests);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.handshakes);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.reconnects);
+}
+
+void test_connection_close_from_server() {
+    hostHttp().closeAfter = true;
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+    TEST_ASSERT_FALSE(hostTls().open);
+
+    hostHttp().closeAfter = false;
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+    TEST_ASSERT_EQUAL_UINT32(2, hostTls().connects);
+    TEST_ASSERT_EQUAL_UINT32(0, connection->getStats().reconnects);
+}
+
+void test_single_retry_on_reused_connection() {
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+
+    // Server hat die Keep-Alive-Verbindung inzwischen geschlossen
+    hostTls().stale = true;
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+    TEST_ASSERT_EQUAL_UINT32(1, hostHttp().failedPosts);
+    TEST_ASSERT_EQUAL_UINT32(2, hostHttp().posts);
+    TEST_ASSERT_EQUAL_UINT32(2, hostTls().connects);
+
+    OjpConnectionStats stats = connection->getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.reconnects);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.handshakes);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.requests);       // Fehlversuch zählt nicht
+}
+
+void test_retry_gives_up_after_one_reconnect() {
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+
+    // Tote Verbindung und der neue Handshake scheitert: kein dritter Versuch
+    hostTls().stale = true;
+    hostTls().refuse = true;
+    TEST_ASSERT_EQUAL_INT(HTTPC_ERROR_CONNECTION_LOST, post());
+    TEST_ASSERT_EQUAL_UINT32(1, hostHttp().failedPosts);
+    TEST_ASSERT_EQUAL_UINT32(1, hostHttp().posts);
+    TEST_ASSERT_FALSE(hostTls().open);
+    TEST_ASSERT_EQUAL_UINT32(1, connection->getStats().reconnects);
+
+    // Frische Verbindung, die nicht zustande kommt: nicht wiederholen
+    TEST_ASSERT_EQUAL_INT(HTTPC_ERROR_CONNECTION_REFUSED, post());
+    TEST_ASSERT_EQUAL_UINT32(1, connection->getStats().reconnects);
+    TEST_ASSERT_EQUAL_UINT32(1, hostHttp().posts);
+
+    hostTls().refuse = false;
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+    TEST_ASSERT_EQUAL_UINT32(2, hostTls().connects);
+}
+
+void test_http_error_keeps_connection() {
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+
+    hostHttp().status = HTTP_CODE_BAD_REQUEST;
+    int written = -1;
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_BAD_REQUEST, post(&written));
+    TEST_ASSERT_EQUAL_INT(0, written);                  // Antwort nicht gelesen
+    TEST_ASSERT_TRUE(hostTls().open);
+
+    hostHttp().status = HTTP_CODE_OK;
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+    TEST_ASSERT_EQUAL_UINT32(1, hostTls().connects);
+    TEST_ASSERT_EQUAL_UINT32(3, connection->getStats().requests);
+}
+
+void test_dns_cache_expiry() {
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+    TEST_ASSERT_EQUAL_UINT32(1, hostWiFi().dnsQueries);
+
+    // Neue Handshakes innerhalb der TTL nehmen die gecachte IP
+    hostWiFi().dnsAddress = IPAddress(10, 0, 0, 2);
+    hostAdvanceMillis(IDLE_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+    connection->close();
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+    TEST_ASSERT_EQUAL_UINT32(3, hostTls().connects);
+    TEST_ASSERT_EQUAL_UINT32(1, hostWiFi().dnsQueries);
+    TEST_ASSERT_TRUE(hostTls().address == IPAddress(10, 0, 0, 1));
+
+    // Nach der TTL wird beim nächsten Handshake neu aufgelöst
+    hostAdvanceMillis(DNS_TTL_MS);
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+    TEST_ASSERT_EQUAL_UINT32(2, hostWiFi().dnsQueries);
+    TEST_ASSERT_TRUE(hostTls().address == IPAddress(10, 0, 0, 2));
+
+    // Eine offen gehaltene Verbindung überlebt die TTL ohne DNS und Handshake
+    for (int i = 0; i < 15; i++) {
+        hostAdvanceMillis(IDLE_TIMEOUT_MS - 5000);
+        TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+    }
+    TEST_ASSERT_EQUAL_UINT32(4, hostTls().connects);
+    TEST_ASSERT_EQUAL_UINT32(2, hostWiFi().dnsQueries);
+    TEST_ASSERT_EQUAL_UINT32(2, connection->getStats().dnsLookups);
+}
+
+void test_failed_connect_resolves_again() {
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+    connection->close();
+
+    // IP könnte sich geändert haben: nach einem gescheiterten Connect neu auflösen,
+    // auch innerhalb der TTL
+    hostTls().refuse = true;
+    TEST_ASSERT_EQUAL_INT(HTTPC_ERROR_CONNECTION_REFUSED, post());
+    TEST_ASSERT_EQUAL_UINT32(1, hostWiFi().dnsQueries);
+    hostTls().refuse = false;
+    hostWiFi().dnsAddress = IPAddress(10, 0, 0, 3);
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post());
+    TEST_ASSERT_EQUAL_UINT32(2, hostWiFi().dnsQueries);
+    TEST_ASSERT_TRUE(hostTls().address == IPAddress(10, 0, 0, 3));
+
+    // DNS schlägt fehl: kein Handshake
+    connection->close();
+    hostAdvanceMillis(DNS_TTL_MS);
+    hostWiFi().dnsOk = false;
+    TEST_ASSERT_EQUAL_INT(HTTPC_ERROR_CONNECTION_REFUSED, post());
+    TEST_ASSERT_EQUAL_UINT32(2, hostTls().connects);
+    TEST_ASSERT_EQUAL_UINT32(2, connection->getStats().dnsLookups);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_post_connects);
+    RUN_TEST(test_keep_alive_until_idle_timeout);
+    RUN_TEST(test_connection_close_from_server);
+    RUN_TEST(test_single_retry_on_reused_connection);
+    RUN_TEST(test_retry_gives_up_after_one_reconnect);
+    RUN_TEST(test_http_error_keeps_connection);
+    RUN_TEST(test_dns_cache_expiry);
+    RUN_TEST(test_failed_connect_resolves_again);
+    return UNITY_END();
+}
@@ -0,0 +1,213 @@
+// OJP 2.0 StopEventResponses im Format von api.opentransportdata.swiss/ojp20,
+// gekürzt (weniger Resultate, PreviousCall/OnwardCall und Places nur
+// stichprobenweise) und mit festen Zeitstempeln.
+
+#pragma once
+
+// Eine Haltestelle, mit allem, was die Parser überspringen müssen:
+// PreviousCall vor ThisCall, Places, Mode/Name/Text, Kommentare, Entities.
+static const char STOP_EVENT_SINGLE[] = R"OJP(<?xml version="1.0" encoding="UTF-8"?>
+<OJP xmlns="http://www.vdv.de/ojp" xmlns:siri="http://www.siri.org.uk/siri" version="2.0">
+  <OJPResponse>
+    <siri:ServiceDelivery>
+      <siri:ResponseTimestamp>2026-02-04T10:00:01Z</siri:ResponseTimestamp>
+      <siri:ProducerRef>EFAController10.6.21.14-OJP-EFA01-P</siri:ProducerRef>
+      <OJPStopEventDelivery>
+        <siri:ResponseTimestamp>2026-02-04T10:00:01Z</siri:ResponseTimestamp>
+        <siri:RequestMessageRef>StopEvent1</siri:RequestMessageRef>
+        <siri:DefaultLanguage>de</siri:DefaultLanguage>
+        <CalcTime>48</CalcTime>
+        <StopEventResponseContext>
+          <Places>
+            <Place>
+              <StopPlace>
+                <StopPlaceRef>8591382</StopPlaceRef>
+                <StopPlaceName><Text xml:lang="de">Z&#252;rich, Sihlquai/HB</Text></StopPlaceName>
+              </StopPlace>
+            </Place>
+          </Places>
+        </StopEventResponseContext>
+        <StopEventResult>
+          <Id>ID-5D0C4F2A-1</Id>
+          <StopEvent>
+            <PreviousCall>
+              <CallAtStop>
+                <siri:StopPointRef>8591435</siri:StopPointRef>
+                <StopPointName><Text xml:lang="de">Z&#252;rich, Limmatplatz</Text></StopPointName>
+                <ServiceDeparture>
+                  <TimetabledTime>2026-02-04T10:02:00Z</TimetabledTime>
+                </ServiceDeparture>
+              </CallAtStop>
+            </PreviousCall>
+            <ThisCall>
+              <CallAtStop>
+                <siri:StopPointRef>ch:1:sloid:91382:0:2</siri:StopPointRef>
+                <StopPointName><Text xml:lang="de">Z&#252;rich, Sihlquai/HB</Text></StopPointName>
+                <PlannedQuay><Text xml:lang="de">B</Text></PlannedQuay>
+                <ServiceArrival>
+                  <TimetabledTime>2026-02-04T10:03:00Z</TimetabledTime>
+                </ServiceArrival>
+                <ServiceDeparture>
+                  <TimetabledTime>2026-02-04T10:03:00Z</TimetabledTime>
+                  <EstimatedTime>2026-02-04T10:04:12Z</EstimatedTime>
+                </ServiceDeparture>
+                <Order>9</Order>
+              </CallAtStop>
+            </ThisCall>
+            <Service>
+              <OperatingDayRef>2026-02-04</OperatingDayRef>
+              <JourneyRef>ch:1:sjyid:100001:13073-001</JourneyRef>
+              <PublicCode>4</PublicCode>
+              <siri:LineRef>ojp:91004:A</siri:LineRef>
+              <siri:DirectionRef>H</siri:DirectionRef>
+              <Mode>
+                <PtMode>tram</PtMode>
+                <siri:TramSubmode>cityTram</siri:TramSubmode>
+                <Name><Text xml:lang="de">Tram</Text></Name>
+                <ShortName><Text xml:lang="de">T</Text></ShortName>
+              </Mode>
+              <PublishedServiceName><Text xml:lang="de">4</Text></PublishedServiceName>
+              <TrainNumber>13073</TrainNumber>
+              <OriginText><Text xml:lang="de">Z&#252;rich, Werdh&#246;lzli</Text></OriginText>
+              <siri:OperatorRef>3849</siri:OperatorRef>
+              <DestinationStopPointRef>8591358</DestinationStopPointRef>
+              <DestinationText><Text xml:lang="de">Z&#252;rich, Tiefenbrunnen</Text></DestinationText>
+            </Service>
+          </StopEvent>
+        </StopEventResult>
+        <!-- Ersatzbus: Zeiten direkt unter ThisCall, Linie ohne Text-Element -->
+        <StopEventResult>
+          <Id>ID-5D0C4F2A-2</Id>
+          <StopEvent>
+            <ThisCall>
+              <ServiceDeparture>
+                <TimetabledTime>2026-02-04T11:07:00+01:00</TimetabledTime>
+              </ServiceDeparture>
+            </ThisCall>
+            <Service>
+              <siri:LineRef>ojp:91046:H</siri:LineRef>
+              <Mode><PtMode>bus</PtMode></Mode>
+              <PublishedServiceName>46</PublishedServiceName>
+              <DestinationText><Text xml:lang="de">Z&#252;rich, R&#252;tihof</Text></DestinationText>
+            </Service>
+          </StopEvent>
+        </StopEventResult>
+        <StopEventResult>
+          <Id>ID-5D0C4F2A-3</Id>
+          <StopEvent>
+            <ThisCall>
+              <CallAtStop>
+                <siri:StopPointRef>ch:1:sloid:91382:0:1</siri:StopPointRef>
+                <ServiceDeparture>
+                  <TimetabledTime>2026-02-04T10:11:00Z</TimetabledTime>
+                  <EstimatedTime>2026-02-04T10:11:00Z</EstimatedTime>
+                </ServiceDeparture>
+              </CallAtStop>
+            </ThisCall>
+            <OnwardCall>
+              <CallAtStop>
+                <siri:StopPointRef>8591245</siri:StopPointRef>
+                <ServiceDeparture>
+                  <TimetabledTime>2026-02-04T10:13:00Z</TimetabledTime>
+                </ServiceDeparture>
+              </CallAtStop>
+            </OnwardCall>
+            <Service>
+              <siri:LineRef>ojp:91013:A</siri:LineRef>
+              <Mode><PtMode>tram</PtMode></Mode>
+              <PublishedServiceName><Text xml:lang="de">13</Text></PublishedServiceName>
+              <DestinationText><Text xml:lang="de">Z&#252;rich, Frankental</Text></DestinationText>
+            </Service>
+          </StopEvent>
+        </StopEventResult>
+        <StopEventResult>
+          <Id>ID-5D0C4F2A-4</Id>
+          <StopEvent>
+            <ThisCall>
+              <CallAtStop>
+                <siri:StopPointRef>8503000</siri:StopPointRef>
+                <ServiceDeparture>
+                  <TimetabledTime>2026-02-04T10:16:00Z</TimetabledTime>
+                </ServiceDeparture>
+              </CallAtStop>
+            </ThisCall>
+            <Service>
+              <siri:LineRef>ojp:91017:H</siri:LineRef>
+              <Mode><PtMode>rail</PtMode><Name><Text xml:lang="de">Zug</Text></Name></Mode>
+              <PublishedServiceName><Text xml:lang="de">S17</Text></PublishedServiceName>
+              <DestinationText><Text xml:lang="de">Dietikon &amp; Widen</Text></DestinationText>
+            </Service>
+          </StopEvent>
+        </StopEventResult>
+        <!-- Ohne Zeiten: wird von beiden Parsern verworfen -->
+        <StopEventResult>
+          <Id>ID-5D0C4F2A-5</Id>
+          <StopEvent>
+            <ThisCall><CallAtStop><siri:StopPointRef>8591382</siri:StopPointRef></CallAtStop></ThisCall>
+            <Service>
+              <PublishedServiceName><Text xml:lang="de">N4</Text></PublishedServiceName>
+            </Service>
+          </StopEvent>
+        </StopEventResult>
+      </OJPStopEventDelivery>
+    </siri:ServiceDelivery>
+  </OJPResponse>
+</OJP>
+)OJP";
+
+// Gebündelter Request für drei Haltestellen (user-008): Deliveries in anderer
+// Reihenfolge als angefragt, eine vierte Delivery gehört zu keiner Haltestelle.
+static const char STOP_EVENT_BUNDLED[] = R"OJP(<?xml version="1.0" encoding="UTF-8"?>
+<siri:OJP xmlns:siri="http://www.siri.org.uk/siri" xmlns:ojp="http://www.vdv.de/ojp" version="2.0">
+<siri:OJPResponse><siri:ServiceDelivery>
+<siri:ResponseTimestamp>2026-02-04T22:58:00Z</siri:ResponseTimestamp>
+<ojp:OJPStopEventDelivery>
+<siri:RequestMessageRef>StopEvent3</siri:RequestMessageRef>
+<ojp:StopEventResult><ojp:StopEvent>
+<ojp:ThisCall><ojp:CallAtStop><ojp:ServiceDeparture><ojp:TimetabledTime>2026-02-04T23:04:00Z</ojp:TimetabledTime></ojp:ServiceDeparture></ojp:CallAtStop></ojp:ThisCall>
+<ojp:Service><siri:LineRef>ojp:92001:H</siri:LineRef><ojp:Mode><ojp:PtMode>rail</ojp:PtMode></ojp:Mode><ojp:PublishedServiceName><ojp:Text>IC1</ojp:Text></ojp:PublishedServiceName><ojp:DestinationText><ojp:Text>Gen&#232;ve-A&#233;roport</ojp:Text></ojp:DestinationText></ojp:Service>
+</ojp:StopEvent></ojp:StopEventResult>
+</ojp:OJPStopEventDelivery>
+<ojp:OJPStopEventDelivery>
+<siri:RequestMessageRef>StopEvent1</siri:RequestMessageRef>
+<ojp:StopEventResult><ojp:StopEvent>
+<ojp:ThisCall><ojp:CallAtStop><ojp:ServiceDeparture><ojp:TimetabledTime>2026-02-04T22:59:00Z</ojp:TimetabledTime><ojp:EstimatedTime>2026-02-04T23:01:30Z</ojp:EstimatedTime></ojp:ServiceDeparture></ojp:CallAtStop></ojp:ThisCall>
+<ojp:Service><ojp:Mode><ojp:PtMode>tram</ojp:PtMode></ojp:Mode><ojp:PublishedServiceName><ojp:Text>10</ojp:Text></ojp:PublishedServiceName><ojp:DestinationText><ojp:Text>Dornach, Bahnhof</ojp:Text></ojp:DestinationText></ojp:Service>
+</ojp:StopEvent></ojp:StopEventResult>
+<ojp:StopEventResult><ojp:StopEvent>
+<ojp:ThisCall><ojp:CallAtStop><ojp:ServiceDeparture><ojp:TimetabledTime>2026-02-04T23:05:00Z</ojp:TimetabledTime></ojp:ServiceDeparture></ojp:CallAtStop></ojp:ThisCall>
+<ojp:Service><ojp:Mode><ojp:PtMode>tram</ojp:PtMode></ojp:Mode><ojp:PublishedServiceName><ojp:Text>11</ojp:Text></ojp:PublishedServiceName><ojp:DestinationText><ojp:Text>Aesch BL, Dorf</ojp:Text></ojp:DestinationText></ojp:Service>
+</ojp:StopEvent></ojp:StopEventResult>
+<ojp:StopEventResult><ojp:StopEvent>
+<ojp:ThisCall><ojp:CallAtStop><ojp:ServiceDeparture><ojp:TimetabledTime>2026-02-05T00:01:00+01:00</ojp:TimetabledTime></ojp:ServiceDeparture></ojp:CallAtStop></ojp:ThisCall>
+<ojp:Service><ojp:Mode><ojp:PtMode>bus</ojp:PtMode></ojp:Mode><ojp:PublishedServiceName><ojp:Text>N10</ojp:Text></ojp:PublishedServiceName><ojp:DestinationText><ojp:Text>Dornach, Bahnhof</ojp:Text></ojp:DestinationText></ojp:Service>
+</ojp:StopEvent></ojp:StopEventResult>
+</ojp:OJPStopEventDelivery>
+<ojp:OJPStopEventDelivery>
+<siri:RequestMessageRef>StopEvent2</siri:RequestMessageRef>
+</ojp:OJPStopEventDelivery>
+<ojp:OJPStopEventDelivery>
+<siri:RequestMessageRef>StopEvent4</siri:RequestMessageRef>
+<ojp:StopEventResult><ojp:StopEvent>
+<ojp:ThisCall><ojp:CallAtStop><ojp:ServiceDeparture><ojp:TimetabledTime>2026-02-04T23:10:00Z</ojp:TimetabledTime></ojp:ServiceDeparture></ojp:CallAtStop></ojp:ThisCall>
+<ojp:Service><ojp:PublishedServiceName><ojp:Text>99</ojp:Text></ojp:PublishedServiceName></ojp:Service>
+</ojp:StopEvent></ojp:StopEventResult>
+</ojp:OJPStopEventDelivery>
+</siri:ServiceDelivery></siri:OJPResponse>
+</siri:OJP>
+)OJP";
+
+// Fehlerantwort des Servers: gültiges XML, aber keine OJPStopEventDelivery
+static const char STOP_EVENT_ERROR[] = R"OJP(<?xml version="1.0" encoding="UTF-8"?>
+<OJP xmlns="http://www.vdv.de/ojp" xmlns:siri="http://www.siri.org.uk/siri" version="2.0">
+  <OJPResponse>
+    <siri:ServiceDelivery>
+      <siri:ResponseTimestamp>2026-02-04T10:00:01Z</siri:ResponseTimestamp>
+      <siri:ErrorCondition>
+        <siri:OtherError/>
+        <siri:Description>STOPEVENT_LOCATIONUNSERVED</siri:Description>
+      </siri:ErrorCondition>
+    </siri:ServiceDelivery>
+  </OJPResponse>
+</OJP>
+)OJP";
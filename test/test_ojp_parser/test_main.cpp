@@ -0,0 +1,313 @@
+#include <unity.h>
+#include "Transport/OjpParser.h"
+#include "Transport/OjpStreamParser.h"
+#include "Transport/OjpPath.h"
+#include <tinyxml2.h>
+#include <chrono>
+#include "responses.h"
+
+namespace {
+
+const size_t STOPS = 3;
+
+DepartureList dom[STOPS];
+DepartureList stream[STOPS];
+
+void clearLists() {
+    for (size_t i = 0; i < STOPS; i++) {
+        dom[i].clear();
+        stream[i].clear();
+    }
+}
+
+// Füttert den Stream-Parser in Chunks von `chunk` Bytes (0 = alles auf einmal)
+bool parseStream(const char* xml, size_t chunk) {
+    OjpStreamParser parser([](size_t stop, const Departure& dep, const char* direction, const char*) {
+        if (stop < STOPS) stream[stop].add(dep, direction);
+    });
+    size_t len = strlen(xml);
+    if (chunk == 0) chunk = len;
+    for (size_t pos = 0; pos < len; pos += chunk) {
+        parser.feed(xml + pos, len - pos < chunk ? len - pos : chunk);
+    }
+    return parser.finish();
+}
+
+void assertSameDepartures() {
+    for (size_t stop = 0; stop < STOPS; stop++) {
+        TEST_ASSERT_EQUAL_UINT32(dom[stop].size(), stream[stop].size());
+        for (size_t i = 0; i < dom[stop].size(); i++) {
+            const Departure& a = dom[stop][i];
+            const Departure& b = stream[stop][i];
+            TEST_ASSERT_EQUAL_STRING(a.line, b.line);
+            TEST_ASSERT_EQUAL_INT32((int32_t)a.departureTime, (int32_t)b.departureTime);
+            TEST_ASSERT_EQUAL_INT32((int32_t)a.estimatedTime, (int32_t)b.estimatedTime);
+            TEST_ASSERT_EQUAL_INT(a.mode, b.mode);
+            TEST_ASSERT_EQUAL_STRING(dom[stop].direction(a), stream[stop].direction(b));
+        }
+    }
+}
+
+// DOM-Referenz gegen den Stream-Parser bei verschiedenen Chunk-Grössen
+void assertParsersAgree(const char* xml) {
+    static const size_t CHUNKS[] = { 1, 7, 64, 1460, 0 };
+    for (size_t c = 0; c < sizeof(CHUNKS) / sizeof(CHUNKS[0]); c++) {
+        clearLists();
+        TEST_ASSERT_TRUE(OjpParser::parseResponse(String(xml), dom, STOPS));
+        TEST_ASSERT_TRUE(parseStream(xml, CHUNKS[c]));
+        assertSameDepartures();
+    }
+}
+
+// Zeitzone des Panels als POSIX-Regel (braucht keine tzdata auf dem Host)
+const char* ZURICH_TZ = "CET-1CEST,M3.5.0,M10.5.0/3";
+
+time_t utc(int year, int month, int day, int hour, int minute, int second) {
+    struct tm tm = {};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    tm.tm_sec = second;
+    return timegm(&tm);
+}
+
+// Lokalzeit wie in den OJP-Antworten: "2026-03-29T03:00:00+02:00" bzw. "+0200"
+void formatLocal(time_t t, bool colon, char* out, size_t size) {
+    struct tm local;
+    localtime_r(&t, &local);
+    long offset = local.tm_gmtoff;
+    char sign = offset < 0 ? '-' : '+';
+    if (offset < 0) offset = -offset;
+    size_t len = strftime(out, size, "%Y-%m-%dT%H:%M:%S", &local);
+    snprintf(out + len, size - len, colon ? "%c%02ld:%02ld" : "%c%02ld%02ld",
+             sign, offset / 3600, offset / 60 % 60);
+}
+
+} // namespace
+
+void setUp() {
+    clearLists();
+}
+
+void tearDown() {}
+
+void test_single_stop_matches() {
+    assertParsersAgree(STOP_EVENT_SINGLE);
+}
+
+void test_single_stop_values() {
+    TEST_ASSERT_TRUE(OjpParser::parseResponse(String(STOP_EVENT_SINGLE), dom, STOPS));
+    // Das Resultat ohne Zeiten fehlt, PreviousCall/OnwardCall überschreiben nichts
+    TEST_ASSERT_EQUAL_UINT32(4, dom[0].size());
+    TEST_ASSERT_EQUAL_UINT32(0, dom[1].size());
+
+    TEST_ASSERT_EQUAL_STRING("4", dom[0][0].line);
+    TEST_ASSERT_EQUAL_INT32(1770199380, (int32_t)dom[0][0].departureTime);
+    TEST_ASSERT_EQUAL_INT32(1770199452, (int32_t)dom[0][0].estimatedTime);
+    TEST_ASSERT_EQUAL_INT(PT_MODE_TRAM, dom[0][0].mode);
+    TEST_ASSERT_EQUAL_STRING("Z\xC3\xBCrich, Tiefenbrunnen", dom[0].direction(dom[0][0]));
+
+    // Fallback ThisCall/ServiceDeparture, Zeit mit Offset, Linie ohne Text-Element
+    TEST_ASSERT_EQUAL_STRING("46", dom[0][1].line);
+    TEST_ASSERT_EQUAL_INT32(1770199620, (int32_t)dom[0][1].departureTime);
+    TEST_ASSERT_EQUAL_INT32(0, (int32_t)dom[0][1].estimatedTime);
+    TEST_ASSERT_EQUAL_INT(PT_MODE_BUS, dom[0][1].mode);
+
+    TEST_ASSERT_EQUAL_STRING("Dietikon & Widen", dom[0].direction(dom[0][3]));
+}
+
+void test_bundled_matches() {
+    assertParsersAgree(STOP_EVENT_BUNDLED);
+}
+
+void test_bundled_values() {
+    TEST_ASSERT_TRUE(OjpParser::parseResponse(String(STOP_EVENT_BUNDLED), dom, STOPS));
+    // StopEvent1 -> 0, StopEvent2 (leer) -> 1, StopEvent3 -> 2, StopEvent4 verworfen
+    TEST_ASSERT_EQUAL_UINT32(3, dom[0].size());
+    TEST_ASSERT_EQUAL_UINT32(0, dom[1].size());
+    TEST_ASSERT_EQUAL_UINT32(1, dom[2].size());
+
+    TEST_ASSERT_EQUAL_STRING("10", dom[0][0].line);
+    TEST_ASSERT_EQUAL_INT32(1770245940, (int32_t)dom[0][0].departureTime);
+    TEST_ASSERT_EQUAL_INT32(1770246090, (int32_t)dom[0][0].estimatedTime);
+    TEST_ASSERT_EQUAL_STRING("N10", dom[0][2].line);
+    TEST_ASSERT_EQUAL_INT32(1770246060, (int32_t)dom[0][2].departureTime);
+
+    TEST_ASSERT_EQUAL_STRING("IC1", dom[2][0].line);
+    TEST_ASSERT_EQUAL_INT32(1770246240, (int32_t)dom[2][0].departureTime);
+    TEST_ASSERT_EQUAL_INT(PT_MODE_RAIL, dom[2][0].mode);
+}
+
+// Der DOM-Parser meldet die fehlende Delivery als Fehler, der Stream-Parser
+// sieht ein gültiges Dokument ohne Abfahrten
+void test_error_response_has_no_departures() {
+    TEST_ASSERT_FALSE(OjpParser::parseResponse(String(STOP_EVENT_ERROR), dom, STOPS));
+    TEST_ASSERT_TRUE(parseStream(STOP_EVENT_ERROR, 64));
+    for (size_t i = 0; i < STOPS; i++) {
+        TEST_ASSERT_EQUAL_UINT32(0, stream[i].size());
+    }
+}
+
+void test_truncated_response_fails() {
+    // Abbruch mitten im dritten StopEventResult
+    String full(STOP_EVENT_SINGLE);
+    String truncated = full.substring(0, full.indexOf("ID-5D0C4F2A-3"));
+    TEST_ASSERT_FALSE(OjpParser::parseResponse(truncated, dom, STOPS));
+    TEST_ASSERT_FALSE(parseStream(truncated.c_str(), 64));
+}
+
+void test_tag_is_cached_on_element() {
+    tinyxml2::XMLDocument doc;
+    TEST_ASSERT_EQUAL_INT(tinyxml2::XML_SUCCESS, doc.Parse(STOP_EVENT_BUNDLED));
+    tinyxml2::XMLElement* root = doc.FirstChildElement();
+    TEST_ASSERT_NULL(root->GetUserData());
+
+    TEST_ASSERT_EQUAL_PTR(root, OjpPath::firstChild(&doc, OJP_TAG_OJP));
+    TEST_ASSERT_NOT_NULL(root->GetUserData());
+    TEST_ASSERT_EQUAL_INT(OJP_TAG_OJP, OjpPath::tagOf(root));
+
+    // Unbekannte Tags werden ebenfalls gecacht
+    tinyxml2::XMLElement* timestamp = OjpPath::firstChild(root, OJP_TAG_OJP_RESPONSE)
+        ->FirstChildElement()->FirstChildElement();
+    TEST_ASSERT_EQUAL_INT(OJP_TAG_UNKNOWN, OjpPath::tagOf(timestamp));
+    TEST_ASSERT_NOT_NULL(timestamp->GetUserData());
+}
+
+void test_iso_time_formats() {
+    const time_t T = utc(2026, 2, 4, 10, 3, 0);
+    TEST_ASSERT_EQUAL_INT32((int32_t)T, (int32_t)OjpParser::parseIsoTime("2026-02-04T10:03:00Z"));
+    TEST_ASSERT_EQUAL_INT32((int32_t)T, (int32_t)OjpParser::parseIsoTime("2026-02-04T10:03:00"));
+    TEST_ASSERT_EQUAL_INT32((int32_t)T, (int32_t)OjpParser::parseIsoTime("2026-02-04t10:03:00z"));
+    TEST_ASSERT_EQUAL_INT32((int32_t)T, (int32_t)OjpParser::parseIsoTime("2026-02-04 10:03:00Z"));
+    TEST_ASSERT_EQUAL_INT32((int32_t)T, (int32_t)OjpParser::parseIsoTime("2026-02-04T11:03:00+01:00"));
+    TEST_ASSERT_EQUAL_INT32((int32_t)T, (int32_t)OjpParser::parseIsoTime("2026-02-04T11:03:00+0100"));
+    TEST_ASSERT_EQUAL_INT32((int32_t)T, (int32_t)OjpParser::parseIsoTime("2026-02-04T11:03:00+01"));
+    TEST_ASSERT_EQUAL_INT32((int32_t)T, (int32_t)OjpParser::parseIsoTime("2026-02-04T06:33:00-03:30"));
+    TEST_ASSERT_EQUAL_INT32((int32_t)T, (int32_t)OjpParser::parseIsoTime("2026-02-04T06:33:00-0330"));
+
+    // Sekundenbruchteile werden abgeschnitten, nicht gerundet
+    TEST_ASSERT_EQUAL_INT32((int32_t)T, (int32_t)OjpParser::parseIsoTime("2026-02-04T10:03:00.999Z"));
+    TEST_ASSERT_EQUAL_INT32((int32_t)T, (int32_t)OjpParser::parseIsoTime("2026-02-04T10:03:00,5Z"));
+    TEST_ASSERT_EQUAL_INT32((int32_t)T, (int32_t)OjpParser::parseIsoTime("2026-02-04T11:03:00.1234567+01:00"));
+
+    // Datumsgrenzen, Schaltjahr, Ende des Tages
+    TEST_ASSERT_EQUAL_INT32((int32_t)utc(2028, 2, 29, 23, 59, 59), (int32_t)OjpParser::parseIsoTime("2028-02-29T23:59:59Z"));
+    TEST_ASSERT_EQUAL_INT32((int32_t)utc(2026, 12, 31, 23, 30, 0), (int32_t)OjpParser::parseIsoTime("2027-01-01T00:30:00+01:00"));
+    TEST_ASSERT_EQUAL_INT32((int32_t)utc(2026, 2, 5, 0, 0, 0), (int32_t)OjpParser::parseIsoTime("2026-02-04T24:00:00Z"));
+    TEST_ASSERT_EQUAL_INT32(0, (int32_t)OjpParser::parseIsoTime("1970-01-01T00:00:00Z"));
+}
+
+void test_iso_time_rejects_malformed() {
+    static const char* const BAD[] = {
+        "",
+        "2026",
+        "2026-02-04",
+        "2026-02-04T10:03",
+        "2026-2-04T10:03:00Z",
+        "2026-02-04X10:03:00Z",
+        "2026/02/04T10:03:00Z",
+        "2026-13-04T10:03:00Z",
+        "2026-00-04T10:03:00Z",
+        "2026-02-00T10:03:00Z",
+        "2026-02-32T10:03:00Z",
+        "2026-02-04T25:00:00Z",
+        "2026-02-04T24:30:00Z",
+        "2026-02-04T24:00:01Z",
+        "2026-02-04T10:60:00Z",
+        "2026-02-04T10:03:61Z",
+        "2026-02-04T1a:03:00Z",
+        "2026-02-04T11:03:00+1",
+        "2026-02-04T11:03:00+01:0",
+        "2026-02-04T11:03:00+ab:00",
+    };
+    TEST_ASSERT_EQUAL_INT32(0, (int32_t)OjpParser::parseIsoTime(NULL));
+    for (size_t i = 0; i < sizeof(BAD) / sizeof(BAD[0]); i++) {
+        TEST_ASSERT_EQUAL_INT32_MESSAGE(0, (int32_t)OjpParser::parseIsoTime(BAD[i]), BAD[i]);
+    }
+}
+
+// Alle Umstellungen 2020-2029 in Europe/Zurich: jede Viertelstunde als Lokalzeit
+// mit Offset formatieren und zurücklesen
+void test_iso_time_round_trips_zurich_dst() {
+    setenv("TZ", ZURICH_TZ, 1);
+    tzset();
+
+    const time_t start = utc(2020, 1, 1, 0, 0, 0);
+    const time_t end = utc(2030, 1, 1, 0, 0, 0);
+    char text[40];
+    long lastOffset = 3600;
+    int transitions = 0;
+    for (time_t t = start; t < end; t += 900) {
+        struct tm local;
+        localtime_r(&t, &local);
+        if (local.tm_gmtoff != lastOffset) {
+            transitions++;
+            lastOffset = local.tm_gmtoff;
+
+            // Umstellung auf die Sekunde genau: 02:00 -> 03:00 im März, 03:00 -> 02:00 im Oktober
+            formatLocal(t - 1, true, text, sizeof(text));
+            TEST_ASSERT_EQUAL_INT32_MESSAGE((int32_t)(t - 1), (int32_t)OjpParser::parseIsoTime(text), text);
+            TEST_ASSERT_EQUAL_INT(local.tm_gmtoff == 7200 ? 3 : 2, local.tm_hour);
+        }
+        formatLocal(t, true, text, sizeof(text));
+        TEST_ASSERT_EQUAL_INT32_MESSAGE((int32_t)t, (int32_t)OjpParser::parseIsoTime(text), text);
+        formatLocal(t, false, text, sizeof(text));
+        TEST_ASSERT_EQUAL_INT32_MESSAGE((int32_t)t, (int32_t)OjpParser::parseIsoTime(text), text);
+    }
+    TEST_ASSERT_EQUAL_INT(20, transitions);
+
+    // Doppelte Stunde im Oktober: gleiche Wanduhrzeit, eine Stunde Abstand
+    TEST_ASSERT_EQUAL_INT32(3600, (int32_t)(OjpParser::parseIsoTime("2026-10-25T02:30:00+01:00") -
+                                            OjpParser::parseIsoTime("2026-10-25T02:30:00+02:00")));
+    // Lücke im März: 01:59:59+01:00 und 03:00:00+02:00 liegen eine Sekunde auseinander
+    TEST_ASSERT_EQUAL_INT32(1, (int32_t)(OjpParser::parseIsoTime("2026-03-29T03:00:00+02:00") -
+                                         OjpParser::parseIsoTime("2026-03-29T01:59:59+01:00")));
+}
+
+// Host-Microbenchmark gegen den früheren Weg (sscanf + timegm), nur zur Info im Log
+void test_iso_time_benchmark() {
+    static const char* const SAMPLES[] = {
+        "2026-02-04T10:03:00Z", "2026-02-04T11:07:00+01:00",
+        "2026-02-04T10:04:12.5Z", "2026-07-14T18:45:30+02:00",
+    };
+    const size_t N = 200000;
+    volatile time_t sink = 0;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < N; i++) sink = sink + OjpParser::parseIsoTime(SAMPLES[i % 4]);
+    auto mid = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < N; i++) {
+        struct tm tm = {};
+        sscanf(SAMPLES[i % 4], "%d-%d-%dT%d:%d:%d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+               &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
+        tm.tm_year -= 1900;
+        tm.tm_mon -= 1;
+        sink = sink + timegm(&tm);
+    }
+    auto done = std::chrono::steady_clock::now();
+
+    double fast = std::chrono::duration<double, std::nano>(mid - begin).count() / N;
+    double slow = std::chrono::duration<double, std::nano>(done - mid).count() / N;
+    char line[96];
+    snprintf(line, sizeof(line), "parseIsoTime: %.0f ns, sscanf+timegm: %.0f ns pro Zeitstempel", fast, slow);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_TRUE(sink != 0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_single_stop_matches);
+    RUN_TEST(test_single_stop_values);
+    RUN_TEST(test_bundled_matches);
+    RUN_TEST(test_bundled_values);
+    RUN_TEST(test_error_response_has_no_departures);
+    RUN_TEST(test_truncated_response_fails);
+    RUN_TEST(test_tag_is_cached_on_element);
+    RUN_TEST(test_iso_time_formats);
+    RUN_TEST(test_iso_time_rejects_malformed);
+    RUN_TEST(test_iso_time_round_trips_zurich_dst);
+    RUN_TEST(test_iso_time_benchmark);
+    return UNITY_END();
+}
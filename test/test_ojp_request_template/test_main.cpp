@@ -0,0 +1,231 @@
+#include <unity.h>
+#include "Transport/OjpRequestTemplate.h"
+
+// Die Templates müssen byte-genau dasselbe XML liefern wie die früheren
+// String-Builder OjpParser::buildRequestXml()/buildLocationSearchXml().
+
+namespace {
+
+const time_t NOW = 1770199380;          // 2026-02-04T10:03:00Z
+const char* const TIMESTAMP = "2026-02-04T10:03:00Z";
+
+// OjpParser::buildRequestXml() vor den Templates, mit festem Zeitstempel
+String baselineStopEvent(const String& stationId, const String& requestorRef, int limit) {
+    String xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
+    xml += "<OJP xmlns=\"http://www.vdv.de/ojp\" xmlns:siri=\"http://www.siri.org.uk/siri\" version=\"2.0\">";
+    xml += "<OJPRequest>";
+    xml += "<siri:ServiceRequest>";
+    xml += "<siri:ServiceRequestContext><siri:Language>de</siri:Language></siri:ServiceRequestContext>";
+    xml += "<siri:RequestTimestamp>" + String(TIMESTAMP) + "</siri:RequestTimestamp>";
+    xml += "<siri:RequestorRef>" + requestorRef + "</siri:RequestorRef>";
+    xml += "<OJPStopEventRequest>";
+    xml += "<siri:RequestTimestamp>" + String(TIMESTAMP) + "</siri:RequestTimestamp>";
+    xml += "<siri:MessageIdentifier>StopEvent1</siri:MessageIdentifier>";
+    xml += "<Location>";
+    xml += "<PlaceRef>";
+    xml += "<siri:StopPointRef>" + stationId + "</siri:StopPointRef>";
+    xml += "<Name><Text>Station</Text></Name>";
+    xml += "</PlaceRef>";
+    xml += "</Location>";
+    xml += "<Params>";
+    xml += "<NumberOfResults>" + String(limit) + "</NumberOfResults>";
+    xml += "<StopEventType>departure</StopEventType>";
+    xml += "<IncludePreviousCalls>false</IncludePreviousCalls>";
+    xml += "<IncludeOnwardCalls>false</IncludeOnwardCalls>";
+    xml += "<UseRealtimeData>full</UseRealtimeData>";
+    xml += "</Params>";
+    xml += "</OJPStopEventRequest>";
+    xml += "</siri:ServiceRequest>";
+    xml += "</OJPRequest>";
+    xml += "</OJP>";
+    return xml;
+}
+
+// OjpParser::buildLocationSearchXml() vor den Templates (Suchbegriff noch ohne Escaping)
+String baselineLocationSearch(const String& query, const String& requestorRef) {
+    String xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
+    xml += "<OJP xmlns=\"http://www.vdv.de/ojp\" xmlns:siri=\"http://www.siri.org.uk/siri\" version=\"2.0\">";
+    xml += "<OJPRequest>";
+    xml += "<siri:ServiceRequest>";
+    xml += "<siri:ServiceRequestContext><siri:Language>de</siri:Language></siri:ServiceRequestContext>";
+    xml += "<siri:RequestTimestamp>" + String(TIMESTAMP) + "</siri:RequestTimestamp>";
+    xml += "<siri:RequestorRef>" + requestorRef + "</siri:RequestorRef>";
+    xml += "<OJPLocationInformationRequest>";
+    xml += "<siri:RequestTimestamp>" + String(TIMESTAMP) + "</siri:RequestTimestamp>";
+    xml += "<siri:MessageIdentifier>LocationSearch1</siri:MessageIdentifier>";
+    xml += "<InitialInput>";
+    xml += "<Name>" + query + "</Name>";
+    xml += "</InitialInput>";
+    xml += "<Restrictions>";
+    xml += "<Type>stop</Type>";
+    xml += "<NumberOfResults>10</NumberOfResults>";
+    xml += "<IncludePtModes>true</IncludePtModes>";
+    xml += "</Restrictions>";
+    xml += "</OJPLocationInformationRequest>";
+    xml += "</siri:ServiceRequest>";
+    xml += "</OJPRequest>";
+    xml += "</OJP>";
+    return xml;
+}
+
+OjpRequestValues values(const char* requestor, int limit = 0) {
+    OjpRequestValues v(NOW);
+    v.requestor = requestor;
+    v.limit = limit;
+    return v;
+}
+
+String renderSingleStop(const char* stopRef, const char* requestor, int limit) {
+    const char* stops[] = { stopRef };
+    return OjpRequestTemplate::renderStopEvents(values(requestor, limit), stops, 1);
+}
+
+String renderSearch(const char* query, const char* requestor = "CrowPanel") {
+    OjpRequestValues v = values(requestor);
+    v.query = query;
+    return OjpRequestTemplate::LOCATION_SEARCH.render(v);
+}
+
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_timestamp_is_formatted_once() {
+    OjpRequestValues v(NOW);
+    TEST_ASSERT_EQUAL_STRING(TIMESTAMP, v.timestamp);
+    OjpRequestValues epoch(0);
+    TEST_ASSERT_EQUAL_STRING("1970-01-01T00:00:00Z", epoch.timestamp);
+}
+
+void test_stop_event_literal() {
+    TEST_ASSERT_EQUAL_STRING(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+        "<OJP xmlns=\"http://www.vdv.de/ojp\" xmlns:siri=\"http://www.siri.org.uk/siri\" version=\"2.0\">"
+        "<OJPRequest><siri:ServiceRequest>"
+        "<siri:ServiceRequestContext><siri:Language>de</siri:Language></siri:ServiceRequestContext>"
+        "<siri:RequestTimestamp>2026-02-04T10:03:00Z</siri:RequestTimestamp>"
+        "<siri:RequestorRef>CrowPanel</siri:RequestorRef>"
+        "<OJPStopEventRequest>"
+        "<siri:RequestTimestamp>2026-02-04T10:03:00Z</siri:RequestTimestamp>"
+        "<siri:MessageIdentifier>StopEvent1</siri:MessageIdentifier>"
+        "<Location><PlaceRef><siri:StopPointRef>8591382</siri:StopPointRef>"
+        "<Name><Text>Station</Text></Name></PlaceRef></Location>"
+        "<Params><NumberOfResults>4</NumberOfResults>"
+        "<StopEventType>departure</StopEventType>"
+        "<IncludePreviousCalls>false</IncludePreviousCalls>"
+        "<IncludeOnwardCalls>false</IncludeOnwardCalls>"
+        "<UseRealtimeData>full</UseRealtimeData>"
+        "</Params></OJPStopEventRequest>"
+        "</siri:ServiceRequest></OJPRequest></OJP>",
+        renderSingleStop("8591382", "CrowPanel", 4).c_str());
+}
+
+void test_stop_event_matches_baseline() {
+    static const char* const STOPS[] = { "8591382", "8503000", "ch:1:sloid:91382:0:2", "" };
+    static const int LIMITS[] = { 0, 4, 12, 50, 100 };
+    for (size_t s = 0; s < sizeof(STOPS) / sizeof(STOPS[0]); s++) {
+        for (size_t l = 0; l < sizeof(LIMITS) / sizeof(LIMITS[0]); l++) {
+            String expected = baselineStopEvent(STOPS[s], "CrowPanel", LIMITS[l]);
+            TEST_ASSERT_EQUAL_STRING(expected.c_str(), renderSingleStop(STOPS[s], "CrowPanel", LIMITS[l]).c_str());
+
+            // Puffer-Variante liefert dasselbe und die exakte Länge
+            char buffer[2048];
+            const char* stops[] = { STOPS[s] };
+            size_t len = OjpRequestTemplate::renderStopEvents(values("CrowPanel", LIMITS[l]), stops, 1,
+                                                              buffer, sizeof(buffer));
+            TEST_ASSERT_EQUAL_size_t(expected.length(), len);
+            TEST_ASSERT_EQUAL_STRING(expected.c_str(), buffer);
+        }
+    }
+}
+
+void test_location_search_matches_baseline() {
+    static const char* const QUERIES[] = { "Bern", "Z\xC3\xBCrich HB", "St. Gallen, Bahnhof", "" };
+    for (size_t i = 0; i < sizeof(QUERIES) / sizeof(QUERIES[0]); i++) {
+        String expected = baselineLocationSearch(QUERIES[i], "CrowPanel");
+        TEST_ASSERT_EQUAL_STRING(expected.c_str(), renderSearch(QUERIES[i]).c_str());
+
+        OjpRequestValues v = values("CrowPanel");
+        v.query = QUERIES[i];
+        TEST_ASSERT_EQUAL_size_t(expected.length(), OjpRequestTemplate::LOCATION_SEARCH.length(v));
+    }
+}
+
+void test_query_is_escaped() {
+    // Früher roh eingesetzt: "&" und "<" machten den Request ungültig
+    String expected = baselineLocationSearch("Bahnhof &amp; &lt;Nord&gt; &quot;A&quot; &apos;B&apos;", "CrowPanel");
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), renderSearch("Bahnhof & <Nord> \"A\" 'B'").c_str());
+
+    // Auch Requestor und StopRef
+    String stopEvent = renderSingleStop("a<b", "Crow&Panel", 4);
+    TEST_ASSERT_EQUAL_STRING(baselineStopEvent("a&lt;b", "Crow&amp;Panel", 4).c_str(), stopEvent.c_str());
+
+    OjpRequestValues v = values("CrowPanel");
+    v.query = "&<>\"'";
+    TEST_ASSERT_EQUAL_size_t(renderSearch("&<>\"'").length(), OjpRequestTemplate::LOCATION_SEARCH.length(v));
+}
+
+void test_bundled_stops_and_line_filter() {
+    OjpStopEventQuery queries[3];
+    queries[0].stopRef = "8591382";
+    queries[0].limit = 8;
+    queries[0].lineRefs[0] = "ojp:91004:A";
+    queries[0].lineRefs[1] = "ojp:91013:A";
+    queries[2].stopRef = "8503000";
+    queries[2].limit = 3;
+
+    char buffer[4096];
+    size_t len = OjpRequestTemplate::renderStopEvents(values("CrowPanel"), queries, 3, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL_size_t(strlen(buffer), len);
+
+    String body(buffer);
+    // Übersprungener Slot behält seine Nummer: StopEvent1 und StopEvent3
+    TEST_ASSERT_TRUE(body.indexOf("<siri:MessageIdentifier>StopEvent1</siri:MessageIdentifier>") > 0);
+    TEST_ASSERT_EQUAL_INT(-1, body.indexOf("StopEvent2"));
+    TEST_ASSERT_TRUE(body.indexOf("<siri:MessageIdentifier>StopEvent3</siri:MessageIdentifier>") > 0);
+    TEST_ASSERT_TRUE(body.indexOf("<Params><LineFilter><Line><siri:LineRef>ojp:91004:A</siri:LineRef></Line>"
+                                  "<Line><siri:LineRef>ojp:91013:A</siri:LineRef></Line>"
+                                  "<Exclude>false</Exclude></LineFilter><NumberOfResults>8</NumberOfResults>") > 0);
+    TEST_ASSERT_TRUE(body.indexOf("<Params><NumberOfResults>3</NumberOfResults>") > 0);
+
+    // Nur der erste StopEventRequest hat einen LineFilter
+    TEST_ASSERT_EQUAL_INT(body.indexOf("<LineFilter>"), body.lastIndexOf("<LineFilter>"));
+}
+
+void test_buffer_too_small_writes_nothing() {
+    OjpRequestValues v = values("CrowPanel");
+    v.query = "Bern & Thun";
+    size_t len = OjpRequestTemplate::LOCATION_SEARCH.length(v);
+
+    char buffer[4096];
+    memset(buffer, 'x', sizeof(buffer));
+    // Ohne Platz für den Nullterminator: nichts geschrieben
+    TEST_ASSERT_EQUAL_size_t(0, OjpRequestTemplate::LOCATION_SEARCH.render(v, buffer, len));
+    TEST_ASSERT_EQUAL_INT('x', buffer[0]);
+    TEST_ASSERT_EQUAL_size_t(0, OjpRequestTemplate::LOCATION_SEARCH.render(v, NULL, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_size_t(len, OjpRequestTemplate::LOCATION_SEARCH.render(v, buffer, len + 1));
+    TEST_ASSERT_EQUAL_INT('\0', buffer[len]);
+
+    const char* stops[] = { "8591382", "8503000" };
+    OjpRequestValues stopValues = values("CrowPanel", 4);
+    size_t bundled = OjpRequestTemplate::renderStopEvents(stopValues, stops, 2, buffer, sizeof(buffer));
+    TEST_ASSERT_GREATER_THAN(0, bundled);
+    memset(buffer, 'x', sizeof(buffer));
+    TEST_ASSERT_EQUAL_size_t(0, OjpRequestTemplate::renderStopEvents(stopValues, stops, 2, buffer, bundled));
+    TEST_ASSERT_EQUAL_INT('x', buffer[0]);
+    TEST_ASSERT_EQUAL_size_t(bundled, OjpRequestTemplate::renderStopEvents(stopValues, stops, 2, buffer, bundled + 1));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_timestamp_is_formatted_once);
+    RUN_TEST(test_stop_event_literal);
+    RUN_TEST(test_stop_event_matches_baseline);
+    RUN_TEST(test_location_search_matches_baseline);
+    RUN_TEST(test_query_is_escaped);
+    RUN_TEST(test_bundled_stops_and_line_filter);
+    RUN_TEST(test_buffer_too_small_writes_nothing);
+    return UNITY_END();
+}
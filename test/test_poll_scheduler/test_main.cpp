@@ -0,0 +1,128 @@
+#include <unity.h>
+#include "Transport/PollScheduler.h"
+
+namespace {
+
+const time_t NOW = 1760000000;      // Gültige Uhrzeit (nach 2020)
+
+Departure departure(const char* line, time_t planned, time_t estimated = 0) {
+    Departure dep;
+    dep.setLine(line);
+    dep.departureTime = planned;
+    dep.estimatedTime = estimated;
+    return dep;
+}
+
+DepartureList listWith(time_t planned, time_t estimated = 0) {
+    DepartureList list;
+    list.add(departure("11", planned, estimated), "Zuerich, Auzelg");
+    return list;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_departure_in_near_window_polls_every_minute() {
+    PollScheduler scheduler;
+    TEST_ASSERT_EQUAL_UINT32(PollScheduler::NEAR_INTERVAL_MS, scheduler.next(listWith(NOW + 120), NOW, true));
+}
+
+void test_waits_until_departure_enters_near_window() {
+    PollScheduler scheduler;
+    // Abfahrt in 8 Minuten: 3 Minuten warten, dann liegt sie im 5-Minuten-Fenster
+    TEST_ASSERT_EQUAL_UINT32(180000, scheduler.next(listWith(NOW + 480), NOW, true));
+}
+
+void test_far_departure_is_capped_at_maximum() {
+    PollScheduler scheduler;
+    TEST_ASSERT_EQUAL_UINT32(PollScheduler::DEFAULT_MAX_MS, scheduler.next(listWith(NOW + 3600), NOW, true));
+}
+
+void test_no_departures_polls_at_maximum() {
+    PollScheduler scheduler;
+    DepartureList empty;
+    TEST_ASSERT_EQUAL_UINT32(PollScheduler::DEFAULT_MAX_MS, scheduler.next(empty, NOW, true));
+}
+
+void test_only_departed_trips_refetch_at_minimum() {
+    PollScheduler scheduler;
+    TEST_ASSERT_EQUAL_UINT32(PollScheduler::DEFAULT_MIN_MS, scheduler.next(listWith(NOW - 60), NOW, true));
+}
+
+void test_moving_estimate_polls_at_minimum() {
+    PollScheduler scheduler;
+    scheduler.next(listWith(NOW + 1800), NOW, true);
+    // Gleicher Kurs, Prognose jetzt 2 Minuten später
+    TEST_ASSERT_EQUAL_UINT32(PollScheduler::DEFAULT_MIN_MS, scheduler.next(listWith(NOW + 1800, NOW + 1920), NOW, true));
+}
+
+void test_small_estimate_drift_is_ignored() {
+    PollScheduler scheduler;
+    scheduler.next(listWith(NOW + 1800), NOW, true);
+    TEST_ASSERT_EQUAL_UINT32(PollScheduler::DEFAULT_MAX_MS, scheduler.next(listWith(NOW + 1800, NOW + 1830), NOW, true));
+}
+
+void test_failures_back_off_exponentially_up_to_maximum() {
+    PollScheduler scheduler;
+    DepartureList list = listWith(NOW + 120);
+    TEST_ASSERT_EQUAL_UINT32(30000, scheduler.next(list, NOW, false));
+    TEST_ASSERT_EQUAL_UINT32(60000, scheduler.next(list, NOW, false));
+    TEST_ASSERT_EQUAL_UINT32(120000, scheduler.next(list, NOW, false));
+    TEST_ASSERT_EQUAL_UINT32(240000, scheduler.next(list, NOW, false));
+    TEST_ASSERT_EQUAL_UINT32(300000, scheduler.next(list, NOW, false));
+    TEST_ASSERT_EQUAL_UINT32(300000, scheduler.next(list, NOW, false));
+    // Erfolg setzt den Backoff zurück
+    TEST_ASSERT_EQUAL_UINT32(PollScheduler::NEAR_INTERVAL_MS, scheduler.next(list, NOW, true));
+    TEST_ASSERT_EQUAL_UINT32(30000, scheduler.next(list, NOW, false));
+}
+
+void test_unsynced_clock_uses_baseline() {
+    PollScheduler scheduler;
+    TEST_ASSERT_EQUAL_UINT32(PollScheduler::BASELINE_MS, scheduler.next(listWith(1000), 900, true));
+}
+
+void test_earliest_departure_over_all_stops_wins() {
+    PollScheduler scheduler;
+    DepartureList lists[3];
+    lists[0] = listWith(NOW + 3600);
+    lists[2] = listWith(NOW + 420);
+    TEST_ASSERT_EQUAL_UINT32(120000, scheduler.next(lists, 3, NOW, true));
+}
+
+void test_limits_clamp_interval() {
+    PollScheduler scheduler;
+    scheduler.setLimits(90000, 120000);
+    TEST_ASSERT_EQUAL_UINT32(90000, scheduler.next(listWith(NOW + 120), NOW, true));
+    DepartureList empty;
+    TEST_ASSERT_EQUAL_UINT32(120000, scheduler.next(empty, NOW, true));
+    // Untergrenze über der Obergrenze wird auf diese begrenzt
+    scheduler.setLimits(200000, 100000);
+    TEST_ASSERT_EQUAL_UINT32(100000, scheduler.getMinMs());
+}
+
+void test_calls_saved_per_day_at_night() {
+    PollScheduler scheduler;
+    DepartureList empty;
+    for (int i = 0; i < 100; i++) scheduler.next(empty, NOW, true);
+    // 300 s statt 30 s: 288 statt 2880 Calls pro Tag
+    TEST_ASSERT_EQUAL_INT32(2592, scheduler.getCallsSavedPerDay());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_departure_in_near_window_polls_every_minute);
+    RUN_TEST(test_waits_until_departure_enters_near_window);
+    RUN_TEST(test_far_departure_is_capped_at_maximum);
+    RUN_TEST(test_no_departures_polls_at_maximum);
+    RUN_TEST(test_only_departed_trips_refetch_at_minimum);
+    RUN_TEST(test_moving_estimate_polls_at_minimum);
+    RUN_TEST(test_small_estimate_drift_is_ignored);
+    RUN_TEST(test_failures_back_off_exponentially_up_to_maximum);
+    RUN_TEST(test_unsynced_clock_uses_baseline);
+    RUN_TEST(test_earliest_departure_over_all_stops_wins);
+    RUN_TEST(test_limits_clamp_interval);
+    RUN_TEST(test_calls_saved_per_day_at_night);
+    return UNITY_END();
+}
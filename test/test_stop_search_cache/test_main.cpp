@@ -0,0 +1,158 @@
+#include <unity.h>
+#include <LittleFS.h>
+#include "Transport/StopSearchCache.h"
+
+namespace {
+
+StopSearchResult stop(const char* id, const char* name, const char* place) {
+    StopSearchResult result;
+    result.id = id;
+    result.name = name;
+    result.topographicPlace = place;
+    return result;
+}
+
+// Vollständige Antwort auf "Ber" (weniger Treffer als das Limit)
+std::vector<StopSearchResult> berResults() {
+    std::vector<StopSearchResult> results;
+    results.push_back(stop("1", "Bern", "Bern"));
+    results.push_back(stop("2", "Bern, Bahnhof", "Bern"));
+    results.push_back(stop("3", "Bern, Wankdorf Bahnhof", "Bern"));
+    results.push_back(stop("4", "Bremgarten b. Bern, Post", "Bremgarten b. Bern"));
+    results.push_back(stop("5", "Zürich, Bernerstrasse", "Zürich"));
+    return results;
+}
+
+std::vector<StopSearchResult> single(const char* id, const char* name, const char* place) {
+    return std::vector<StopSearchResult>(1, stop(id, name, place));
+}
+
+} // namespace
+
+void setUp() {
+    LittleFS.files.clear();
+}
+
+void tearDown() {}
+
+void test_normalize_folds_case_umlauts_and_spaces() {
+    TEST_ASSERT_EQUAL_STRING("zuerich hb", StopSearchCache::normalize("  Zürich   HB ").c_str());
+    TEST_ASSERT_EQUAL_STRING("zuerich hb", StopSearchCache::normalize("ZUERICH hb").c_str());
+    TEST_ASSERT_EQUAL_STRING("geneve", StopSearchCache::normalize("Genève").c_str());
+}
+
+void test_exact_hit_ignores_spelling() {
+    StopSearchCache cache;
+    std::vector<StopSearchResult> results;
+    TEST_ASSERT_FALSE(cache.lookup("Zürich", results));
+    cache.put("Zürich", single("8503000", "Zürich HB", "Zürich"), true);
+    TEST_ASSERT_TRUE(cache.lookup("zuerich", results));
+    TEST_ASSERT_EQUAL_size_t(1, results.size());
+    TEST_ASSERT_TRUE(cache.lookup("ZÜRICH ", results));
+}
+
+void test_truncated_result_does_not_answer_longer_query() {
+    StopSearchCache cache;
+    std::vector<StopSearchResult> results;
+    cache.put("Zürich", single("8503000", "Zürich HB", "Zürich"), true);
+    TEST_ASSERT_FALSE(cache.lookup("Zürich H", results));
+}
+
+void test_complete_result_is_filtered_by_word_prefix() {
+    StopSearchCache cache;
+    std::vector<StopSearchResult> results;
+    cache.put("Ber", berResults(), false);
+
+    TEST_ASSERT_TRUE(cache.lookup("Bern", results));
+    TEST_ASSERT_EQUAL_size_t(5, results.size());
+
+    TEST_ASSERT_TRUE(cache.lookup("bern wank", results));
+    TEST_ASSERT_EQUAL_size_t(1, results.size());
+    TEST_ASSERT_EQUAL_STRING("3", results[0].id.c_str());
+
+    TEST_ASSERT_TRUE(cache.lookup("Bern Bahnhof", results));
+    TEST_ASSERT_EQUAL_size_t(2, results.size());
+
+    TEST_ASSERT_TRUE(cache.lookup("bernerstr", results));
+    TEST_ASSERT_EQUAL_size_t(1, results.size());
+    TEST_ASSERT_EQUAL_STRING("5", results[0].id.c_str());
+
+    // Vollständige Liste: kein Treffer ist auch eine gültige Antwort
+    TEST_ASSERT_TRUE(cache.lookup("berx", results));
+    TEST_ASSERT_TRUE(results.empty());
+
+    // Kürzer als der Schlüssel: muss ans OJP
+    TEST_ASSERT_FALSE(cache.lookup("Be", results));
+
+    StopSearchCacheStats stats = cache.getStats();
+    TEST_ASSERT_EQUAL_UINT32(5, stats.prefixHits);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.misses);
+}
+
+void test_shorter_complete_result_replaces_extensions() {
+    StopSearchCache cache;
+    std::vector<StopSearchResult> results;
+    cache.put("Ber", berResults(), false);
+    cache.put("Be", single("9", "Bettlach", "Bettlach"), false);
+    // "ber" wird jetzt aus "be" gefiltert, der alte Eintrag ist weg
+    TEST_ASSERT_TRUE(cache.lookup("ber", results));
+    TEST_ASSERT_TRUE(results.empty());
+
+    // Gekürztes "b" verdrängt nichts
+    cache.put("b", single("7", "Basel SBB", "Basel"), true);
+    TEST_ASSERT_TRUE(cache.lookup("be", results));
+    TEST_ASSERT_EQUAL_size_t(1, results.size());
+    TEST_ASSERT_EQUAL_STRING("9", results[0].id.c_str());
+}
+
+void test_least_recently_used_entry_is_evicted() {
+    StopSearchCache cache;
+    std::vector<StopSearchResult> results;
+    for (int i = 0; i < 20; i++) {
+        char query[8];
+        snprintf(query, sizeof(query), "q%02d", i);
+        cache.put(query, std::vector<StopSearchResult>(), true);
+    }
+    TEST_ASSERT_EQUAL_UINT32(StopSearchCache::MAX_ENTRIES, cache.getStats().entries);
+    TEST_ASSERT_FALSE(cache.lookup("q00", results));
+    TEST_ASSERT_TRUE(cache.lookup("q04", results));
+    TEST_ASSERT_TRUE(cache.lookup("q19", results));
+}
+
+void test_persisted_cache_keeps_prefix_filtering() {
+    StopSearchCache cache;
+    cache.setStorage(&LittleFS, "/stopsearch.txt");
+    cache.put("Zürich", single("8503000", "Zürich HB", "Zürich"), true);
+    cache.put("ber", berResults(), false);
+    TEST_ASSERT_TRUE(cache.save());
+    TEST_ASSERT_FALSE(cache.save());      // Nichts Neues
+
+    StopSearchCache loaded;
+    loaded.setStorage(&LittleFS, "/stopsearch.txt");
+    std::vector<StopSearchResult> results;
+    TEST_ASSERT_TRUE(loaded.lookup("bern wank", results));
+    TEST_ASSERT_EQUAL_size_t(1, results.size());
+    TEST_ASSERT_EQUAL_STRING("Bern, Wankdorf Bahnhof", results[0].name.c_str());
+    TEST_ASSERT_TRUE(loaded.lookup("zuerich", results));
+    TEST_ASSERT_EQUAL_STRING("Zürich", results[0].topographicPlace.c_str());
+    TEST_ASSERT_FALSE(loaded.lookup("zuerich h", results));
+}
+
+void test_supersedes_matches_prefix_in_both_directions() {
+    TEST_ASSERT_TRUE(StopSearchCache::supersedes("Ber", "Bern"));
+    TEST_ASSERT_TRUE(StopSearchCache::supersedes("Bern", "Be"));
+    TEST_ASSERT_FALSE(StopSearchCache::supersedes("Basel", "Bern"));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_normalize_folds_case_umlauts_and_spaces);
+    RUN_TEST(test_exact_hit_ignores_spelling);
+    RUN_TEST(test_truncated_result_does_not_answer_longer_query);
+    RUN_TEST(test_complete_result_is_filtered_by_word_prefix);
+    RUN_TEST(test_shorter_complete_result_replaces_extensions);
+    RUN_TEST(test_least_recently_used_entry_is_evicted);
+    RUN_TEST(test_persisted_cache_keeps_prefix_filtering);
+    RUN_TEST(test_supersedes_matches_prefix_in_both_directions);
+    return UNITY_END();
+}
@@ -0,0 +1,202 @@
+#include <unity.h>
+#include "Core/StringUtils.h"
+#include <string.h>
+
+namespace {
+
+// Transliteriert mit großzügigem Puffer (keine Kürzung)
+String ascii(const char* input) {
+    char buffer[256];
+    size_t len = StringUtils::toASCII(input, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL_size_t(strlen(buffer), len);
+    return String(buffer);
+}
+
+// UTF-8 Kodierung eines Codepoints (ohne Surrogates), Rückgabe: Anzahl Bytes
+size_t encodeUtf8(uint32_t codepoint, char* out) {
+    if (codepoint < 0x80) {
+        out[0] = (char)codepoint;
+        out[1] = '\0';
+        return 1;
+    }
+    if (codepoint < 0x800) {
+        out[0] = (char)(0xC0 | (codepoint >> 6));
+        out[1] = (char)(0x80 | (codepoint & 0x3F));
+        out[2] = '\0';
+        return 2;
+    }
+    if (codepoint < 0x10000) {
+        out[0] = (char)(0xE0 | (codepoint >> 12));
+        out[1] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (codepoint & 0x3F));
+        out[3] = '\0';
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (codepoint >> 18));
+    out[1] = (char)(0x80 | ((codepoint >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (codepoint & 0x3F));
+    out[4] = '\0';
+    return 4;
+}
+
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_ascii_passes_through() {
+    TEST_ASSERT_EQUAL_STRING("Bern, Bahnhof 12 (Gleis 3)", ascii("Bern, Bahnhof 12 (Gleis 3)").c_str());
+    TEST_ASSERT_EQUAL_STRING(" ~", ascii(" ~").c_str());
+    // Steuerzeichen fallen weg, Zeilenumbrüche bleiben
+    TEST_ASSERT_EQUAL_STRING("a\nb\rcd", ascii("a\nb\rc\td\x7F\x01").c_str());
+    TEST_ASSERT_EQUAL_STRING("", ascii("").c_str());
+    TEST_ASSERT_EQUAL_STRING("", ascii(NULL).c_str());
+}
+
+void test_umlauts() {
+    TEST_ASSERT_EQUAL_STRING("Zuerich Hauptbahnhof", ascii("Z\xC3\xBCrich Hauptbahnhof").c_str());
+    TEST_ASSERT_EQUAL_STRING("Ae Oe Ue ae oe ue ss",
+                             ascii("\xC3\x84 \xC3\x96 \xC3\x9C \xC3\xA4 \xC3\xB6 \xC3\xBC \xC3\x9F").c_str());
+    TEST_ASSERT_EQUAL_STRING("Muenchenbuchsee", ascii("M\xC3\xBCnchenbuchsee").c_str());
+}
+
+void test_latin1_supplement() {
+    // Akzente fallen weg
+    TEST_ASSERT_EQUAL_STRING("Geneve-Aeroport", ascii("Gen\xC3\xA8ve-A\xC3\xA9roport").c_str());
+    TEST_ASSERT_EQUAL_STRING("Neuchatel", ascii("Neuch\xC3\xA2tel").c_str());
+    TEST_ASSERT_EQUAL_STRING("AE ae O o N n C c", ascii("\xC3\x86 \xC3\xA6 \xC3\x98 \xC3\xB8 \xC3\x91 \xC3\xB1 \xC3\x87 \xC3\xA7").c_str());
+    // Symbole
+    TEST_ASSERT_EQUAL_STRING("(c) (R) 1/2 +- o", ascii("\xC2\xA9 \xC2\xAE \xC2\xBD \xC2\xB1 \xC2\xB0").c_str());
+    TEST_ASSERT_EQUAL_STRING("\"Bern\"", ascii("\xC2\xAB" "Bern" "\xC2\xBB").c_str());
+    // NBSP wird Leerzeichen, Soft Hyphen und Währungszeichen fallen weg
+    TEST_ASSERT_EQUAL_STRING("S 1Gleis", ascii("S\xC2\xA0" "1\xC2\xAD" "Gleis\xC2\xA4").c_str());
+}
+
+void test_latin_extended_a() {
+    TEST_ASSERT_EQUAL_STRING("Lodz", ascii("\xC5\x81\xC3\xB3\xC4\x91\xC5\xBA").c_str());      // Łóđź
+    TEST_ASSERT_EQUAL_STRING("Ceske Budejovice",
+                             ascii("\xC4\x8C" "esk\xC3\xA9 Bud\xC4\x9Bjovice").c_str());      // České Budějovice
+    TEST_ASSERT_EQUAL_STRING("OE oe IJ ij", ascii("\xC5\x92 \xC5\x93 \xC4\xB2 \xC4\xB3").c_str());
+    // Tabellenränder U+0100 und U+017F
+    TEST_ASSERT_EQUAL_STRING("As", ascii("\xC4\x80\xC5\xBF").c_str());
+    // Erster Codepoint danach (U+0180) ist nicht abgedeckt
+    TEST_ASSERT_EQUAL_STRING("", ascii("\xC6\x80").c_str());
+}
+
+void test_punctuation() {
+    // U+2010..U+2015 Striche
+    TEST_ASSERT_EQUAL_STRING("------",
+                             ascii("\xE2\x80\x90\xE2\x80\x91\xE2\x80\x92\xE2\x80\x93\xE2\x80\x94\xE2\x80\x95").c_str());
+    // U+2016 ‖, U+2017 ‗
+    TEST_ASSERT_EQUAL_STRING("|_", ascii("\xE2\x80\x96\xE2\x80\x97").c_str());
+    // U+2018..U+201B einfache, U+201C..U+201F doppelte Anführungszeichen
+    TEST_ASSERT_EQUAL_STRING("''''", ascii("\xE2\x80\x98\xE2\x80\x99\xE2\x80\x9A\xE2\x80\x9B").c_str());
+    TEST_ASSERT_EQUAL_STRING("\"\"\"\"", ascii("\xE2\x80\x9C\xE2\x80\x9D\xE2\x80\x9E\xE2\x80\x9F").c_str());
+    TEST_ASSERT_EQUAL_STRING("Bern \"Wankdorf\" - Thun",
+                             ascii("Bern \xE2\x80\x9EWankdorf\xE2\x80\x9C \xE2\x80\x93 Thun").c_str());
+    // Ellipse
+    TEST_ASSERT_EQUAL_STRING("Bahnhof...", ascii("Bahnhof\xE2\x80\xA6").c_str());
+    // Nachbarn der Bereiche (U+200F, U+2020) und andere Zeichen fallen weg
+    TEST_ASSERT_EQUAL_STRING("ab", ascii("a\xE2\x80\x8F\xE2\x80\xA0" "b").c_str());
+    TEST_ASSERT_EQUAL_STRING("Bus ", ascii("Bus \xF0\x9F\x9A\x8C").c_str());     // Emoji (4 Bytes)
+    TEST_ASSERT_EQUAL_STRING("10", ascii("10\xE2\x82\xAC").c_str());            // €
+}
+
+void test_malformed_utf8() {
+    // Abgebrochene Sequenz am Ende
+    TEST_ASSERT_EQUAL_STRING("Zu", ascii("Zu\xC3").c_str());
+    TEST_ASSERT_EQUAL_STRING("a", ascii("a\xE2\x80").c_str());
+    TEST_ASSERT_EQUAL_STRING("a", ascii("a\xF0\x9F\x9A").c_str());
+    // Abgebrochene Sequenz mitten im Text: das nächste ASCII-Zeichen bleibt erhalten
+    TEST_ASSERT_EQUAL_STRING("ZArich", ascii("Z\xC3" "Arich").c_str());
+    TEST_ASSERT_EQUAL_STRING("a-b", ascii("a\xE2\x80-b").c_str());
+    // Startbyte gefolgt von neuem Startbyte: zweite Sequenz wird normal dekodiert
+    TEST_ASSERT_EQUAL_STRING("ue", ascii("\xC3\xC3\xBC").c_str());
+    // Folgebytes ohne Startbyte und ungültige Startbytes
+    TEST_ASSERT_EQUAL_STRING("ab", ascii("a\x80\xBF" "b").c_str());
+    TEST_ASSERT_EQUAL_STRING("ab", ascii("a\xF8\xFF" "b").c_str());
+    // Latin-1 statt UTF-8 ("Zürich" als ISO-8859-1)
+    TEST_ASSERT_EQUAL_STRING("Zrich", ascii("Z\xFCrich").c_str());
+}
+
+void test_truncates_at_capacity() {
+    char buffer[8];
+    memset(buffer, 'x', sizeof(buffer));
+    TEST_ASSERT_EQUAL_size_t(7, StringUtils::toASCII("Bahnhofstrasse", buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_STRING("Bahnhof", buffer);
+
+    // Ersatztext wird mitten drin gekürzt, der Rest nicht mehr gelesen
+    TEST_ASSERT_EQUAL_size_t(7, StringUtils::toASCII("Zuerich\xC3\xBC", buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_STRING("Zuerich", buffer);
+    TEST_ASSERT_EQUAL_size_t(7, StringUtils::toASCII("Z\xC3\xBCrich \xC2\xBD", buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_STRING("Zuerich", buffer);
+    TEST_ASSERT_EQUAL_size_t(3, StringUtils::toASCII("ab\xC3\xA4", buffer, 4));
+    TEST_ASSERT_EQUAL_STRING("aba", buffer);
+
+    // Kapazität 1: nur der Nullterminator
+    buffer[0] = 'x';
+    TEST_ASSERT_EQUAL_size_t(0, StringUtils::toASCII("Bern", buffer, 1));
+    TEST_ASSERT_EQUAL_INT('\0', buffer[0]);
+
+    // Kapazität 0 oder kein Puffer: nichts geschrieben
+    buffer[0] = 'x';
+    TEST_ASSERT_EQUAL_size_t(0, StringUtils::toASCII("Bern", buffer, 0));
+    TEST_ASSERT_EQUAL_INT('x', buffer[0]);
+    TEST_ASSERT_EQUAL_size_t(0, StringUtils::toASCII("Bern", NULL, 16));
+}
+
+void test_string_overload_never_truncates() {
+    // Die String-Variante reserviert 1.5x der Eingabe. Für jeden Codepoint
+    // (einzeln und 40x wiederholt, damit der Heap-Puffer greift) muss das
+    // Ergebnis dem ungekürzten Ergebnis entsprechen.
+    char big[1024];
+    char sequence[5];
+    for (uint32_t codepoint = 1; codepoint < 0x10000; codepoint++) {
+        if (codepoint >= 0xD800 && codepoint <= 0xDFFF) continue;
+        size_t bytes = encodeUtf8(codepoint, sequence);
+
+        size_t len = StringUtils::toASCII(sequence, big, sizeof(big));
+        TEST_ASSERT_LESS_OR_EQUAL(bytes + bytes / 2, len);
+        TEST_ASSERT_EQUAL_STRING(big, StringUtils::toASCII(String(sequence)).c_str());
+
+        String repeated;
+        for (int i = 0; i < 40; i++) repeated += sequence;
+        StringUtils::toASCII(repeated.c_str(), big, sizeof(big));
+        TEST_ASSERT_EQUAL_STRING(big, StringUtils::toASCII(repeated).c_str());
+    }
+}
+
+void test_string_overload_worst_case() {
+    // Längste Ersatztexte pro Byte: ¼ (2 Bytes -> "1/4") und … (3 Bytes -> "...")
+    String quarter;
+    String expected;
+    for (int i = 0; i < 100; i++) {
+        quarter += "\xC2\xBC";
+        expected += "1/4";
+    }
+    TEST_ASSERT_EQUAL_size_t(300, StringUtils::toASCII(quarter).length());
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), StringUtils::toASCII(quarter).c_str());
+
+    // Grenze zwischen Stack- (96 Bytes) und Heap-Puffer
+    String onStack;
+    for (int i = 0; i < 31; i++) onStack += "\xC2\xBC";   // 62 Bytes -> 93 Zeichen
+    TEST_ASSERT_EQUAL_size_t(93, StringUtils::toASCII(onStack).length());
+    onStack += "\xC2\xBC";                                  // 64 Bytes -> 96 Zeichen, Heap
+    TEST_ASSERT_EQUAL_size_t(96, StringUtils::toASCII(onStack).length());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_ascii_passes_through);
+    RUN_TEST(test_umlauts);
+    RUN_TEST(test_latin1_supplement);
+    RUN_TEST(test_latin_extended_a);
+    RUN_TEST(test_punctuation);
+    RUN_TEST(test_malformed_utf8);
+    RUN_TEST(test_truncates_at_capacity);
+    RUN_TEST(test_string_overload_never_truncates);
+    RUN_TEST(test_string_overload_worst_case);
+    return UNITY_END();
+}